@@ -0,0 +1,484 @@
+//------------------------------------------------------------------------
+//  ADJACENCY
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Adjacency.h"
+
+#include "Document.h"
+#include "LineDef.h"
+#include "SideDef.h"
+#include "sys_debug.h"
+#include "Vertex.h"
+
+#include <algorithm>
+
+static uint64_t spotKey(FFixedPoint fx, FFixedPoint fy) noexcept
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(fx.raw())) << 32) |
+		   static_cast<uint32_t>(fy.raw());
+}
+
+static void addRef(std::vector<std::vector<int>> &table, int index, int objnum)
+{
+	if (index < 0)
+		return;
+
+	if (index >= (int)table.size())
+		table.resize(index + 1);
+
+	table[index].push_back(objnum);
+}
+
+static void removeRef(std::vector<int> &list, int objnum)
+{
+	auto it = std::find(list.begin(), list.end(), objnum);
+	if (it != list.end())
+	{
+		*it = list.back();
+		list.pop_back();
+	}
+}
+
+static void removeRef(std::vector<std::vector<int>> &table, int index, int objnum)
+{
+	if (index >= 0 && index < (int)table.size())
+		removeRef(table[index], objnum);
+}
+
+static void copyRefs(const std::vector<std::vector<int>> &table, int index, std::vector<int> &list)
+{
+	if (index >= 0 && index < (int)table.size())
+		list.insert(list.end(), table[index].begin(), table[index].end());
+}
+
+//------------------------------------------------------------------------
+//  FILING
+//------------------------------------------------------------------------
+
+void Adjacency::fileLine(int ld) const
+{
+	const LineDef &L = *doc.linedefs[ld];
+
+	if (ld >= (int)mLineRefs.size())
+		mLineRefs.resize(ld + 1);
+
+	mLineRefs[ld] = { L.start, L.end, L.right, L.left };
+
+	addRef(mVertexLines, L.start, ld);
+	if (L.end != L.start)
+		addRef(mVertexLines, L.end, ld);
+
+	addRef(mSidedefLines, L.right, ld);
+	if (L.left != L.right)
+		addRef(mSidedefLines, L.left, ld);
+}
+
+void Adjacency::unfileLine(int ld) const
+{
+	const LineRefs &refs = mLineRefs[ld];
+
+	removeRef(mVertexLines, refs.start, ld);
+	if (refs.end != refs.start)
+		removeRef(mVertexLines, refs.end, ld);
+
+	removeRef(mSidedefLines, refs.right, ld);
+	if (refs.left != refs.right)
+		removeRef(mSidedefLines, refs.left, ld);
+}
+
+void Adjacency::fileSidedef(int sd) const
+{
+	if (sd >= (int)mSidedefSector.size())
+		mSidedefSector.resize(sd + 1);
+
+	mSidedefSector[sd] = doc.sidedefs[sd]->sector;
+
+	addRef(mSectorSidedefs, mSidedefSector[sd], sd);
+}
+
+void Adjacency::unfileSidedef(int sd) const
+{
+	removeRef(mSectorSidedefs, mSidedefSector[sd], sd);
+}
+
+void Adjacency::fileVertex(int v) const
+{
+	const Vertex &V = *doc.vertices[v];
+
+	if (v >= (int)mVertexKey.size())
+		mVertexKey.resize(v + 1);
+
+	mVertexKey[v] = spotKey(V.raw_x, V.raw_y);
+
+	mSpotVertices[mVertexKey[v]].push_back(v);
+}
+
+void Adjacency::unfileVertex(int v) const
+{
+	auto spot = mSpotVertices.find(mVertexKey[v]);
+	if (spot == mSpotVertices.end())
+		return;
+
+	removeRef(spot->second, v);
+
+	if (spot->second.empty())
+		mSpotVertices.erase(spot);
+}
+
+//------------------------------------------------------------------------
+//  SYNCING
+//------------------------------------------------------------------------
+
+//
+// How far the objects can be filed: not past the ones added by the
+// open edit group, since those may still be written to.
+//
+int Adjacency::limitFor(const Table &table, int total) const noexcept
+{
+	return mInGroup ? std::min(total, table.fresh) : total;
+}
+
+void Adjacency::syncLines() const
+{
+	int total = doc.numLinedefs();
+
+	if (mLines.count > total)
+		mLines.valid = false;
+
+	if (!mLines.valid)
+	{
+		mLineRefs.clear();
+		mVertexLines.clear();
+		mSidedefLines.clear();
+
+		mLines.count = 0;
+		mLines.valid = true;
+	}
+
+	int limit = limitFor(mLines, total);
+
+	for (int n = mLines.count ; n < limit ; n++)
+		fileLine(n);
+
+	mLines.count = std::max(mLines.count, limit);
+}
+
+void Adjacency::syncSidedefs() const
+{
+	int total = doc.numSidedefs();
+
+	if (mSidedefs.count > total)
+		mSidedefs.valid = false;
+
+	if (!mSidedefs.valid)
+	{
+		mSidedefSector.clear();
+		mSectorSidedefs.clear();
+
+		mSidedefs.count = 0;
+		mSidedefs.valid = true;
+	}
+
+	int limit = limitFor(mSidedefs, total);
+
+	for (int n = mSidedefs.count ; n < limit ; n++)
+		fileSidedef(n);
+
+	mSidedefs.count = std::max(mSidedefs.count, limit);
+}
+
+void Adjacency::syncVertices() const
+{
+	int total = doc.numVertices();
+
+	if (mVertices.count > total)
+		mVertices.valid = false;
+
+	if (!mVertices.valid)
+	{
+		mVertexKey.clear();
+		mSpotVertices.clear();
+
+		mVertices.count = 0;
+		mVertices.valid = true;
+	}
+
+	int limit = limitFor(mVertices, total);
+
+	for (int n = mVertices.count ; n < limit ; n++)
+		fileVertex(n);
+
+	mVertices.count = std::max(mVertices.count, limit);
+}
+
+//------------------------------------------------------------------------
+//  QUERIES
+//------------------------------------------------------------------------
+
+//
+// Find all the linedefs which start or end at the vertex
+//
+void Adjacency::linesAtVertex(int v_num, std::vector<int> &list) const
+{
+	list.clear();
+
+	syncLines();
+
+	copyRefs(mVertexLines, v_num, list);
+
+	for (int n = mLines.count ; n < doc.numLinedefs() ; n++)
+		if (doc.linedefs[n]->TouchesVertex(v_num))
+			list.push_back(n);
+
+	std::sort(list.begin(), list.end());
+}
+
+int Adjacency::countLinesAtVertex(int v_num) const
+{
+	syncLines();
+
+	int count = 0;
+
+	if (v_num >= 0 && v_num < (int)mVertexLines.size())
+		count = (int)mVertexLines[v_num].size();
+
+	for (int n = mLines.count ; n < doc.numLinedefs() ; n++)
+		if (doc.linedefs[n]->TouchesVertex(v_num))
+			count++;
+
+	return count;
+}
+
+//
+// Find all the linedefs which use the sidedef (on either side)
+//
+void Adjacency::linesOfSidedef(int sd_num, std::vector<int> &list) const
+{
+	list.clear();
+
+	syncLines();
+
+	copyRefs(mSidedefLines, sd_num, list);
+
+	for (int n = mLines.count ; n < doc.numLinedefs() ; n++)
+		if (doc.linedefs[n]->right == sd_num || doc.linedefs[n]->left == sd_num)
+			list.push_back(n);
+
+	std::sort(list.begin(), list.end());
+}
+
+//
+// Find all the sidedefs which face into the sector
+//
+void Adjacency::sidedefsOfSector(int sec_num, std::vector<int> &list) const
+{
+	list.clear();
+
+	syncSidedefs();
+
+	copyRefs(mSectorSidedefs, sec_num, list);
+
+	for (int n = mSidedefs.count ; n < doc.numSidedefs() ; n++)
+		if (doc.sidedefs[n]->sector == sec_num)
+			list.push_back(n);
+
+	std::sort(list.begin(), list.end());
+}
+
+//
+// Find the lowest numbered vertex at the exact coordinates, or -1
+//
+int Adjacency::vertexAt(FFixedPoint fx, FFixedPoint fy) const
+{
+	syncVertices();
+
+	int result = INT_MAX;
+
+	auto spot = mSpotVertices.find(spotKey(fx, fy));
+	if (spot != mSpotVertices.end())
+		for (int v : spot->second)
+			result = std::min(result, v);
+
+	if (result != INT_MAX)
+		return result;
+
+	for (int n = mVertices.count ; n < doc.numVertices() ; n++)
+		if (doc.vertices[n]->Matches(fx, fy))
+			return n;
+
+	return -1;  // not found
+}
+
+//
+// Forget everything, e.g. after loading a new level
+//
+void Adjacency::invalidate() noexcept
+{
+	mLines.valid = false;
+	mSidedefs.valid = false;
+	mVertices.valid = false;
+}
+
+//------------------------------------------------------------------------
+//  BASIS NOTIFICATIONS
+//------------------------------------------------------------------------
+
+Adjacency::Table *Adjacency::tableFor(ObjType type) noexcept
+{
+	switch (type)
+	{
+	case ObjType::linedefs: return &mLines;
+	case ObjType::sidedefs: return &mSidedefs;
+	case ObjType::vertices: return &mVertices;
+
+	default:
+		return nullptr;
+	}
+}
+
+void Adjacency::notifyBegin() noexcept
+{
+	mInGroup = true;
+
+	mLines.fresh = INT_MAX;
+	mSidedefs.fresh = INT_MAX;
+	mVertices.fresh = INT_MAX;
+}
+
+//
+// Called before the object is inserted
+//
+void Adjacency::notifyInsert(ObjType type, int objnum) noexcept
+{
+	// anything referring to objects after it gets renumbered
+	if (objnum < doc.numObjects(type))
+	{
+		if (type == ObjType::vertices || type == ObjType::sidedefs)
+			mLines.valid = false;
+		else if (type == ObjType::sectors)
+			mSidedefs.valid = false;
+	}
+
+	Table *table = tableFor(type);
+	if (!table)
+		return;
+
+	if (mInGroup)
+		table->fresh = std::min(table->fresh, objnum);
+
+	// appending is free: the new object is pending until the group ends
+	if (objnum < table->count)
+		table->valid = false;
+}
+
+//
+// Called before the object is deleted
+//
+void Adjacency::notifyDelete(ObjType type, int objnum)
+{
+	// anything referring to objects after it gets renumbered
+	if (objnum < doc.numObjects(type) - 1)
+	{
+		if (type == ObjType::vertices || type == ObjType::sidedefs)
+			mLines.valid = false;
+		else if (type == ObjType::sectors)
+			mSidedefs.valid = false;
+	}
+
+	Table *table = tableFor(type);
+	if (!table)
+		return;
+
+	if (objnum < table->fresh && table->fresh != INT_MAX)
+		table->fresh--;
+
+	if (objnum >= table->count)
+		return;
+
+	if (table->valid && objnum == table->count - 1)
+	{
+		switch (type)
+		{
+		case ObjType::linedefs: unfileLine(objnum); break;
+		case ObjType::sidedefs: unfileSidedef(objnum); break;
+		case ObjType::vertices: unfileVertex(objnum); break;
+		default: break;
+		}
+
+		table->count--;
+		return;
+	}
+
+	table->valid = false;
+}
+
+//
+// Called after the field has changed
+//
+void Adjacency::notifyChange(ObjType type, int objnum, int field)
+{
+	switch (type)
+	{
+	case ObjType::linedefs:
+		if (field != LineDef::F_START && field != LineDef::F_END &&
+			field != LineDef::F_RIGHT && field != LineDef::F_LEFT)
+			break;
+
+		if (mLines.valid && objnum < mLines.count)
+		{
+			unfileLine(objnum);
+			fileLine(objnum);
+		}
+		break;
+
+	case ObjType::sidedefs:
+		if (field != SideDef::F_SECTOR)
+			break;
+
+		if (mSidedefs.valid && objnum < mSidedefs.count)
+		{
+			unfileSidedef(objnum);
+			fileSidedef(objnum);
+		}
+		break;
+
+	case ObjType::vertices:
+		if (mVertices.valid && objnum < mVertices.count)
+		{
+			unfileVertex(objnum);
+			fileVertex(objnum);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void Adjacency::notifyEnd() noexcept
+{
+	mInGroup = false;
+
+	mLines.fresh = INT_MAX;
+	mSidedefs.fresh = INT_MAX;
+	mVertices.fresh = INT_MAX;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------
+//  ADJACENCY
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef ADJACENCY_H_
+#define ADJACENCY_H_
+
+#include "DocumentModule.h"
+#include "FixedPoint.h"
+#include "objid.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//
+// Reverse lookups between map objects: the linedefs using a vertex or
+// a sidedef, the sidedefs of a sector, and the vertices at a map spot.
+//
+// Kept up to date by the Basis notifications, so a field change costs a
+// couple of list updates. Like the SpatialIndex, objects appended while
+// an edit group is open are "pending" (their fields get set after the
+// insertion) and are checked directly by the queries until the group
+// ends, while deleting or inserting in the middle of an array (which
+// renumbers the references) marks the affected tables as stale, to be
+// rebuilt by the next query.
+//
+// Lists are returned sorted by ascending object number.
+//
+class Adjacency : public DocumentModule
+{
+public:
+	explicit Adjacency(Document &doc) : DocumentModule(doc)
+	{
+	}
+
+	void linesAtVertex(int v_num, std::vector<int> &list) const;
+	int countLinesAtVertex(int v_num) const;
+	void linesOfSidedef(int sd_num, std::vector<int> &list) const;
+	void sidedefsOfSector(int sec_num, std::vector<int> &list) const;
+	int vertexAt(FFixedPoint fx, FFixedPoint fy) const;
+
+	void invalidate() noexcept;
+
+	// Basis hooks
+	void notifyBegin() noexcept;
+	void notifyInsert(ObjType type, int objnum) noexcept;
+	void notifyDelete(ObjType type, int objnum);
+	void notifyChange(ObjType type, int objnum, int field);
+	void notifyEnd() noexcept;
+
+private:
+	struct Table
+	{
+		int count = 0;	// objects [0, count) are filed, the rest are pending
+		int fresh = INT_MAX;	// lowest object added by the open edit group
+		bool valid = false;
+	};
+
+	// the references of a filed linedef, as they were when filed
+	struct LineRefs
+	{
+		int start, end;
+		int right, left;
+	};
+
+	Table *tableFor(ObjType type) noexcept;
+	int limitFor(const Table &table, int total) const noexcept;
+
+	void syncLines() const;
+	void syncSidedefs() const;
+	void syncVertices() const;
+
+	void fileLine(int ld) const;
+	void unfileLine(int ld) const;
+	void fileSidedef(int sd) const;
+	void unfileSidedef(int sd) const;
+	void fileVertex(int v) const;
+	void unfileVertex(int v) const;
+
+	// mutable since the tables are lazily updated by const queries
+	mutable Table mLines;
+	mutable std::vector<LineRefs> mLineRefs;
+	mutable std::vector<std::vector<int>> mVertexLines;
+	mutable std::vector<std::vector<int>> mSidedefLines;
+
+	mutable Table mSidedefs;
+	mutable std::vector<int> mSidedefSector;
+	mutable std::vector<std::vector<int>> mSectorSidedefs;
+
+	mutable Table mVertices;
+	mutable std::vector<uint64_t> mVertexKey;
+	mutable std::unordered_map<uint64_t, std::vector<int>> mSpotVertices;
+
+	bool mInGroup = false;
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -118,10 +118,10 @@ void Document::getLevelChecksum(crc32_c &crc) const
 	int i;
 
 	for(i = 0; i < numThings(); i++)
-		ChecksumThing(crc, things[i].get());
+		ChecksumThing(crc, things[i]);
 
 	for(i = 0; i < numLinedefs(); i++)
-		ChecksumLineDef(crc, linedefs[i].get(), *this);
+		ChecksumLineDef(crc, linedefs[i], *this);
 }
 
 const Sector &Document::getSector(const SideDef &side) const
@@ -148,7 +148,7 @@ const Sector *Document::getSector(const LineDef &line, Side side) const
 {
 	int sid = getSectorID(line, side);
 	if(isSector(sid))
-		return sectors[sid].get();
+		return sectors[sid];
 	return nullptr;
 }
 
@@ -164,12 +164,12 @@ const Vertex &Document::getEnd(const LineDef &line) const
 
 const SideDef *Document::getRight(const LineDef &line) const
 {
-	return line.right >= 0 ? sidedefs[line.right].get() : nullptr;
+	return line.right >= 0 ? sidedefs[line.right] : nullptr;
 }
 
 const SideDef *Document::getLeft(const LineDef &line) const
 {
-	return line.left >= 0 ? sidedefs[line.left].get() : nullptr;
+	return line.left >= 0 ? sidedefs[line.left] : nullptr;
 }
 
 double Document::calcLength(const LineDef &line) const
@@ -227,6 +227,8 @@ void Document::clear()
 	scriptsData.clear();
 	
 	basis.clear();
+	adjacency.invalidate();
+	spatial.invalidate();
 
 	// TODO: other modules
 	Clipboard_ClearLocals();
@@ -19,6 +19,7 @@
 #ifndef Document_hpp
 #define Document_hpp
 
+#include "Adjacency.h"
 #include "e_basis.h"
 #include "e_checks.h"
 #include "e_hover.h"
@@ -27,6 +28,8 @@
 #include "e_sector.h"
 #include "e_vertex.h"
 #include "LineDef.h"
+#include "MapArray.h"
+#include "SpatialIndex.h"
 #include "Vertex.h"
 #include <memory>
 
@@ -43,11 +46,11 @@ private:
 	Instance &inst;	// make this private because we don't want to access it from Document
 public:
 
-	std::vector<std::shared_ptr<Thing>> things;
-	std::vector<std::shared_ptr<Vertex>> vertices;
-	std::vector<std::shared_ptr<Sector>> sectors;
-	std::vector<std::shared_ptr<SideDef>> sidedefs;
-	std::vector<std::shared_ptr<LineDef>> linedefs;
+	MapArray<Thing> things;
+	MapArray<Vertex> vertices;
+	MapArray<Sector> sectors;
+	MapArray<SideDef> sidedefs;
+	MapArray<LineDef> linedefs;
 
 	std::vector<byte> headerData;
 	std::vector<byte> behaviorData;
@@ -65,13 +68,15 @@ public:
 	VertexModule vertmod;
 	SectorModule secmod;
 	ObjectsModule objects;
+	Adjacency adjacency;
+	SpatialIndex spatial;
 
 	explicit Document(Instance &inst) : inst(inst), basis(*this), checks(*this), hover(*this),
-	linemod(*this), vertmod(*this), secmod(*this), objects(*this)
+	linemod(*this), vertmod(*this), secmod(*this), objects(*this), adjacency(*this), spatial(*this)
 	{
 	}
 	
-	Document(Document &&other) noexcept : inst(other.inst), basis(*this), checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this) 
+	Document(Document &&other) noexcept : inst(other.inst), basis(*this), checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this), adjacency(*this), spatial(*this) 
 	{
 		*this = std::move(other);
 	}
@@ -91,6 +96,8 @@ public:
 		MadeChanges = other.MadeChanges;
 		// TODO: basis
 		basis = std::move(other.basis);
+		adjacency.invalidate();
+		spatial.invalidate();
 		return *this;
 	}
 
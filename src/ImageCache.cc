@@ -0,0 +1,238 @@
+//------------------------------------------------------------------------
+//  IMAGE CACHE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "ImageCache.h"
+
+#include "im_img.h"
+#include "MappedFile.h"
+#include "sys_debug.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string.h>
+#include <vector>
+
+//
+// What each file starts with. The numbers are in the byte order of the
+// machine which wrote them; another machine fails the magic check.
+//
+struct ImageFileHeader
+{
+	u32_t magic;
+	u32_t version;
+	u32_t key_raw;
+	u32_t key_extra;
+	u32_t pixel_size;	// sizeof(img_pixel_t)
+	s32_t width;
+	s32_t height;
+	s32_t offset_x;		// the sprite offset
+	s32_t offset_y;
+	u32_t reserved;
+};
+
+static const u32_t IMAGE_FILE_MAGIC = 0x676D4945;	// "EImg"
+
+// how far trim() goes below the budget, so it does not run every store
+#define IMAGE_CACHE_TRIM_TO(budget)  ((budget) / 4 * 3)
+
+
+ImageCache::ImageCache(const fs::path &dir, uint64_t budget) : dir(dir), budget(budget)
+{
+	std::error_code ec;
+	fs::create_directories(dir, ec);
+
+	usable = ! ec && fs::is_directory(dir, ec);
+	if (! usable)
+	{
+		gLog.printf("Cannot use image cache %s\n", dir.u8string().c_str());
+		return;
+	}
+
+	// temp files of other processes must not clash with ours
+	std::random_device random;
+	temp_tag = random();
+
+	// also finds out how much is in there already
+	trim();
+}
+
+
+fs::path ImageCache::pathFor(const crc32_c &key) const
+{
+	return dir / fs::u8path(SString::printf("%08X%08X.img", key.extra, key.raw).get());
+}
+
+
+bool ImageCache::load(const crc32_c &key, Img_c &img)
+{
+	if (! usable)
+	{
+		num_misses++;
+		return false;
+	}
+
+	fs::path path = pathFor(key);
+
+	{
+		std::shared_ptr<MappedFile> file = MappedFile::open(path);
+
+		ImageFileHeader header;
+		if (! file || file->size() < sizeof(header))
+		{
+			num_misses++;
+			return false;
+		}
+		memcpy(&header, file->data(), sizeof(header));
+
+		size_t pixel_bytes = (size_t)header.width * (size_t)header.height * sizeof(img_pixel_t);
+
+		if (header.magic != IMAGE_FILE_MAGIC || header.version != kVersion ||
+			header.key_raw != key.raw || header.key_extra != key.extra ||
+			header.pixel_size != sizeof(img_pixel_t) ||
+			header.width <= 0 || header.height <= 0 ||
+			file->size() != sizeof(header) + pixel_bytes)
+		{
+			num_misses++;
+			return false;
+		}
+
+		img = Img_c(header.width, header.height, false);
+		memcpy(img.wbuf(), file->data() + sizeof(header), pixel_bytes);
+		img.setSpriteOffset(header.offset_x, header.offset_y);
+	}
+
+	// it was just used, so trim() keeps it longer
+	std::error_code ec;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+	num_hits++;
+	return true;
+}
+
+
+void ImageCache::store(const crc32_c &key, const Img_c &img)
+{
+	if (! usable || img.is_null())
+		return;
+
+	ImageFileHeader header = {};
+	header.magic = IMAGE_FILE_MAGIC;
+	header.version = kVersion;
+	header.key_raw = key.raw;
+	header.key_extra = key.extra;
+	header.pixel_size = sizeof(img_pixel_t);
+	header.width = img.width();
+	header.height = img.height();
+	img.getSpriteOffset(header.offset_x, header.offset_y);
+
+	size_t pixel_bytes = (size_t)img.width() * (size_t)img.height() * sizeof(img_pixel_t);
+
+	// write it under another name and then rename it, so that nobody
+	// ever maps a half written file
+	fs::path path = pathFor(key);
+	fs::path temp = path;
+	temp += SString::printf(".%08X.%u.tmp", temp_tag, num_temps++).get();
+
+	bool written;
+	{
+		std::ofstream os(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+		os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		os.write(reinterpret_cast<const char *>(img.buf()), (std::streamsize)pixel_bytes);
+		os.close();
+		written = ! os.fail();
+	}
+
+	std::error_code ec;
+	if (written)
+		fs::rename(temp, path, ec);
+
+	if (! written || ec)
+	{
+		fs::remove(temp, ec);
+		return;
+	}
+
+	bool over_budget;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		disk_bytes += sizeof(header) + pixel_bytes;
+		over_budget = disk_bytes > budget;
+	}
+
+	if (over_budget)
+		trim();
+}
+
+
+void ImageCache::trim()
+{
+	if (! usable)
+		return;
+
+	struct CacheFile
+	{
+		fs::path path;
+		fs::file_time_type time;
+		uint64_t size;
+	};
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<CacheFile> files;
+	uint64_t total = 0;
+
+	std::error_code ec;
+	for (fs::directory_iterator it(dir, ec), end ; ! ec && it != end ; it.increment(ec))
+	{
+		if (it->path().extension() != ".img")
+			continue;
+
+		std::error_code file_ec;
+		CacheFile file = { it->path(), it->last_write_time(file_ec), it->file_size(file_ec) };
+		if (file_ec)
+			continue;
+
+		total += file.size;
+		files.push_back(std::move(file));
+	}
+
+	if (total > budget)
+	{
+		std::sort(files.begin(), files.end(), [](const CacheFile &a, const CacheFile &b)
+		{
+			return a.time < b.time;
+		});
+
+		for (const CacheFile &file : files)
+		{
+			if (total <= IMAGE_CACHE_TRIM_TO(budget))
+				break;
+
+			if (fs::remove(file.path, ec))
+				total -= file.size;
+		}
+	}
+
+	disk_bytes = total;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
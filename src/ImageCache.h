@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------
+//  IMAGE CACHE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef IMAGECACHE_H_
+#define IMAGECACHE_H_
+
+#include "m_strings.h"
+#include "sys_type.h"
+#include "lib_adler.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "filesystem.hpp"
+namespace fs = ghc::filesystem;
+
+class Img_c;
+
+//
+// Decoded images kept on the disk between runs, so that the next start
+// can skip decoding the same PNGs and patches again.
+//
+// Each image is one file named after its key: a checksum of everything
+// the image was made from (the lump bytes and any setting which changes
+// the result). Changing a lump thus gives a new key, and the old file
+// just ages out. The file is a small header and then the pixels as they
+// lie in memory, so it gets mapped and copied without any decoding.
+//
+// When the files take more than the budget, the ones used longest ago
+// are deleted. The cache is only an optimisation, so any failure to read
+// or write it just means decoding as usual.
+//
+// All methods may be called from several threads at once.
+//
+class ImageCache
+{
+public:
+	explicit ImageCache(const fs::path &dir, uint64_t budget = kDefaultBudget);
+
+	// returns false if the image is not in the cache (or is damaged)
+	bool load(const crc32_c &key, Img_c &img);
+	void store(const crc32_c &key, const Img_c &img);
+
+	// deletes the oldest files until they fit in the budget
+	void trim();
+
+	const fs::path &directory() const noexcept
+	{
+		return dir;
+	}
+	uint64_t diskBytes() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return disk_bytes;
+	}
+	int hits() const noexcept
+	{
+		return num_hits;
+	}
+	int misses() const noexcept
+	{
+		return num_misses;
+	}
+
+	static constexpr uint64_t kDefaultBudget = 256 << 20;
+
+	// bump this whenever the decoders change what they produce
+	static constexpr u32_t kVersion = 1;
+
+private:
+	fs::path pathFor(const crc32_c &key) const;
+
+	const fs::path dir;
+	const uint64_t budget;
+	bool usable = false;
+
+	mutable std::mutex mutex;
+	uint64_t disk_bytes = 0;
+
+	std::atomic<int> num_hits{ 0 };
+	std::atomic<int> num_misses{ 0 };
+	// for naming the files being written
+	u32_t temp_tag = 0;
+	std::atomic<unsigned> num_temps{ 0 };
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
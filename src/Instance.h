@@ -264,6 +264,7 @@ public:
 
 	// M_GAME
 	bool is_sky(const SString &flat) const;
+	bool is_sky(StringID flat) const;
 	char M_GetFlatType(const SString &name) const;
 	const linetype_t &M_GetLineType(int type) const;
 	const sectortype_t &M_GetSectorType(int type) const;
@@ -295,8 +296,8 @@ public:
 	bool M_PortSetupDialog(const SString& port, const SString& game, const tl::optional<SString> &commandLine);
 
 	// M_UDMF
-	void UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document &doc, LoadingData &loading, BadCount &bad) const;
-	void UDMF_SaveLevel(const LoadingData &loading, Wad_file &wad) const;
+	void UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document &doc, LoadingData &loading, BadCount &bad, int num_threads = 0) const;
+	void UDMF_SaveLevel(const LoadingData &loading, Wad_file &wad, int num_threads = 0) const;
 
 	// MAIN
 	fs::path Main_FileOpFolder() const;
@@ -315,6 +316,7 @@ public:
 
 	// R_SOFTWARE
 	bool SW_QueryPoint(Objid &hl, int qx, int qy);
+	void SW_RenderBuffer();
 	void SW_RenderWorld(int ox, int oy, int ow, int oh);
 
 	// R_SUBDIV
@@ -458,7 +460,6 @@ public:	// will be private when we encapsulate everything
 	Recently_used recent_things{ *this };
 	int last_given_file = 0;
 	tl::optional<UI_NodeDialog> nodeialog;
-	nodebuildinfo_t *nb_info = nullptr;
 	
 	int tagInMemory = 0;
 
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------
+//  MAP OBJECT ARRAYS
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef MAPARRAY_H_
+#define MAPARRAY_H_
+
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+//
+// The things, vertices, sectors, sidedefs or linedefs of a level, kept by
+// value in one block of memory, so the passes over the whole level read
+// it in order.
+//
+// Indexing and iterating give plain pointers to the objects. They don't
+// own anything and are only good until objects of the same type get added
+// or removed: across such edits, keep the object number instead. The undo
+// history keeps its own copies of the removed objects (see Basis).
+//
+template<typename T>
+class MapArray
+{
+public:
+	//
+	// Walks the objects, giving a pointer to each
+	//
+	template<typename P>
+	class Iterator
+	{
+	public:
+		explicit Iterator(P *pos) noexcept : pos(pos)
+		{
+		}
+		P *operator*() const noexcept
+		{
+			return pos;
+		}
+		Iterator &operator++() noexcept
+		{
+			++pos;
+			return *this;
+		}
+		bool operator==(const Iterator &other) const noexcept
+		{
+			return pos == other.pos;
+		}
+		bool operator!=(const Iterator &other) const noexcept
+		{
+			return pos != other.pos;
+		}
+
+	private:
+		P *pos;
+	};
+
+	T *operator[](int n) noexcept
+	{
+		return &items[n];
+	}
+	const T *operator[](int n) const noexcept
+	{
+		return &items[n];
+	}
+
+	Iterator<T> begin() noexcept
+	{
+		return Iterator<T>(items.data());
+	}
+	Iterator<T> end() noexcept
+	{
+		return Iterator<T>(items.data() + items.size());
+	}
+	Iterator<const T> begin() const noexcept
+	{
+		return Iterator<const T>(items.data());
+	}
+	Iterator<const T> end() const noexcept
+	{
+		return Iterator<const T>(items.data() + items.size());
+	}
+
+	size_t size() const noexcept
+	{
+		return items.size();
+	}
+	bool empty() const noexcept
+	{
+		return items.empty();
+	}
+	T *back() noexcept
+	{
+		return &items.back();
+	}
+
+	void reserve(size_t count)
+	{
+		items.reserve(count);
+	}
+	void resize(size_t count)
+	{
+		items.resize(count);
+	}
+	void clear() noexcept
+	{
+		items.clear();
+	}
+
+	void push_back(const T &object)
+	{
+		items.push_back(object);
+	}
+	void push_back(T &&object)
+	{
+		items.push_back(std::move(object));
+	}
+	void pop_back() noexcept
+	{
+		items.pop_back();
+	}
+
+	// adds the objects at the end, in order
+	void append(std::vector<T> &&objects)
+	{
+		if(items.empty())
+		{
+			items = std::move(objects);
+			return;
+		}
+		items.insert(items.end(), std::make_move_iterator(objects.begin()),
+					 std::make_move_iterator(objects.end()));
+		objects.clear();
+	}
+
+	// puts the object at the given number, moving the next ones up
+	void insert(int n, T &&object)
+	{
+		items.insert(items.begin() + n, std::move(object));
+	}
+
+	// takes the object out, moving the next ones down
+	T remove(int n)
+	{
+		T result = std::move(items[n]);
+		items.erase(items.begin() + n);
+		return result;
+	}
+
+private:
+	std::vector<T> items;
+};
+
+#endif
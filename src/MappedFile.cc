@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------
+//  MAPPED FILE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#elif defined(__APPLE__)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+#endif
+
+#ifdef _WIN32
+
+//
+// Whether the file is on a fixed local drive
+//
+static bool IsLocalStorage(const fs::path &path)
+{
+	wchar_t root[MAX_PATH];
+	if (!GetVolumePathNameW(path.wstring().c_str(), root, MAX_PATH))
+		return false;
+
+	UINT type = GetDriveTypeW(root);
+	return type == DRIVE_FIXED || type == DRIVE_RAMDISK;
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const fs::path &path)
+{
+	if (!IsLocalStorage(path))
+		return nullptr;
+
+	HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	std::shared_ptr<MappedFile> result(new MappedFile);
+	result->mData = static_cast<const byte *>(view);
+	result->mSize = (size_t)size.QuadPart;
+	result->mFile = file;
+	result->mMapping = mapping;
+	return result;
+}
+
+MappedFile::~MappedFile()
+{
+	UnmapViewOfFile(mData);
+	CloseHandle(mMapping);
+	CloseHandle(mFile);
+}
+
+#else
+
+//
+// Whether the open file is on a local disk, and not on a network share or
+// (where we can tell) a removable drive
+//
+static bool IsLocalStorage(int fd)
+{
+#ifdef __linux__
+	struct statfs info;
+	if (fstatfs(fd, &info) < 0)
+		return false;
+
+	switch ((unsigned long)info.f_type)
+	{
+	case 0x6969:		// NFS
+	case 0x517B:		// SMB
+	case 0xFF534D42:	// CIFS
+	case 0xFE534D42:	// SMB2
+	case 0x01021997:	// 9P
+	case 0x65735546:	// FUSE (sshfs and the like)
+	case 0x4d44:		// FAT, as on USB sticks and memory cards
+	case 0x2011BAB0:	// exFAT
+	case 0x9660:		// ISO 9660
+	case 0x15013346:	// UDF
+		return false;
+	default:
+		return true;
+	}
+#elif defined(__APPLE__)
+	struct statfs info;
+	if (fstatfs(fd, &info) < 0)
+		return false;
+
+	if (!(info.f_flags & MNT_LOCAL))
+		return false;
+#ifdef MNT_REMOVABLE
+	if (info.f_flags & MNT_REMOVABLE)
+		return false;
+#endif
+	return true;
+#else
+	(void)fd;
+	return true;
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const fs::path &path)
+{
+	int fd = ::open(path.u8string().c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat info;
+	if (!IsLocalStorage(fd) || fstat(fd, &info) < 0 || info.st_size <= 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid without the descriptor
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return nullptr;
+
+	std::shared_ptr<MappedFile> result(new MappedFile);
+	result->mData = static_cast<const byte *>(view);
+	result->mSize = (size_t)info.st_size;
+	return result;
+}
+
+MappedFile::~MappedFile()
+{
+	munmap(const_cast<byte *>(mData), mSize);
+}
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
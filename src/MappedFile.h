@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------
+//  MAPPED FILE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include "sys_type.h"
+
+#include <memory>
+
+#include "filesystem.hpp"
+namespace fs = ghc::filesystem;
+
+//
+// A whole file mapped into memory, read-only. The pages only get read from
+// the disk when they are first touched.
+//
+// The file must not be rewritten while it is mapped, so this is only for
+// files which Eureka never writes (the IWAD and the resource wads), or
+// only ever replaces whole by renaming (the image cache). If another
+// program truncates or rewrites the file in place anyway, touching a page
+// which is no longer backed by it kills Eureka with SIGBUS (or an
+// in-page error on Windows), and pages already read may show either the
+// old or the new contents.
+//
+// Files on network shares or removable drives are not mapped at all
+// (open() gives nullptr and the callers read them in instead), as these
+// can go away or change under us without any program of ours doing it.
+//
+class MappedFile
+{
+public:
+	// returns nullptr if the file cannot be mapped (or is empty)
+	static std::shared_ptr<MappedFile> open(const fs::path &path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile &other) = delete;
+	MappedFile &operator = (const MappedFile &other) = delete;
+
+	const byte *data() const noexcept
+	{
+		return mData;
+	}
+	size_t size() const noexcept
+	{
+		return mSize;
+	}
+
+private:
+	MappedFile() = default;
+
+	const byte *mData = nullptr;
+	size_t mSize = 0;
+
+#ifdef _WIN32
+	void *mFile = nullptr;
+	void *mMapping = nullptr;
+#endif
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
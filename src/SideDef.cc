@@ -22,17 +22,17 @@
 #include "m_game.h"
 #include "m_strings.h"
 
-SString SideDef::UpperTex() const
+const SString &SideDef::UpperTex() const
 {
 	return BA_GetString(upper_tex);
 }
 
-SString SideDef::MidTex() const
+const SString &SideDef::MidTex() const
 {
 	return BA_GetString(mid_tex);
 }
 
-SString SideDef::LowerTex() const
+const SString &SideDef::LowerTex() const
 {
 	return BA_GetString(lower_tex);
 }
@@ -48,9 +48,9 @@ struct SideDef
 		F_LOWER_TEX,
 	};
 
-	SString UpperTex() const;
-	SString MidTex()   const;
-	SString LowerTex() const;
+	const SString &UpperTex() const;
+	const SString &MidTex()   const;
+	const SString &LowerTex() const;
 
 	// use new_tex when >= 0, otherwise use default_wall_tex
 	void SetDefaults(const ConfigData &config, bool two_sided, StringID new_tex = StringID(-1));
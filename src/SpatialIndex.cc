@@ -0,0 +1,473 @@
+//------------------------------------------------------------------------
+//  SPATIAL INDEX
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "SpatialIndex.h"
+
+#include "Document.h"
+#include "Errors.h"
+#include "LineDef.h"
+#include "sys_debug.h"
+#include "Thing.h"
+#include "Vertex.h"
+
+#include <algorithm>
+#include <math.h>
+
+// size of a grid cell, in map units
+#define SPATIAL_CELL_SIZE	128.0
+
+// objects covering more cells than this go into the "big" list
+#define SPATIAL_MAX_CELLS	256
+
+// keeps cell coordinates sane for huge query boxes
+#define SPATIAL_CELL_LIMIT	(1 << 24)
+
+static int cellCoord(double v) noexcept
+{
+	double c = floor(v / SPATIAL_CELL_SIZE);
+
+	if (c < -SPATIAL_CELL_LIMIT) return -SPATIAL_CELL_LIMIT;
+	if (c >  SPATIAL_CELL_LIMIT) return  SPATIAL_CELL_LIMIT;
+
+	return static_cast<int>(c);
+}
+
+static uint64_t cellKey(int cx, int cy) noexcept
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+static int cellKeyX(uint64_t key) noexcept
+{
+	return static_cast<int>(static_cast<uint32_t>(key >> 32));
+}
+
+static int cellKeyY(uint64_t key) noexcept
+{
+	return static_cast<int>(static_cast<uint32_t>(key));
+}
+
+//------------------------------------------------------------------------
+//  GRID
+//------------------------------------------------------------------------
+
+void SpatialIndex::Grid::clear() noexcept
+{
+	cells.clear();
+	boxes.clear();
+	big.clear();
+
+	bound1 = { 1e30, 1e30 };
+	bound2 = { -1e30, -1e30 };
+
+	count = 0;
+	valid = false;
+}
+
+//
+// Put an object in the cells overlapped by its bounding box
+//
+void SpatialIndex::Grid::file(int objnum, const v2double_t &lo, const v2double_t &hi)
+{
+	if (objnum >= (int)boxes.size())
+		boxes.resize(objnum + 1);
+
+	bound1.x = std::min(bound1.x, lo.x);
+	bound1.y = std::min(bound1.y, lo.y);
+	bound2.x = std::max(bound2.x, hi.x);
+	bound2.y = std::max(bound2.y, hi.y);
+
+	CellBox box;
+
+	box.lx = cellCoord(lo.x);
+	box.ly = cellCoord(lo.y);
+	box.hx = cellCoord(hi.x);
+	box.hy = cellCoord(hi.y);
+
+	if ((int64_t)(box.hx - box.lx + 1) * (box.hy - box.ly + 1) > SPATIAL_MAX_CELLS)
+	{
+		big.push_back(objnum);
+		boxes[objnum] = CellBox();
+		return;
+	}
+
+	for (int cy = box.ly ; cy <= box.hy ; cy++)
+		for (int cx = box.lx ; cx <= box.hx ; cx++)
+			cells[cellKey(cx, cy)].push_back(objnum);
+
+	boxes[objnum] = box;
+}
+
+//
+// Remove an object from the cells it was filed in
+//
+void SpatialIndex::Grid::unfile(int objnum)
+{
+	SYS_ASSERT(objnum >= 0 && objnum < (int)boxes.size());
+
+	const CellBox &box = boxes[objnum];
+
+	if (box.isEmpty())
+	{
+		auto it = std::find(big.begin(), big.end(), objnum);
+		if (it != big.end())
+		{
+			*it = big.back();
+			big.pop_back();
+		}
+		return;
+	}
+
+	for (int cy = box.ly ; cy <= box.hy ; cy++)
+		for (int cx = box.lx ; cx <= box.hx ; cx++)
+		{
+			auto cell = cells.find(cellKey(cx, cy));
+			if (cell == cells.end())
+				continue;
+
+			std::vector<int> &list = cell->second;
+			auto it = std::find(list.begin(), list.end(), objnum);
+			if (it != list.end())
+			{
+				*it = list.back();
+				list.pop_back();
+			}
+			if (list.empty())
+				cells.erase(cell);
+		}
+
+	boxes[objnum] = CellBox();
+}
+
+//
+// Collect (unsorted, with duplicates) the objects filed near the box
+//
+void SpatialIndex::Grid::query(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const
+{
+	list.insert(list.end(), big.begin(), big.end());
+
+	int lx = cellCoord(lo.x);
+	int ly = cellCoord(lo.y);
+	int hx = cellCoord(hi.x);
+	int hy = cellCoord(hi.y);
+
+	if (hx < lx || hy < ly)
+		return;
+
+	// when zoomed far out, it is cheaper to visit the occupied cells
+	if ((int64_t)(hx - lx + 1) * (hy - ly + 1) > (int64_t)cells.size())
+	{
+		for (const auto &cell : cells)
+		{
+			int cx = cellKeyX(cell.first);
+			int cy = cellKeyY(cell.first);
+
+			if (cx >= lx && cx <= hx && cy >= ly && cy <= hy)
+				list.insert(list.end(), cell.second.begin(), cell.second.end());
+		}
+		return;
+	}
+
+	for (int cy = ly ; cy <= hy ; cy++)
+		for (int cx = lx ; cx <= hx ; cx++)
+		{
+			auto cell = cells.find(cellKey(cx, cy));
+			if (cell != cells.end())
+				list.insert(list.end(), cell->second.begin(), cell->second.end());
+		}
+}
+
+//------------------------------------------------------------------------
+//  INDEX
+//------------------------------------------------------------------------
+
+SpatialIndex::Grid *SpatialIndex::gridFor(ObjType type) const noexcept
+{
+	switch (type)
+	{
+	case ObjType::things:   return &mThings;
+	case ObjType::vertices: return &mVertices;
+	case ObjType::linedefs: return &mLinedefs;
+
+	default:
+		return nullptr;
+	}
+}
+
+int SpatialIndex::numObjects(ObjType type) const noexcept
+{
+	return doc.numObjects(type);
+}
+
+void SpatialIndex::objectBounds(ObjType type, int objnum, v2double_t &lo, v2double_t &hi) const
+{
+	switch (type)
+	{
+	case ObjType::things:
+		lo = hi = doc.things[objnum]->xy();
+		return;
+
+	case ObjType::vertices:
+		lo = hi = doc.vertices[objnum]->xy();
+		return;
+
+	case ObjType::linedefs:
+	{
+		const LineDef &L = *doc.linedefs[objnum];
+
+		v2double_t pos1 = doc.getStart(L).xy();
+		v2double_t pos2 = doc.getEnd(L).xy();
+
+		lo = { std::min(pos1.x, pos2.x), std::min(pos1.y, pos2.y) };
+		hi = { std::max(pos1.x, pos2.x), std::max(pos1.y, pos2.y) };
+		return;
+	}
+
+	default:
+		BugError("SpatialIndex::objectBounds: bad objtype %d\n", (int)type);
+	}
+}
+
+//
+// Move an already filed object after its coordinates changed
+//
+void SpatialIndex::refile(ObjType type, int objnum) const
+{
+	Grid &grid = *gridFor(type);
+
+	if (!grid.valid || objnum >= grid.count)
+		return;
+
+	grid.unfile(objnum);
+
+	v2double_t lo, hi;
+	objectBounds(type, objnum, lo, hi);
+
+	grid.file(objnum, lo, hi);
+}
+
+//
+// Bring the grid up to date: rebuild it when stale, otherwise file
+// the pending objects (unless they may still be written to).
+//
+void SpatialIndex::sync(ObjType type) const
+{
+	Grid &grid = *gridFor(type);
+
+	int total = numObjects(type);
+
+	if (grid.count > total)
+		grid.valid = false;
+
+	if (!grid.valid)
+	{
+		grid.clear();
+		grid.valid = true;
+	}
+
+	int limit = mInGroup ? std::min(total, grid.fresh) : total;
+
+	for (int n = grid.count ; n < limit ; n++)
+	{
+		v2double_t lo, hi;
+		objectBounds(type, n, lo, hi);
+
+		grid.file(n, lo, hi);
+	}
+
+	grid.count = std::max(grid.count, limit);
+}
+
+void SpatialIndex::find(ObjType type, const v2double_t &lo, const v2double_t &hi,
+						std::vector<int> &list) const
+{
+	list.clear();
+
+	sync(type);
+
+	const Grid &grid = *gridFor(type);
+
+	grid.query(lo, hi, list);
+
+	// pending objects are always candidates
+	for (int n = grid.count ; n < numObjects(type) ; n++)
+		list.push_back(n);
+
+	std::sort(list.begin(), list.end());
+	list.erase(std::unique(list.begin(), list.end()), list.end());
+}
+
+//
+// Find the things which could be inside the given box
+//
+void SpatialIndex::findThings(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const
+{
+	find(ObjType::things, lo, hi, list);
+}
+
+//
+// Find the vertices which could be inside the given box
+//
+void SpatialIndex::findVertices(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const
+{
+	find(ObjType::vertices, lo, hi, list);
+}
+
+//
+// Find the linedefs whose bounding box could touch the given box
+//
+void SpatialIndex::findLinedefs(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const
+{
+	find(ObjType::linedefs, lo, hi, list);
+}
+
+//
+// True if the box contains every filed linedef, i.e. growing it any
+// further cannot produce new candidates.
+//
+bool SpatialIndex::coversLinedefs(const v2double_t &lo, const v2double_t &hi) const
+{
+	sync(ObjType::linedefs);
+
+	return lo.x <= mLinedefs.bound1.x && lo.y <= mLinedefs.bound1.y &&
+		   hi.x >= mLinedefs.bound2.x && hi.y >= mLinedefs.bound2.y;
+}
+
+//
+// Forget everything, e.g. after loading a new level
+//
+void SpatialIndex::invalidate() noexcept
+{
+	mThings.valid = false;
+	mVertices.valid = false;
+	mLinedefs.valid = false;
+}
+
+//------------------------------------------------------------------------
+//  BASIS NOTIFICATIONS
+//------------------------------------------------------------------------
+
+void SpatialIndex::notifyBegin() noexcept
+{
+	mInGroup = true;
+
+	mThings.fresh = INT_MAX;
+	mVertices.fresh = INT_MAX;
+	mLinedefs.fresh = INT_MAX;
+}
+
+//
+// Called before the object is inserted
+//
+void SpatialIndex::notifyInsert(ObjType type, int objnum) noexcept
+{
+	Grid *grid = gridFor(type);
+	if (!grid)
+		return;
+
+	if (mInGroup)
+		grid->fresh = std::min(grid->fresh, objnum);
+
+	// appending is free: the new object is pending until the group ends
+	if (objnum < grid->count)
+		grid->valid = false;
+}
+
+//
+// Called before the object is deleted
+//
+void SpatialIndex::notifyDelete(ObjType type, int objnum)
+{
+	Grid *grid = gridFor(type);
+	if (!grid)
+		return;
+
+	if (objnum < grid->fresh && grid->fresh != INT_MAX)
+		grid->fresh--;
+
+	if (objnum >= grid->count)
+		return;
+
+	if (grid->valid && objnum == grid->count - 1)
+	{
+		grid->unfile(objnum);
+		grid->count--;
+		return;
+	}
+
+	// everything after it gets renumbered
+	grid->valid = false;
+}
+
+//
+// Called after the field has changed
+//
+void SpatialIndex::notifyChange(ObjType type, int objnum, int field)
+{
+	switch (type)
+	{
+	case ObjType::things:
+		if (field == Thing::F_X || field == Thing::F_Y)
+			refile(type, objnum);
+		break;
+
+	case ObjType::vertices:
+	{
+		refile(type, objnum);
+
+		// the linedefs using it have moved too
+		std::vector<int> lines;
+		doc.adjacency.linesAtVertex(objnum, lines);
+
+		for (int ld : lines)
+			refile(ObjType::linedefs, ld);
+		break;
+	}
+
+	case ObjType::linedefs:
+		if (field == LineDef::F_START || field == LineDef::F_END)
+		{
+			// a vertex added by this group may not have its final position yet
+			if (doc.linedefs[objnum]->start >= mVertices.fresh ||
+				doc.linedefs[objnum]->end >= mVertices.fresh)
+			{
+				mLinedefs.valid = false;
+				break;
+			}
+			refile(type, objnum);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void SpatialIndex::notifyEnd() noexcept
+{
+	mInGroup = false;
+
+	mThings.fresh = INT_MAX;
+	mVertices.fresh = INT_MAX;
+	mLinedefs.fresh = INT_MAX;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
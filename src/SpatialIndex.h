@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------
+//  SPATIAL INDEX
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include "DocumentModule.h"
+#include "m_vector.h"
+#include "objid.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//
+// Uniform grid of map buckets for things, vertices and linedefs, used by
+// the hover (picking) code to avoid scanning the whole level on every
+// mouse motion.
+//
+// The index is kept in sync by the Basis notifications. Objects appended
+// while an edit group is open stay "pending" (checked directly on every
+// query) until the group ends, since their fields get set after insertion.
+// Anything the index cannot follow cheaply (e.g. deleting from the middle
+// of an array) just marks that grid as stale, and it gets rebuilt on the
+// next query.
+//
+// All queries return a superset of the matching objects, sorted by
+// ascending object number, so callers keep their exact tie-break rules.
+//
+class SpatialIndex : public DocumentModule
+{
+public:
+	explicit SpatialIndex(Document &doc) : DocumentModule(doc)
+	{
+	}
+
+	void findThings(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const;
+	void findVertices(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const;
+	void findLinedefs(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const;
+
+	bool coversLinedefs(const v2double_t &lo, const v2double_t &hi) const;
+
+	void invalidate() noexcept;
+
+	// Basis hooks
+	void notifyBegin() noexcept;
+	void notifyInsert(ObjType type, int objnum) noexcept;
+	void notifyDelete(ObjType type, int objnum);
+	void notifyChange(ObjType type, int objnum, int field);
+	void notifyEnd() noexcept;
+
+private:
+	struct CellBox
+	{
+		int lx = 0, ly = 0;
+		int hx = -1, hy = -1;	// empty when hx < lx
+
+		bool isEmpty() const noexcept
+		{
+			return hx < lx;
+		}
+	};
+
+	struct Grid
+	{
+		std::unordered_map<uint64_t, std::vector<int>> cells;
+		std::vector<CellBox> boxes;	// where each filed object lives
+		std::vector<int> big;		// objects too large for the cells
+
+		// map area covered by all filed objects
+		v2double_t bound1 = { 1e30, 1e30 };
+		v2double_t bound2 = { -1e30, -1e30 };
+
+		int count = 0;	// objects [0, count) are filed, the rest are pending
+		int fresh = INT_MAX;	// lowest object added by the open edit group
+		bool valid = false;
+
+		void clear() noexcept;
+		void file(int objnum, const v2double_t &lo, const v2double_t &hi);
+		void unfile(int objnum);
+		void query(const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const;
+	};
+
+	Grid *gridFor(ObjType type) const noexcept;
+	int numObjects(ObjType type) const noexcept;
+	void objectBounds(ObjType type, int objnum, v2double_t &lo, v2double_t &hi) const;
+	void refile(ObjType type, int objnum) const;
+	void sync(ObjType type) const;
+	void find(ObjType type, const v2double_t &lo, const v2double_t &hi, std::vector<int> &list) const;
+
+	// mutable since the index is lazily updated by const queries
+	mutable Grid mThings;
+	mutable Grid mVertices;
+	mutable Grid mLinedefs;
+
+	bool mInGroup = false;
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
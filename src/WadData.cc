@@ -62,7 +62,7 @@ void WadData::W_LoadPalette() noexcept(false)
 	images.IM_ResetDummyTextures();
 }
 
-void WadData::reloadResources(const std::shared_ptr<Wad_file> &gameWad, const ConfigData &config, const std::vector<std::shared_ptr<Wad_file>> &resourceWads) noexcept(false)
+void WadData::reloadResources(const std::shared_ptr<Wad_file> &gameWad, const ConfigData &config, const std::vector<std::shared_ptr<Wad_file>> &resourceWads, int num_threads) noexcept(false)
 {
 	// reset the master directory
 	WadData newWad = *this;
@@ -76,7 +76,7 @@ void WadData::reloadResources(const std::shared_ptr<Wad_file> &gameWad, const Co
 		newWad.W_LoadColormap();
 		
 		newWad.W_LoadFlats();
-		newWad.W_LoadTextures(config);
+		newWad.W_LoadTextures(config, num_threads);
 		newWad.images.W_ClearSprites();
 	}
 	catch(const std::runtime_error &e)
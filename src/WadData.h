@@ -31,8 +31,10 @@ namespace fs = ghc::filesystem;
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
+class ImageCache;
 class Img_c;
 class Lump_c;
 class Palette;
@@ -43,6 +45,58 @@ struct LoadingData;
 // maps type number to an image
 typedef std::map<int, tl::optional<Img_c>> sprite_map_t;
 
+//
+// One patch of a TEXTURE1/2 entry
+//
+struct TexturePatch
+{
+	std::shared_ptr<const Lump_c> lump;		// NULL if it was not found
+	SString name;
+	int x;
+	int y;
+};
+
+//
+// A texture or flat which is only drawn when something first asks for it.
+// Its size is known without drawing it, and the pixels may be dropped
+// again by ImageSet::W_TrimImages() when not used for a while.
+//
+class LazyImage
+{
+public:
+	LazyImage() = default;
+	LazyImage(int width, int height) : w(width), h(height)
+	{
+	}
+
+	int width() const noexcept
+	{
+		return w;
+	}
+	int height() const noexcept
+	{
+		return h;
+	}
+
+private:
+	friend class ImageSet;
+
+	int w = 0;
+	int h = 0;
+
+	// how to draw it: the patches of a composite texture, or the lump of
+	// a flat. With neither, the image was given when added and is kept.
+	// The lumps are shared, as the wad may drop them before we draw.
+	std::vector<TexturePatch> patches;
+	std::shared_ptr<const Lump_c> flat;
+
+	// textures which can cause the Medusa Effect in vanilla/chocolate DOOM
+	bool medusa = false;
+
+	mutable tl::optional<Img_c> image;
+	mutable unsigned last_used = 0;
+};
+
 //
 // Wad image set
 //
@@ -77,7 +131,42 @@ public:
 	void IM_UnloadDummyTextures();
 	void IM_ResetDummyTextures();
 
+	//
+	// Textures and flats are kept in one registry and known by their
+	// handle (the index in it), or by one of these for names which are
+	// not a plain image. Handles stay valid until the textures or flats
+	// get loaded again.
+	//
+	enum
+	{
+		IMAGE_UNKNOWN     = -1,	// no such texture or flat
+		IMAGE_NULL_TEX    = -2,	// the "-" texture
+		IMAGE_SPECIAL_TEX = -3,	// a "#xxxx" texture
+		IMAGE_SKY_FLAT    = -4,	// the sky flat of the game
+	};
+
+	// these take a name from the global string table, as sidedefs and
+	// sectors have them. Only the first call for each name looks at the
+	// string, so they suit the renderers.
+	int textureHandle(const ConfigData &config, StringID name) const;
+	int flatHandle(const ConfigData &config, StringID name) const;
+
+	const LazyImage &getImage(int handle) const
+	{
+		return registry[handle];
+	}
+	const Img_c *drawImage(const ConfigData &config, int handle) const
+	{
+		return drawImage(config, registry[handle]);
+	}
+	Img_c *drawMutableImage(const ConfigData &config, int handle)
+	{
+		return const_cast<Img_c *>(drawImage(config, registry[handle]));
+	}
+
 	void W_AddTexture(const SString &name, Img_c &&img, bool is_medusa);
+	void W_AddTexture(const SString &name, int width, int height, std::vector<TexturePatch> &&patches,
+					  bool is_medusa);
 	const Img_c *getTexture(const ConfigData &config, const SString &name, bool try_uppercase = false) const;
 	Img_c *getMutableTexture(const ConfigData &config, const SString &name, bool try_uppercase = false)
 	{
@@ -87,20 +176,21 @@ public:
 	bool W_TextureCausesMedusa(const SString &name) const;
 	bool W_TextureIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearTextures();
-	const std::map<SString, Img_c> &getTextures() const
+	// handles by name
+	const std::unordered_map<SString, int> &getTextures() const
 	{
 		return textures;
 	}
 
-	void W_AddFlat(const SString &name, Img_c &&img);
-	const Img_c *W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase = false) const noexcept;
+	void W_AddFlat(const SString &name, const std::shared_ptr<const Lump_c> &lump);
+	const Img_c *W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase = false) const;
 	Img_c *getMutableFlat(const ConfigData &config, const SString &name, bool try_uppercase = false)
 	{
 		return const_cast<Img_c *>(W_GetFlat(config, name, try_uppercase));
 	}
 	bool W_FlatIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearFlats();
-	const std::map<SString, Img_c> &getFlats() const
+	const std::unordered_map<SString, int> &getFlats() const
 	{
 		return flats;
 	}
@@ -109,15 +199,64 @@ public:
 
 	void W_UnloadAllTextures();
 
+	// what textures and flats are drawn from. The wads are kept open for
+	// as long as the images may need them.
+	void W_SetImageSource(const Palette &palette, const std::vector<std::shared_ptr<Wad_file>> &wads);
+	void W_TrimImages();
+	void setImageBudget(size_t bytes) noexcept
+	{
+		image_budget = bytes;
+	}
+	size_t drawnImageBytes() const noexcept
+	{
+		return image_bytes;
+	}
+
+	// the default for how much the drawn textures and flats may use
+	static constexpr size_t kDefaultImageBudget = 128 << 20;
+
+	// where decoded images are kept between runs (none by default)
+	void setImageCache(const std::shared_ptr<ImageCache> &cache)
+	{
+		image_cache = cache;
+	}
+	ImageCache *imageCache() const noexcept
+	{
+		return image_cache.get();
+	}
+
 public: // TODO: make private
 	sprite_map_t sprites;
 
-private:	
-	std::map<SString, Img_c> textures;
-	// textures which can cause the Medusa Effect in vanilla/chocolate DOOM
-	std::map<SString, int> medusa_textures;
-	std::map<SString, Img_c> flats;
-	
+private:
+	int findTexture(const ConfigData &config, const SString &name, bool try_uppercase) const;
+	int findFlat(const ConfigData &config, const SString &name, bool try_uppercase) const noexcept;
+	int addImage(std::unordered_map<SString, int> &names, const SString &name);
+	void clearImages(std::unordered_map<SString, int> &names);
+	int &lookupSlot(std::vector<int> &table, const ConfigData &config, StringID name) const;
+	const Img_c *drawImage(const ConfigData &config, const LazyImage &entry) const;
+	void dropImage(const LazyImage &entry, bool can_delete_gl) const;
+
+	std::vector<LazyImage> registry;
+	std::unordered_map<SString, int> textures;
+	std::unordered_map<SString, int> flats;
+
+	// handles by StringID, found when first asked for. They are only good
+	// for the config they were found with, and for the current registry.
+	mutable std::vector<int> texture_lookup;
+	mutable std::vector<int> flat_lookup;
+	mutable const ConfigData *lookup_config = nullptr;
+
+	std::shared_ptr<const Palette> image_palette;
+	std::vector<std::shared_ptr<Wad_file>> image_wads;
+
+	// for the images which can be dropped
+	mutable size_t image_bytes = 0;
+	mutable unsigned image_clock = 0;
+	size_t image_budget = kDefaultImageBudget;
+
+	std::shared_ptr<ImageCache> image_cache;
+
 
 	int missing_tex_color = 0;
 	tl::optional<Img_c> missing_tex_image;
@@ -151,16 +290,10 @@ class MasterDir
 {
 public:
 	
-	void setGameWad(const std::shared_ptr<Wad_file> &gameWad)
-	{
-		game_wad = gameWad;
-	}
+	void setGameWad(const std::shared_ptr<Wad_file> &gameWad);
 	void RemoveEditWad();
 	void ReplaceEditWad(const std::shared_ptr<Wad_file> &wad);
-	void setResources(const std::vector<std::shared_ptr<Wad_file>> &wads)
-	{
-		resource_wads = wads;
-	}
+	void setResources(const std::vector<std::shared_ptr<Wad_file>> &wads);
 	void MasterDir_CloseAll();
 	bool MasterDir_HaveFilename(const SString &chk_path) const;
 
@@ -202,6 +335,13 @@ private:
 	std::shared_ptr<Wad_file> edit_wad;
 	std::vector<std::shared_ptr<Wad_file>> resource_wads;
 	std::shared_ptr<Wad_file> game_wad;
+
+	// the global lumps of the game and resource wads by name, the later
+	// wads overriding the earlier ones. The edit wad keeps changing, so
+	// it is searched on its own.
+	std::unordered_map<int64_t, const Lump_c *> global_lumps;
+
+	void buildGlobalIndex();
 };
 
 //
@@ -209,7 +349,7 @@ private:
 //
 struct WadData
 {
-	void W_LoadTextures(const ConfigData &config);
+	void W_LoadTextures(const ConfigData &config, int num_threads = 0);
 
 	const Img_c *getSprite(const ConfigData &config, int type, const LoadingData &loading);
 	Img_c *getMutableSprite(const ConfigData &config, int type, const LoadingData &loading)
@@ -217,7 +357,7 @@ struct WadData
 		return const_cast<Img_c *>(getSprite(config, type, loading));
 	}
 	
-	void reloadResources(const std::shared_ptr<Wad_file> &gameWad, const ConfigData &config, const std::vector<std::shared_ptr<Wad_file>> &resourceWads) noexcept(false);
+	void reloadResources(const std::shared_ptr<Wad_file> &gameWad, const ConfigData &config, const std::vector<std::shared_ptr<Wad_file>> &resourceWads, int num_threads = 0) noexcept(false);
 
 	ImageSet images;
 	Palette palette;
@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------
+//  WORKER POOL
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "WorkerPool.h"
+
+#include "Errors.h"
+#include "sys_debug.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(int num_threads)
+{
+	for (int i = 1 ; i < num_threads ; i++)
+		mThreads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mClosing = true;
+	}
+	mStarted.notify_all();
+
+	for (std::thread &thread : mThreads)
+		thread.join();
+}
+
+//
+// One thread per CPU, or one if that cannot be told
+//
+int WorkerPool::defaultThreads() noexcept
+{
+	return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+//
+// Calls func(index) for every index in [0, count), on all the threads,
+// and returns once they are all done. An exception thrown by func is
+// passed on to the caller (the remaining items still run).
+//
+void WorkerPool::parallelFor(int count, const std::function<void(int)> &func)
+{
+	if (count <= 0)
+		return;
+
+	if (mThreads.empty() || count == 1)
+	{
+		for (int i = 0 ; i < count ; i++)
+			func(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		SYS_ASSERT(!mFunc);
+
+		mFunc = &func;
+		mCount = count;
+		mNext = 0;
+		mError = nullptr;
+		mBusy = (int)mThreads.size();
+		mGeneration++;
+	}
+	mStarted.notify_all();
+
+	runItems();
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFinished.wait(lock, [this]() { return mBusy == 0; });
+
+		mFunc = nullptr;
+		error = mError;
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+//
+// Queues func to run on one of the pool's threads. The future tells when
+// it is done, and passes on any exception it throws. A pool without any
+// threads of its own runs func right away.
+//
+std::future<void> WorkerPool::post(std::function<void()> func)
+{
+	std::packaged_task<void()> task(std::move(func));
+	std::future<void> result = task.get_future();
+
+	if (mThreads.empty())
+	{
+		task();
+		return result;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTasks.push_back(std::move(task));
+	}
+	mStarted.notify_one();
+
+	return result;
+}
+
+void WorkerPool::runItems() noexcept
+{
+	for (;;)
+	{
+		int index = mNext.fetch_add(1);
+		if (index >= mCount)
+			return;
+
+		try
+		{
+			(*mFunc)(index);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mError)
+				mError = std::current_exception();
+		}
+	}
+}
+
+void WorkerPool::workerLoop()
+{
+	int seen = 0;
+
+	for (;;)
+	{
+		std::packaged_task<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStarted.wait(lock, [this, seen]()
+			{
+				return mClosing || mGeneration != seen || !mTasks.empty();
+			});
+
+			if (mClosing)
+				return;
+
+			// a loop waits for every thread, so it goes first
+			if (mGeneration == seen)
+			{
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+			seen = mGeneration;
+		}
+
+		if (task.valid())
+		{
+			task();
+			continue;
+		}
+
+		runItems();
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			last = --mBusy == 0;
+		}
+		if (last)
+			mFinished.notify_one();
+	}
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
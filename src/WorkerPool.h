@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------
+//  WORKER POOL
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// A fixed set of threads for splitting a loop over several CPUs. The
+// thread calling parallelFor() does its share of the work too, so a pool
+// of one thread has no extra threads and just runs the loop.
+//
+// Only one loop runs at a time; parallelFor() must not be called from
+// inside the loop body.
+//
+// post() instead hands a task to the pool's own threads and returns at
+// once, leaving the caller free (e.g. to keep the GUI going). Tasks start
+// in the order they were posted; those not started yet when the pool is
+// destroyed are dropped.
+//
+class WorkerPool
+{
+public:
+	explicit WorkerPool(int num_threads);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool &other) = delete;
+	WorkerPool &operator = (const WorkerPool &other) = delete;
+
+	int numThreads() const noexcept
+	{
+		return (int)mThreads.size() + 1;
+	}
+
+	void parallelFor(int count, const std::function<void(int)> &func);
+	std::future<void> post(std::function<void()> func);
+
+	static int defaultThreads() noexcept;
+
+private:
+	void workerLoop();
+	void runItems() noexcept;
+
+	std::vector<std::thread> mThreads;
+
+	std::mutex mMutex;
+	std::condition_variable mStarted;
+	std::condition_variable mFinished;
+	bool mClosing = false;
+
+	// the current loop
+	const std::function<void(int)> *mFunc = nullptr;
+	int mCount = 0;
+	int mGeneration = 0;	// bumped for each loop
+	int mBusy = 0;			// workers still in the loop
+	std::atomic<int> mNext{ 0 };
+	std::exception_ptr mError;
+
+	// the posted tasks not started yet
+	std::deque<std::packaged_task<void()>> mTasks;
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
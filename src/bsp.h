@@ -25,8 +25,11 @@
 #include "m_strings.h"
 #include "sys_type.h"
 #include "Thing.h"
+#include "WorkerPool.h"
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <vector>
 
 struct ConfigData;
@@ -37,6 +40,7 @@ enum class Side;
 struct Document;
 class Wad_file;
 struct LoadingData;
+struct NewDocument;
 
 // Node Build Information Structure
 //
@@ -57,6 +61,10 @@ struct nodebuildinfo_t
 	bool do_blockmap = true;
 	bool do_reject = true;
 
+	// with do_reject, check which sectors can see each other instead of
+	// only finding the isolated groups (much slower)
+	bool full_reject = false;
+
 	bool fast = false;
 	bool warnings = false;
 
@@ -64,12 +72,16 @@ struct nodebuildinfo_t
 	bool force_xnod = false;
 	bool force_compress = false;
 
+	// how many threads to use, 0 for one per CPU
+	int threads = 0;
+
 	// the GUI can set this to tell the node builder to stop
-	bool cancelled = false;
+	std::atomic<bool> cancelled{ false };
 
 	// from here on, various bits of internal state
-	int total_failed_maps = 0;
-	int total_warnings = 0;
+	// (atomic since several levels may be built at once)
+	std::atomic<int> total_failed_maps{ 0 };
+	std::atomic<int> total_warnings{ 0 };
 };
 
 
@@ -89,7 +101,23 @@ enum build_result_e
 };
 
 
-build_result_e AJBSP_BuildLevel(nodebuildinfo_t *info, int lev_idx, Instance &inst, const Document &doc, const LoadingData& loading, Wad_file &wad);
+build_result_e AJBSP_BuildLevel(nodebuildinfo_t *info, int lev_idx, Instance &inst, Document &doc, const LoadingData& loading, Wad_file &wad);
+
+//
+// Builds the nodes of every level in the wad, several levels at once.
+//
+// The levels are loaded by 'loadLevel' on the calling thread, built on
+// worker threads (each on a copy of the level's lumps), and
+// put back into the wad in level order, so the result is the same as
+// building them one after the other. The messages of each level are passed
+// to 'reportLog' in level order too. 'poll' is called on the calling thread
+// while waiting, with the number of levels done, and may set the cancelled
+// flag in 'info'.
+//
+build_result_e AJBSP_BuildAllLevels(nodebuildinfo_t *info, const ConfigData &config, Wad_file &wad,
+		const std::function<NewDocument(int lev_idx)> &loadLevel,
+		const std::function<void(const SString &)> &reportLog,
+		const std::function<void(int num_done)> &poll);
 
 
 //======================================================================
@@ -134,6 +162,42 @@ void *UtilRealloc(void *old, int size);
 // free some memory or a string.
 void UtilFree(void *data);
 
+// number of objects in each block of a block_alloc_c
+#define ALLOC_BLKNUM  1024
+
+//
+// Hands out zeroed objects from blocks of ALLOC_BLKNUM, which are only
+// freed all together by Clear().  Objects allocated one after the other
+// are next to each other in memory.
+//
+template<typename T>
+class block_alloc_c
+{
+public:
+	T *Alloc()
+	{
+		if (used == ALLOC_BLKNUM)
+		{
+			blocks.emplace_back(new T[ALLOC_BLKNUM]());
+			used = 0;
+		}
+
+		return &blocks.back()[used++];
+	}
+
+	void Clear()
+	{
+		blocks.clear();
+		used = ALLOC_BLKNUM;
+	}
+
+private:
+	std::vector<std::unique_ptr<T[]>> blocks;
+
+	// objects handed out from the last block
+	int used = ALLOC_BLKNUM;
+};
+
 // return an allocated string for the current data and time,
 // or NULL if an error occurred.
 SString UtilTimeString(void);
@@ -407,7 +471,7 @@ class LevelData
 public:
 	typedef std::function<void(const SString &)> ReportFunc;
 	
-	LevelData(MapFormat format, Wad_file &wad, const Document &doc, const ConfigData &config, const ReportFunc &reportLog) : format(format), wad(wad), doc(doc), config(config), reportLog(reportLog)
+	LevelData(MapFormat format, Wad_file &wad, Document &doc, const ConfigData &config, const ReportFunc &reportLog) : format(format), wad(wad), doc(doc), config(config), reportLog(reportLog)
 	{
 	}
 	LevelData(const LevelData& other) = delete;
@@ -431,7 +495,8 @@ public:
 	vertex_t *NewVertexDegenerate(vertex_t *start, vertex_t *end);
 	
 	// MAIN STUFF
-	build_result_e BuildLevel(nodebuildinfo_t *info, int lev_idx);
+	// 'num_threads' is how many threads may evaluate the partitions
+	build_result_e BuildLevel(nodebuildinfo_t *info, int lev_idx, int num_threads = 1);
 	
 	void Warning(EUR_FORMAT_STRING(const char *fmt), ...) EUR_PRINTF(2, 3);
 	
@@ -466,6 +531,8 @@ private:
 		void Free();
 		void GroupSectors(const Document &doc);
 		void ProcessSectors(const Document &doc);
+		int ProcessSightLines(const Document &doc, WorkerPool *pool,
+							  const std::atomic<bool> &cancelled);
 		
 		u8_t *rej_matrix = nullptr;
 		int   rej_total_size = 0;	// in bytes
@@ -489,13 +556,6 @@ private:
 	node_t    *NewNode();
 	walltip_t *NewWallTip();
 	
-	/* ----- free routines ---------------------------- */
-	void FreeVertices();
-	void FreeSegs();
-	void FreeSubsecs();
-	void FreeNodes();
-	void FreeWallTips();
-	
 	/* ----- reading routines ------------------------------ */
 	void GetVertices();
 	
@@ -608,6 +668,7 @@ private:
 	seg_t *FindFastSeg(quadtree_c *tree);
 	bool PickNodeWorker(quadtree_c *part_list,
 						quadtree_c *tree, seg_t ** best, int *best_cost);
+	bool PickNodeParallel(quadtree_c *tree, seg_t ** best, int *best_cost);
 	// scan all the segs in the list, and choose the best seg to use as a
 	// partition line, returning it.  If no seg can be used, returns NULL.
 	// The 'depth' parameter is the current depth in the tree, used for
@@ -647,13 +708,24 @@ private:
 	std::vector<seg_t *>     segs;
 	std::vector<node_t *>    nodes;
 	std::vector<walltip_t *> walltips;
+
+	// where the objects above live, freed by FreeLevel()
+	block_alloc_c<vertex_t>  vertex_alloc;
+	block_alloc_c<subsec_t>  subsec_alloc;
+	block_alloc_c<seg_t>     seg_alloc;
+	block_alloc_c<node_t>    node_alloc;
+	block_alloc_c<walltip_t> walltip_alloc;
 	
 	// internal storage of node building parameters
 	nodebuildinfo_t * cur_info = NULL;
 
+	// for evaluating partitions (and the full reject) on several
+	// threads, NULL when only one
+	std::unique_ptr<WorkerPool> work_pool;
+
 	const MapFormat format;
 	Wad_file& wad;
-	const Document& doc;
+	Document& doc;
 	const ConfigData &config;
 	
 	const ReportFunc reportLog;
@@ -685,7 +757,7 @@ private:
 
 // detection routines
 
-void DetectOverlappingLines(const Document &doc);
+void DetectOverlappingLines(Document &doc);
 
 // check whether a line with the given delta coordinates from this
 // vertex is open or closed.  If there exists a walltip at same
@@ -22,6 +22,11 @@
 #include "Instance.h"
 #include "w_rawdef.h"
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
 #include <zlib.h>
 
 
@@ -156,7 +161,7 @@ void LevelData::Block::Add(int blk_num, int line_index)
 
 void LevelData::Block::AddLine(int line_index, const Document &doc)
 {
-	const auto L = doc.linedefs[line_index];
+	const LineDef *L = doc.linedefs[line_index];
 
 	int x1 = (int) doc.getStart(*L).x();
 	int y1 = (int) doc.getStart(*L).y();
@@ -439,7 +444,7 @@ static void FindMapLimits(bbox_t *bbox, const Document &doc)
 
 	for (int i=0 ; i < doc.numLinedefs() ; i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		if (!doc.isZeroLength(*L))
 		{
@@ -567,11 +572,31 @@ void LevelData::Reject::Free()
 }
 
 
+//
+// Follow the group links up to the lowest sector of the group,
+// shortening the path on the way.
+//
+static int Reject_FindGroup(std::vector<int> &groups, int sec)
+{
+	while (groups[sec] != sec)
+	{
+		groups[sec] = groups[groups[sec]];
+		sec = groups[sec];
+	}
+
+	return sec;
+}
+
+
 //
 // Algorithm: Initially all sectors are in individual groups.
 // Now we scan the linedef list.  For each two-sectored line,
 // merge the two sector groups into one.  That's it!
 //
+// While merging, each sector only links to a lower sector of its
+// group (a union-find forest), and at the end every sector gets the
+// number of the lowest sector in its group.
+//
 void LevelData::Reject::GroupSectors(const Document &doc)
 {
 	for(const auto &L : doc.linedefs)
@@ -586,8 +611,8 @@ void LevelData::Reject::GroupSectors(const Document &doc)
 			continue;
 
 		// already in the same group ?
-		int group1 = rej_sector_groups[sec1];
-		int group2 = rej_sector_groups[sec2];
+		int group1 = Reject_FindGroup(rej_sector_groups, sec1);
+		int group2 = Reject_FindGroup(rej_sector_groups, sec2);
 
 		if (group1 == group2)
 			continue;
@@ -597,10 +622,11 @@ void LevelData::Reject::GroupSectors(const Document &doc)
 			std::swap(group1, group2);
 
 		// merge the groups
-		for (int s = 0 ; s < doc.numSectors() ; s++)
-			if (rej_sector_groups[s] == group2)
-				rej_sector_groups[s] =  group1;
+		rej_sector_groups[group2] = group1;
 	}
+
+	for (int s = 0 ; s < doc.numSectors() ; s++)
+		rej_sector_groups[s] = Reject_FindGroup(rej_sector_groups, s);
 }
 
 
@@ -652,6 +678,470 @@ void LevelData::Reject::ProcessSectors(const Document &doc)
 }
 
 
+//
+// Full reject : a line of sight from one sector to another has to go
+// through a chain of two-sided lines (portals), each leading into the
+// sector of the next one.  Starting from each portal of a sector, we
+// follow these chains and keep a "window" on each portal: the part of
+// it which some straight line through all the previous portals can
+// reach.  When a window gets clipped away, that chain is blind.
+//
+// This only ever keeps too much (one-sided lines inside a sector and
+// the heights are ignored), so a sector is never rejected when it might
+// be seen.
+//
+
+// a two-sided line between two different sectors
+struct sight_portal_t
+{
+	double x1, y1;
+	double x2, y2;
+
+	// sectors on the right and left side
+	int right, left;
+};
+
+// the part of a portal which a line of sight can go through
+struct sight_window_t
+{
+	double x1, y1;
+	double x2, y2;
+};
+
+// distances smaller than this are "on" a line
+#define SIGHT_EPSILON  (1.0 / 1024.0)
+
+// how many windows to try from one sector before giving up and using
+// the simple reject (the whole group is visible) for it
+#define SIGHT_STEP_LIMIT  200000
+
+
+static int Sight_Side(double lx, double ly, double dx, double dy, double x, double y)
+{
+	double d = ((x - lx) * dy - (y - ly) * dx) / hypot(dx, dy);
+
+	if (d > SIGHT_EPSILON)
+		return 1;
+	if (d < -SIGHT_EPSILON)
+		return -1;
+	return 0;
+}
+
+
+//
+// Keep the part of the window on one side of the line, where 'keep' is
+// 1 for the right side and -1 for the left.  Returns false when nothing
+// (or too little to matter) is left.
+//
+static bool Sight_ClipWindow(sight_window_t &w, double lx, double ly, double dx, double dy, int keep)
+{
+	double len = hypot(dx, dy);
+
+	double d1 = keep * ((w.x1 - lx) * dy - (w.y1 - ly) * dx) / len;
+	double d2 = keep * ((w.x2 - lx) * dy - (w.y2 - ly) * dx) / len;
+
+	if (d1 < -SIGHT_EPSILON && d2 < -SIGHT_EPSILON)
+		return false;
+
+	if (d1 < -SIGHT_EPSILON || d2 < -SIGHT_EPSILON)
+	{
+		double along = d1 / (d1 - d2);
+
+		double ix = w.x1 + along * (w.x2 - w.x1);
+		double iy = w.y1 + along * (w.y2 - w.y1);
+
+		if (d1 < 0)
+		{
+			w.x1 = ix;
+			w.y1 = iy;
+		}
+		else
+		{
+			w.x2 = ix;
+			w.y2 = iy;
+		}
+	}
+
+	return hypot(w.x2 - w.x1, w.y2 - w.y1) >= SIGHT_EPSILON;
+}
+
+
+//
+// Keep the part of the window on the side of the portal where 'sector' is.
+//
+static bool Sight_ClipBeyond(sight_window_t &w, const sight_portal_t &portal, int sector)
+{
+	return Sight_ClipWindow(w, portal.x1, portal.y1, portal.x2 - portal.x1, portal.y2 - portal.y1,
+							portal.right == sector ? 1 : -1);
+}
+
+
+//
+// Keep the part of 'target' which a line going through 'source' and then
+// 'pass' can reach.  Those lines are bounded by the separating lines, which
+// go through an end of 'source' and an end of 'pass' and have the two
+// windows on opposite sides.
+//
+static bool Sight_ClipToSeparators(const sight_window_t &source, const sight_window_t &pass,
+								   sight_window_t &target)
+{
+	const double src[2][2] = { { source.x1, source.y1 }, { source.x2, source.y2 } };
+	const double pas[2][2] = { { pass.x1,   pass.y1   }, { pass.x2,   pass.y2   } };
+
+	for (int i = 0 ; i < 2 ; i++)
+	{
+		for (int k = 0 ; k < 2 ; k++)
+		{
+			double lx = src[i][0];
+			double ly = src[i][1];
+			double dx = pas[k][0] - lx;
+			double dy = pas[k][1] - ly;
+
+			if (hypot(dx, dy) < SIGHT_EPSILON)
+				continue;
+
+			int src_side  = Sight_Side(lx, ly, dx, dy, src[1-i][0], src[1-i][1]);
+			int pass_side = Sight_Side(lx, ly, dx, dy, pas[1-k][0], pas[1-k][1]);
+
+			// not a separating line?
+			if (src_side == 0 && pass_side == 0)
+				continue;
+			if (src_side != 0 && pass_side == src_side)
+				continue;
+
+			int keep = (pass_side != 0) ? pass_side : -src_side;
+
+			if (! Sight_ClipWindow(target, lx, ly, dx, dy, keep))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
+//
+// The portals of a level, and for each portal (in each direction) the
+// sectors which might be seen through it: those reached through portals
+// which are at least partly beyond it.  A line of sight stays beyond
+// every portal it went through, so it can only reach the sectors which
+// all of them might see.
+//
+class sight_map_c
+{
+public:
+	sight_map_c(const Document &doc);
+
+	void FindMightSee(WorkerPool *pool);
+
+	// index into might_see for going through a portal into a sector
+	inline int Way(int portal, int sector) const
+	{
+		return portal * 2 + (portals[portal].right == sector ? 0 : 1);
+	}
+
+	int num_sectors;
+
+	// size of a set of sectors, in words
+	int num_words;
+
+	std::vector<sight_portal_t> portals;
+	std::vector<std::vector<int>> sector_portals;
+
+	std::vector<std::vector<uint64_t>> might_see;
+
+private:
+	void FloodMightSee(int portal, int sector, std::vector<uint64_t> &bits) const;
+};
+
+
+sight_map_c::sight_map_c(const Document &doc) :
+	num_sectors(doc.numSectors()), num_words((doc.numSectors() + 63) / 64),
+	sector_portals(doc.numSectors())
+{
+	for(const auto &L : doc.linedefs)
+	{
+		if (L->right < 0 || L->left < 0 || doc.isZeroLength(*L))
+			continue;
+
+		int sec1 = doc.getRight(*L)->sector;
+		int sec2 = doc.getLeft(*L) ->sector;
+
+		if (sec1 < 0 || sec2 < 0 || sec1 >= num_sectors || sec2 >= num_sectors || sec1 == sec2)
+			continue;
+
+		sight_portal_t portal;
+
+		portal.x1 = doc.getStart(*L).x();
+		portal.y1 = doc.getStart(*L).y();
+		portal.x2 = doc.getEnd(*L).x();
+		portal.y2 = doc.getEnd(*L).y();
+		portal.right = sec1;
+		portal.left  = sec2;
+
+		sector_portals[sec1].push_back((int)portals.size());
+		sector_portals[sec2].push_back((int)portals.size());
+
+		portals.push_back(portal);
+	}
+}
+
+
+void sight_map_c::FindMightSee(WorkerPool *pool)
+{
+	might_see.resize(portals.size() * 2);
+
+	auto flood = [this](int way)
+	{
+		const sight_portal_t &P = portals[way / 2];
+
+		might_see[way].assign(num_words, 0);
+		FloodMightSee(way / 2, (way & 1) ? P.left : P.right, might_see[way]);
+	};
+
+	if (pool)
+		pool->parallelFor((int)might_see.size(), flood);
+	else
+	{
+		for (int way = 0 ; way < (int)might_see.size() ; way++)
+			flood(way);
+	}
+}
+
+
+void sight_map_c::FloodMightSee(int portal, int sector, std::vector<uint64_t> &bits) const
+{
+	const sight_portal_t &source = portals[portal];
+
+	std::vector<int> stack;
+
+	bits[sector >> 6] |= (uint64_t)1 << (sector & 63);
+	stack.push_back(sector);
+
+	while (! stack.empty())
+	{
+		int cur = stack.back();
+		stack.pop_back();
+
+		for (int idx : sector_portals[cur])
+		{
+			const sight_portal_t &P = portals[idx];
+
+			int next = (P.right == cur) ? P.left : P.right;
+
+			if (bits[next >> 6] & ((uint64_t)1 << (next & 63)))
+				continue;
+
+			sight_window_t window = { P.x1, P.y1, P.x2, P.y2 };
+
+			if (! Sight_ClipBeyond(window, source, sector))
+				continue;
+
+			bits[next >> 6] |= (uint64_t)1 << (next & 63);
+			stack.push_back(next);
+		}
+	}
+}
+
+
+//
+// Finds every sector which can be seen from one sector.
+//
+class sight_flow_c
+{
+public:
+	sight_flow_c(const sight_map_c &map) :
+		visible(map.num_words, 0), map(map), on_path(map.portals.size(), 0)
+	{
+	}
+
+	// returns false when it took too long
+	bool Run(int sector)
+	{
+		Mark(sector);
+
+		for (int idx : map.sector_portals[sector])
+		{
+			const sight_portal_t &P = map.portals[idx];
+
+			source_idx  = idx;
+			first_sector = (P.right == sector) ? P.left : P.right;
+
+			Mark(first_sector);
+
+			sight_window_t window = { P.x1, P.y1, P.x2, P.y2 };
+
+			on_path[idx] = 1;
+			bool ok = Flow(first_sector, idx, window, window, map.might_see[map.Way(idx, first_sector)], 0);
+			on_path[idx] = 0;
+
+			if (! ok)
+				return false;
+		}
+
+		return true;
+	}
+
+	inline bool IsVisible(int sector) const
+	{
+		return (visible[sector >> 6] & ((uint64_t)1 << (sector & 63))) != 0;
+	}
+
+	// the sectors which can be seen
+	std::vector<uint64_t> visible;
+
+private:
+	inline void Mark(int sector)
+	{
+		visible[sector >> 6] |= (uint64_t)1 << (sector & 63);
+	}
+
+	bool Flow(int sector, int pass_idx, const sight_window_t &source, const sight_window_t &pass,
+			  const std::vector<uint64_t> &might, int depth)
+	{
+		if ((int)might_stack.size() <= depth)
+			might_stack.resize(depth + 1);
+
+		std::vector<uint64_t> &new_might = might_stack[depth];
+
+		for (int idx : map.sector_portals[sector])
+		{
+			// a straight line only goes through a portal once
+			if (on_path[idx])
+				continue;
+
+			if (++steps > SIGHT_STEP_LIMIT)
+				return false;
+
+			const sight_portal_t &P = map.portals[idx];
+
+			int next = (P.right == sector) ? P.left : P.right;
+
+			// nothing new to be seen that way?
+			const std::vector<uint64_t> &test = map.might_see[map.Way(idx, next)];
+
+			new_might.resize(map.num_words);
+
+			uint64_t more = 0;
+
+			for (int k = 0 ; k < map.num_words ; k++)
+			{
+				new_might[k] = might[k] & test[k];
+				more |= new_might[k] & ~visible[k];
+			}
+
+			if (! more && IsVisible(next))
+				continue;
+
+			sight_window_t target = { P.x1, P.y1, P.x2, P.y2 };
+
+			if (! Sight_ClipBeyond(target, map.portals[pass_idx], sector))
+				continue;
+			if (! Sight_ClipBeyond(target, map.portals[source_idx], first_sector))
+				continue;
+			if (! Sight_ClipToSeparators(source, pass, target))
+				continue;
+
+			// the same the other way round narrows down the source
+			sight_window_t new_source = source;
+
+			if (! Sight_ClipToSeparators(target, pass, new_source))
+				continue;
+
+			Mark(next);
+
+			on_path[idx] = 1;
+			bool ok = Flow(next, idx, new_source, target, new_might, depth + 1);
+			on_path[idx] = 0;
+
+			if (! ok)
+				return false;
+		}
+
+		return true;
+	}
+
+	const sight_map_c &map;
+
+	std::vector<u8_t> on_path;
+
+	// the sectors which the path so far might see, for each depth
+	// (a deque so the deeper ones can be added while in use)
+	std::deque<std::vector<uint64_t>> might_stack;
+
+	int source_idx = -1;
+	int first_sector = -1;
+	int steps = 0;
+};
+
+
+//
+// Work out which sectors can see each other, one sector per job on the
+// worker pool (when there is one).  Needs the groups.  Returns how many
+// sectors were too complex, which use the groups instead.
+//
+int LevelData::Reject::ProcessSightLines(const Document &doc, WorkerPool *pool,
+										 const std::atomic<bool> &cancelled)
+{
+	sight_map_c map(doc);
+
+	map.FindMightSee(pool);
+
+	const int num_sectors = map.num_sectors;
+
+	// what each sector can see
+	std::vector<std::vector<uint64_t>> rows(num_sectors);
+	std::atomic<int> too_complex{ 0 };
+
+	auto processRow = [&](int view)
+	{
+		sight_flow_c flow(map);
+
+		if (cancelled || ! flow.Run(view))
+		{
+			for (int target = 0 ; target < num_sectors ; target++)
+				if (rej_sector_groups[target] == rej_sector_groups[view])
+					flow.visible[target >> 6] |= (uint64_t)1 << (target & 63);
+
+			if (! cancelled)
+				too_complex++;
+		}
+
+		rows[view] = std::move(flow.visible);
+	};
+
+	if (pool)
+		pool->parallelFor(num_sectors, processRow);
+	else
+	{
+		for (int view = 0 ; view < num_sectors ; view++)
+			processRow(view);
+	}
+
+	// the windows are not always the same both ways, so a sector is
+	// only rejected when neither sees the other
+	for (int view=0 ; view < num_sectors ; view++)
+	{
+		for (int target=0 ; target < view ; target++)
+		{
+			if (rows[view][target >> 6] & ((uint64_t)1 << (target & 63)))
+				continue;
+			if (rows[target][view >> 6] & ((uint64_t)1 << (view & 63)))
+				continue;
+
+			int p1 = view * num_sectors + target;
+			int p2 = target * num_sectors + view;
+
+			// must do both directions at same time
+			rej_matrix[p1 >> 3] |= (1 << (p1 & 7));
+			rej_matrix[p2 >> 3] |= (1 << (p2 & 7));
+		}
+	}
+
+	return too_complex;
+}
+
+
 void LevelData::Reject_WriteLump() const
 {
 	Lump_c &lump = CreateLevelLump("REJECT");
@@ -663,9 +1153,9 @@ void LevelData::Reject_WriteLump() const
 //
 // build the reject table and write it into the REJECT lump
 //
-// For now we only do very basic reject processing, limited to
-// determining all isolated groups of sectors (islands that are
-// surrounded by void space).
+// The simple reject is limited to determining all isolated groups
+// of sectors (islands that are surrounded by void space).  The full
+// reject also checks the lines of sight between the sectors.
 //
 void LevelData::PutReject()
 {
@@ -678,16 +1168,35 @@ void LevelData::PutReject()
 
 	rej.Init(doc);
 	rej.GroupSectors(doc);
-	rej.ProcessSectors(doc);
 
 # if DEBUG_REJECT
 	Reject_DebugGroups();
 # endif
 
+	if (cur_info->full_reject)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		int too_complex = rej.ProcessSightLines(doc, work_pool.get(), cur_info->cancelled);
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - start);
+
+		PrintMsg("Full reject for %s: %d sectors in %d ms\n", current_name.c_str(),
+				 doc.numSectors(), (int)elapsed.count());
+
+		if (too_complex > 0)
+			Warning("Reject: %d sectors were too complex, only their groups are used\n", too_complex);
+	}
+	else
+	{
+		rej.ProcessSectors(doc);
+	}
+
 	Reject_WriteLump();
 	rej.Free();
 
-	PrintDetail("Added simple reject lump\n");
+	PrintDetail("Added %s reject lump\n", cur_info->full_reject ? "full" : "simple");
 }
 
 
@@ -699,90 +1208,44 @@ void LevelData::PutReject()
 // Note: ZDoom format support based on code (C) 2002,2003 Randy Heit
 
 
-#define ALLOC_BLKNUM  1024
-
-
 /* ----- allocation routines ---------------------------- */
 
 vertex_t *LevelData::NewVertex()
 {
-	vertex_t *V = (vertex_t *) UtilCalloc(sizeof(vertex_t));
+	vertex_t *V = vertex_alloc.Alloc();
 	vertices.push_back(V);
 	return V;
 }
 
 seg_t *LevelData::NewSeg()
 {
-	seg_t *S = (seg_t *) UtilCalloc(sizeof(seg_t));
+	seg_t *S = seg_alloc.Alloc();
 	segs.push_back(S);
 	return S;
 }
 
 subsec_t *LevelData::NewSubsec()
 {
-	subsec_t *S = (subsec_t *) UtilCalloc(sizeof(subsec_t));
+	subsec_t *S = subsec_alloc.Alloc();
 	subsecs.push_back(S);
 	return S;
 }
 
 node_t *LevelData::NewNode()
 {
-	node_t *N = (node_t *) UtilCalloc(sizeof(node_t));
+	node_t *N = node_alloc.Alloc();
 	nodes.push_back(N);
 	return N;
 }
 
 walltip_t *LevelData::NewWallTip()
 {
-	walltip_t *WT = (walltip_t *) UtilCalloc(sizeof(walltip_t));
+	walltip_t *WT = walltip_alloc.Alloc();
 	walltips.push_back(WT);
 	return WT;
 }
 
 
-/* ----- free routines ---------------------------- */
-
-void LevelData::FreeVertices()
-{
-	for (unsigned int i = 0 ; i < vertices.size() ; i++)
-		UtilFree((void *) vertices[i]);
-
-	vertices.clear();
-}
-
-void LevelData::FreeSegs()
-{
-	for (unsigned int i = 0 ; i < segs.size() ; i++)
-		UtilFree((void *) segs[i]);
-
-	segs.clear();
-}
-
-void LevelData::FreeSubsecs()
-{
-	for (unsigned int i = 0 ; i < subsecs.size() ; i++)
-		UtilFree((void *) subsecs[i]);
-
-	subsecs.clear();
-}
-
-void LevelData::FreeNodes()
-{
-	for (unsigned int i = 0 ; i < nodes.size() ; i++)
-		UtilFree((void *) nodes[i]);
-
-	nodes.clear();
-}
-
-void LevelData::FreeWallTips()
-{
-	for (unsigned int i = 0 ; i < walltips.size() ; i++)
-		UtilFree((void *) walltips[i]);
-
-	walltips.clear();
-}
-
-
 /* ----- reading routines ------------------------------ */
 
 void LevelData::GetVertices()
@@ -817,7 +1280,7 @@ static inline SideDef *SafeLookupSidedef(u16_t num)
 
 static inline int VanillaSegDist(const seg_t *seg, const Document &doc)
 {
-	const auto L = doc.linedefs[seg->linedef];
+	const LineDef *L = doc.linedefs[seg->linedef];
 
 	double lx = seg->side ? doc.getEnd(*L).x() : doc.getStart(*L).x();
 	double ly = seg->side ? doc.getEnd(*L).y() : doc.getStart(*L).y();
@@ -1330,12 +1793,9 @@ void LevelData::SortSegs()
 	// sort segs into ascending index
 	std::sort(segs.begin(), segs.end(), seg_index_CMP_pred());
 
-	// remove unwanted segs
+	// remove unwanted segs (their memory goes with the rest in FreeLevel)
 	while (segs.size() > 0 && segs.back()->index == SEG_IS_GARBAGE)
-	{
-		UtilFree((void *) segs.back());
 		segs.pop_back();
-	}
 }
 
 
@@ -1833,7 +2293,7 @@ void LevelData::LoadLevel()
 
 	GetVertices();
 
-	for(auto &L : doc.linedefs)
+	for(LineDef *L : doc.linedefs)
 	{
 		if (L->right >= 0 || L->left >= 0)
 			num_real_lines++;
@@ -1863,11 +2323,17 @@ void LevelData::LoadLevel()
 
 void LevelData::FreeLevel(void)
 {
-	FreeVertices();
-	FreeSegs();
-	FreeSubsecs();
-	FreeNodes();
-	FreeWallTips();
+	vertices.clear();
+	subsecs.clear();
+	segs.clear();
+	nodes.clear();
+	walltips.clear();
+
+	vertex_alloc.Clear();
+	subsec_alloc.Clear();
+	seg_alloc.Clear();
+	node_alloc.Clear();
+	walltip_alloc.Clear();
 }
 
 u32_t LevelData::CalcGLChecksum() const
@@ -1880,7 +2346,7 @@ u32_t LevelData::CalcGLChecksum() const
 
 	if (lump && lump->Length() > 0)
 	{
-		const u8_t *data = lump->getData().data();
+		const u8_t *data = lump->data();
 		Adler32_AddBlock(&crc, data, lump->Length());
 	}
 
@@ -1888,7 +2354,7 @@ u32_t LevelData::CalcGLChecksum() const
 
 	if (lump && lump->Length() > 0)
 	{
-		const u8_t *data = lump->getData().data();
+		const u8_t *data = lump->data();
 		Adler32_AddBlock(&crc, data, lump->Length());
 	}
 
@@ -2063,7 +2529,7 @@ build_result_e LevelData::SaveUDMF(node_t *root_node)
 	}
 	catch (const std::runtime_error& e)
 	{
-		gLog.printf("Failed building UDMF nodes: %s\n", e.what());
+		PrintMsg("Failed building UDMF nodes: %s\n", e.what());
 		throw;
 	}
 
@@ -2142,7 +2608,7 @@ Lump_c & LevelData::CreateGLMarker() const
 // MAIN STUFF
 //------------------------------------------------------------------------
 
-build_result_e LevelData::BuildLevel(nodebuildinfo_t *info, int lev_idx)
+build_result_e LevelData::BuildLevel(nodebuildinfo_t *info, int lev_idx, int num_threads)
 {
 	cur_info = info;
 
@@ -2153,6 +2619,9 @@ build_result_e LevelData::BuildLevel(nodebuildinfo_t *info, int lev_idx)
 	if (cur_info->cancelled)
 		return BUILD_Cancelled;
 
+	if (num_threads > 1)
+		work_pool = std::make_unique<WorkerPool>(num_threads);
+
 	current_idx   = lev_idx;
 	current_start = wad.LevelHeader(lev_idx);
 
@@ -2207,8 +2676,10 @@ build_result_e LevelData::BuildLevel(nodebuildinfo_t *info, int lev_idx)
 	FreeLevel();
 	FreeQuickAllocCuts();
 
+	work_pool.reset();
+
 	// clear some fake line flags
-	for(auto &linedef : doc.linedefs)
+	for(LineDef *linedef : doc.linedefs)
 		linedef->flags &= ~(MLF_IS_PRECIOUS | MLF_IS_OVERLAP);
 
 	return ret;
@@ -2217,12 +2688,169 @@ build_result_e LevelData::BuildLevel(nodebuildinfo_t *info, int lev_idx)
 }  // namespace ajbsp
 
 
-build_result_e AJBSP_BuildLevel(nodebuildinfo_t *info, int lev_idx, Instance &inst, const Document &doc, const LoadingData& loading, Wad_file& wad)
+static int NumThreads(const nodebuildinfo_t *info)
+{
+	return info->threads > 0 ? info->threads : WorkerPool::defaultThreads();
+}
+
+
+build_result_e AJBSP_BuildLevel(nodebuildinfo_t *info, int lev_idx, Instance &inst, Document &doc, const LoadingData& loading, Wad_file& wad)
 {
 	ajbsp::LevelData lev_data(loading.levelFormat, wad, doc, inst.conf, [&inst](const SString &message){
 		inst.GB_PrintMsg("%s", message.c_str());
 	});
-	return lev_data.BuildLevel(info, lev_idx);
+	return lev_data.BuildLevel(info, lev_idx, NumThreads(info));
+}
+
+//------------------------------------------------------------------------
+// MULTIPLE LEVELS
+//------------------------------------------------------------------------
+
+namespace
+{
+
+//
+// A level being built by AJBSP_BuildAllLevels
+//
+struct LevelJob
+{
+	std::unique_ptr<NewDocument> level;
+
+	// copy of the level's lumps, where the nodes get written
+	std::shared_ptr<Wad_file> scratch;
+
+	// the messages, kept until the previous levels are done
+	std::vector<SString> messages;
+	LogBuffer log;
+
+	build_result_e result = BUILD_OK;
+
+	// ready once the level is built, or has failed to load or build
+	std::future<void> done;
+};
+
+//
+// Builds the nodes of the job's level, on one of the pool's threads
+//
+void BuildLevelJob(LevelJob &job, nodebuildinfo_t *info, const ConfigData &config, int level_threads)
+{
+	// the log isn't safe to use from here, and would mix up the levels
+	LogCapture capture(job.log);
+
+	ajbsp::LevelData lev_data(job.level->loading.levelFormat, *job.scratch, job.level->doc, config,
+			[&job](const SString &message) {
+		job.messages.push_back(message);
+	});
+	job.result = lev_data.BuildLevel(info, 0, level_threads);
+}
+
+}  // namespace
+
+
+build_result_e AJBSP_BuildAllLevels(nodebuildinfo_t *info, const ConfigData &config, Wad_file &wad,
+		const std::function<NewDocument(int lev_idx)> &loadLevel,
+		const std::function<void(const SString &)> &reportLog,
+		const std::function<void(int num_done)> &poll)
+{
+	int num_levels = wad.LevelCount();
+
+	// one level per thread, and any spare threads help within the levels
+	int total_threads = NumThreads(info);
+	int num_threads = clamp(1, total_threads, std::max(num_levels, 1));
+	int level_threads = std::max(1, total_threads / num_threads);
+
+	// load a few levels ahead of the builders, but not the whole wad
+	const int max_ahead = num_threads * 2;
+
+	std::vector<std::unique_ptr<LevelJob>> jobs;
+
+	// the builders get threads of their own, this one keeps the GUI going.
+	// jobs not started when we stop early are dropped with the pool.
+	WorkerPool pool(num_threads + 1);
+
+	build_result_e ret = BUILD_OK;
+
+	for (int n = 0 ; n < num_levels ; n++)
+	{
+		// the loading uses the wad and the string table, so it stays here
+		while ((int)jobs.size() < num_levels && (int)jobs.size() < n + max_ahead)
+		{
+			int lev_idx = (int)jobs.size();
+
+			auto job = std::make_unique<LevelJob>();
+
+			try
+			{
+				job->level = std::make_unique<NewDocument>(loadLevel(lev_idx));
+				job->scratch = wad.copyLevel(lev_idx);
+
+				LevelJob *raw = job.get();
+				job->done = pool.post([raw, info, &config, level_threads]()
+				{
+					BuildLevelJob(*raw, info, config, level_threads);
+				});
+			}
+			catch (...)
+			{
+				std::promise<void> failed;
+				failed.set_exception(std::current_exception());
+				job->done = failed.get_future();
+			}
+
+			jobs.push_back(std::move(job));
+		}
+
+		LevelJob &job = *jobs[n];
+
+		// keep the GUI alive while waiting
+		while (job.done.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+			poll(n);
+
+		job.log.replay();
+
+		for (const SString &message : job.messages)
+			reportLog(message);
+
+		// a level which fails is left as it was, and the others still get built
+		SString failure;
+		try
+		{
+			job.done.get();
+		}
+		catch (const std::exception &e)
+		{
+			failure = e.what();
+		}
+		catch (...)
+		{
+			failure = "unknown error";
+		}
+
+		if (! failure.empty())
+		{
+			reportLog(SString::printf("Failed building nodes for level %d: %s\n", n, failure.c_str()));
+			jobs[n].reset();
+			continue;
+		}
+
+		ret = job.result;
+
+		// don't fail on maps with overflows
+		// [ Note that 'total_failed_maps' keeps a tally of these ]
+		if (ret == BUILD_LumpOverflow)
+			ret = BUILD_OK;
+
+		if (ret != BUILD_OK)
+			break;
+
+		wad.replaceLevel(n, *job.scratch);
+
+		jobs[n].reset();
+
+		poll(n + 1);
+	}
+
+	return ret;
 }
 
 //--- editor settings ---
@@ -49,6 +49,10 @@ namespace ajbsp
 
 #define SEG_FAST_THRESHHOLD  200
 
+// below this many segs, evaluating the partitions is not worth the
+// trouble of splitting it over several threads
+#define SEG_PARALLEL_THRESHOLD  64
+
 
 #define DEBUG_BUILDER  0
 #define DEBUG_SORTER   0
@@ -63,7 +67,8 @@ namespace ajbsp
 #define DIST_EPSILON  (1.0 / 1024.0)
 
 
-static int current_seg_index;
+// per thread, since several levels may be built at once
+static thread_local int current_seg_index;
 
 
 struct eval_info_t
@@ -97,7 +102,7 @@ public:
 };
 
 
-static intersection_t *quick_alloc_cuts = NULL;
+static thread_local intersection_t *quick_alloc_cuts = NULL;
 
 
 static intersection_t *NewIntersection(void)
@@ -724,6 +729,75 @@ bool LevelData::PickNodeWorker(quadtree_c *part_list,
 }
 
 
+static void CollectCandidates(quadtree_c *part_list, std::vector<seg_t *> &candidates)
+{
+	for (seg_t *part=part_list->list ; part ; part = part->next)
+	{
+		/* ignore minisegs as partition candidates */
+		if (part->linedef >= 0)
+			candidates.push_back(part);
+	}
+
+	for (int c=0 ; c < 2 ; c++)
+	{
+		if (part_list->subs[c] && !part_list->subs[c]->Empty())
+		{
+			CollectCandidates(part_list->subs[c], candidates);
+		}
+	}
+}
+
+
+//
+// Same as PickNodeWorker, but with the partitions evaluated on several
+// threads.  A partition is only cut short when it costs more than one
+// already found, and the costs are compared in the same seg order as
+// PickNodeWorker, so the same seg gets picked.
+//
+/* returns false if cancelled */
+bool LevelData::PickNodeParallel(quadtree_c *tree, seg_t ** best, int *best_cost)
+{
+	std::vector<seg_t *> candidates;
+	CollectCandidates(tree, candidates);
+
+	std::vector<int> costs(candidates.size(), -1);
+
+	std::atomic<int> lowest(*best_cost);
+
+	work_pool->parallelFor((int)candidates.size(), [&](int i)
+	{
+		if (cur_info->cancelled)
+			return;
+
+		int cost = EvalPartition(tree, candidates[i], lowest.load(std::memory_order_relaxed));
+
+		costs[i] = cost;
+
+		if (cost < 0)
+			return;
+
+		int old = lowest.load(std::memory_order_relaxed);
+		while (cost < old && ! lowest.compare_exchange_weak(old, cost, std::memory_order_relaxed))
+		{ }
+	});
+
+	if (cur_info->cancelled)
+		return false;
+
+	for (size_t i = 0 ; i < candidates.size() ; i++)
+	{
+		/* seg unsuitable or too costly ? */
+		if (costs[i] < 0 || costs[i] >= *best_cost)
+			continue;
+
+		(*best_cost) = costs[i];
+		(*best) = candidates[i];
+	}
+
+	return true;
+}
+
+
 //
 // Find the best seg in the seg_list to use as a partition line.
 //
@@ -760,7 +834,14 @@ seg_t *LevelData::PickNode(quadtree_c *tree, int depth)
 		}
 	}
 
-	if (! PickNodeWorker(tree, tree, &best, &best_cost))
+	bool finished;
+
+	if (work_pool && tree->real_num >= SEG_PARALLEL_THRESHOLD)
+		finished = PickNodeParallel(tree, &best, &best_cost);
+	else
+		finished = PickNodeWorker(tree, tree, &best, &best_cost);
+
+	if (! finished)
 	{
 		/* hack here : BuildNodes will detect the cancellation */
 		return NULL;
@@ -1317,7 +1398,7 @@ seg_t *LevelData::CreateOneSeg(int line, vertex_t *start, vertex_t *end,
 {
 	const SideDef *sd = NULL;
 	if (sidedef >= 0)
-		sd = doc.sidedefs[sidedef].get();
+		sd = doc.sidedefs[sidedef];
 
 	// check for bad sidedef
 	if (sd && !doc.isSector(sd->sector))
@@ -1356,7 +1437,7 @@ seg_t *LevelData::CreateSegs()
 
 	for (int i=0 ; i < doc.numLinedefs() ; i++)
 	{
-		const auto line = doc.linedefs[i];
+		const LineDef *line = doc.linedefs[i];
 
 		seg_t *left  = NULL;
 		seg_t *right = NULL;
@@ -174,12 +174,14 @@ SString UtilTimeString(void)
 #else // LINUX or MACOSX
 
 	time_t epoch_time;
+	struct tm calend_buf;
 	struct tm *calend_time;
 
 	if (time(&epoch_time) == (time_t)-1)
 		return NULL;
 
-	calend_time = localtime(&epoch_time);
+	// the re-entrant form, since the node builder may run on several threads
+	calend_time = localtime_r(&epoch_time, &calend_buf);
 	if (! calend_time)
 		return NULL;
 
@@ -231,7 +233,7 @@ void Adler32_Finish(u32_t *crc)
 
 /* ----- polyobj handling ----------------------------- */
 
-static void MarkPolyobjSector(int sector, const Document &doc)
+static void MarkPolyobjSector(int sector, Document &doc)
 {
 	int i;
 
@@ -244,7 +246,7 @@ static void MarkPolyobjSector(int sector, const Document &doc)
 
 	for (i = 0 ; i < doc.numLinedefs(); i++)
 	{
-		auto L = doc.linedefs[i];
+		LineDef *L = doc.linedefs[i];
 
 		if ((L->right >= 0 && doc.getRight(*L)->sector == sector) ||
 			(L->left  >= 0 && doc.getLeft(*L)->sector  == sector))
@@ -279,7 +281,7 @@ void LevelData::MarkPolyobjPoint(double x, double y)
 
 	for (i = 0 ; i < doc.numLinedefs(); i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		if (CheckLinedefInsideBox(bminx, bminy, bmaxx, bmaxy,
 					(int) doc.getStart(*L).x(), (int) doc.getStart(*L).y(),
@@ -310,7 +312,7 @@ void LevelData::MarkPolyobjPoint(double x, double y)
 
 	for (i = 0 ; i < doc.numLinedefs(); i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		double x_cut;
 
@@ -344,7 +346,7 @@ void LevelData::MarkPolyobjPoint(double x, double y)
 		return;
 	}
 
-	const auto best_ld = doc.linedefs[best_match];
+	const LineDef *best_ld = doc.linedefs[best_match];
 
 	y1 = doc.getStart(*best_ld).y();
 	y2 = doc.getEnd(*best_ld).y();
@@ -403,7 +405,7 @@ void LevelData::DetectPolyobjSectors()
 	// -JL- First go through all lines to see if level contains any polyobjs
 	for (i = 0 ; i < doc.numLinedefs(); i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
         const linetype_t *type = get(config.line_types, L->type);
         if(type && type->isPolyObjectSpecial())
 			break;
@@ -422,7 +424,7 @@ void LevelData::DetectPolyobjSectors()
 
 	for (i = 0 ; i < doc.numThings(); i++)
 	{
-		const auto T = doc.things[i];
+		const Thing *T = doc.things[i];
 
 		double x = T->x();
 		double y = T->y();
@@ -451,8 +453,8 @@ static FFixedPoint VertexCompare(const Document &doc, const void *p1, const void
 	if (vert1 == vert2)
 		return FFixedPoint{};
 
-	const auto A = doc.vertices[vert1];
-	const auto B = doc.vertices[vert2];
+	const Vertex *A = doc.vertices[vert1];
+	const Vertex *B = doc.vertices[vert2];
 
 	if (A->raw_x != B->raw_x)
 		return A->raw_x - B->raw_x;
@@ -513,12 +515,12 @@ static FFixedPoint LineStartCompare(const Document &doc, const void *p1, const v
 	if (line1 == line2)
 		return FFixedPoint();
 
-	const auto A = doc.linedefs[line1];
-	const auto B = doc.linedefs[line2];
+	const LineDef *A = doc.linedefs[line1];
+	const LineDef *B = doc.linedefs[line2];
 
 	// determine left-most vertex of each line
-	const Vertex *C = LineVertexLowest(doc, A.get()) ? &doc.getEnd(*A) : &doc.getStart(*A);
-	const Vertex *D = LineVertexLowest(doc, B.get()) ? &doc.getEnd(*B) : &doc.getStart(*B);
+	const Vertex *C = LineVertexLowest(doc, A) ? &doc.getEnd(*A) : &doc.getStart(*A);
+	const Vertex *D = LineVertexLowest(doc, B) ? &doc.getEnd(*B) : &doc.getStart(*B);
 
 	if (C->raw_x != D->raw_x)
 		return C->raw_x - D->raw_x;
@@ -534,12 +536,12 @@ static FFixedPoint LineEndCompare(const Document &doc, const void *p1, const voi
 	if (line1 == line2)
 		return FFixedPoint{};
 
-	const auto A = doc.linedefs[line1];
-	const auto B = doc.linedefs[line2];
+	const LineDef *A = doc.linedefs[line1];
+	const LineDef *B = doc.linedefs[line2];
 
 	// determine right-most vertex of each line
-	const Vertex * C = LineVertexLowest(doc, A.get()) ? &doc.getStart(*A) : &doc.getEnd(*A);
-	const Vertex * D = LineVertexLowest(doc, B.get()) ? &doc.getStart(*B) : &doc.getEnd(*B);
+	const Vertex * C = LineVertexLowest(doc, A) ? &doc.getStart(*A) : &doc.getEnd(*A);
+	const Vertex * D = LineVertexLowest(doc, B) ? &doc.getStart(*B) : &doc.getEnd(*B);
 
 	if (C->raw_x != D->raw_x)
 		return C->raw_x - D->raw_x;
@@ -548,7 +550,7 @@ static FFixedPoint LineEndCompare(const Document &doc, const void *p1, const voi
 }
 
 
-void DetectOverlappingLines(const Document &doc)
+void DetectOverlappingLines(Document &doc)
 {
 	// Algorithm:
 	//   Sort all lines by left-most vertex.
@@ -581,7 +583,7 @@ void DetectOverlappingLines(const Document &doc)
 			{
 				// found an overlap !
 
-				auto L = doc.linedefs[array[j]];
+				LineDef *L = doc.linedefs[array[j]];
 				L->flags |= MLF_IS_OVERLAP;
 				count++;
 			}
@@ -649,7 +651,7 @@ void LevelData::CalculateWallTips()
 
 	for (i=0 ; i < doc.numLinedefs(); i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		if ((L->flags & MLF_IS_OVERLAP) || doc.isZeroLength(*L))
 			continue;
@@ -702,7 +704,7 @@ vertex_t *LevelData::NewVertexFromSplitSeg(seg_t *seg, double x, double y)
 	}
 	else
 	{
-		const auto L = doc.linedefs[seg->linedef];
+		const LineDef *L = doc.linedefs[seg->linedef];
 
 		bool front_open = ((seg->side ? L->left : L->right) >= 0);
 
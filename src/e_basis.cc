@@ -29,12 +29,15 @@
 #include "Errors.h"
 #include "Instance.h"
 #include "LineDef.h"
+#include "m_bitvec.h"
 #include "main.h"
 #include "Sector.h"
 #include "SideDef.h"
 #include "Thing.h"
 #include "Vertex.h"
 
+#include <algorithm>
+
 // need these for the XXX_Notify() prototypes
 #include "r_render.h"
 
@@ -65,7 +68,7 @@ StringID BA_InternaliseString(const SString &str)
 	return basis_strtab.add(str);
 }
 
-SString BA_GetString(StringID offset) noexcept
+const SString &BA_GetString(StringID offset) noexcept
 {
 	return basis_strtab.get(offset);
 }
@@ -197,27 +200,27 @@ int Basis::addNew(ObjType type)
 	{
 	case ObjType::things:
 		op.objnum = doc.numThings();
-		op.thing = std::make_shared<Thing>();
+		op.thing = std::make_unique<Thing>();
 		break;
 
 	case ObjType::vertices:
 		op.objnum = doc.numVertices();
-		op.vertex = std::make_shared<Vertex>();
+		op.vertex = std::make_unique<Vertex>();
 		break;
 
 	case ObjType::sidedefs:
 		op.objnum = doc.numSidedefs();
-		op.sidedef = std::make_shared<SideDef>();
+		op.sidedef = std::make_unique<SideDef>();
 		break;
 
 	case ObjType::linedefs:
 		op.objnum = doc.numLinedefs();
-		op.linedef = std::make_shared<LineDef>();
+		op.linedef = std::make_unique<LineDef>();
 		break;
 
 	case ObjType::sectors:
 		op.objnum = doc.numSectors();
-		op.sector = std::make_shared<Sector>();
+		op.sector = std::make_unique<Sector>();
 		break;
 
 	default:
@@ -252,7 +255,7 @@ void Basis::del(ObjType type, int objnum)
 		// unbind sidedef from any linedefs using it
 		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
 		{
-			const auto L = doc.linedefs[n];
+			const LineDef *L = doc.linedefs[n];
 
 			if(L->right == objnum)
 				changeLinedef(n, LineDef::F_RIGHT, -1);
@@ -285,6 +288,92 @@ void Basis::del(ObjType type, int objnum)
 	mCurrentGroup.addApply(std::move(op), *this);
 }
 
+//
+// deletes several objects of the same type at once.  Same as calling
+// del() on each of them (from the highest number down), but the arrays
+// get compacted and the references renumbered only once.
+//
+void Basis::del(ObjType type, std::vector<int> objnums)
+{
+	SYS_ASSERT(mCurrentGroup.isActive());
+
+	std::sort(objnums.begin(), objnums.end());
+	objnums.erase(std::unique(objnums.begin(), objnums.end()), objnums.end());
+
+	if(objnums.empty())
+		return;
+
+	if(objnums.size() == 1)
+	{
+		del(type, objnums[0]);
+		return;
+	}
+
+	SYS_ASSERT(objnums.front() >= 0 && objnums.back() < doc.numObjects(type));
+
+	bitvec_c doomed(doc.numObjects(type));
+
+	for(int n : objnums)
+		doomed.set(n);
+
+	auto isDoomed = [&doomed](int ref)
+	{
+		return ref >= 0 && doomed.get(ref);
+	};
+
+	// like above, this must happen _before_ doing the deletion
+	if(type == ObjType::sidedefs)
+	{
+		// unbind sidedefs from any linedefs using them
+		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
+		{
+			const LineDef *L = doc.linedefs[n];
+
+			if(isDoomed(L->right))
+				changeLinedef(n, LineDef::F_RIGHT, -1);
+
+			if(isDoomed(L->left))
+				changeLinedef(n, LineDef::F_LEFT, -1);
+		}
+	}
+	else if(type == ObjType::vertices)
+	{
+		// delete any linedefs bound to these vertices
+		std::vector<int> lines;
+
+		for(int n = 0; n < doc.numLinedefs(); n++)
+		{
+			const auto L = doc.linedefs[n];
+
+			if(isDoomed(L->start) || isDoomed(L->end))
+				lines.push_back(n);
+		}
+
+		del(ObjType::linedefs, std::move(lines));
+	}
+	else if(type == ObjType::sectors)
+	{
+		// delete the sidedefs bound to these sectors
+		std::vector<int> sides;
+
+		for(int n = 0; n < doc.numSidedefs(); n++)
+			if(isDoomed(doc.sidedefs[n]->sector))
+				sides.push_back(n);
+
+		del(ObjType::sidedefs, std::move(sides));
+	}
+
+	EditUnit op;
+
+	op.action = EditType::del;
+	op.objtype = type;
+	op.objnum = objnums.front();
+	op.batch = std::make_unique<EditUnit::Batch>();
+	op.batch->objnums = std::move(objnums);
+
+	mCurrentGroup.addApply(std::move(op), *this);
+}
+
 //
 // change a field of an existing object.  If the value was the
 // same as before, nothing happens and false is returned.
@@ -495,23 +584,23 @@ void Basis::EditUnit::rawChange(Basis &basis)
 	{
 	case ObjType::things:
 		SYS_ASSERT(0 <= objnum && objnum < basis.doc.numThings());
-		pos = reinterpret_cast<int *>(basis.doc.things[objnum].get());
+		pos = reinterpret_cast<int *>(basis.doc.things[objnum]);
 		break;
 	case ObjType::vertices:
 		SYS_ASSERT(0 <= objnum && objnum < basis.doc.numVertices());
-		pos = reinterpret_cast<int *>(basis.doc.vertices[objnum].get());
+		pos = reinterpret_cast<int *>(basis.doc.vertices[objnum]);
 		break;
 	case ObjType::sectors:
 		SYS_ASSERT(0 <= objnum && objnum < basis.doc.numSectors());
-		pos = reinterpret_cast<int *>(basis.doc.sectors[objnum].get());
+		pos = reinterpret_cast<int *>(basis.doc.sectors[objnum]);
 		break;
 	case ObjType::sidedefs:
 		SYS_ASSERT(0 <= objnum && objnum < basis.doc.numSidedefs());
-		pos = reinterpret_cast<int *>(basis.doc.sidedefs[objnum].get());
+		pos = reinterpret_cast<int *>(basis.doc.sidedefs[objnum]);
 		break;
 	case ObjType::linedefs:
 		SYS_ASSERT(0 <= objnum && objnum < basis.doc.numLinedefs());
-		pos = reinterpret_cast<int *>(basis.doc.linedefs[objnum].get());
+		pos = reinterpret_cast<int *>(basis.doc.linedefs[objnum]);
 		break;
 	default:
 		BugError("Basis::EditOperation::rawChange: bad objtype %u\n", (unsigned)objtype);
@@ -527,6 +616,38 @@ void Basis::EditUnit::rawChange(Basis &basis)
 	basis.inst.MapStuff_NotifyChange(objtype, objnum, field);
 	Render3D_NotifyChange(objtype, objnum, field);
 	basis.inst.ObjectBox_NotifyChange(objtype, objnum, field);
+	basis.doc.adjacency.notifyChange(objtype, objnum, field);
+	basis.doc.spatial.notifyChange(objtype, objnum, field);
+}
+
+//
+// Tell the interested parties an object is about to be deleted
+//
+void Basis::EditUnit::notifyDelete(Basis &basis, int num) const
+{
+	// TODO: their own modules
+	Clipboard_NotifyDelete(objtype, num);
+	basis.inst.Selection_NotifyDelete(objtype, num);
+	basis.inst.MapStuff_NotifyDelete(objtype, num);
+	Render3D_NotifyDelete(basis.doc, objtype, num);
+	basis.inst.ObjectBox_NotifyDelete(objtype, num);
+	basis.doc.adjacency.notifyDelete(objtype, num);
+	basis.doc.spatial.notifyDelete(objtype, num);
+}
+
+//
+// Tell the interested parties an object is about to be inserted
+//
+void Basis::EditUnit::notifyInsert(Basis &basis, int num) const
+{
+	// TODO: their module
+	Clipboard_NotifyInsert(basis.doc, objtype, num);
+	basis.inst.Selection_NotifyInsert(objtype, num);
+	basis.inst.MapStuff_NotifyInsert(objtype, num);
+	Render3D_NotifyInsert(objtype, num);
+	basis.inst.ObjectBox_NotifyInsert(objtype, num);
+	basis.doc.adjacency.notifyInsert(objtype, num);
+	basis.doc.spatial.notifyInsert(objtype, num);
 }
 
 //
@@ -536,12 +657,18 @@ void Basis::EditUnit::rawDelete(Basis &basis)
 {
 	basis.mDidMakeChanges = true;
 
-	// TODO: their own modules
-	Clipboard_NotifyDelete(objtype, objnum);
-	basis.inst.Selection_NotifyDelete(objtype, objnum);
-	basis.inst.MapStuff_NotifyDelete(objtype, objnum);
-	Render3D_NotifyDelete(basis.doc, objtype, objnum);
-	basis.inst.ObjectBox_NotifyDelete(objtype, objnum);
+	if(batch)
+	{
+		// notify from the highest number down, as if the objects were
+		// deleted one by one (so lower numbers stay valid)
+		for(auto it = batch->objnums.rbegin(); it != batch->objnums.rend(); ++it)
+			notifyDelete(basis, *it);
+
+		rawDeleteBatch(basis.doc);
+		return;
+	}
+
+	notifyDelete(basis, objnum);
 
 	switch(objtype)
 	{
@@ -574,12 +701,11 @@ void Basis::EditUnit::rawDelete(Basis &basis)
 //
 // Thing deletion
 //
-std::shared_ptr<Thing> Basis::EditUnit::rawDeleteThing(Document &doc) const
+std::unique_ptr<Thing> Basis::EditUnit::rawDeleteThing(Document &doc) const
 {
 	SYS_ASSERT(0 <= objnum && objnum < doc.numThings());
 
-	auto result = std::move(doc.things[objnum]);
-	doc.things.erase(doc.things.begin() + objnum);
+	auto result = std::make_unique<Thing>(doc.things.remove(objnum));
 
 	return result;
 }
@@ -587,12 +713,11 @@ std::shared_ptr<Thing> Basis::EditUnit::rawDeleteThing(Document &doc) const
 //
 // Vertex deletion (and update linedef refs)
 //
-std::shared_ptr<Vertex> Basis::EditUnit::rawDeleteVertex(Document &doc) const
+std::unique_ptr<Vertex> Basis::EditUnit::rawDeleteVertex(Document &doc) const
 {
 	SYS_ASSERT(0 <= objnum && objnum < doc.numVertices());
 
-	auto result = std::move(doc.vertices[objnum]);
-	doc.vertices.erase(doc.vertices.begin() + objnum);
+	auto result = std::make_unique<Vertex>(doc.vertices.remove(objnum));
 
 	// fix the linedef references
 
@@ -600,7 +725,7 @@ std::shared_ptr<Vertex> Basis::EditUnit::rawDeleteVertex(Document &doc) const
 	{
 		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
 		{
-			auto L = doc.linedefs[n];
+			LineDef *L = doc.linedefs[n];
 
 			if(L->start > objnum)
 				L->start--;
@@ -616,12 +741,11 @@ std::shared_ptr<Vertex> Basis::EditUnit::rawDeleteVertex(Document &doc) const
 //
 // Raw delete sector (and update sidedef refs)
 //
-std::shared_ptr<Sector> Basis::EditUnit::rawDeleteSector(Document &doc) const
+std::unique_ptr<Sector> Basis::EditUnit::rawDeleteSector(Document &doc) const
 {
 	SYS_ASSERT(0 <= objnum && objnum < doc.numSectors());
 
-	auto result = std::move(doc.sectors[objnum]);
-	doc.sectors.erase(doc.sectors.begin() + objnum);
+	auto result = std::make_unique<Sector>(doc.sectors.remove(objnum));
 
 	// fix sidedef references
 
@@ -629,7 +753,7 @@ std::shared_ptr<Sector> Basis::EditUnit::rawDeleteSector(Document &doc) const
 	{
 		for(int n = doc.numSidedefs() - 1; n >= 0; n--)
 		{
-			auto S = doc.sidedefs[n];
+			SideDef *S = doc.sidedefs[n];
 
 			if(S->sector > objnum)
 				S->sector--;
@@ -642,12 +766,11 @@ std::shared_ptr<Sector> Basis::EditUnit::rawDeleteSector(Document &doc) const
 //
 // Delete sidedef (and update linedef references)
 //
-std::shared_ptr<SideDef> Basis::EditUnit::rawDeleteSidedef(Document &doc) const
+std::unique_ptr<SideDef> Basis::EditUnit::rawDeleteSidedef(Document &doc) const
 {
 	SYS_ASSERT(0 <= objnum && objnum < doc.numSidedefs());
 
-	auto result = std::move(doc.sidedefs[objnum]);
-	doc.sidedefs.erase(doc.sidedefs.begin() + objnum);
+	auto result = std::make_unique<SideDef>(doc.sidedefs.remove(objnum));
 
 	// fix the linedefs references
 
@@ -655,7 +778,7 @@ std::shared_ptr<SideDef> Basis::EditUnit::rawDeleteSidedef(Document &doc) const
 	{
 		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
 		{
-			auto L = doc.linedefs[n];
+			LineDef *L = doc.linedefs[n];
 
 			if(L->right > objnum)
 				L->right--;
@@ -671,16 +794,189 @@ std::shared_ptr<SideDef> Basis::EditUnit::rawDeleteSidedef(Document &doc) const
 //
 // Raw delete linedef
 //
-std::shared_ptr<LineDef> Basis::EditUnit::rawDeleteLinedef(Document &doc) const
+std::unique_ptr<LineDef> Basis::EditUnit::rawDeleteLinedef(Document &doc) const
 {
 	SYS_ASSERT(0 <= objnum && objnum < doc.numLinedefs());
 
-	auto result = std::move(doc.linedefs[objnum]);
-	doc.linedefs.erase(doc.linedefs.begin() + objnum);
+	auto result = std::make_unique<LineDef>(doc.linedefs.remove(objnum));
 
 	return result;
 }
 
+//
+// Remove the batch objects from the array, keeping the order of the
+// others. Fills 'remap' with the new number of each old object (-1 for
+// the removed ones).
+//
+template<typename T>
+static void compactArray(MapArray<T> &array, const std::vector<int> &objnums,
+						 std::vector<T> &removed, std::vector<int> &remap)
+{
+	remap.resize(array.size());
+	removed.clear();
+	removed.reserve(objnums.size());
+
+	size_t k = 0;
+	size_t dest = 0;
+
+	for(size_t n = 0; n < array.size(); n++)
+	{
+		if(k < objnums.size() && objnums[k] == (int)n)
+		{
+			removed.push_back(std::move(*array[(int)n]));
+			remap[n] = -1;
+			k++;
+			continue;
+		}
+
+		remap[n] = (int)dest;
+		if(dest != n)
+			*array[(int)dest] = std::move(*array[(int)n]);
+		dest++;
+	}
+
+	SYS_ASSERT(k == objnums.size());
+	array.resize(dest);
+}
+
+//
+// Put the batch objects back at their numbers. Fills 'remap' with the
+// new number of each old object. Works from the end down, so the others
+// can move up in place.
+//
+template<typename T>
+static void expandArray(MapArray<T> &array, const std::vector<int> &objnums,
+						std::vector<T> &inserted, std::vector<int> &remap)
+{
+	SYS_ASSERT(inserted.size() == objnums.size());
+
+	size_t src = array.size();
+	size_t total = src + inserted.size();
+
+	remap.resize(src);
+	array.resize(total);
+
+	size_t k = objnums.size();
+
+	for(size_t n = total; n-- > 0; )
+	{
+		if(k > 0 && objnums[k - 1] == (int)n)
+		{
+			*array[(int)n] = std::move(inserted[--k]);
+			continue;
+		}
+
+		SYS_ASSERT(src > 0);
+		remap[--src] = (int)n;
+		if(src != n)
+			*array[(int)n] = std::move(*array[(int)src]);
+	}
+
+	inserted.clear();
+}
+
+//
+// Update the references to renumbered vertices, sidedefs or sectors
+//
+static void remapReferences(Document &doc, ObjType type, const std::vector<int> &remap)
+{
+	auto fix = [&remap](int &ref)
+	{
+		if(ref >= 0 && ref < (int)remap.size())
+			ref = remap[ref];
+	};
+
+	switch(type)
+	{
+	case ObjType::vertices:
+		for(LineDef *L : doc.linedefs)
+		{
+			fix(L->start);
+			fix(L->end);
+		}
+		break;
+
+	case ObjType::sidedefs:
+		for(LineDef *L : doc.linedefs)
+		{
+			fix(L->right);
+			fix(L->left);
+		}
+		break;
+
+	case ObjType::sectors:
+		for(SideDef *S : doc.sidedefs)
+			fix(S->sector);
+		break;
+
+	default:
+		break;
+	}
+}
+
+//
+// Batch deletion: compact the array once, then fix all the references
+// in a single pass.
+//
+void Basis::EditUnit::rawDeleteBatch(Document &doc)
+{
+	std::vector<int> remap;
+
+	switch(objtype)
+	{
+	case ObjType::things:
+		compactArray(doc.things, batch->objnums, batch->things, remap);
+		break;
+	case ObjType::vertices:
+		compactArray(doc.vertices, batch->objnums, batch->vertices, remap);
+		break;
+	case ObjType::sectors:
+		compactArray(doc.sectors, batch->objnums, batch->sectors, remap);
+		break;
+	case ObjType::sidedefs:
+		compactArray(doc.sidedefs, batch->objnums, batch->sidedefs, remap);
+		break;
+	case ObjType::linedefs:
+		compactArray(doc.linedefs, batch->objnums, batch->linedefs, remap);
+		break;
+	default:
+		BugError("Basis::EditOperation::rawDeleteBatch: bad objtype %u\n", (unsigned)objtype);
+	}
+
+	remapReferences(doc, objtype, remap);
+}
+
+//
+// Batch insertion (the reverse of the above)
+//
+void Basis::EditUnit::rawInsertBatch(Document &doc)
+{
+	std::vector<int> remap;
+
+	switch(objtype)
+	{
+	case ObjType::things:
+		expandArray(doc.things, batch->objnums, batch->things, remap);
+		break;
+	case ObjType::vertices:
+		expandArray(doc.vertices, batch->objnums, batch->vertices, remap);
+		break;
+	case ObjType::sectors:
+		expandArray(doc.sectors, batch->objnums, batch->sectors, remap);
+		break;
+	case ObjType::sidedefs:
+		expandArray(doc.sidedefs, batch->objnums, batch->sidedefs, remap);
+		break;
+	case ObjType::linedefs:
+		expandArray(doc.linedefs, batch->objnums, batch->linedefs, remap);
+		break;
+	default:
+		BugError("Basis::EditOperation::rawInsertBatch: bad objtype %u\n", (unsigned)objtype);
+	}
+
+	remapReferences(doc, objtype, remap);
+}
+
 //
 // Insert operation
 //
@@ -688,12 +984,18 @@ void Basis::EditUnit::rawInsert(Basis &basis)
 {
 	basis.mDidMakeChanges = true;
 
-	// TODO: their module
-	Clipboard_NotifyInsert(basis.doc, objtype, objnum);
-	basis.inst.Selection_NotifyInsert(objtype, objnum);
-	basis.inst.MapStuff_NotifyInsert(objtype, objnum);
-	Render3D_NotifyInsert(objtype, objnum);
-	basis.inst.ObjectBox_NotifyInsert(objtype, objnum);
+	if(batch)
+	{
+		// notify from the lowest number up, as if the objects were
+		// inserted one by one at their final places
+		for(int n : batch->objnums)
+			notifyInsert(basis, n);
+
+		rawInsertBatch(basis.doc);
+		return;
+	}
+
+	notifyInsert(basis, objnum);
 
 	switch(objtype)
 	{
@@ -733,7 +1035,7 @@ void Basis::EditUnit::rawInsert(Basis &basis)
 void Basis::EditUnit::rawInsertThing(Document &doc)
 {
 	SYS_ASSERT(0 <= objnum && objnum <= doc.numThings());
-	doc.things.insert(doc.things.begin() + objnum, std::move(thing));
+	doc.things.insert(objnum, std::move(*thing));
 }
 
 //
@@ -742,7 +1044,7 @@ void Basis::EditUnit::rawInsertThing(Document &doc)
 void Basis::EditUnit::rawInsertVertex(Document &doc)
 {
 	SYS_ASSERT(0 <= objnum && objnum <= doc.numVertices());
-	doc.vertices.insert(doc.vertices.begin() + objnum, std::move(vertex));
+	doc.vertices.insert(objnum, std::move(*vertex));
 
 	// fix references in linedefs
 
@@ -750,7 +1052,7 @@ void Basis::EditUnit::rawInsertVertex(Document &doc)
 	{
 		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
 		{
-			auto L = doc.linedefs[n];
+			LineDef *L = doc.linedefs[n];
 
 			if(L->start >= objnum)
 				L->start++;
@@ -767,7 +1069,7 @@ void Basis::EditUnit::rawInsertVertex(Document &doc)
 void Basis::EditUnit::rawInsertSector(Document &doc)
 {
 	SYS_ASSERT(0 <= objnum && objnum <= doc.numSectors());
-	doc.sectors.insert(doc.sectors.begin() + objnum, std::move(sector));
+	doc.sectors.insert(objnum, std::move(*sector));
 
 	// fix all sidedef references
 
@@ -775,7 +1077,7 @@ void Basis::EditUnit::rawInsertSector(Document &doc)
 	{
 		for(int n = doc.numSidedefs() - 1; n >= 0; n--)
 		{
-			auto S = doc.sidedefs[n];
+			SideDef *S = doc.sidedefs[n];
 
 			if(S->sector >= objnum)
 				S->sector++;
@@ -789,7 +1091,7 @@ void Basis::EditUnit::rawInsertSector(Document &doc)
 void Basis::EditUnit::rawInsertSidedef(Document &doc)
 {
 	SYS_ASSERT(0 <= objnum && objnum <= doc.numSidedefs());
-	doc.sidedefs.insert(doc.sidedefs.begin() + objnum, std::move(sidedef));
+	doc.sidedefs.insert(objnum, std::move(*sidedef));
 
 	// fix the linedefs references
 
@@ -797,7 +1099,7 @@ void Basis::EditUnit::rawInsertSidedef(Document &doc)
 	{
 		for(int n = doc.numLinedefs() - 1; n >= 0; n--)
 		{
-			auto L = doc.linedefs[n];
+			LineDef *L = doc.linedefs[n];
 
 			if(L->right >= objnum)
 				L->right++;
@@ -814,7 +1116,7 @@ void Basis::EditUnit::rawInsertSidedef(Document &doc)
 void Basis::EditUnit::rawInsertLinedef(Document &doc)
 {
 	SYS_ASSERT(0 <= objnum && objnum <= doc.numLinedefs());
-	doc.linedefs.insert(doc.linedefs.begin() + objnum, std::move(linedef));
+	doc.linedefs.insert(objnum, std::move(*linedef));
 }
 
 //
@@ -822,6 +1124,12 @@ void Basis::EditUnit::rawInsertLinedef(Document &doc)
 //
 void Basis::EditUnit::deleteFinally()
 {
+	if(batch)
+	{
+		batch.reset();
+		return;
+	}
+
 	switch(objtype)
 	{
 	case ObjType::things:   thing.reset(); break;
@@ -896,6 +1204,8 @@ void Basis::doClearChangeStatus()
 	inst.MapStuff_NotifyBegin();
 	Render3D_NotifyBegin();
 	inst.ObjectBox_NotifyBegin();
+	doc.adjacency.notifyBegin();
+	doc.spatial.notifyBegin();
 }
 
 //
@@ -910,6 +1220,10 @@ void Basis::doProcessChangeStatus() const
 		inst.RedrawMap();
 	}
 
+	// the lookups go first, since the others may use them
+	doc.adjacency.notifyEnd();
+	doc.spatial.notifyEnd();
+
 	Clipboard_NotifyEnd();
 	inst.Selection_NotifyEnd();
 	inst.MapStuff_NotifyEnd();
@@ -37,6 +37,7 @@
 #include "Vertex.h"
 #include <memory>
 #include <stack>
+#include <vector>
 
 #define DEFAULT_UNDO_GROUP_MESSAGE "[something]"
 
@@ -113,29 +114,50 @@ private:
 	//
 	struct EditUnit
 	{
+		//
+		// Several objects of one type, deleted (or reinserted) at once
+		//
+		struct Batch
+		{
+			std::vector<int> objnums;	// ascending
+			std::vector<Thing> things;
+			std::vector<Vertex> vertices;
+			std::vector<Sector> sectors;
+			std::vector<SideDef> sidedefs;
+			std::vector<LineDef> linedefs;
+		};
+
 		EditType action = EditType::none;
 		ObjType objtype = ObjType::things;
 		byte field = 0;
 		int objnum = 0;
-		std::shared_ptr<Thing> thing;
-		std::shared_ptr<Vertex> vertex;
-		std::shared_ptr<Sector> sector;
-		std::shared_ptr<SideDef> sidedef;
-		std::shared_ptr<LineDef> linedef;
+		// the object while it is out of the document (deleted, or not
+		// inserted yet). The document keeps its objects by value, so
+		// these are copies moved in and out of it.
+		std::unique_ptr<Thing> thing;
+		std::unique_ptr<Vertex> vertex;
+		std::unique_ptr<Sector> sector;
+		std::unique_ptr<SideDef> sidedef;
+		std::unique_ptr<LineDef> linedef;
+		std::unique_ptr<Batch> batch;	// if set, objnum and the above are unused
 		int value = 0;
 
 		void apply(Basis &basis);
 		void destroy();
 
 	private:
+		void notifyDelete(Basis &basis, int num) const;
+		void notifyInsert(Basis &basis, int num) const;
+
 		void rawChange(Basis &basis);
 
 		void rawDelete(Basis &basis);
-		std::shared_ptr<Thing> rawDeleteThing(Document &doc) const;
-		std::shared_ptr<Vertex> rawDeleteVertex(Document &doc) const;
-		std::shared_ptr<Sector> rawDeleteSector(Document &doc) const;
-		std::shared_ptr<SideDef> rawDeleteSidedef(Document &doc) const;
-		std::shared_ptr<LineDef> rawDeleteLinedef(Document &doc) const;
+		std::unique_ptr<Thing> rawDeleteThing(Document &doc) const;
+		std::unique_ptr<Vertex> rawDeleteVertex(Document &doc) const;
+		std::unique_ptr<Sector> rawDeleteSector(Document &doc) const;
+		std::unique_ptr<SideDef> rawDeleteSidedef(Document &doc) const;
+		std::unique_ptr<LineDef> rawDeleteLinedef(Document &doc) const;
+		void rawDeleteBatch(Document &doc);
 
 		void rawInsert(Basis &basis);
 		void rawInsertThing(Document &doc);
@@ -143,6 +165,7 @@ private:
 		void rawInsertSector(Document &doc);
 		void rawInsertSidedef(Document &doc);
 		void rawInsertLinedef(Document &doc);
+		void rawInsertBatch(Document &doc);
 
 		void deleteFinally();
 	};
@@ -251,6 +274,7 @@ private:
 	bool changeSidedef(int side, SideDef::StringIDAddress field, StringID value);
 	bool changeLinedef(int line, byte field, int value);
 	void del(ObjType type, int objnum);
+	void del(ObjType type, std::vector<int> objnums);
 	void end();
 	void abort(bool keepChanges);
 
@@ -342,6 +366,11 @@ public:
 		basis.del(type, objnum);
 	}
 
+	void del(ObjType type, const std::vector<int> &objnums)
+	{
+		basis.del(type, objnums);
+	}
+
 	void setAbort(bool keepChanges)
 	{
 		abort = true;
@@ -365,7 +394,7 @@ const char *NameForObjectType(ObjType type, bool plural = false);
 StringID BA_InternaliseString(const SString &str);
 
 // get the string from the basis string table.
-SString BA_GetString(StringID offset) noexcept;
+const SString &BA_GetString(StringID offset) noexcept;
 
 #endif  /* __EUREKA_E_BASIS_H__ */
 
@@ -46,6 +46,9 @@ extern int vertex_radius(double scale);
 
 #define FASTOPP_DIST  320
 
+// initial half-width of the spatial searches used by ray casting
+#define HOVER_CAST_SPAN  256.0
+
 
 struct opp_test_state_t
 {
@@ -79,7 +82,7 @@ public:
 		// sure the casting line is not integral (i.e. lies between two lines
 		// on the unit grid) so that we never directly hit a vertex.
 
-		const auto L = doc.linedefs[ld];
+		const LineDef *L = doc.linedefs[ld];
 
 		dx = doc.getEnd(*L).x() - doc.getStart(*L).x();
 		dy = doc.getEnd(*L).y() - doc.getStart(*L).y();
@@ -204,7 +207,7 @@ void fastopp_node_c::AddLine_X(int ld, int x1, int x2)
 
 void fastopp_node_c::AddLine_X(int ld)
 {
-	const auto L = doc.linedefs[ld];
+	const LineDef *L = doc.linedefs[ld];
 
 	// can ignore purely vertical lines
 	if (doc.isVertical(*L))
@@ -237,7 +240,7 @@ void fastopp_node_c::AddLine_Y(int ld, int y1, int y2)
 
 void fastopp_node_c::AddLine_Y(int ld)
 {
-	const auto L = doc.linedefs[ld];
+	const LineDef *L = doc.linedefs[ld];
 
 	// can ignore purely horizonal lines
 	if (doc.isHorizontal(*L))
@@ -350,40 +353,59 @@ int hover::getClosestLine_CastingHoriz(const Document &doc, v2double_t pos, Side
 	// avoid hitting vertices.
 	pos.y += 0.04;
 
-	for(int n = 0; n < doc.numLinedefs(); n++)
+	// widen the search until the best crossing lies within it (any line
+	// crossing the ray within the search span is a candidate).
+	std::vector<int> list;
+
+	for(double span = HOVER_CAST_SPAN; ; span *= 2)
 	{
-		v2double_t lpos1, lpos2;
-		lpos1.y = doc.getStart(*doc.linedefs[n]).y();
-		lpos2.y = doc.getEnd(*doc.linedefs[n]).y();
+		v2double_t lo = { pos.x - span, pos.y };
+		v2double_t hi = { pos.x + span, pos.y };
 
-		// ignore purely horizontal lines
-		if(lpos1.y == lpos2.y)
-			continue;
+		doc.spatial.findLinedefs(lo, hi, list);
 
-		// does the linedef cross the horizontal ray?
-		if(std::min(lpos1.y, lpos2.y) >= pos.y || std::max(lpos1.y, lpos2.y) <= pos.y)
-			continue;
+		for(int n : list)
+		{
+			v2double_t lpos1, lpos2;
+			lpos1.y = doc.getStart(*doc.linedefs[n]).y();
+			lpos2.y = doc.getEnd(*doc.linedefs[n]).y();
+
+			// ignore purely horizontal lines
+			if(lpos1.y == lpos2.y)
+				continue;
 
-		lpos1.x = doc.getStart(*doc.linedefs[n]).x();
-		lpos2.x = doc.getEnd(*doc.linedefs[n]).x();
+			// does the linedef cross the horizontal ray?
+			if(std::min(lpos1.y, lpos2.y) >= pos.y || std::max(lpos1.y, lpos2.y) <= pos.y)
+				continue;
 
-		double dist = lpos1.x - pos.x + (lpos2.x - lpos1.x) * (pos.y - lpos1.y) / (lpos2.y - lpos1.y);
+			lpos1.x = doc.getStart(*doc.linedefs[n]).x();
+			lpos2.x = doc.getEnd(*doc.linedefs[n]).x();
 
-		if(fabs(dist) < best_dist)
-		{
-			best_match = n;
-			best_dist = fabs(dist);
+			double dist = lpos1.x - pos.x + (lpos2.x - lpos1.x) * (pos.y - lpos1.y) / (lpos2.y - lpos1.y);
 
-			if(side)
+			if(fabs(dist) < best_dist)
 			{
-				if(best_dist < 0.01)
-					*side = Side::neither;  // on the line
-				else if((lpos1.y > lpos2.y) == (dist > 0))
-					*side = Side::right;  // right side
-				else
-					*side = Side::left; // left side
+				best_match = n;
+				best_dist = fabs(dist);
+
+				if(side)
+				{
+					if(best_dist < 0.01)
+						*side = Side::neither;  // on the line
+					else if((lpos1.y > lpos2.y) == (dist > 0))
+						*side = Side::right;  // right side
+					else
+						*side = Side::left; // left side
+				}
 			}
 		}
+
+		// stop once the ray has passed every line
+		if(best_dist <= span || doc.spatial.coversLinedefs({ lo.x, -HUGE_VAL }, { hi.x, HUGE_VAL }))
+			break;
+
+		best_match = -1;
+		best_dist = 9e9;
 	}
 
 	return best_match;
@@ -401,40 +423,57 @@ static int getClosestLine_CastingVert(const Document &doc, v2double_t pos, Side
 	// avoid hitting vertices.
 	pos.x += 0.04;
 
-	for(int n = 0; n < doc.numLinedefs(); n++)
+	std::vector<int> list;
+
+	for(double span = HOVER_CAST_SPAN; ; span *= 2)
 	{
-		v2double_t lpos1, lpos2;
-		lpos1.x = doc.getStart(*doc.linedefs[n]).x();
-		lpos2.x = doc.getEnd(*doc.linedefs[n]).x();
+		v2double_t lo = { pos.x, pos.y - span };
+		v2double_t hi = { pos.x, pos.y + span };
 
-		// ignore purely vertical lines
-		if(lpos1.x == lpos2.x)
-			continue;
+		doc.spatial.findLinedefs(lo, hi, list);
 
-		// does the linedef cross the vertical ray?
-		if(std::min(lpos1.x, lpos2.x) >= pos.x || std::max(lpos1.x, lpos2.x) <= pos.x)
-			continue;
+		for(int n : list)
+		{
+			v2double_t lpos1, lpos2;
+			lpos1.x = doc.getStart(*doc.linedefs[n]).x();
+			lpos2.x = doc.getEnd(*doc.linedefs[n]).x();
 
-		lpos1.y = doc.getStart(*doc.linedefs[n]).y();
-		lpos2.y = doc.getEnd(*doc.linedefs[n]).y();
+			// ignore purely vertical lines
+			if(lpos1.x == lpos2.x)
+				continue;
 
-		double dist = lpos1.y - pos.y + (lpos2.y - lpos1.y) * (pos.x - lpos1.x) / (lpos2.x - lpos1.x);
+			// does the linedef cross the vertical ray?
+			if(std::min(lpos1.x, lpos2.x) >= pos.x || std::max(lpos1.x, lpos2.x) <= pos.x)
+				continue;
 
-		if(fabs(dist) < best_dist)
-		{
-			best_match = n;
-			best_dist = fabs(dist);
+			lpos1.y = doc.getStart(*doc.linedefs[n]).y();
+			lpos2.y = doc.getEnd(*doc.linedefs[n]).y();
 
-			if(side)
+			double dist = lpos1.y - pos.y + (lpos2.y - lpos1.y) * (pos.x - lpos1.x) / (lpos2.x - lpos1.x);
+
+			if(fabs(dist) < best_dist)
 			{
-				if(best_dist < 0.01)
-					*side = Side::neither;  // on the line
-				else if((lpos1.x > lpos2.x) == (dist < 0))
-					*side = Side::right;  // right side
-				else
-					*side = Side::left; // left side
+				best_match = n;
+				best_dist = fabs(dist);
+
+				if(side)
+				{
+					if(best_dist < 0.01)
+						*side = Side::neither;  // on the line
+					else if((lpos1.x > lpos2.x) == (dist < 0))
+						*side = Side::right;  // right side
+					else
+						*side = Side::left; // left side
+				}
 			}
 		}
+
+		// stop once the ray has passed every line
+		if(best_dist <= span || doc.spatial.coversLinedefs({ -HUGE_VAL, lo.y }, { HUGE_VAL, hi.y }))
+			break;
+
+		best_match = -1;
+		best_dist = 9e9;
 	}
 
 	return best_match;
@@ -457,7 +496,7 @@ Objid hover::findSplitLine(const Document &doc, MapFormat format, const Editor_S
 	if(!out.valid())
 		return Objid();
 
-	const auto L = doc.linedefs[out.num];
+	const LineDef *L = doc.linedefs[out.num];
 
 	v2double_t v1 = doc.getStart(*L).xy();
 	v2double_t v2 = doc.getEnd(*L).xy();
@@ -466,7 +505,7 @@ Objid hover::findSplitLine(const Document &doc, MapFormat format, const Editor_S
 
 	if(grid.ratio > 0 && edit.action == EditorAction::drawLine)
 	{
-		const auto V = doc.vertices[edit.drawLine.from.num];
+		const Vertex *V = doc.vertices[edit.drawLine.from.num];
 
 		// convert ratio into a vector, use it to intersect the linedef
 		v2double_t ppos1 = V->xy();
@@ -624,39 +663,59 @@ FastOppositeTree::FastOppositeTree(Instance &inst)
 //
 bool hover::isPointOutsideOfMap(const Document &doc, const v2double_t &v)
 {
-	// this keeps track of directions tested
-	int dirs = 0;
-
 	// most end-points will be integral, so look in-between
 	v2double_t v2 = v + v2double_t{ 0.04, 0.04 };
 
-	for(int n = 0; n < doc.numLinedefs(); n++)
+	std::vector<int> list;
+
+	// widen the search (a cross centered on the point) until a line
+	// has been hit in all four directions, or the whole map is covered.
+	for(double span = HOVER_CAST_SPAN; ; span *= 2)
 	{
-		v2double_t lv1 = doc.getStart(*doc.linedefs[n]).xy();
-		v2double_t lv2 = doc.getEnd(*doc.linedefs[n]).xy();
+		// this keeps track of directions tested
+		int dirs = 0;
+
+		v2double_t lo = v2 - v2double_t(span);
+		v2double_t hi = v2 + v2double_t(span);
 
-		// does the linedef cross the horizontal ray?
-		if(std::min(lv1.y, lv2.y) < v2.y && std::max(lv1.y, lv2.y) > v2.y)
+		doc.spatial.findLinedefs({ lo.x, v2.y }, { hi.x, v2.y }, list);
+
+		for(int n : list)
 		{
-			double dist = lv1.x - v.x + (lv2.x - lv1.x) * (v2.y - lv1.y) / (lv2.y - lv1.y);
+			v2double_t lv1 = doc.getStart(*doc.linedefs[n]).xy();
+			v2double_t lv2 = doc.getEnd(*doc.linedefs[n]).xy();
 
-			dirs |= (dist < 0) ? 1 : 2;
+			// does the linedef cross the horizontal ray?
+			if(std::min(lv1.y, lv2.y) < v2.y && std::max(lv1.y, lv2.y) > v2.y)
+			{
+				double dist = lv1.x - v.x + (lv2.x - lv1.x) * (v2.y - lv1.y) / (lv2.y - lv1.y);
 
-			if(dirs == 15) return false;
+				dirs |= (dist < 0) ? 1 : 2;
+			}
 		}
 
-		// does the linedef cross the vertical ray?
-		if(std::min(lv1.x, lv2.x) < v2.x && std::max(lv1.x, lv2.x) > v2.x)
+		doc.spatial.findLinedefs({ v2.x, lo.y }, { v2.x, hi.y }, list);
+
+		for(int n : list)
 		{
-			double dist = lv1.y - v.y + (lv2.y - lv1.y) * (v2.x - lv1.x) / (lv2.x - lv1.x);
+			v2double_t lv1 = doc.getStart(*doc.linedefs[n]).xy();
+			v2double_t lv2 = doc.getEnd(*doc.linedefs[n]).xy();
 
-			dirs |= (dist < 0) ? 4 : 8;
+			// does the linedef cross the vertical ray?
+			if(std::min(lv1.x, lv2.x) < v2.x && std::max(lv1.x, lv2.x) > v2.x)
+			{
+				double dist = lv1.y - v.y + (lv2.y - lv1.y) * (v2.x - lv1.x) / (lv2.x - lv1.x);
 
-			if(dirs == 15) return false;
+				dirs |= (dist < 0) ? 4 : 8;
+			}
 		}
-	}
 
-	return true;
+		if(dirs == 15)
+			return false;
+
+		if(doc.spatial.coversLinedefs(lo, hi))
+			return true;
+	}
 }
 
 #define CROSSING_EPSILON  0.2
@@ -692,12 +751,17 @@ void Hover::findCrossingPoints(crossing_state_c &cross,
 
 	/* must do all vertices FIRST */
 
-	for(int v = 0; v < doc.numVertices(); v++)
+	std::vector<int> list;
+	doc.spatial.findVertices(
+		{ std::min(p1.x, p2.x) - close_dist, std::min(p1.y, p2.y) - close_dist },
+		{ std::max(p1.x, p2.x) + close_dist, std::max(p1.y, p2.y) + close_dist }, list);
+
+	for(int v : list)
 	{
 		if(v == possible_v1 || v == possible_v2)
 			continue;
 
-		const auto VC = doc.vertices[v];
+		const Vertex *VC = doc.vertices[v];
 
 		// ignore vertices at same coordinates as v1 or v2
 		if(VC->Matches(FFixedPoint(p1.x), FFixedPoint(p1.y)) ||
@@ -763,9 +827,12 @@ static Objid getNearestThing(const Document &doc, const ConfigData &config,
 	int best = -1;
 	thing_comparer_t best_comp;
 
-	for(int n = 0; n < doc.numThings(); n++)
+	std::vector<int> list;
+	doc.spatial.findThings(lpos, hpos, list);
+
+	for(int n : list)
 	{
-		const auto thing = doc.things[n];
+		const Thing *thing = doc.things[n];
 		v2double_t tpos = thing->xy();
 
 		// filter out things that are outside the search bbox.
@@ -820,7 +887,10 @@ static Objid getNearestVertex(const Document &doc, const Grid_State_c &grid, con
 	int    best = -1;
 	double best_dist = 9e9;
 
-	for(int n = 0; n < doc.numVertices(); n++)
+	std::vector<int> list;
+	doc.spatial.findVertices(lpos, hpos, list);
+
+	for(int n : list)
 	{
 		v2double_t vpos = doc.vertices[n]->xy();
 
@@ -865,7 +935,10 @@ static Objid getNearestLinedef(const Document &doc, const Grid_State_c &grid, co
 	int    best = -1;
 	double best_dist = 9e9;
 
-	for(int n = 0; n < doc.numLinedefs(); n++)
+	std::vector<int> list;
+	doc.spatial.findLinedefs(lpos, hpos, list);
+
+	for(int n : list)
 	{
 		v2double_t pos1 = doc.getStart(*doc.linedefs[n]).xy();
 		v2double_t pos2 = doc.getEnd(*doc.linedefs[n]).xy();
@@ -1004,9 +1077,12 @@ static Objid getNearestSplitLine(const Document &doc, MapFormat format, const Gr
 
 	double too_small = (format == MapFormat::udmf) ? 0.2 : 4.0;
 
-	for(int n = 0; n < doc.numLinedefs(); n++)
+	std::vector<int> list;
+	doc.spatial.findLinedefs(lpos, hpos, list);
+
+	for(int n : list)
 	{
-		const auto L = doc.linedefs[n];
+		const LineDef *L = doc.linedefs[n];
 
 		if(L->start == ignore_vert || L->end == ignore_vert)
 			continue;
@@ -1070,9 +1146,12 @@ void Hover::findCrossingLines(crossing_state_c &cross, const v2double_t &pos1, i
 	};
 
 
-	for (int ld = 0 ; ld < doc.numLinedefs() ; ld++)
+	std::vector<int> list;
+	doc.spatial.findLinedefs(bbox1, bbox2, list);
+
+	for (int ld : list)
 	{
-		const auto L = doc.linedefs[ld];
+		const LineDef *L = doc.linedefs[ld];
 
 		v2double_t lpos1 = doc.getStart(*L).xy();
 		v2double_t lpos2 = doc.getEnd(*L).xy();
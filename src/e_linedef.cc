@@ -54,7 +54,7 @@ bool LinedefModule::linedefAlreadyExists(int v1, int v2) const
 {
 	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
-		const auto L = doc.linedefs[n];
+		const LineDef *L = doc.linedefs[n];
 
 		if (L->start == v1 && L->end == v2) return true;
 		if (L->start == v2 && L->end == v1) return true;
@@ -72,7 +72,7 @@ bool LinedefModule::linedefAlreadyExists(int v1, int v2) const
 //
 inline const LineDef * LinedefModule::pointer(const Objid& obj) const
 {
-	return doc.linedefs[obj.num].get();
+	return doc.linedefs[obj.num];
 }
 
 //
@@ -84,7 +84,7 @@ inline const SideDef * LinedefModule::sidedefPointer(const Objid& obj) const
 
 	int sd = pointer(obj)->WhatSideDef(where);
 
-	return (sd >= 0) ? doc.sidedefs[sd].get() : nullptr;
+	return (sd >= 0) ? doc.sidedefs[sd] : nullptr;
 }
 
 
@@ -341,9 +341,9 @@ void LinedefModule::determineAdjoiner(Objid& result,
 
 	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
-		const auto N = doc.linedefs[n];
+		const LineDef *N = doc.linedefs[n];
 
-		if (N.get() == L)
+		if (N == L)
 			continue;
 
 		if (doc.isZeroLength(*N))
@@ -919,11 +919,11 @@ static int getTileWidth(const SideDef &side, const ImageSet &images, const Confi
 //
 int LinedefModule::splitLinedefAtVertex(EditOperation &op, int ld, int new_v) const
 {
-	const auto L = doc.linedefs[ld];
-
 	// create new linedef
 	int new_l = op.addNew(ObjType::linedefs);
 
+	// (adding a linedef can move the others, so look it up afterwards)
+	const auto L = doc.linedefs[ld];
 	auto L2 = doc.linedefs[new_l];
 
 	// it is OK to directly set fields of newly created objects
@@ -1155,7 +1155,7 @@ void LinedefModule::removeSidedef(EditOperation &op, int ld, Side ld_side) const
 
 	// FIXME: if sidedef is shared, either don't modify it _OR_ duplicate it
 
-	const SideDef *SD = doc.sidedefs[other_sd].get();
+	const SideDef *SD = doc.sidedefs[other_sd];
 
 	StringID new_tex = BA_InternaliseString(inst.conf.default_wall_tex);
 
@@ -1166,7 +1166,7 @@ void LinedefModule::removeSidedef(EditOperation &op, int ld, Side ld_side) const
 		new_tex = SD->upper_tex;
 	else if (gone_sd >= 0)
 	{
-		SD = doc.sidedefs[gone_sd].get();
+		SD = doc.sidedefs[gone_sd];
 
 		if (! is_null_tex(SD->LowerTex()))
 			new_tex = SD->lower_tex;
@@ -1253,7 +1253,7 @@ void Instance::commandLinedefMergeTwo()
 //
 void linemod::moveCoordOntoLinedef(const Document &doc, int ld, v2double_t &v)
 {
-	const auto L = doc.linedefs[ld];
+	const LineDef *L = doc.linedefs[ld];
 
 	v2double_t v1 = doc.getStart(*L).xy();
 	v2double_t v2 = doc.getEnd(*L).xy();
@@ -1278,7 +1278,7 @@ bool LinedefModule::linedefStartWillBeMoved(int ld, selection_c &list) const
 {
 	for (sel_iter_c it(list) ; !it.done() ; it.next())
 	{
-		const auto L = doc.linedefs[*it];
+		const LineDef *L = doc.linedefs[*it];
 
 		if (*it != ld && L->end == doc.linedefs[ld]->start)
 			return true;
@@ -1294,7 +1294,7 @@ bool LinedefModule::linedefEndWillBeMoved(int ld, selection_c &list) const
 {
 	for (sel_iter_c it(list) ; !it.done() ; it.next())
 	{
-		const auto L = doc.linedefs[*it];
+		const LineDef *L = doc.linedefs[*it];
 
 		if (*it != ld && L->start == doc.linedefs[ld]->end)
 			return true;
@@ -1386,7 +1386,7 @@ void LinedefModule::setLinedefsLength(int new_len) const
 
 	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
-		const auto L = doc.linedefs[n];
+		const LineDef *L = doc.linedefs[n];
 
 		angles[n] = atan2(doc.getEnd(*L).y() - doc.getStart(*L).y(), doc.getEnd(*L).x() - doc.getStart(*L).x());
 	}
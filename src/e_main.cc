@@ -274,8 +274,8 @@ void Instance::UpdateHighlight()
 		if (grid.ratio > 0 && edit.action == EditorAction::drawLine &&
 			edit.mode == ObjType::vertices && edit.highlight.valid())
 		{
-			const auto V = level.vertices[edit.highlight.num];
-			const auto S = level.vertices[edit.drawLine.from.num];
+			const Vertex *V = level.vertices[edit.highlight.num];
+			const Vertex *S = level.vertices[edit.drawLine.from.num];
 
 			v2double_t vpos = V->xy();
 
@@ -376,7 +376,7 @@ void Document::UpdateLevelBounds(int start_vert) noexcept
 {
 	for(int i = start_vert; i < numVertices(); i++)
 	{
-		const auto V = vertices[i];
+		const Vertex *V = vertices[i];
 
 		if (V->x() < Map_bound1.x) Map_bound1.x = V->x();
 		if (V->y() < Map_bound1.y) Map_bound1.y = V->y();
@@ -418,6 +418,8 @@ void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
 		if (new_vertex_minimum < 0 || objnum < new_vertex_minimum)
 			new_vertex_minimum = objnum;
 	}
+
+	sector_info_cache.NotifyInsert(type, objnum);
 }
 
 void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
@@ -432,6 +434,8 @@ void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
 			Editor_ClearAction();
 		}
 	}
+
+	sector_info_cache.NotifyDelete(type, objnum);
 }
 
 void Instance::MapStuff_NotifyChange(ObjType type, int objnum, int field)
@@ -442,26 +446,16 @@ void Instance::MapStuff_NotifyChange(ObjType type, int objnum, int field)
 		//       map bounds when only moving a few vertices.
 		moved_vertex_count++;
 
-		const auto V = level.vertices[objnum];
+		const Vertex *V = level.vertices[objnum];
 
 		if (V->x() < level.Map_bound1.x) level.Map_bound1.x = V->x();
 		if (V->y() < level.Map_bound1.y) level.Map_bound1.y = V->y();
 
 		if (V->x() > level.Map_bound2.x) level.Map_bound2.x = V->x();
 		if (V->y() > level.Map_bound2.y) level.Map_bound2.y = V->y();
-
-		// TODO: only invalidate sectors touching vertex
-		Subdiv_InvalidateAll();
 	}
 
-	if (type == ObjType::sidedefs && field == SideDef::F_SECTOR)
-		Subdiv_InvalidateAll();
-
-	if (type == ObjType::linedefs && (field == LineDef::F_LEFT || field == LineDef::F_RIGHT || field == LineDef::F_START || field == LineDef::F_END))
-		Subdiv_InvalidateAll();
-
-	if (type == ObjType::sectors && (field == Sector::F_FLOORH || field == Sector::F_CEILH))
-		Subdiv_InvalidateAll();
+	sector_info_cache.NotifyChange(type, objnum, field);
 }
 
 void Instance::MapStuff_NotifyEnd()
@@ -474,6 +468,9 @@ void Instance::MapStuff_NotifyEnd()
 	{
 		level.UpdateLevelBounds(new_vertex_minimum);
 	}
+
+	if (main_win)
+		main_win->canvas->InvalidateMap();
 }
 
 
@@ -495,7 +492,7 @@ void Instance::ObjectBox_NotifyInsert(ObjType type, int objnum)
 {
 	invalidated_totals = true;
 
-	if (type != edit.mode)
+	if (type != edit.mode || !main_win)
 		return;
 
 	if (objnum > main_win->GetPanelObjNum())
@@ -509,7 +506,7 @@ void Instance::ObjectBox_NotifyDelete(ObjType type, int objnum)
 {
 	invalidated_totals = true;
 
-	if (type != edit.mode)
+	if (type != edit.mode || !main_win)
 		return;
 
 	if (objnum > main_win->GetPanelObjNum())
@@ -643,7 +640,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 	{
 		for (int t = 0 ; t < doc.numThings() ; t++)
 		{
-			const auto T = doc.things[t];
+			const Thing *T = doc.things[t];
 
 			Objid obj = hover::getNearestSector(doc, T->xy());
 
@@ -660,7 +657,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 	{
 		for (int l = 0 ; l < doc.numLinedefs(); l++)
 		{
-			const auto L = doc.linedefs[l];
+			const LineDef *L = doc.linedefs[l];
 
 			if ( (doc.getRight(*L) && src.get(doc.getRight(*L)->sector)) ||
 				 (doc.getLeft(*L)  && src.get(doc.getLeft(*L)->sector)) )
@@ -691,7 +688,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 	{
 		for (sel_iter_c it(src); ! it.done(); it.next())
 		{
-			const auto L = doc.linedefs[*it];
+			const LineDef *L = doc.linedefs[*it];
 
 			if (doc.getRight(*L)) dest.set(L->right);
 			if (doc.getLeft(*L))  dest.set(L->left);
@@ -703,7 +700,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 	{
 		for (int n = 0 ; n < doc.numSidedefs(); n++)
 		{
-			const auto SD = doc.sidedefs[n];
+			const SideDef *SD = doc.sidedefs[n];
 
 			if (src.get(SD->sector))
 				dest.set(n);
@@ -716,7 +713,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 	{
 		for (sel_iter_c it(src); ! it.done(); it.next())
 		{
-			const auto L = doc.linedefs[*it];
+			const LineDef *L = doc.linedefs[*it];
 
 			dest.set(L->start);
 			dest.set(L->end);
@@ -730,7 +727,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 		// select all linedefs that have both ends selected
 		for (int l = 0 ; l < doc.numLinedefs(); l++)
 		{
-			const auto L = doc.linedefs[l];
+			const LineDef *L = doc.linedefs[l];
 
 			if (src.get(L->start) && src.get(L->end))
 			{
@@ -754,7 +751,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 
 	for (l = 0 ; l < doc.numLinedefs() ; l++)
 	{
-		const auto L = doc.linedefs[l];
+		const LineDef *L = doc.linedefs[l];
 
 		if (doc.getRight(*L)) dest.set(doc.getRight(*L)->sector);
 		if (doc.getLeft(*L))  dest.set(doc.getLeft(*L)->sector);
@@ -764,7 +761,7 @@ void ConvertSelection(const Document &doc, const selection_c & src, selection_c
 
 	for (l = 0 ; l < doc.numLinedefs(); l++)
 	{
-		const auto L = doc.linedefs[l];
+		const LineDef *L = doc.linedefs[l];
 
 		if (src.what_type() == ObjType::vertices)
 		{
@@ -794,7 +791,7 @@ static int Selection_FirstLine(const Document &doc, const selection_c &list)
 {
 	for (sel_iter_c it(list); ! it.done(); it.next())
 	{
-		const auto L = doc.linedefs[*it];
+		const LineDef *L = doc.linedefs[*it];
 
 		if (L->TwoSided())
 			return *it;
@@ -841,7 +838,7 @@ void SelectObjectsInBox(const Document &doc, selection_c *list, ObjType objtype,
 		case ObjType::things:
 			for (int n = 0 ; n < doc.numThings() ; n++)
 			{
-				const auto T = doc.things[n];
+				const Thing *T = doc.things[n];
 
 				v2double_t tpos = T->xy();
 
@@ -853,7 +850,7 @@ void SelectObjectsInBox(const Document &doc, selection_c *list, ObjType objtype,
 		case ObjType::vertices:
 			for (int n = 0 ; n < doc.numVertices(); n++)
 			{
-				const auto V = doc.vertices[n];
+				const Vertex *V = doc.vertices[n];
 
 				v2double_t vpos = V->xy();
 
@@ -865,7 +862,7 @@ void SelectObjectsInBox(const Document &doc, selection_c *list, ObjType objtype,
 		case ObjType::linedefs:
 			for (int n = 0 ; n < doc.numLinedefs(); n++)
 			{
-				const auto L = doc.linedefs[n];
+				const LineDef *L = doc.linedefs[n];
 
 				/* the two ends of the line must be in the box */
 				if(doc.getStart(*L).xy().inbounds(pos1, pos2) &&
@@ -883,7 +880,7 @@ void SelectObjectsInBox(const Document &doc, selection_c *list, ObjType objtype,
 
 			for (int n = 0 ; n < doc.numLinedefs(); n++)
 			{
-				const auto L = doc.linedefs[n];
+				const LineDef *L = doc.linedefs[n];
 
 				// Get the numbers of the sectors on both sides of the linedef
 				int s1 = doc.getRight(*L) ? doc.getRight(*L)->sector : -1;
@@ -62,10 +62,8 @@ int  config::new_sector_size = 128;
 //
 void ObjectsModule::del(EditOperation &op, const selection_c &list) const
 {
-	// we need to process the object numbers from highest to lowest,
-	// because each deletion invalidates all higher-numbered refs
-	// in the selection.  Our selection iterator cannot give us
-	// what we need, hence put them into a vector for sorting.
+	// deleting them together lets Basis renumber the references
+	// once, rather than after every single deletion.
 
 	if (list.empty())
 		return;
@@ -75,10 +73,7 @@ void ObjectsModule::del(EditOperation &op, const selection_c &list) const
 	for (sel_iter_c it(list) ; !it.done() ; it.next())
 		objnums.push_back(*it);
 
-	std::sort(objnums.begin(), objnums.end());
-
-	for (int i = (int)objnums.size()-1 ; i >= 0 ; i--)
-		op.del(list.what_type(), objnums[i]);
+	op.del(list.what_type(), objnums);
 }
 
 
@@ -112,7 +107,7 @@ void ObjectsModule::createSquare(EditOperation &op, int model) const
 
 		int new_ld = op.addNew(ObjType::linedefs);
 
-		auto L = doc.linedefs[new_ld];
+		LineDef *L = doc.linedefs[new_ld];
 
 		L->start = new_v;
 		L->end   = (i == 3) ? (new_v - 3) : new_v + 1;
@@ -890,7 +885,7 @@ int ObjectsModule::findLineBetweenLineAndVertex(int lineID, int vertID) const
 {
 	for(int i = 0; i < doc.numLinedefs(); ++i)
 	{
-		const auto otherLine = doc.linedefs[i];
+		const LineDef *otherLine = doc.linedefs[i];
 		if(!otherLine->TouchesVertex(vertID) || i == lineID)
 			continue;
 
@@ -1301,7 +1296,7 @@ void ObjectsModule::dragCountOnGridWorker(ObjType obj_type, int objnum, int *cou
 		case ObjType::sectors:
 			for (int n = 0 ; n < doc.numLinedefs(); n++)
 			{
-				const auto L = doc.linedefs[n];
+				const LineDef *L = doc.linedefs[n];
 
 				if (! doc.touchesSector(*L, objnum))
 					continue;
@@ -1348,7 +1343,7 @@ void ObjectsModule::dragUpdateCurrentDist(ObjType obj_type, int objnum, double *
 
 		case ObjType::linedefs:
 			{
-				const auto L = doc.linedefs[objnum];
+				const LineDef *L = doc.linedefs[objnum];
 
 				dragUpdateCurrentDist(ObjType::vertices, L->start, x, y, best_dist,
 									   ptr_x, ptr_y, only_grid);
@@ -1365,7 +1360,7 @@ void ObjectsModule::dragUpdateCurrentDist(ObjType obj_type, int objnum, double *
 
 			for (int n = 0 ; n < doc.numLinedefs(); n++)
 			{
-				const auto L = doc.linedefs[n];
+				const LineDef *L = doc.linedefs[n];
 
 				if (! doc.touchesSector(*L, objnum))
 					continue;
@@ -1565,7 +1560,7 @@ void ObjectsModule::calcBBox(const selection_c & list, v2double_t &pos1, v2doubl
 		{
 			for (sel_iter_c it(list) ; !it.done() ; it.next())
 			{
-				const auto T = doc.things[*it];
+				const Thing *T = doc.things[*it];
 				double Tx = T->x();
 				double Ty = T->y();
 
@@ -1584,7 +1579,7 @@ void ObjectsModule::calcBBox(const selection_c & list, v2double_t &pos1, v2doubl
 		{
 			for (sel_iter_c it(list) ; !it.done() ; it.next())
 			{
-				const auto V = doc.vertices[*it];
+				const Vertex *V = doc.vertices[*it];
 				double Vx = V->x();
 				double Vy = V->y();
 
@@ -1984,7 +1979,7 @@ void ObjectsModule::doScaleSectorHeights(EditOperation &op, const selection_c &l
 
 	for (sel_iter_c it(list) ; !it.done() ; it.next())
 	{
-		const auto S = doc.sectors[*it];
+		const Sector *S = doc.sectors[*it];
 
 		lz = std::min(lz, S->floorh);
 		hz = std::max(hz, S->ceilh);
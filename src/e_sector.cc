@@ -271,7 +271,7 @@ void SectorModule::linedefsBetweenSectors(selection_c *list, int sec1, int sec2)
 {
 	for (int i = 0 ; i < doc.numLinedefs() ; i++)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		if (! (doc.getLeft(*L) && doc.getRight(*L)))
 			continue;
@@ -287,14 +287,12 @@ void SectorModule::linedefsBetweenSectors(selection_c *list, int sec1, int sec2)
 
 void SectorModule::replaceSectorRefs(EditOperation &op, int old_sec, int new_sec) const
 {
-	for (int i = 0 ; i < doc.numSidedefs() ; i++)
-	{
-		const auto sd = doc.sidedefs[i];
+	std::vector<int> sides;
+	doc.adjacency.sidedefsOfSector(old_sec, sides);
 
-		if (sd->sector == old_sec)
-		{
-			op.changeSidedef(i, SideDef::F_SECTOR, new_sec);
-		}
+	for (int i : sides)
+	{
+		op.changeSidedef(i, SideDef::F_SECTOR, new_sec);
 	}
 }
 
@@ -440,7 +438,7 @@ double lineloop_c::TotalLength() const
 
 	for (unsigned int k = 0 ; k < lines.size() ; k++)
 	{
-		const auto L = doc.linedefs[lines[k]];
+		const LineDef *L = doc.linedefs[lines[k]];
 
 		result += doc.calcLength(*L);
 	}
@@ -492,7 +490,7 @@ int lineloop_c::NeighboringSector() const
 
 	for (unsigned int i = 0 ; i < lines.size() ; i++)
 	{
-		const auto L = doc.linedefs[lines[i]];
+		const LineDef *L = doc.linedefs[lines[i]];
 
 		// we assume here that SIDE_RIGHT == 0 - SIDE_LEFT
 		int sec = doc.getSectorID(*doc.linedefs[lines[i]], - sides[i]);
@@ -570,7 +568,7 @@ void lineloop_c::CalcBounds(double *x1, double *y1, double *x2, double *y2) cons
 
 	for (unsigned int i = 0 ; i < lines.size() ; i++)
 	{
-		const auto L = doc.linedefs[lines[i]];
+		const LineDef *L = doc.linedefs[lines[i]];
 
 		*x1 = std::min(*x1, std::min(doc.getStart(*L).x(), doc.getEnd(*L).x()));
 		*y1 = std::min(*y1, std::min(doc.getStart(*L).y(), doc.getEnd(*L).y()));
@@ -643,6 +641,8 @@ bool SectorModule::traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignor
 	// compute the average angle over all the lines
 	double average_angle = 0;
 
+	std::vector<int> vert_lines;
+
 	for (;;)
 	{
 		loop.push_back(ld, side);
@@ -658,13 +658,12 @@ bool SectorModule::traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignor
 		// it *can* be the exact same linedef (when hitting a dangling
 		// vertex).
 
-		for (int n = 0 ; n < doc.numLinedefs() ; n++)
+		doc.adjacency.linesAtVertex(cur_vert, vert_lines);
+
+		for (int n : vert_lines)
 		{
 			const auto N = doc.linedefs[n];
 
-			if (! N->TouchesVertex(cur_vert))
-				continue;
-
 			if (ignore_bare && !doc.getLeft(*N) && !doc.getRight(*N))
 				continue;
 
@@ -763,7 +762,10 @@ bool lineloop_c::LookForIsland()
 
 	int count = 0;
 
-	for (int ld = 0 ; ld < doc.numLinedefs() ; ld++)
+	std::vector<int> lines;
+	doc.spatial.findLinedefs({ bbox_x1, bbox_y1 }, { bbox_x2, bbox_y2 }, lines);
+
+	for (int ld : lines)
 	{
 		const auto L = doc.linedefs[ld];
 
@@ -868,7 +870,7 @@ void lineloop_c::Dump() const
 
 	for (unsigned int i = 0 ; i < lines.size() ; i++)
 	{
-		const auto L = doc.linedefs[lines[i]];
+		const LineDef *L = doc.linedefs[lines[i]];
 
 		gLog.debugPrintf("  %s of line #%d : (%f %f) --> (%f %f)\n",
 		            sides[i] == Side::left ? " LEFT" : "RIGHT",
@@ -881,7 +883,7 @@ void lineloop_c::Dump() const
 
 inline bool SectorModule::willBeTwoSided(int ld, Side side) const
 {
-	const auto L = doc.linedefs[ld];
+	const LineDef *L = doc.linedefs[ld];
 
 	if (L->WhatSideDef(side) < 0)
 	{
@@ -925,7 +927,7 @@ void SectorModule::determineNewTextures(lineloop_c& loop,
 			if (sd < 0)
 				continue;
 
-			const auto SD = doc.sidedefs[sd];
+			const SideDef *SD = doc.sidedefs[sd];
 
 			if (doc.linedefs[ld]->TwoSided())
 			{
@@ -962,7 +964,7 @@ void SectorModule::determineNewTextures(lineloop_c& loop,
 			continue;
 		}
 
-		const auto SD = doc.sidedefs[sd];
+		const SideDef *SD = doc.sidedefs[sd];
 
 		if (doc.linedefs[ld]->TwoSided())
 		{
@@ -1228,16 +1230,29 @@ bool SectorModule::assignSectorToSpace(EditOperation &op, const v2double_t &map,
 	doc.linemod.flipLinedefGroup(op, &flip);
 
 	// detect any sectors which have become unused, and delete them
-	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	std::vector<int> still_used;
+	std::vector<int> sides;
+	std::vector<int> lines;
+
+	for (sel_iter_c it(unused) ; !it.done() ; it.next())
 	{
-		const auto L = doc.linedefs[n];
+		doc.adjacency.sidedefsOfSector(*it, sides);
+
+		for (int sd : sides)
+		{
+			doc.adjacency.linesOfSidedef(sd, lines);
 
-		if (doc.getSectorID(*L, Side::left) >= 0)
-			unused.clear(doc.getSectorID(*L, Side::left));
-		if (doc.getSectorID(*L, Side::right) >= 0)
-			unused.clear(doc.getSectorID(*L, Side::right));
+			if (! lines.empty())
+			{
+				still_used.push_back(*it);
+				break;
+			}
+		}
 	}
 
+	for (int sec : still_used)
+		unused.clear(sec);
+
 	doc.objects.del(op, unused);
 
 	return true;
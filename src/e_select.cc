@@ -301,21 +301,6 @@ static WallContinuity matchingWallHeights(const Instance &inst, const LineDef &s
 	return result.moveLeft(nextSide);
 }
 
-static std::vector<std::vector<int>> makeVertexLineMap(const Document &doc)
-{
-	std::vector<std::vector<int>> result;
-	result.resize(doc.numVertices());
-	for(int i = 0; i < doc.numLinedefs(); ++i)
-	{
-		const auto line = doc.linedefs[i];
-		for(int vertNum : {line->start, line->end})
-			if(doc.isVertex(vertNum))
-				result[vertNum].push_back(i);
-	}
-	return result;
-}
-
-
 static void selectNeighborLines(Instance &inst, int objnum, byte parts, WallContinuity (*func)(
 	const Instance &inst, const LineDef &source, Side sourceSide, const LineDef &next, 
 	Side nextSide))
@@ -324,16 +309,16 @@ static void selectNeighborLines(Instance &inst, int objnum, byte parts, WallCont
 	if(!doc.isLinedef(objnum) || !(parts & (PART_RT_ALL | PART_LF_ALL)))
 		return;
 
-	auto vertLineMap = makeVertexLineMap(doc);
+	std::vector<int> vertLines;
 
-	const auto source = doc.linedefs[objnum];
+	const LineDef *source = doc.linedefs[objnum];
 	struct Entry
 	{
 		const LineDef *line;
 		byte parts;
 	};
 	std::queue<Entry> queue;
-	queue.push({source.get(), parts});
+	queue.push({source, parts});
 
 	// Also select the current line
 	inst.edit.Selected->set_ext(objnum, inst.edit.Selected->get_ext(objnum) | parts);
@@ -345,10 +330,11 @@ static void selectNeighborLines(Instance &inst, int objnum, byte parts, WallCont
 
 		for(int vertNum : {entry.line->start, entry.line->end})
 		{
-			for(int neigh : vertLineMap[vertNum])
+			doc.adjacency.linesAtVertex(vertNum, vertLines);
+			for(int neigh : vertLines)
 			{
-				const auto otherLine = doc.linedefs[neigh];
-				if(otherLine.get() == entry.line)
+				const LineDef *otherLine = doc.linedefs[neigh];
+				if(otherLine == entry.line)
 					continue;
 				bool flipped = otherLine->start == entry.line->start ||
 							   otherLine->end == entry.line->end;
@@ -367,7 +353,7 @@ static void selectNeighborLines(Instance &inst, int objnum, byte parts, WallCont
 						if((otherCurrentlySelected & otherParts) < otherParts)
 						{
 							inst.edit.Selected->set_ext(neigh, otherCurrentlySelected | otherParts);
-							queue.push({otherLine.get(), otherParts});
+							queue.push({otherLine, otherParts});
 						}
 					}
 				}
@@ -378,7 +364,7 @@ static void selectNeighborLines(Instance &inst, int objnum, byte parts, WallCont
 
 void Instance::SelectNeighborSectors(int objnum, SelectNeighborCriterion option, byte parts)
 {
-	const auto sector1 = level.sectors[objnum];
+	const Sector *sector1 = level.sectors[objnum];
 
 	for (const auto &line : level.linedefs)
 	{
@@ -86,8 +86,8 @@ void Instance::CMD_TH_SpinThings()
 
 static bool ThingsAtSameLoc(const Document &doc, int th1, int th2)
 {
-	const auto T1 = doc.things[th1];
-	const auto T2 = doc.things[th2];
+	const Thing *T1 = doc.things[th1];
+	const Thing *T2 = doc.things[th2];
 
 	double dx = fabs(T1->x() - T2->x());
 	double dy = fabs(T1->y() - T2->y());
@@ -45,17 +45,12 @@
 #include "w_rawdef.h"
 
 #include <algorithm>
+#include <iterator>
 
 
 int VertexModule::findExact(FFixedPoint fx, FFixedPoint fy) const
 {
-	for (int i = 0 ; i < doc.numVertices() ; i++)
-	{
-		if (doc.vertices[i]->Matches(fx, fy))
-			return i;
-	}
-
-	return -1;  // not found
+	return doc.adjacency.vertexAt(fx, fy);
 }
 
 
@@ -66,9 +61,12 @@ int VertexModule::findDragOther(int v_num) const
 
 	int fallback = -1;
 
-	for (int i = 0 ; i < doc.numLinedefs() ; i++)
+	std::vector<int> lines;
+	doc.adjacency.linesAtVertex(v_num, lines);
+
+	for (int i : lines)
 	{
-		const auto L = doc.linedefs[i];
+		const LineDef *L = doc.linedefs[i];
 
 		if (L->end == v_num)
 			return L->start;
@@ -83,17 +81,7 @@ int VertexModule::findDragOther(int v_num) const
 
 int VertexModule::howManyLinedefs(int v_num) const
 {
-	int count = 0;
-
-	for (int n = 0 ; n < doc.numLinedefs() ; n++)
-	{
-		const auto L = doc.linedefs[n];
-
-		if (L->start == v_num || L->end == v_num)
-			count++;
-	}
-
-	return count;
+	return doc.adjacency.countLinesAtVertex(v_num);
 }
 
 
@@ -189,8 +177,14 @@ void VertexModule::doMergeVertex(EditOperation &op, int v1, int v2, selection_c&
 	// check if two linedefs would overlap after the merge
 	// [ but ignore lines already marked for deletion ]
 
+	std::vector<int> v1_lines;
+	std::vector<int> v2_lines;
+
+	doc.adjacency.linesAtVertex(v1, v1_lines);
+	doc.adjacency.linesAtVertex(v2, v2_lines);
+
 	int sandwichesMerged = 0;
-	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	for (int n : v1_lines)
 	{
 		const auto L = doc.linedefs[n];
 
@@ -204,12 +198,12 @@ void VertexModule::doMergeVertex(EditOperation &op, int v1, int v2, selection_c&
 
 		int found = -1;
 
-		for (int k = 0 ; k < doc.numLinedefs(); k++)
+		for (int k : v2_lines)
 		{
 			if (k == n)
 				continue;
 
-			const auto K = doc.linedefs[k];
+			const LineDef *K = doc.linedefs[k];
 
 			if ((K->start == v3 && K->end == v2) ||
 				(K->start == v2 && K->end == v3))
@@ -230,7 +224,13 @@ void VertexModule::doMergeVertex(EditOperation &op, int v1, int v2, selection_c&
 	// update all linedefs which use V1 to use V2 instead, and
 	// delete any line that exists between the two vertices.
 
-	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	std::vector<int> lines;
+	doc.adjacency.linesAtVertex(v1, v1_lines);
+	doc.adjacency.linesAtVertex(v2, v2_lines);
+	std::set_union(v1_lines.begin(), v1_lines.end(), v2_lines.begin(), v2_lines.end(),
+				   std::back_inserter(lines));
+
+	for (int n : lines)
 	{
 		const auto L = doc.linedefs[n];
 
@@ -426,7 +426,7 @@ bool VertexModule::tryFixDangler(int v_num) const
 
 void VertexModule::calcDisconnectCoord(const LineDef *L, int v_num, double *x, double *y) const
 {
-	const auto V = doc.vertices[v_num];
+	const Vertex *V = doc.vertices[v_num];
 
 	double dx = doc.getEnd(*L).x() - doc.getStart(*L).x();
 	double dy = doc.getEnd(*L).y() - doc.getStart(*L).y();
@@ -467,14 +467,17 @@ void VertexModule::doDisconnectVertex(EditOperation &op, int v_num, int num_line
 {
 	int which = 0;
 
-	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	std::vector<int> lines;
+	doc.adjacency.linesAtVertex(v_num, lines);
+
+	for (int n : lines)
 	{
 		const auto L = doc.linedefs[n];
 
 		if (L->start == v_num || L->end == v_num)
 		{
 			double new_x, new_y;
-			calcDisconnectCoord(L.get(), v_num, &new_x, &new_y);
+			calcDisconnectCoord(L, v_num, &new_x, &new_y);
 
 			// the _LAST_ linedef keeps the current vertex, the rest
 			// need a new one.
@@ -554,14 +557,12 @@ void VertexModule::doDisconnectLinedef(EditOperation &op, int ld, int which_vert
 
 	bool touches_non_sel = false;
 
-	for (int n = 0 ; n < doc.numLinedefs(); n++)
-	{
-		if (inst.edit.Selected->get(n))
-			continue;
+	std::vector<int> lines;
+	doc.adjacency.linesAtVertex(v_num, lines);
 
-		const auto N = doc.linedefs[n];
-
-		if (N->start == v_num || N->end == v_num)
+	for (int n : lines)
+	{
+		if (! inst.edit.Selected->get(n))
 		{
 			touches_non_sel = true;
 			break;
@@ -572,7 +573,7 @@ void VertexModule::doDisconnectLinedef(EditOperation &op, int ld, int which_vert
 		return;
 
 	double new_x, new_y;
-	calcDisconnectCoord(doc.linedefs[ld].get(), v_num, &new_x, &new_y);
+	calcDisconnectCoord(doc.linedefs[ld], v_num, &new_x, &new_y);
 
 	int new_v = op.addNew(ObjType::vertices);
 
@@ -640,7 +641,7 @@ void VertexModule::verticesOfDetachableSectors(selection_c &verts) const
 
 	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
-		const auto L = doc.linedefs[n];
+		const LineDef *L = doc.linedefs[n];
 
 		// only process lines which touch a selected sector
 		bool  left_in = doc.getLeft(*L)  && inst.edit.Selected->get(doc.getLeft(*L)->sector);
@@ -691,11 +692,10 @@ void VertexModule::verticesOfDetachableSectors(selection_c &verts) const
 
 void VertexModule::DETSEC_SeparateLine(EditOperation &op, int ld_num, int start2, int end2, Side in_side) const
 {
-	const auto L1 = doc.linedefs[ld_num];
-
 	int new_ld = op.addNew(ObjType::linedefs);
 	int lost_sd;
 
+	const auto L1 = doc.linedefs[ld_num];
 	const auto L2 = doc.linedefs[new_ld];
 
 	if (in_side == Side::left)
@@ -736,7 +736,7 @@ void VertexModule::DETSEC_SeparateLine(EditOperation &op, int ld_num, int start2
 
 	StringID tex = BA_InternaliseString(inst.conf.default_wall_tex);
 
-	const SideDef * SD = doc.sidedefs[L1->right].get();
+	const SideDef * SD = doc.sidedefs[L1->right];
 
 	if (! is_null_tex(SD->LowerTex()))
 		tex = SD->lower_tex;
@@ -748,7 +748,7 @@ void VertexModule::DETSEC_SeparateLine(EditOperation &op, int ld_num, int start2
 
 	// now fix the second line's textures
 
-	SD = doc.sidedefs[lost_sd].get();
+	SD = doc.sidedefs[lost_sd];
 
 	if (! is_null_tex(SD->LowerTex()))
 		tex = SD->lower_tex;
@@ -843,7 +843,7 @@ void Instance::commandSectorDisconnect()
 
 			mapping[*it] = new_v;
 
-			auto newbie = level.vertices[new_v];
+			Vertex *newbie = level.vertices[new_v];
 
 			*newbie = *level.vertices[*it];
 		}
@@ -992,9 +992,9 @@ void Instance::CMD_VT_ShapeLine()
 
 	for (sel_iter_c it(*edit.Selected) ; !it.done() ; it.next())
 	{
-		const auto V = level.vertices[*it];
+		const Vertex *V = level.vertices[*it];
 
-		double weight = WeightForVertex(V.get(), pos1.x,pos1.y, pos2.x,pos2.y, width,height, -1);
+		double weight = WeightForVertex(V, pos1.x,pos1.y, pos2.x,pos2.y, width,height, -1);
 
 		if (weight > 0)
 		{
@@ -1004,7 +1004,7 @@ void Instance::CMD_VT_ShapeLine()
 			a_total += weight;
 		}
 
-		weight = WeightForVertex(V.get(), pos1.x,pos1.y, pos2.x,pos2.y, width,height, +1);
+		weight = WeightForVertex(V, pos1.x,pos1.y, pos2.x,pos2.y, width,height, +1);
 
 		if (weight > 0)
 		{
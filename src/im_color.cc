@@ -77,12 +77,12 @@ bool Palette::updateGamma(int usegamma, int panel_gamma)
 
 bool Palette::loadPalette(const Lump_c &lump, int usegamma, int panel_gamma)
 {
-	if(lump.getData().size() < sizeof(raw_palette))
+	if(lump.Length() < (int)sizeof(raw_palette))
 	{
 		gLog.printf("PLAYPAL: read error\n");
 		return false;
 	}
-	memcpy(raw_palette, lump.getData().data(), sizeof(raw_palette));
+	memcpy(raw_palette, lump.data(), sizeof(raw_palette));
 	
 	// find the colour closest to TRANS_PIXEL
 	byte tr = raw_palette[TRANS_PIXEL][0];
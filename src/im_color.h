@@ -117,6 +117,10 @@ public:
 	{
 		return raw_colormap[cmap][pos];
 	}
+	const byte *getColormap(int cmap) const
+	{
+		return raw_colormap[cmap];
+	}
 
 	int getTransReplace() const
 	{
@@ -56,10 +56,17 @@ crc32_c& crc32_c::AddBlock(const u8_t *data, int len)
 	u32_t s1 = raw & 0xFFFF;
 	u32_t s2 = (raw >> 16) & 0xFFFF;
 
+	// s1 and s2 stay below 65521, so one subtraction does the modulo
+	// (and is much quicker than dividing for every byte)
 	for (; len > 0; data++, len--)
 	{
-		s1 = (s1 + *data) % 65521;
-		s2 = (s2 + s1)    % 65521;
+		s1 += *data;
+		if (s1 >= 65521)
+			s1 -= 65521;
+
+		s2 += s1;
+		if (s2 >= 65521)
+			s2 -= 65521;
 
     extra += s2;
     if (extra >= 0xFFFEFFF9)
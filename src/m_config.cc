@@ -154,6 +154,15 @@ const opt_desc_t options[] =
 		&gInstance.loaded.portName	// TODO: same deal
 	},
 
+	{	"threads",
+		0,
+        OptType::integer,
+		0,
+		"Threads for building nodes (default: one per CPU)",
+		"<num>",
+		&config::bsp_threads
+	},
+
 	{	"warp",
 		"w",
         OptType::string,
@@ -210,6 +219,24 @@ const opt_desc_t options[] =
 		&config::backup_max_space
 	},
 
+	{	"backup_min_interval",
+		0,
+        OptType::integer,
+		OptFlag_preference,
+		"Minimum time (in minutes) between two backups of a wad",
+		NULL,
+		&config::backup_min_interval
+	},
+
+	{	"image_cache_space",
+		0,
+        OptType::integer,
+		OptFlag_preference,
+		"Maximum space to use (in MB) for keeping decoded images between runs",
+		NULL,
+		&config::image_cache_space
+	},
+
 	{	"browser_combine_tex",
 		0,
         OptType::boolean,
@@ -255,6 +282,15 @@ const opt_desc_t options[] =
 		&config::bsp_warnings
 	},
 
+	{	"bsp_full_reject",
+		0,
+        OptType::boolean,
+		OptFlag_preference,
+		"Node building: check the lines of sight for the REJECT lump (slower)",
+		NULL,
+		&config::bsp_full_reject
+	},
+
 	{	"bsp_split_factor",
 		0,
         OptType::integer,
@@ -154,6 +154,9 @@ extern rgb_color_t normal_small_col;
 
 extern int backup_max_files;
 extern int backup_max_space;
+extern int backup_min_interval;
+
+extern int image_cache_space;
 
 extern bool browser_small_tex;
 extern bool browser_combine_tex;
@@ -178,7 +181,9 @@ extern rgb_color_t transparent_col;
 extern bool bsp_on_save;
 extern bool bsp_fast;
 extern bool bsp_warnings;
+extern bool bsp_full_reject;
 extern int  bsp_split_factor;
+extern int  bsp_threads;
 
 extern bool bsp_gl_nodes;
 extern bool bsp_force_v5;
@@ -34,6 +34,8 @@
 #include "filesystem.hpp"
 namespace fs = ghc::filesystem;
 
+#include <chrono>
+
 // list of known iwads (mapping GAME name --> PATH)
 
 void RecentKnowledge::addIWAD(const fs::path &path)
@@ -839,6 +841,7 @@ void LoadingData::writeEurekaLump(Wad_file &wad) const
 // config variables
 int config::backup_max_files = 30;
 int config::backup_max_space = 60;  // MB
+int config::backup_min_interval = 10;  // minutes
 
 
 struct backup_scan_data_t
@@ -926,6 +929,21 @@ void M_BackupWad(const Wad_file *wad)
 	int b_low  = scan_data.low;
 	int b_high = scan_data.high;
 
+	// skip it when the last backup is recent enough, a wad saved every
+	// minute does not need to be copied every minute.
+	if (b_low <= b_high && config::backup_min_interval > 0)
+	{
+		std::error_code ec;
+		fs::file_time_type last = fs::last_write_time(Backup_Name(dir_name, b_high), ec);
+
+		if (!ec && fs::file_time_type::clock::now() - last <
+			std::chrono::minutes(config::backup_min_interval))
+		{
+			gLog.debugPrintf("backup skipped, the last one is recent\n");
+			return;
+		}
+	}
+
 	// actually back-up the file
 
 	fs::path dest_name = Backup_Name(dir_name, b_high + 1);
@@ -1284,6 +1284,12 @@ bool Instance::is_sky(const SString &flat) const
 	return flat.noCaseEqual(conf.miscInfo.sky_flat);
 }
 
+// the same for a flat of a sector, without any string work
+bool Instance::is_sky(StringID flat) const
+{
+	return wad.images.flatHandle(conf, flat) == ImageSet::IMAGE_SKY_FLAT;
+}
+
 bool is_null_tex(const SString &tex)
 {
 	return tex.good() && tex[0] == '-';
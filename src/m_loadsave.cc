@@ -72,40 +72,40 @@ void MasterDir::ReplaceEditWad(const std::shared_ptr<Wad_file> &new_wad)
 static Document makeFreshDocument(Instance &inst, const ConfigData &config, MapFormat levelFormat)
 {
 	Document doc(inst);
-	auto sec = std::make_unique<Sector>();
+	Sector sec;
 
-	sec->SetDefaults(config);
+	sec.SetDefaults(config);
 	doc.sectors.push_back(std::move(sec));
 
 	for (int i = 0 ; i < 4 ; i++)
 	{
-		auto v = std::make_shared<Vertex>();
+		Vertex v;
 
-		v->SetRawX(levelFormat, (i >= 2) ? 256 : -256);
-		v->SetRawY(levelFormat, (i==1 || i==2) ? 256 :-256);
+		v.SetRawX(levelFormat, (i >= 2) ? 256 : -256);
+		v.SetRawY(levelFormat, (i==1 || i==2) ? 256 :-256);
 		doc.vertices.push_back(std::move(v));
 
-		auto sd = std::make_shared<SideDef>();
-		sd->SetDefaults(config, false);
+		SideDef sd;
+		sd.SetDefaults(config, false);
 		doc.sidedefs.push_back(std::move(sd));
 
-		auto ld = std::make_shared<LineDef>();
-		ld->start = i;
-		ld->end   = (i+1) % 4;
-		ld->flags = MLF_Blocking;
-		ld->right = i;
+		LineDef ld;
+		ld.start = i;
+		ld.end   = (i+1) % 4;
+		ld.flags = MLF_Blocking;
+		ld.right = i;
 		doc.linedefs.push_back(std::move(ld));
 	}
 
 	for (int pl = 1 ; pl <= 4 ; pl++)
 	{
-		auto th = std::make_unique<Thing>();
+		Thing th;
 
-		th->type  = pl;
-		th->angle = 90;
+		th.type  = pl;
+		th.angle = 90;
 
-		th->SetRawX(levelFormat, (pl == 1) ? 0 : (pl - 3) * 48);
-		th->SetRawY(levelFormat, (pl == 1) ? 48 : (pl == 3) ? -48 : 0);
+		th.SetRawX(levelFormat, (pl == 1) ? 0 : (pl - 3) * 48);
+		th.SetRawY(levelFormat, (pl == 1) ? 48 : (pl == 3) ? -48 : 0);
 		doc.things.push_back(std::move(th));
 	}
 
@@ -118,6 +118,9 @@ void Instance::FreshLevel()
 {
 	level.clear();
 	level = makeFreshDocument(*this, conf, loaded.levelFormat);
+	r_view.InvalidatePick();
+	if (main_win)
+		main_win->canvas->InvalidateMap();
 
 	ZoomWholeMap();
 
@@ -459,10 +462,10 @@ void Document::LoadVertices(int loading_level, const Wad_file *load_wad)
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading vertices.\n");
 
-		auto vert = std::make_unique<Vertex>();
+		Vertex vert;
 
-		vert->raw_x = FFixedPoint(LE_S16(raw.x));
-		vert->raw_y = FFixedPoint(LE_S16(raw.y));
+		vert.raw_x = FFixedPoint(LE_S16(raw.x));
+		vert.raw_y = FFixedPoint(LE_S16(raw.y));
 
 		vertices.push_back(std::move(vert));
 	}
@@ -491,20 +494,20 @@ void Document::LoadSectors(int loading_level, const Wad_file *load_wad)
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading sectors.\n");
 
-		auto sec = std::make_shared<Sector>();
+		Sector sec;
 
-		sec->floorh = LE_S16(raw.floorh);
-		sec->ceilh  = LE_S16(raw.ceilh);
+		sec.floorh = LE_S16(raw.floorh);
+		sec.ceilh  = LE_S16(raw.ceilh);
 
 		UpperCaseShortStr(raw.floor_tex, 8);
 		UpperCaseShortStr(raw. ceil_tex, 8);
 
-		sec->floor_tex = BA_InternaliseString(SString(raw.floor_tex, 8));
-		sec->ceil_tex  = BA_InternaliseString(SString(raw.ceil_tex,  8));
+		sec.floor_tex = BA_InternaliseString(SString(raw.floor_tex, 8));
+		sec.ceil_tex  = BA_InternaliseString(SString(raw.ceil_tex,  8));
 
-		sec->light = LE_U16(raw.light);
-		sec->type  = LE_U16(raw.type);
-		sec->tag   = LE_S16(raw.tag);
+		sec.light = LE_U16(raw.light);
+		sec.type  = LE_U16(raw.type);
+		sec.tag   = LE_S16(raw.tag);
 
 		sectors.push_back(std::move(sec));
 	}
@@ -515,9 +518,9 @@ void Document::CreateFallbackSector(const ConfigData &config)
 {
 	gLog.printf("Creating a fallback sector.\n");
 
-	auto sec = std::make_shared<Sector>();
+	Sector sec;
 
-	sec->SetDefaults(config);
+	sec.SetDefaults(config);
 
 	sectors.push_back(std::move(sec));
 }
@@ -530,9 +533,9 @@ void Document::CreateFallbackSideDef(const ConfigData &config)
 
 	gLog.printf("Creating a fallback sidedef.\n");
 
-	auto sd = std::make_shared<SideDef>();
+	SideDef sd;
 
-	sd->SetDefaults(config, false);
+	sd.SetDefaults(config, false);
 
 	sidedefs.push_back(std::move(sd));
 }
@@ -541,14 +544,14 @@ void Document::CreateFallbackVertices()
 {
 	gLog.printf("Creating two fallback vertices.\n");
 
-	auto v1 = std::make_unique<Vertex>();
-	auto v2 = std::make_unique<Vertex>();
+	Vertex v1;
+	Vertex v2;
 
-	v1->raw_x = FFixedPoint(-777);
-	v1->raw_y = FFixedPoint(-777);
+	v1.raw_x = FFixedPoint(-777);
+	v1.raw_y = FFixedPoint(-777);
 
-	v2->raw_x = FFixedPoint(555);
-	v2->raw_y = FFixedPoint(555);
+	v2.raw_x = FFixedPoint(555);
+	v2.raw_y = FFixedPoint(555);
 
 	vertices.push_back(std::move(v1));
 	vertices.push_back(std::move(v2));
@@ -662,14 +665,14 @@ void Document::LoadThings(int loading_level, const Wad_file *load_wad)
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading things.\n");
 
-		auto th = std::make_unique<Thing>();
+		Thing th;
 
-		th->raw_x = FFixedPoint(LE_S16(raw.x));
-		th->raw_y = FFixedPoint(LE_S16(raw.y));
+		th.raw_x = FFixedPoint(LE_S16(raw.x));
+		th.raw_y = FFixedPoint(LE_S16(raw.y));
 
-		th->angle   = LE_U16(raw.angle);
-		th->type    = LE_U16(raw.type);
-		th->options = LE_U16(raw.options);
+		th.angle   = LE_U16(raw.angle);
+		th.type    = LE_U16(raw.type);
+		th.options = LE_U16(raw.options);
 
 		things.push_back(std::move(th));
 	}
@@ -698,23 +701,23 @@ void Document::LoadThings_Hexen(int loading_level, const Wad_file *load_wad)
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading things.\n");
 
-		auto th = std::make_unique<Thing>();
+		Thing th;
 
-		th->tid = LE_S16(raw.tid);
-		th->raw_x = FFixedPoint(LE_S16(raw.x));
-		th->raw_y = FFixedPoint(LE_S16(raw.y));
-		th->raw_h = FFixedPoint(LE_S16(raw.height));
+		th.tid = LE_S16(raw.tid);
+		th.raw_x = FFixedPoint(LE_S16(raw.x));
+		th.raw_y = FFixedPoint(LE_S16(raw.y));
+		th.raw_h = FFixedPoint(LE_S16(raw.height));
 
-		th->angle = LE_U16(raw.angle);
-		th->type = LE_U16(raw.type);
-		th->options = LE_U16(raw.options);
+		th.angle = LE_U16(raw.angle);
+		th.type = LE_U16(raw.type);
+		th.options = LE_U16(raw.options);
 
-		th->special = raw.special;
-		th->arg1 = raw.args[0];
-		th->arg2 = raw.args[1];
-		th->arg3 = raw.args[2];
-		th->arg4 = raw.args[3];
-		th->arg5 = raw.args[4];
+		th.special = raw.special;
+		th.arg1 = raw.args[0];
+		th.arg2 = raw.args[1];
+		th.arg3 = raw.args[2];
+		th.arg4 = raw.args[3];
+		th.arg5 = raw.args[4];
 
 		things.push_back(std::move(th));
 	}
@@ -742,22 +745,22 @@ void Document::LoadSideDefs(int loading_level, const Wad_file *load_wad, const C
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading sidedefs.\n");
 
-		auto sd = std::make_shared<SideDef>();
+		SideDef sd;
 
-		sd->x_offset = LE_S16(raw.x_offset);
-		sd->y_offset = LE_S16(raw.y_offset);
+		sd.x_offset = LE_S16(raw.x_offset);
+		sd.y_offset = LE_S16(raw.y_offset);
 
 		UpperCaseShortStr(raw.upper_tex, 8);
 		UpperCaseShortStr(raw.lower_tex, 8);
 		UpperCaseShortStr(raw.  mid_tex, 8);
 
-		sd->upper_tex = BA_InternaliseString(SString(raw.upper_tex, 8));
-		sd->lower_tex = BA_InternaliseString(SString(raw.lower_tex, 8));
-		sd->  mid_tex = BA_InternaliseString(SString(raw.  mid_tex, 8));
+		sd.upper_tex = BA_InternaliseString(SString(raw.upper_tex, 8));
+		sd.lower_tex = BA_InternaliseString(SString(raw.lower_tex, 8));
+		sd.  mid_tex = BA_InternaliseString(SString(raw.  mid_tex, 8));
 
-		sd->sector = LE_U16(raw.sector);
+		sd.sector = LE_U16(raw.sector);
 
-		ValidateSectorRef(*sd, i, config, bad);
+		ValidateSectorRef(sd, i, config, bad);
 
 		sidedefs.push_back(std::move(sd));
 	}
@@ -788,23 +791,23 @@ void Document::LoadLineDefs(int loading_level, const Wad_file *load_wad, const C
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading linedefs.\n");
 
-		auto ld = std::make_shared<LineDef>();
+		LineDef ld;
 
-		ld->start = LE_U16(raw.start);
-		ld->end   = LE_U16(raw.end);
+		ld.start = LE_U16(raw.start);
+		ld.end   = LE_U16(raw.end);
 
-		ld->flags = LE_U16(raw.flags);
-		ld->type  = LE_U16(raw.type);
-		ld->tag   = LE_S16(raw.tag);
+		ld.flags = LE_U16(raw.flags);
+		ld.type  = LE_U16(raw.type);
+		ld.tag   = LE_S16(raw.tag);
 
-		ld->right = LE_U16(raw.right);
-		ld->left  = LE_U16(raw.left);
+		ld.right = LE_U16(raw.right);
+		ld.left  = LE_U16(raw.left);
 
-		if (ld->right == 0xFFFF) ld->right = -1;
-		if (ld-> left == 0xFFFF) ld-> left = -1;
+		if (ld.right == 0xFFFF) ld.right = -1;
+		if (ld. left == 0xFFFF) ld. left = -1;
 
-		ValidateVertexRefs(*ld, i, bad);
-		ValidateSidedefRefs(*ld, i, config, bad);
+		ValidateVertexRefs(ld, i, bad);
+		ValidateSidedefRefs(ld, i, config, bad);
 
 		linedefs.push_back(std::move(ld));
 	}
@@ -836,27 +839,27 @@ void Document::LoadLineDefs_Hexen(int loading_level, const Wad_file *load_wad, c
 		if (! stream.read(&raw, sizeof(raw)))
 			ThrowException("Error reading linedefs.\n");
 
-		auto ld = std::make_shared<LineDef>();
+		LineDef ld;
 
-		ld->start = LE_U16(raw.start);
-		ld->end   = LE_U16(raw.end);
+		ld.start = LE_U16(raw.start);
+		ld.end   = LE_U16(raw.end);
 
-		ld->flags = LE_U16(raw.flags);
-		ld->type = raw.type;
-		ld->tag  = raw.args[0];
-		ld->arg2 = raw.args[1];
-		ld->arg3 = raw.args[2];
-		ld->arg4 = raw.args[3];
-		ld->arg5 = raw.args[4];
+		ld.flags = LE_U16(raw.flags);
+		ld.type = raw.type;
+		ld.tag  = raw.args[0];
+		ld.arg2 = raw.args[1];
+		ld.arg3 = raw.args[2];
+		ld.arg4 = raw.args[3];
+		ld.arg5 = raw.args[4];
 
-		ld->right = LE_U16(raw.right);
-		ld->left  = LE_U16(raw.left);
+		ld.right = LE_U16(raw.right);
+		ld.left  = LE_U16(raw.left);
 
-		if (ld->right == 0xFFFF) ld->right = -1;
-		if (ld-> left == 0xFFFF) ld-> left = -1;
+		if (ld.right == 0xFFFF) ld.right = -1;
+		if (ld. left == 0xFFFF) ld. left = -1;
 
-		ValidateVertexRefs(*ld, i, bad);
-		ValidateSidedefRefs(*ld, i, config, bad);
+		ValidateVertexRefs(ld, i, bad);
+		ValidateSidedefRefs(ld, i, config, bad);
 
 		linedefs.push_back(std::move(ld));
 	}
@@ -1017,6 +1020,9 @@ void Instance::LoadLevelNum(const Wad_file *wad, int lev_num) noexcept(false)
 	loaded = newdoc.loading;
 	level = std::move(newdoc.doc);
 	Subdiv_InvalidateAll();
+	r_view.InvalidatePick();
+	if (main_win)
+		main_win->canvas->InvalidateMap();
 }
 
 void Instance::refreshViewAfterLoad(const BadCount& bad, const Wad_file *wad, const SString &map_name, bool new_resources)
@@ -1025,6 +1031,9 @@ void Instance::refreshViewAfterLoad(const BadCount& bad, const Wad_file *wad, co
 		ShowLoadProblem(bad);
 
 	Subdiv_InvalidateAll();
+	r_view.InvalidatePick();
+	if (main_win)
+		main_win->canvas->InvalidateMap();
 
 	// reset various editor state
 	Editor_ClearAction();
@@ -2092,9 +2101,9 @@ void Instance::CMD_DeleteMap()
 		for (const Lump_c& backup : backupLumps)
 		{
 			if(&backup == &backupLumps[0])
-				wad.master.editWad()->AddLevel(backup.Name())->Write(backup.getData().data(), (int)backup.getData().size());
+				wad.master.editWad()->AddLevel(backup.Name())->Write(backup.data(), backup.Length());
 			else
-				wad.master.editWad()->AddLump(backup.Name()).Write(backup.getData().data(), (int)backup.getData().size());
+				wad.master.editWad()->AddLump(backup.Name()).Write(backup.data(), backup.Length());
 		}
 		wad.master.editWad()->SortLevels();
 		DLG_ShowError(false, "Cannot delete map: %s", e.what());
@@ -35,8 +35,10 @@
 bool config::bsp_on_save	= true;
 bool config::bsp_fast		= false;
 bool config::bsp_warnings	= false;
+bool config::bsp_full_reject	= false;
 
 int  config::bsp_split_factor	= DEFAULT_FACTOR;
+int  config::bsp_threads		= 0;
 
 bool config::bsp_gl_nodes		= true;
 bool config::bsp_force_v5		= false;
@@ -249,10 +251,14 @@ static void PrepareInfo(nodebuildinfo_t *info)
 	info->fast		= config::bsp_fast;
 	info->warnings	= config::bsp_warnings;
 
+	info->full_reject	= config::bsp_full_reject;
+
 	info->force_v5			= config::bsp_force_v5;
 	info->force_xnod		= config::bsp_force_zdoom;
 	info->force_compress	= config::bsp_compressed;
 
+	info->threads	= std::max(0, config::bsp_threads);
+
 	info->total_failed_maps		= 0;
 	info->total_warnings		= 0;
 
@@ -276,42 +282,30 @@ build_result_e Instance::BuildAllNodes(nodebuildinfo_t *info)
 
 	nodeialog->SetProg(0);
 
-	build_result_e ret;
+	Wad_file &edit_wad = *wad.master.editWad();
 
-	// loop over each level in the wad
-	for (int n = 0 ; n < num_levels ; n++)
-	{
-		// load level
-		try
+	// the levels are built in parallel, but put back in order
+	build_result_e ret = AJBSP_BuildAllLevels(info, conf, edit_wad,
+		[this, &edit_wad](int lev_idx)
 		{
-			NewDocument newdoc = openDocument(loaded, *wad.master.editWad(), n);
-			
-			ret = AJBSP_BuildLevel(info, n, *this, newdoc.doc, newdoc.loading, *wad.master.editWad());
-		}
-		catch(const std::runtime_error &e)
+			return openDocument(loaded, edit_wad, lev_idx);
+		},
+		[this](const SString &message)
 		{
-			GB_PrintMsg("Failed building nodes for level %d: %s\n", n, e.what());
-			continue;
-		}
-
-		// don't fail on maps with overflows
-		// [ Note that 'total_failed_maps' keeps a tally of these ]
-		if (ret == BUILD_LumpOverflow)
-			ret = BUILD_OK;
-
-		if (ret != BUILD_OK)
-			break;
+			GB_PrintMsg("%s", message.c_str());
+		},
+		[this, info, num_levels](int num_done)
+		{
+			nodeialog->SetProg(100 * num_done / num_levels);
 
-		nodeialog->SetProg(100 * (n + 1) / num_levels);
+			Fl::check();
 
-		Fl::check();
+			if (nodeialog->WantCancel())
+			{
+				info->cancelled = true;
+			}
+		});
 
-		if (nodeialog->WantCancel())
-		{
-			nb_info->cancelled = true;
-		}
-	}
-	
 	try
 	{
 		wad.master.editWad()->writeToDisk();
@@ -328,11 +322,11 @@ build_result_e Instance::BuildAllNodes(nodebuildinfo_t *info)
 
 		if (info->total_failed_maps == 0)
 			GB_PrintMsg("All maps built successfully, %d warnings\n",
-						info->total_warnings);
+						info->total_warnings.load());
 		else
 			GB_PrintMsg("%d failed maps, %d warnings\n",
-						info->total_failed_maps,
-						info->total_warnings);
+						info->total_failed_maps.load(),
+						info->total_warnings.load());
 	}
 	else if (ret == BUILD_Cancelled)
 	{
@@ -389,34 +389,49 @@ size_t SString::findDigit() const
 	return std::string::npos;
 }
 
+StringTable::StringTable()
+{
+	add("");
+}
+
 //
 // Add a text
 //
 StringID StringTable::add(const SString &text)
 {
-	int index = 0;
-	for(const SString &string : mStrings)
-	{
-		if(string == text)	// this should also cover "" === 0
-			return StringID(index);
-		++index;
-	}
+	auto found = mIndex.find(text.get());
+	if(found != mIndex.end())
+		return StringID(found->second);
+
+	int index = (int)mStrings.size();
 	mStrings.push_back(text);
-	return StringID((int)mStrings.size() - 1);
+
+	std::string_view key = mStrings.back().get();
+	mIndex.emplace(key, index);
+
+	return StringID(index);
 }
 
 //
 // Get a text (handle it robustly)
 //
-SString StringTable::get(StringID offset) const noexcept
+const SString &StringTable::get(StringID offset) const noexcept
 {
+	static const SString error("???ERROR");
+
 	// this should never happen
 	// [ but handle it gracefully, for the sake of robustness ]
 	if(offset.isInvalid() || offset.get() >= (int)mStrings.size())
-		return "???ERROR";
+		return error;
 	return mStrings[offset.get()];
 }
 
+StringID StringTable::find(std::string_view text) const noexcept
+{
+	auto found = mIndex.find(text);
+	return found != mIndex.end() ? StringID(found->second) : StringID(-1);
+}
+
 //
 // If string has spaces, surrounds it in double quotes. If there are any quotes, it doubles them (MS-DOS convention)
 //
@@ -25,8 +25,11 @@
 
 #include <string.h>
 
+#include <deque>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 // Helper to treat nullptr char* the same as ""
@@ -473,16 +476,34 @@ private:
 static_assert(sizeof(StringID) == sizeof(int), "StringID must be size of int");
 
 //
-// String storage table
+// String storage table. Adding the same text again gives back the same ID,
+// found through a hash index. Stored strings never move, so the references
+// from get() stay valid as long as the table lives.
 //
 class StringTable
 {
 public:
+	StringTable();
+	StringTable(const StringTable &other) = delete;
+	StringTable &operator = (const StringTable &other) = delete;
+
 	StringID add(const SString &str);
-	SString get(StringID offset) const noexcept;
+	const SString &get(StringID offset) const noexcept;
+
+	// lookup without adding, giving an invalid ID if missing
+	StringID find(std::string_view text) const noexcept;
+
+	int size() const noexcept
+	{
+		return (int)mStrings.size();
+	}
+
 private:
 	// Must start with an empty string, so get(0) gets "".
-	std::vector<SString> mStrings = { "" };	
+	std::deque<SString> mStrings;
+
+	// the keys are views into mStrings
+	std::unordered_map<std::string_view, int> mIndex;
 };
 
 #ifdef _WIN32
@@ -30,25 +30,168 @@
 #include "w_rawdef.h"
 #include "w_texture.h"
 #include "w_wad.h"
+#include "WorkerPool.h"
 
 #include "ui_window.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <unordered_map>
+
+//
+// The names which UDMF_LoadLevel understands (case insensitive)
+//
+enum class UdmfKey : unsigned char
+{
+	unknown,
+
+	// blocks
+	thing, vertex, linedef, sidedef, sector,
+
+	// global variables
+	namespace_, ee_compat,
+
+	// fields
+	x, y, height, type, angle, id, special,
+	arg0, arg1, arg2, arg3, arg4,
+	skill2, skill3, skill4, ambush, friend_, single, coop, dm,
+	v1, v2, sidefront, sideback,
+	blocking, blockmonsters, twosided, dontpegtop, dontpegbottom,
+	secret, blocksound, dontdraw, mapped, passuse,
+	texturetop, texturebottom, texturemiddle, offsetx, offsety,
+	heightfloor, heightceiling, texturefloor, textureceiling, lightlevel
+};
+
+static const struct
+{
+	const char *name;
+	UdmfKey key;
+}
+udmf_keys[] =
+{
+	{ "thing", UdmfKey::thing },
+	{ "vertex", UdmfKey::vertex },
+	{ "linedef", UdmfKey::linedef },
+	{ "sidedef", UdmfKey::sidedef },
+	{ "sector", UdmfKey::sector },
+
+	{ "namespace", UdmfKey::namespace_ },
+	{ "ee_compat", UdmfKey::ee_compat },
+
+	{ "x", UdmfKey::x },
+	{ "y", UdmfKey::y },
+	{ "height", UdmfKey::height },
+	{ "type", UdmfKey::type },
+	{ "angle", UdmfKey::angle },
+	{ "id", UdmfKey::id },
+	{ "special", UdmfKey::special },
+	{ "arg0", UdmfKey::arg0 },
+	{ "arg1", UdmfKey::arg1 },
+	{ "arg2", UdmfKey::arg2 },
+	{ "arg3", UdmfKey::arg3 },
+	{ "arg4", UdmfKey::arg4 },
+	{ "skill2", UdmfKey::skill2 },
+	{ "skill3", UdmfKey::skill3 },
+	{ "skill4", UdmfKey::skill4 },
+	{ "ambush", UdmfKey::ambush },
+	{ "friend", UdmfKey::friend_ },
+	{ "single", UdmfKey::single },
+	{ "coop", UdmfKey::coop },
+	{ "dm", UdmfKey::dm },
+	{ "v1", UdmfKey::v1 },
+	{ "v2", UdmfKey::v2 },
+	{ "sidefront", UdmfKey::sidefront },
+	{ "sideback", UdmfKey::sideback },
+	{ "blocking", UdmfKey::blocking },
+	{ "blockmonsters", UdmfKey::blockmonsters },
+	{ "twosided", UdmfKey::twosided },
+	{ "dontpegtop", UdmfKey::dontpegtop },
+	{ "dontpegbottom", UdmfKey::dontpegbottom },
+	{ "secret", UdmfKey::secret },
+	{ "blocksound", UdmfKey::blocksound },
+	{ "dontdraw", UdmfKey::dontdraw },
+	{ "mapped", UdmfKey::mapped },
+	{ "passuse", UdmfKey::passuse },
+	{ "texturetop", UdmfKey::texturetop },
+	{ "texturebottom", UdmfKey::texturebottom },
+	{ "texturemiddle", UdmfKey::texturemiddle },
+	{ "offsetx", UdmfKey::offsetx },
+	{ "offsety", UdmfKey::offsety },
+	{ "heightfloor", UdmfKey::heightfloor },
+	{ "heightceiling", UdmfKey::heightceiling },
+	{ "texturefloor", UdmfKey::texturefloor },
+	{ "textureceiling", UdmfKey::textureceiling },
+	{ "lightlevel", UdmfKey::lightlevel },
+};
+
+#define UDMF_KEY_SLOTS  256
+
+//
+// A perfect hash of the names in udmf_keys[]: FNV-1a of the lowercased
+// name, scrambled by a multiplier which was picked so that no two of
+// them share a slot.  Other names can land anywhere.
+//
+static inline unsigned UDMF_KeySlot(std::string_view name) noexcept
+{
+	uint32_t hash = 2166136261u;
+
+	for (char ch : name)
+		hash = (hash ^ ((unsigned char)ch | 0x20u)) * 16777619u;
+
+	return (hash * 999u) >> 24;
+}
+
+static UdmfKey UDMF_LookupKey(std::string_view name) noexcept
+{
+	static const std::array<unsigned char, UDMF_KEY_SLOTS> slots = []()
+	{
+		std::array<unsigned char, UDMF_KEY_SLOTS> result;
+		result.fill(0xff);
+
+		for (unsigned char i = 0 ; i < (unsigned char)(sizeof(udmf_keys) / sizeof(udmf_keys[0])) ; i++)
+		{
+			unsigned slot = UDMF_KeySlot(udmf_keys[i].name);
+			SYS_ASSERT(result[slot] == 0xff);
+			result[slot] = i;
+		}
+		return result;
+	}();
+
+	unsigned char index = slots[UDMF_KeySlot(name)];
+	if (index == 0xff)
+		return UdmfKey::unknown;
+
+	const char *key_name = udmf_keys[index].name;
+	if (name.size() != strlen(key_name) || y_strnicmp(name.data(), key_name, name.size()) != 0)
+		return UdmfKey::unknown;
+
+	return udmf_keys[index].key;
+}
+
+
 class Udmf_Token
 {
 private:
-	// empty means EOF
-	SString text;
+	// empty means EOF.
+	// this points into the lump, it is never copied.
+	std::string_view text;
 
 public:
-	Udmf_Token(const char *str) : text(str)
-	{ }
+	Udmf_Token() = default;
 
-	Udmf_Token(const char *str, int len) : text(str, len)
+	explicit Udmf_Token(std::string_view text) : text(text)
 	{ }
 
-	const char *c_str() const
+	SString ToString() const
 	{
-		return text.c_str();
+		return SString(text.data(), (int)text.size());
+	}
+
+	std::string_view Text() const
+	{
+		return text;
 	}
 
 	bool IsEOF() const
@@ -61,7 +204,7 @@ public:
 		if (text.size() == 0)
 			return false;
 
-		char ch = text[0];
+		unsigned char ch = text[0];
 
 		return isalpha(ch) || ch == '_';
 	}
@@ -73,17 +216,46 @@ public:
 
 	bool Match(const char *name) const
 	{
-		return y_stricmp(text.c_str(), name) == 0;
+		size_t len = strlen(name);
+
+		return text.size() == len && y_strnicmp(text.data(), name, len) == 0;
+	}
+
+	bool Match(char symbol) const
+	{
+		return text.size() == 1 && text[0] == symbol;
+	}
+
+	UdmfKey Key() const
+	{
+		return UDMF_LookupKey(text);
 	}
 
 	int DecodeInt() const
 	{
-		return atoi(text);
+		std::string_view number = Number();
+
+		int value = 0;
+		std::from_chars(number.data(), number.data() + number.size(), value);
+		return value;
 	}
 
 	double DecodeFloat() const
 	{
-		return atof(text);
+		std::string_view number = Number();
+
+		double value = 0;
+#ifdef __cpp_lib_to_chars
+		std::from_chars(number.data(), number.data() + number.size(), value);
+#else
+		// no floating point from_chars in this library
+		char buffer[64];
+		size_t len = std::min(number.size(), sizeof(buffer) - 1);
+		memcpy(buffer, number.data(), len);
+		buffer[len] = 0;
+		value = strtod(buffer, nullptr);
+#endif
+		return value;
 	}
 
 	SString DecodeString() const
@@ -94,10 +266,7 @@ public:
 			return SString();
 		}
 
-		SString string = text;
-		string.erase(0, 1);
-		string.pop_back();
-		return string;
+		return SString(text.data() + 1, (int)text.size() - 2);
 	}
 
 	FFixedPoint DecodeCoord() const
@@ -105,7 +274,7 @@ public:
 		return MakeValidCoord(MapFormat::udmf, DecodeFloat());
 	}
 
-	StringID DecodeTexture() const
+	SString DecodeTexture() const
 	{
 		SString buffer;
 
@@ -120,204 +289,228 @@ public:
 
 			if (text.size() < 10)
 				use_len = (int)text.size() - 2;
-			buffer = text;
-			buffer.erase(0, 1);
-			buffer.erase(use_len, SString::npos);
+
+			buffer = SString(text.data() + 1, use_len);
 		}
 
-		return BA_InternaliseString(NormalizeTex(buffer));
+		return NormalizeTex(buffer);
 	}
-};
 
+private:
+	// from_chars does not take the leading '+' which atoi/atof did
+	std::string_view Number() const
+	{
+		if (! text.empty() && text[0] == '+')
+			return text.substr(1);
+
+		return text;
+	}
+};
 
-// since UDMF lumps can be very large, we read chunks of it
-// as-needed instead of loading the whole thing into memory.
-// the buffer size should be over 2x maximum token length.
-#define U_BUF_SIZE  16384
 
+//
+// Splits the lump into tokens where they are, without copying it.
+//
 class Udmf_Parser
 {
 private:
-	LumpInputStream stream;
-
-	// reached EOF or a file read error
-	bool done = false;
-
-	// we have seen a "/*" but not the closing "*/"
-	bool in_comment = false;
-
-	// number of remaining bytes
-	int remaining;
-
-	// read buffer
-	char buffer[U_BUF_SIZE];
-
-	// position in buffer and used size of buffer
-	int b_pos = 0;
-	int b_size = 0;
+	const char *pos;
+	const char *end;
 
 public:
-	Udmf_Parser(const Lump_c &_lump) : stream(_lump)
+	Udmf_Parser(const char *start, const char *end) : pos(start), end(end)
+	{
+	}
+
+	bool AtEnd() const
 	{
-		remaining = _lump.Length();
+		return pos >= end;
 	}
 
 	Udmf_Token Next()
 	{
 		for (;;)
 		{
-			if (done)
-				return Udmf_Token("");
-
-			// when position reaches half-way point, shift buffer down
-			if (b_pos >= U_BUF_SIZE/2)
-			{
-				memmove(buffer, buffer + U_BUF_SIZE/2, U_BUF_SIZE/2);
-
-				b_pos  -= U_BUF_SIZE/2;
-				b_size -= U_BUF_SIZE/2;
-			}
-
-			// top up the buffer
-			if (remaining > 0 && b_size < U_BUF_SIZE)
-			{
-				int want = U_BUF_SIZE - b_size;
-				if (want > remaining)
-					want = remaining;
-
-				if (! stream.read(buffer + b_size, want))
-				{
-					// TODO mark error somewhere, show dialog later
-					done = true;
-					continue;
-				}
+			// end of file?
+			if (pos >= end)
+				return Udmf_Token();
 
-				remaining -= want;
-				b_size    += want;
-			}
+			unsigned char ch = *pos;
 
-			// end of file?
-			if (remaining <= 0 && b_pos >= b_size)
+			// skip whitespace (assumes ASCII)
+			if ((ch <= 32) || (ch >= 127 && ch <= 160))
 			{
-				done = true;
+				pos++;
 				continue;
 			}
 
-			if (in_comment)
+			if (ch == '/' && pos + 1 < end)
 			{
-				// end of multi-line comment?
-				if (b_pos+2 <= b_size &&
-					buffer[b_pos] == '*' &&
-					buffer[b_pos+1] == '/')
+				// check for single-line comment
+				if (pos[1] == '/')
 				{
-					in_comment = false;
-					b_pos += 2;
+					SkipToEOLN();
 					continue;
 				}
 
-				b_pos++;
-				continue;
-			}
-
-			// check for multi-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '*')
-			{
-				in_comment = true;
-				b_pos += 2;
-				continue;
-			}
-
-			// check for single-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '/')
-			{
-				SkipToEOLN();
-				continue;
-			}
-
-			// skip whitespace (assumes ASCII)
-			int start = b_pos;
-			unsigned char ch = buffer[b_pos];
+				// check for multi-line comment, which may run to EOF
+				if (pos[1] == '*')
+				{
+					static const char closing[] = "*/";
 
-			if ((ch <= 32) || (ch >= 127 && ch <= 160))
-			{
-				b_pos++;
-				continue;
+					const char *close = std::search(pos + 2, end, closing, closing + 2);
+					pos = (close < end) ? close + 2 : end;
+					continue;
+				}
 			}
 
 			// an actual token, yay!
+			const char *start = pos;
 
 			// is it a string?
 			if (ch == '"')
 			{
-				b_pos++;
+				pos++;
 
-				while (b_pos < b_size)
+				while (pos < end)
 				{
 					// skip escapes
-					if (buffer[b_pos] == '\\' && b_pos+1 < b_size)
+					if (*pos == '\\' && pos+1 < end)
 					{
-						b_pos += 2;
+						pos += 2;
 						continue;
 					}
 
-					if (buffer[b_pos] == '"')
+					if (*pos == '"')
 					{
 						// include trailing double quote
-						b_pos++;
+						pos++;
 						break;
 					}
 
-					b_pos++;
+					pos++;
 				}
 
-				return Udmf_Token(buffer+start, b_pos - start);
+				return Udmf_Token(std::string_view(start, pos - start));
 			}
 
 			// is it a identifier or number?
 			if (isalnum(ch) || ch == '_' || ch == '-' || ch == '+')
 			{
-				b_pos++;
+				pos++;
 
-				while (b_pos < b_size)
+				while (pos < end)
 				{
-					char ch = buffer[b_pos];
+					unsigned char ch = *pos;
 					if (isalnum(ch) || ch == '_' || ch == '-' || ch == '+' || ch == '.')
 					{
-						b_pos++;
+						pos++;
 						continue;
 					}
 					break;
 				}
 
-				return Udmf_Token(buffer+start, b_pos - start);
+				return Udmf_Token(std::string_view(start, pos - start));
 			}
 
 			// it must be a symbol, such as '{' or '}'
-			b_pos++;
+			pos++;
 
-			return Udmf_Token(buffer+start, 1);
+			return Udmf_Token(std::string_view(start, 1));
 		}
 	}
 
-	bool Expect(const char *name)
+	bool Expect(char symbol)
 	{
 		Udmf_Token tok = Next();
-		return tok.Match(name);
+		return tok.Match(symbol);
 	}
 
 	void SkipToEOLN()
 	{
-		while (b_pos < b_size && buffer[b_pos] != '\n')
-			b_pos++;
+		while (pos < end && *pos != '\n')
+			pos++;
 	}
 };
 
 
-static void UDMF_ParseGlobalVar(LoadingData &loading, Udmf_Parser& parser, const Udmf_Token& name)
+//
+// Something to go in the log, kept until its chunk is merged
+//
+struct Udmf_Note
+{
+	enum class Kind : unsigned char
+	{
+		global, block, field
+	};
+
+	Kind kind;
+	ObjType type;	// for fields
+	int index;		// within the chunk
+	Udmf_Token name;
+};
+
+
+//
+// The objects parsed from one stretch of the TEXTMAP. A big lump is split
+// into several of these which are parsed on different threads, and then
+// added to the level in order.
+//
+struct Udmf_Chunk
+{
+	const char *start;
+	const char *end;
+
+	std::vector<Thing> things;
+	std::vector<Vertex> vertices;
+	std::vector<LineDef> linedefs;
+	std::vector<SideDef> sidedefs;
+	std::vector<Sector> sectors;
+
+	SString udmfNamespace;
+	bool hasNamespace = false;
+
+	// The global string table is not thread-safe, so the texture IDs in
+	// the objects index this list instead until the chunk is merged.
+	// It starts with "" and "-".
+	std::vector<SString> textures;
+	std::unordered_map<std::string_view, StringID> texture_ids;	// by token
+
+	std::vector<Udmf_Note> notes;
+
+	// whether the last thing parsed was a block closed right at the end
+	bool closedAtEnd = false;
+
+	Udmf_Chunk(const char *start, const char *end) :
+		start(start), end(end), textures{ "", "-" }
+	{
+	}
+
+	StringID AddTexture(const Udmf_Token &value)
+	{
+		auto found = texture_ids.find(value.Text());
+		if (found != texture_ids.end())
+			return found->second;
+
+		StringID id((int)textures.size());
+		textures.push_back(value.DecodeTexture());
+		texture_ids.emplace(value.Text(), id);
+		return id;
+	}
+
+	void NoteField(ObjType type, int count, const Udmf_Token &field)
+	{
+		notes.push_back({ Udmf_Note::Kind::field, type, count - 1, field });
+	}
+};
+
+static const StringID UDMF_LOCAL_DASH(1);
+
+// lumps are only split into pieces at least this big
+static const size_t UDMF_CHUNK_SIZE = 256 * 1024;
+
+
+static void UDMF_ParseGlobalVar(Udmf_Chunk &chunk, Udmf_Parser& parser, const Udmf_Token& name)
 {
 	Udmf_Token value = parser.Next();
 	if (value.IsEOF())
@@ -325,32 +518,35 @@ static void UDMF_ParseGlobalVar(LoadingData &loading, Udmf_Parser& parser, const
 		// TODO mark error
 		return;
 	}
-	if (!parser.Expect(";"))
+	if (!parser.Expect(';'))
 	{
 		// TODO mark error
 		parser.SkipToEOLN();
 		return;
 	}
 
-	if (name.Match("namespace"))
+	switch (name.Key())
 	{
+	case UdmfKey::namespace_:
 		// TODO : check if namespace is supported by current port
 		//        [ if not, show a dialog with some options ]
 
-		loading.udmfNamespace = value.DecodeString();
-	}
-	else if (name.Match("ee_compat"))
-	{
+		chunk.udmfNamespace = value.DecodeString();
+		chunk.hasNamespace = true;
+		break;
+
+	case UdmfKey::ee_compat:
 		// odd Eternity thing, ignore it
-	}
-	else
-	{
-		gLog.printf("skipping unknown global '%s' in UDMF\n", name.c_str());
+		break;
+
+	default:
+		chunk.notes.push_back({ Udmf_Note::Kind::global, ObjType::things, 0, name });
+		break;
 	}
 }
 
 
-static void UDMF_ParseThingField(const Document &doc, Thing *T, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseThingField(Udmf_Chunk &chunk, Thing *T, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// just ignore any setting with the "false" keyword
 	if (value.Match("false"))
@@ -360,68 +556,51 @@ static void UDMF_ParseThingField(const Document &doc, Thing *T, const Udmf_Token
 
 	// TODO strife options
 
-	if (field.Match("x"))
-		T->raw_x = value.DecodeCoord();
-	else if (field.Match("y"))
-		T->raw_y = value.DecodeCoord();
-	else if (field.Match("height"))
-		T->raw_h = value.DecodeCoord();
-	else if (field.Match("type"))
-		T->type = value.DecodeInt();
-	else if (field.Match("angle"))
-		T->angle = value.DecodeInt();
-
-	else if (field.Match("id"))
-		T->tid = value.DecodeInt();
-	else if (field.Match("special"))
-		T->special = value.DecodeInt();
-	else if (field.Match("arg0"))
-		T->arg1 = value.DecodeInt();
-	else if (field.Match("arg1"))
-		T->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		T->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		T->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		T->arg5 = value.DecodeInt();
-
-	else if (field.Match("skill2"))
-		T->options |= MTF_Easy;
-	else if (field.Match("skill3"))
-		T->options |= MTF_Medium;
-	else if (field.Match("skill4"))
-		T->options |= MTF_Hard;
-	else if (field.Match("ambush"))
-		T->options |= MTF_Ambush;
-	else if (field.Match("friend"))
-		T->options |= MTF_Friend;
-	else if (field.Match("single"))
-		T->options &= ~MTF_Not_SP;
-	else if (field.Match("coop"))
-		T->options &= ~MTF_Not_COOP;
-	else if (field.Match("dm"))
-		T->options &= ~MTF_Not_DM;
-
-	else
+	switch (field.Key())
 	{
-		gLog.debugPrintf("thing #%d: unknown field '%s'\n", doc.numThings()-1, field.c_str());
+	case UdmfKey::x:		T->raw_x = value.DecodeCoord(); break;
+	case UdmfKey::y:		T->raw_y = value.DecodeCoord(); break;
+	case UdmfKey::height:	T->raw_h = value.DecodeCoord(); break;
+	case UdmfKey::type:		T->type = value.DecodeInt(); break;
+	case UdmfKey::angle:	T->angle = value.DecodeInt(); break;
+
+	case UdmfKey::id:		T->tid = value.DecodeInt(); break;
+	case UdmfKey::special:	T->special = value.DecodeInt(); break;
+	case UdmfKey::arg0:		T->arg1 = value.DecodeInt(); break;
+	case UdmfKey::arg1:		T->arg2 = value.DecodeInt(); break;
+	case UdmfKey::arg2:		T->arg3 = value.DecodeInt(); break;
+	case UdmfKey::arg3:		T->arg4 = value.DecodeInt(); break;
+	case UdmfKey::arg4:		T->arg5 = value.DecodeInt(); break;
+
+	case UdmfKey::skill2:	T->options |= MTF_Easy; break;
+	case UdmfKey::skill3:	T->options |= MTF_Medium; break;
+	case UdmfKey::skill4:	T->options |= MTF_Hard; break;
+	case UdmfKey::ambush:	T->options |= MTF_Ambush; break;
+	case UdmfKey::friend_:	T->options |= MTF_Friend; break;
+	case UdmfKey::single:	T->options &= ~MTF_Not_SP; break;
+	case UdmfKey::coop:		T->options &= ~MTF_Not_COOP; break;
+	case UdmfKey::dm:		T->options &= ~MTF_Not_DM; break;
+
+	default:
+		chunk.NoteField(ObjType::things, (int)chunk.things.size(), field);
+		break;
 	}
 }
 
-static void UDMF_ParseVertexField(const Document &doc, Vertex *V, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseVertexField(Udmf_Chunk &chunk, Vertex *V, const Udmf_Token& field, const Udmf_Token& value)
 {
-	if (field.Match("x"))
-		V->raw_x = value.DecodeCoord();
-	else if (field.Match("y"))
-		V->raw_y = value.DecodeCoord();
-	else
+	switch (field.Key())
 	{
-		gLog.debugPrintf("vertex #%d: unknown field '%s'\n", doc.numVertices()-1, field.c_str());
+	case UdmfKey::x:	V->raw_x = value.DecodeCoord(); break;
+	case UdmfKey::y:	V->raw_y = value.DecodeCoord(); break;
+
+	default:
+		chunk.NoteField(ObjType::vertices, (int)chunk.vertices.size(), field);
+		break;
 	}
 }
 
-static void UDMF_ParseLinedefField(const Document &doc, LineDef *LD, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseLinedefField(Udmf_Chunk &chunk, LineDef *LD, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// Note: vertex and sidedef numbers are validated later on
 
@@ -433,103 +612,78 @@ static void UDMF_ParseLinedefField(const Document &doc, LineDef *LD, const Udmf_
 
 	// TODO strife flags
 
-	if (field.Match("v1"))
-		LD->start = value.DecodeInt();
-	else if (field.Match("v2"))
-		LD->end = value.DecodeInt();
-	else if (field.Match("sidefront"))
-		LD->right = value.DecodeInt();
-	else if (field.Match("sideback"))
-		LD->left = value.DecodeInt();
-	else if (field.Match("special"))
-		LD->type = value.DecodeInt();
-
-	else if (field.Match("arg0"))
-		LD->tag = value.DecodeInt();
-	else if (field.Match("arg1"))
-		LD->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		LD->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		LD->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		LD->arg5 = value.DecodeInt();
-
-	else if (field.Match("blocking"))
-		LD->flags |= MLF_Blocking;
-	else if (field.Match("blockmonsters"))
-		LD->flags |= MLF_BlockMonsters;
-	else if (field.Match("twosided"))
-		LD->flags |= MLF_TwoSided;
-	else if (field.Match("dontpegtop"))
-		LD->flags |= MLF_UpperUnpegged;
-	else if (field.Match("dontpegbottom"))
-		LD->flags |= MLF_LowerUnpegged;
-	else if (field.Match("secret"))
-		LD->flags |= MLF_Secret;
-	else if (field.Match("blocksound"))
-		LD->flags |= MLF_SoundBlock;
-	else if (field.Match("dontdraw"))
-		LD->flags |= MLF_DontDraw;
-	else if (field.Match("mapped"))
-		LD->flags |= MLF_Mapped;
-
-	else if (field.Match("passuse"))
-		LD->flags |= MLF_Boom_PassThru;
-
-	else
+	switch (field.Key())
 	{
-		gLog.debugPrintf("linedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfKey::v1:			LD->start = value.DecodeInt(); break;
+	case UdmfKey::v2:			LD->end = value.DecodeInt(); break;
+	case UdmfKey::sidefront:	LD->right = value.DecodeInt(); break;
+	case UdmfKey::sideback:		LD->left = value.DecodeInt(); break;
+	case UdmfKey::special:		LD->type = value.DecodeInt(); break;
+
+	case UdmfKey::arg0:		LD->tag = value.DecodeInt(); break;
+	case UdmfKey::arg1:		LD->arg2 = value.DecodeInt(); break;
+	case UdmfKey::arg2:		LD->arg3 = value.DecodeInt(); break;
+	case UdmfKey::arg3:		LD->arg4 = value.DecodeInt(); break;
+	case UdmfKey::arg4:		LD->arg5 = value.DecodeInt(); break;
+
+	case UdmfKey::blocking:			LD->flags |= MLF_Blocking; break;
+	case UdmfKey::blockmonsters:	LD->flags |= MLF_BlockMonsters; break;
+	case UdmfKey::twosided:			LD->flags |= MLF_TwoSided; break;
+	case UdmfKey::dontpegtop:		LD->flags |= MLF_UpperUnpegged; break;
+	case UdmfKey::dontpegbottom:	LD->flags |= MLF_LowerUnpegged; break;
+	case UdmfKey::secret:			LD->flags |= MLF_Secret; break;
+	case UdmfKey::blocksound:		LD->flags |= MLF_SoundBlock; break;
+	case UdmfKey::dontdraw:			LD->flags |= MLF_DontDraw; break;
+	case UdmfKey::mapped:			LD->flags |= MLF_Mapped; break;
+
+	case UdmfKey::passuse:			LD->flags |= MLF_Boom_PassThru; break;
+
+	default:
+		chunk.NoteField(ObjType::linedefs, (int)chunk.linedefs.size(), field);
+		break;
 	}
 }
 
-static void UDMF_ParseSidedefField(const Document &doc, SideDef *SD, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseSidedefField(Udmf_Chunk &chunk, SideDef *SD, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// Note: sector numbers are validated later on
 
 	// TODO: consider how to handle "offsetx_top" (etc), if at all
 
-	if (field.Match("sector"))
-		SD->sector = value.DecodeInt();
-	else if (field.Match("texturetop"))
-		SD->upper_tex = value.DecodeTexture();
-	else if (field.Match("texturebottom"))
-		SD->lower_tex = value.DecodeTexture();
-	else if (field.Match("texturemiddle"))
-		SD->mid_tex = value.DecodeTexture();
-	else if (field.Match("offsetx"))
-		SD->x_offset = value.DecodeInt();
-	else if (field.Match("offsety"))
-		SD->y_offset = value.DecodeInt();
-	else
+	switch (field.Key())
 	{
-		gLog.debugPrintf("sidedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfKey::sector:			SD->sector = value.DecodeInt(); break;
+	case UdmfKey::texturetop:		SD->upper_tex = chunk.AddTexture(value); break;
+	case UdmfKey::texturebottom:	SD->lower_tex = chunk.AddTexture(value); break;
+	case UdmfKey::texturemiddle:	SD->mid_tex = chunk.AddTexture(value); break;
+	case UdmfKey::offsetx:			SD->x_offset = value.DecodeInt(); break;
+	case UdmfKey::offsety:			SD->y_offset = value.DecodeInt(); break;
+
+	default:
+		chunk.NoteField(ObjType::sidedefs, (int)chunk.sidedefs.size(), field);
+		break;
 	}
 }
 
-static void UDMF_ParseSectorField(const Document &doc, Sector *S, const Udmf_Token& field, const Udmf_Token& value)
-{
-	if (field.Match("heightfloor"))
-		S->floorh = value.DecodeInt();
-	else if (field.Match("heightceiling"))
-		S->ceilh = value.DecodeInt();
-	else if (field.Match("texturefloor"))
-		S->floor_tex = value.DecodeTexture();
-	else if (field.Match("textureceiling"))
-		S->ceil_tex = value.DecodeTexture();
-	else if (field.Match("lightlevel"))
-		S->light = value.DecodeInt();
-	else if (field.Match("special"))
-		S->type = value.DecodeInt();
-	else if (field.Match("id"))
-		S->tag = value.DecodeInt();
-	else
+static void UDMF_ParseSectorField(Udmf_Chunk &chunk, Sector *S, const Udmf_Token& field, const Udmf_Token& value)
+{
+	switch (field.Key())
 	{
-		gLog.debugPrintf("sector #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfKey::heightfloor:		S->floorh = value.DecodeInt(); break;
+	case UdmfKey::heightceiling:	S->ceilh = value.DecodeInt(); break;
+	case UdmfKey::texturefloor:		S->floor_tex = chunk.AddTexture(value); break;
+	case UdmfKey::textureceiling:	S->ceil_tex = chunk.AddTexture(value); break;
+	case UdmfKey::lightlevel:		S->light = value.DecodeInt(); break;
+	case UdmfKey::special:			S->type = value.DecodeInt(); break;
+	case UdmfKey::id:				S->tag = value.DecodeInt(); break;
+
+	default:
+		chunk.NoteField(ObjType::sectors, (int)chunk.sectors.size(), field);
+		break;
 	}
 }
 
-static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Token& name)
+static void UDMF_ParseObject(Udmf_Chunk &chunk, Udmf_Parser& parser, const Udmf_Token& name)
 {
 	// create a new object of the specified type
 	Objid kind;
@@ -540,51 +694,59 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Toke
 	SideDef *new_SD = NULL;
 	Sector  *new_S  = NULL;
 
-	if (name.Match("thing"))
+	switch (name.Key())
+	{
+	case UdmfKey::thing:
 	{
 		kind = Objid(ObjType::things, 1);
-		auto addedThing = std::make_unique<Thing>();
-		addedThing->options = MTF_Not_SP | MTF_Not_COOP | MTF_Not_DM;
-		doc.things.push_back(std::move(addedThing));
-		new_T = doc.things.back().get();
+		Thing addedThing;
+		addedThing.options = MTF_Not_SP | MTF_Not_COOP | MTF_Not_DM;
+		chunk.things.push_back(std::move(addedThing));
+		new_T = &chunk.things.back();
+		break;
 	}
-	else if (name.Match("vertex"))
+	case UdmfKey::vertex:
 	{
 		kind = Objid(ObjType::vertices, 1);
-		auto addedVertex = std::make_unique<Vertex>();
-		doc.vertices.push_back(std::move(addedVertex));
-		new_V = doc.vertices.back().get();
+		chunk.vertices.emplace_back();
+		new_V = &chunk.vertices.back();
+		break;
 	}
-	else if (name.Match("linedef"))
+	case UdmfKey::linedef:
 	{
 		kind = Objid(ObjType::linedefs, 1);
-		auto addedLine = std::make_shared<LineDef>();
-		doc.linedefs.push_back(std::move(addedLine));
-		new_LD = doc.linedefs.back().get();
+		chunk.linedefs.emplace_back();
+		new_LD = &chunk.linedefs.back();
+		break;
 	}
-	else if (name.Match("sidedef"))
+	case UdmfKey::sidedef:
 	{
 		kind = Objid(ObjType::sidedefs, 1);
-		auto addedSide = std::make_shared<SideDef>();
-		addedSide->mid_tex = BA_InternaliseString("-");
-		addedSide->lower_tex = addedSide->mid_tex;
-		addedSide->upper_tex = addedSide->mid_tex;
-		doc.sidedefs.push_back(std::move(addedSide));
-		new_SD = doc.sidedefs.back().get();
+		SideDef addedSide;
+		addedSide.mid_tex = UDMF_LOCAL_DASH;
+		addedSide.lower_tex = addedSide.mid_tex;
+		addedSide.upper_tex = addedSide.mid_tex;
+		chunk.sidedefs.push_back(std::move(addedSide));
+		new_SD = &chunk.sidedefs.back();
+		break;
 	}
-	else if (name.Match("sector"))
+	case UdmfKey::sector:
 	{
 		kind = Objid(ObjType::sectors, 1);
-		auto addedSector = std::make_shared<Sector>();
-		addedSector->light = 160;
-		doc.sectors.push_back(std::move(addedSector));
-		new_S = doc.sectors.back().get();
+		Sector addedSector;
+		addedSector.light = 160;
+		chunk.sectors.push_back(std::move(addedSector));
+		new_S = &chunk.sectors.back();
+		break;
+	}
+	default:
+		break;
 	}
 
 	if (!kind.valid())
 	{
 		// unknown object kind
-		gLog.printf("skipping unknown block '%s' in UDMF\n", name.c_str());
+		chunk.notes.push_back({ Udmf_Note::Kind::block, ObjType::things, 0, name });
 	}
 
 	for (;;)
@@ -593,10 +755,13 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Toke
 		if (tok.IsEOF())
 			break;
 
-		if (tok.Match("}"))
+		if (tok.Match('}'))
+		{
+			chunk.closedAtEnd = parser.AtEnd();
 			break;
+		}
 
-		if (! parser.Expect("="))
+		if (! parser.Expect('='))
 		{
 			// TODO mark error
 			parser.SkipToEOLN();
@@ -607,7 +772,7 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Toke
 		if (value.IsEOF())
 			break;
 
-		if (! parser.Expect(";"))
+		if (! parser.Expect(';'))
 		{
 			// TODO mark error
 			parser.SkipToEOLN();
@@ -615,20 +780,157 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Toke
 		}
 
 		if (new_T)
-			UDMF_ParseThingField(doc, new_T, tok, value);
+			UDMF_ParseThingField(chunk, new_T, tok, value);
 
 		if (new_V)
-			UDMF_ParseVertexField(doc, new_V, tok, value);
+			UDMF_ParseVertexField(chunk, new_V, tok, value);
 
 		if (new_LD)
-			UDMF_ParseLinedefField(doc, new_LD, tok, value);
+			UDMF_ParseLinedefField(chunk, new_LD, tok, value);
 
 		if (new_SD)
-			UDMF_ParseSidedefField(doc, new_SD, tok, value);
+			UDMF_ParseSidedefField(chunk, new_SD, tok, value);
 
 		if (new_S)
-			UDMF_ParseSectorField(doc, new_S, tok, value);
+			UDMF_ParseSectorField(chunk, new_S, tok, value);
+	}
+}
+
+static void UDMF_ParseChunk(Udmf_Chunk &chunk)
+{
+	Udmf_Parser parser(chunk.start, chunk.end);
+
+	for (;;)
+	{
+		Udmf_Token tok = parser.Next();
+		if (tok.IsEOF())
+			break;
+
+		chunk.closedAtEnd = false;
+
+		if (! tok.IsIdentifier())
+		{
+			// something has gone wrong
+			// TODO mark the error somehow, pop-up dialog later
+			parser.SkipToEOLN();
+			continue;
+		}
+
+		Udmf_Token tok2 = parser.Next();
+		if (tok2.IsEOF())
+			break;
+
+		if (tok2.Match('='))
+		{
+			UDMF_ParseGlobalVar(chunk, parser, tok);
+			continue;
+		}
+		if (tok2.Match('{'))
+		{
+			UDMF_ParseObject(chunk, parser, tok);
+			continue;
+		}
+
+		// unexpected symbol
+		// TODO mark the error somehow, show dialog later
+		parser.SkipToEOLN();
+	}
+}
+
+//
+// Finds where to split the lump, after a '}' on a line of its own.
+// That is how every editor ends a block, but it could also be inside
+// a comment, so the chunk before the split checks it when parsed.
+// Returns 'end' if there is no such place.
+//
+static const char *UDMF_FindSplit(const char *pos, const char *end)
+{
+	static const char pattern[] = "\n}";
+
+	for (;;)
+	{
+		pos = std::search(pos, end, pattern, pattern + 2);
+
+		if (end - pos < 3)
+			return end;
+
+		pos += 2;
+
+		if (*pos == '\n' || *pos == '\r')
+			return pos;
+	}
+}
+
+static std::vector<Udmf_Chunk> UDMF_SplitChunks(const char *start, const char *end, int num_chunks)
+{
+	std::vector<Udmf_Chunk> chunks;
+
+	const char *pos = start;
+
+	for (int i = 1 ; i < num_chunks && pos < end ; i++)
+	{
+		const char *split = UDMF_FindSplit(std::max(pos, start + (end - start) / num_chunks * i), end);
+
+		chunks.emplace_back(pos, split);
+		pos = split;
+	}
+
+	if (pos < end || chunks.empty())
+		chunks.emplace_back(pos, end);
+
+	return chunks;
+}
+
+//
+// Adds the chunk's objects to the level, after those of earlier chunks
+//
+static void UDMF_MergeChunk(Document &doc, LoadingData &loading, Udmf_Chunk &chunk)
+{
+	std::vector<StringID> tex_ids;
+	tex_ids.reserve(chunk.textures.size());
+
+	for (const SString &name : chunk.textures)
+		tex_ids.push_back(BA_InternaliseString(name));
+
+	for (SideDef &SD : chunk.sidedefs)
+	{
+		SD.upper_tex = tex_ids[SD.upper_tex.get()];
+		SD.mid_tex   = tex_ids[SD.mid_tex.get()];
+		SD.lower_tex = tex_ids[SD.lower_tex.get()];
+	}
+	for (Sector &S : chunk.sectors)
+	{
+		S.floor_tex = tex_ids[S.floor_tex.get()];
+		S.ceil_tex  = tex_ids[S.ceil_tex.get()];
 	}
+
+	for (const Udmf_Note &note : chunk.notes)
+	{
+		switch (note.kind)
+		{
+		case Udmf_Note::Kind::global:
+			gLog.printf("skipping unknown global '%s' in UDMF\n", note.name.ToString().c_str());
+			break;
+
+		case Udmf_Note::Kind::block:
+			gLog.printf("skipping unknown block '%s' in UDMF\n", note.name.ToString().c_str());
+			break;
+
+		case Udmf_Note::Kind::field:
+			gLog.debugPrintf("%s #%d: unknown field '%s'\n", NameForObjectType(note.type),
+							 doc.numObjects(note.type) + note.index, note.name.ToString().c_str());
+			break;
+		}
+	}
+
+	if (chunk.hasNamespace)
+		loading.udmfNamespace = chunk.udmfNamespace;
+
+	doc.things.append(std::move(chunk.things));
+	doc.vertices.append(std::move(chunk.vertices));
+	doc.linedefs.append(std::move(chunk.linedefs));
+	doc.sidedefs.append(std::move(chunk.sidedefs));
+	doc.sectors.append(std::move(chunk.sectors));
 }
 
 
@@ -641,7 +943,7 @@ void Document::ValidateLevel_UDMF(const ConfigData &config, BadCount &bad)
 
 	for (int n = 0 ; n < numLinedefs(); n++)
 	{
-		auto L = linedefs[n];
+		LineDef *L = linedefs[n];
 
 		ValidateVertexRefs(*L, n, bad);
 		ValidateSidedefRefs(*L, n, config, bad);
@@ -649,102 +951,219 @@ void Document::ValidateLevel_UDMF(const ConfigData &config, BadCount &bad)
 }
 
 
-void Instance::UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document& doc, LoadingData &loading, BadCount &bad) const
+//
+// Big lumps are parsed in chunks on several threads (0 for one per CPU).
+// The result is the same as parsing it all in one go.
+//
+void Instance::UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document& doc, LoadingData &loading, BadCount &bad, int num_threads) const
 {
 	const Lump_c *lump = Load_LookupAndSeek(loading_level, load_wad, "TEXTMAP");
 	// we assume this cannot happen
 	if (! lump)
 		return;
 
-	// NOTE: this must be a pointer to heap, due to stack size.
-	auto parser = std::make_unique<Udmf_Parser>(*lump);
+	const char *start = reinterpret_cast<const char *>(lump->data());
+	const char *end = start + lump->Length();
 
-	for (;;)
-	{
-		Udmf_Token tok = parser->Next();
-		if (tok.IsEOF())
-			break;
+	if (num_threads <= 0)
+		num_threads = WorkerPool::defaultThreads();
 
-		if (! tok.IsIdentifier())
-		{
-			// something has gone wrong
-			// TODO mark the error somehow, pop-up dialog later
-			parser->SkipToEOLN();
-			continue;
-		}
+	// a few chunks per thread, to even out the work
+	int num_chunks = 1;
+	if (num_threads > 1)
+		num_chunks = (int)std::min((size_t)num_threads * 4, (end - start) / UDMF_CHUNK_SIZE);
 
-		Udmf_Token tok2 = parser->Next();
-		if (tok2.IsEOF())
-			break;
+	std::vector<Udmf_Chunk> chunks = UDMF_SplitChunks(start, end, num_chunks);
+
+	if (chunks.size() > 1)
+	{
+		WorkerPool pool(num_threads);
 
-		if (tok2.Match("="))
+		pool.parallelFor((int)chunks.size(), [&chunks](int index)
 		{
-			UDMF_ParseGlobalVar(loading, *parser, tok);
-			continue;
-		}
-		if (tok2.Match("{"))
+			UDMF_ParseChunk(chunks[index]);
+		});
+
+		// a chunk which did not end with a block was split in the wrong
+		// place (and the next one started wrong), so join the two and
+		// parse them again.
+		for (size_t i = 0 ; i + 1 < chunks.size() ; )
 		{
-			UDMF_ParseObject(doc, *parser, tok);
-			continue;
-		}
+			if (chunks[i].closedAtEnd)
+			{
+				i++;
+				continue;
+			}
 
-		// unexpected symbol
-		// TODO mark the error somehow, show dialog later
-		parser->SkipToEOLN();
+			Udmf_Chunk joined(chunks[i].start, chunks[i + 1].end);
+			UDMF_ParseChunk(joined);
+
+			chunks[i] = std::move(joined);
+			chunks.erase(chunks.begin() + i + 1);
+		}
+	}
+	else
+	{
+		UDMF_ParseChunk(chunks[0]);
 	}
 
+	for (Udmf_Chunk &chunk : chunks)
+		UDMF_MergeChunk(doc, loading, chunk);
+
 	doc.ValidateLevel_UDMF(conf, bad);
 }
 
 
 //----------------------------------------------------------------------
 
-static inline void WrFlag(Lump_c *lump, int flags, const char *name, int mask)
+//
+// Builds up TEXTMAP text in memory, which is much quicker than a Printf
+// for every field. The keys passed in include the " = " part.
+//
+class Udmf_Writer
 {
-	if ((flags & mask) != 0)
+private:
+	std::string text;
+
+public:
+	const std::string &Text() const
 	{
-		lump->Printf("%s = true;\n", name);
+		return text;
+	}
+
+	void Reserve(size_t size)
+	{
+		text.reserve(size);
 	}
-}
 
-static void UDMF_WriteInfo(const LoadingData &loading, Lump_c *lump)
+	void Raw(std::string_view part)
+	{
+		text.append(part);
+	}
+
+	void Int(int value)
+	{
+		char buffer[16];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		text.append(buffer, result.ptr);
+	}
+
+	// the same as printf's "%1.3f"
+	void Coord(double value)
+	{
+		char buffer[64];
+#ifdef __cpp_lib_to_chars
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 3);
+		text.append(buffer, result.ptr);
+#else
+		int len = snprintf(buffer, sizeof(buffer), "%1.3f", value);
+		text.append(buffer, len);
+#endif
+	}
+
+	void IntField(std::string_view key, int value)
+	{
+		Raw(key);
+		Int(value);
+		Raw(";\n");
+	}
+
+	void CoordField(std::string_view key, double value)
+	{
+		Raw(key);
+		Coord(value);
+		Raw(";\n");
+	}
+
+	void StringField(std::string_view key, const SString &value)
+	{
+		Raw(key);
+		text += '"';
+		Raw(value.get());
+		Raw("\";\n");
+	}
+
+	// the whole line is given, e.g. "blocking = true;\n"
+	void Flag(int flags, std::string_view line, int mask)
+	{
+		if ((flags & mask) != 0)
+			Raw(line);
+	}
+
+	void BeginObject(std::string_view kind, int index)
+	{
+		Raw(kind);
+		Raw(" // ");
+		Int(index);
+		Raw("\n{\n");
+	}
+
+	void EndObject()
+	{
+		Raw("}\n\n");
+	}
+};
+
+
+//
+// A range of objects of one type. These are written separately, perhaps
+// on several threads, and then joined up in order.
+//
+struct Udmf_WriteGroup
+{
+	ObjType type;
+	int first;
+	int last;	// exclusive
+
+	Udmf_Writer out;
+};
+
+// how many objects go in each group
+static const int UDMF_WRITE_GROUP = 4096;
+
+// roughly how much text each object needs
+static const int UDMF_OBJECT_SIZE = 128;
+
+
+static void UDMF_WriteInfo(const LoadingData &loading, Udmf_Writer &out)
 {
-	lump->Printf("namespace = \"%s\";\n\n", loading.udmfNamespace.c_str());
+	out.Raw("namespace = \"");
+	out.Raw(loading.udmfNamespace.get());
+	out.Raw("\";\n\n");
 }
 
-static void UDMF_WriteThings(const Instance &inst, Lump_c *lump)
+static void UDMF_WriteThings(const Instance &inst, Udmf_Writer &out, int first, int last)
 {
-	for (int i = 0 ; i < inst.level.numThings() ; i++)
+	for (int i = first ; i < last ; i++)
 	{
-		lump->Printf("thing // %d\n", i);
-		lump->Printf("{\n");
+		out.BeginObject("thing", i);
 
-		const auto th = inst.level.things[i];
+		const Thing *th = inst.level.things[i];
 
-		lump->Printf("x = %1.3f;\n", th->x());
-		lump->Printf("y = %1.3f;\n", th->y());
+		out.CoordField("x = ", th->x());
+		out.CoordField("y = ", th->y());
 
 		if (th->raw_h != FFixedPoint{})
-			lump->Printf("height = %1.3f;\n", th->h());
+			out.CoordField("height = ", th->h());
 
-		lump->Printf("angle = %d;\n", th->angle);
-		lump->Printf("type = %d;\n", th->type);
+		out.IntField("angle = ", th->angle);
+		out.IntField("type = ", th->type);
 
 		// thing options
-		WrFlag(lump, th->options, "skill1", MTF_Easy);
-		WrFlag(lump, th->options, "skill2", MTF_Easy);
-		WrFlag(lump, th->options, "skill3", MTF_Medium);
-		WrFlag(lump, th->options, "skill4", MTF_Hard);
-		WrFlag(lump, th->options, "skill5", MTF_Hard);
+		out.Flag(th->options, "skill1 = true;\n", MTF_Easy);
+		out.Flag(th->options, "skill2 = true;\n", MTF_Easy);
+		out.Flag(th->options, "skill3 = true;\n", MTF_Medium);
+		out.Flag(th->options, "skill4 = true;\n", MTF_Hard);
+		out.Flag(th->options, "skill5 = true;\n", MTF_Hard);
 
-		WrFlag(lump, ~ th->options, "single", MTF_Not_SP);
-		WrFlag(lump, ~ th->options, "coop",   MTF_Not_COOP);
-		WrFlag(lump, ~ th->options, "dm",     MTF_Not_DM);
+		out.Flag(~ th->options, "single = true;\n", MTF_Not_SP);
+		out.Flag(~ th->options, "coop = true;\n",   MTF_Not_COOP);
+		out.Flag(~ th->options, "dm = true;\n",     MTF_Not_DM);
 
-		WrFlag(lump, th->options, "ambush", MTF_Ambush);
+		out.Flag(th->options, "ambush = true;\n", MTF_Ambush);
 
 		if (inst.conf.features.friend_flag)
-			WrFlag(lump, th->options, "friend", MTF_Friend);
+			out.Flag(th->options, "friend = true;\n", MTF_Friend);
 
 		// TODO Hexen flags
 
@@ -752,73 +1171,71 @@ static void UDMF_WriteThings(const Instance &inst, Lump_c *lump)
 
 		// TODO Hexen special and args
 
-		lump->Printf("}\n\n");
+		out.EndObject();
 	}
 }
 
-static void UDMF_WriteVertices(const Document &doc, Lump_c *lump)
+static void UDMF_WriteVertices(const Document &doc, Udmf_Writer &out, int first, int last)
 {
-	for (int i = 0 ; i < doc.numVertices(); i++)
+	for (int i = first ; i < last ; i++)
 	{
-		lump->Printf("vertex // %d\n", i);
-		lump->Printf("{\n");
+		out.BeginObject("vertex", i);
 
-		const auto vert = doc.vertices[i];
+		const Vertex *vert = doc.vertices[i];
 
-		lump->Printf("x = %1.3f;\n", vert->x());
-		lump->Printf("y = %1.3f;\n", vert->y());
+		out.CoordField("x = ", vert->x());
+		out.CoordField("y = ", vert->y());
 
-		lump->Printf("}\n\n");
+		out.EndObject();
 	}
 }
 
-static void UDMF_WriteLineDefs(const Instance &inst, Lump_c *lump)
+static void UDMF_WriteLineDefs(const Instance &inst, Udmf_Writer &out, int first, int last)
 {
-	for (int i = 0 ; i < inst.level.numLinedefs(); i++)
+	for (int i = first ; i < last ; i++)
 	{
-		lump->Printf("linedef // %d\n", i);
-		lump->Printf("{\n");
+		out.BeginObject("linedef", i);
 
-		const auto ld = inst.level.linedefs[i];
+		const LineDef *ld = inst.level.linedefs[i];
 
-		lump->Printf("v1 = %d;\n", ld->start);
-		lump->Printf("v2 = %d;\n", ld->end);
+		out.IntField("v1 = ", ld->start);
+		out.IntField("v2 = ", ld->end);
 
 		if (ld->right >= 0)
-			lump->Printf("sidefront = %d;\n", ld->right);
+			out.IntField("sidefront = ", ld->right);
 		if (ld->left >= 0)
-			lump->Printf("sideback = %d;\n", ld->left);
+			out.IntField("sideback = ", ld->left);
 
 		if (ld->type != 0)
-			lump->Printf("special = %d;\n", ld->type);
+			out.IntField("special = ", ld->type);
 
 		if (ld->tag != 0)
-			lump->Printf("arg0 = %d;\n", ld->tag);
+			out.IntField("arg0 = ", ld->tag);
 		if (ld->arg2 != 0)
-			lump->Printf("arg1 = %d;\n", ld->arg2);
+			out.IntField("arg1 = ", ld->arg2);
 		if (ld->arg3 != 0)
-			lump->Printf("arg2 = %d;\n", ld->arg3);
+			out.IntField("arg2 = ", ld->arg3);
 		if (ld->arg4 != 0)
-			lump->Printf("arg3 = %d;\n", ld->arg4);
+			out.IntField("arg3 = ", ld->arg4);
 		if (ld->arg5 != 0)
-			lump->Printf("arg4 = %d;\n", ld->arg5);
+			out.IntField("arg4 = ", ld->arg5);
 
 		// linedef flags
-		WrFlag(lump, ld->flags, "blocking",      MLF_Blocking);
-		WrFlag(lump, ld->flags, "blockmonsters", MLF_BlockMonsters);
-		WrFlag(lump, ld->flags, "twosided",      MLF_TwoSided);
-		WrFlag(lump, ld->flags, "dontpegtop",    MLF_UpperUnpegged);
-		WrFlag(lump, ld->flags, "dontpegbottom", MLF_LowerUnpegged);
-		WrFlag(lump, ld->flags, "secret",        MLF_Secret);
-		WrFlag(lump, ld->flags, "blocksound",    MLF_SoundBlock);
-		WrFlag(lump, ld->flags, "dontdraw",      MLF_DontDraw);
-		WrFlag(lump, ld->flags, "mapped",        MLF_Mapped);
+		out.Flag(ld->flags, "blocking = true;\n",      MLF_Blocking);
+		out.Flag(ld->flags, "blockmonsters = true;\n", MLF_BlockMonsters);
+		out.Flag(ld->flags, "twosided = true;\n",      MLF_TwoSided);
+		out.Flag(ld->flags, "dontpegtop = true;\n",    MLF_UpperUnpegged);
+		out.Flag(ld->flags, "dontpegbottom = true;\n", MLF_LowerUnpegged);
+		out.Flag(ld->flags, "secret = true;\n",        MLF_Secret);
+		out.Flag(ld->flags, "blocksound = true;\n",    MLF_SoundBlock);
+		out.Flag(ld->flags, "dontdraw = true;\n",      MLF_DontDraw);
+		out.Flag(ld->flags, "mapped = true;\n",        MLF_Mapped);
 
 		if (inst.conf.features.pass_through)
-			WrFlag(lump, ld->flags, "passuse", MLF_Boom_PassThru);
+			out.Flag(ld->flags, "passuse = true;\n", MLF_Boom_PassThru);
 
 		if (inst.conf.features.midtex_3d)
-			WrFlag(lump, ld->flags, "midtex3d", MLF_Eternity_3DMidTex);
+			out.Flag(ld->flags, "midtex3d = true;\n", MLF_Eternity_3DMidTex);
 
 		// TODO : hexen stuff (SPAC flags, etc)
 
@@ -826,76 +1243,137 @@ static void UDMF_WriteLineDefs(const Instance &inst, Lump_c *lump)
 
 		// TODO : zdoom stuff
 
-		lump->Printf("}\n\n");
+		out.EndObject();
 	}
 }
 
-static void UDMF_WriteSideDefs(const Document &doc, Lump_c *lump)
+static void UDMF_WriteSideDefs(const Document &doc, Udmf_Writer &out, int first, int last)
 {
-	for (int i = 0 ; i < doc.numSidedefs(); i++)
+	for (int i = first ; i < last ; i++)
 	{
-		lump->Printf("sidedef // %d\n", i);
-		lump->Printf("{\n");
+		out.BeginObject("sidedef", i);
 
-		const auto side = doc.sidedefs[i];
+		const SideDef *side = doc.sidedefs[i];
 
-		lump->Printf("sector = %d;\n", side->sector);
+		out.IntField("sector = ", side->sector);
 
 		if (side->x_offset != 0)
-			lump->Printf("offsetx = %d;\n", side->x_offset);
+			out.IntField("offsetx = ", side->x_offset);
 		if (side->y_offset != 0)
-			lump->Printf("offsety = %d;\n", side->y_offset);
+			out.IntField("offsety = ", side->y_offset);
 
 		// use NormalizeTex to ensure no double quote
 
 		if (side->UpperTex() != "-")
-			lump->Printf("texturetop = \"%s\";\n", NormalizeTex(side->UpperTex()).c_str());
+			out.StringField("texturetop = ", NormalizeTex(side->UpperTex()));
 		if (side->LowerTex() != "-")
-			lump->Printf("texturebottom = \"%s\";\n", NormalizeTex(side->LowerTex()).c_str());
+			out.StringField("texturebottom = ", NormalizeTex(side->LowerTex()));
 		if (side->MidTex() != "-")
-			lump->Printf("texturemiddle = \"%s\";\n", NormalizeTex(side->MidTex()).c_str());
+			out.StringField("texturemiddle = ", NormalizeTex(side->MidTex()));
 
-		lump->Printf("}\n\n");
+		out.EndObject();
 	}
 }
 
-static void UDMF_WriteSectors(const Document &doc, Lump_c *lump)
+static void UDMF_WriteSectors(const Document &doc, Udmf_Writer &out, int first, int last)
 {
-	for (int i = 0 ; i < doc.numSectors(); i++)
+	for (int i = first ; i < last ; i++)
 	{
-		lump->Printf("sector // %d\n", i);
-		lump->Printf("{\n");
+		out.BeginObject("sector", i);
 
-		const auto sec = doc.sectors[i];
+		const Sector *sec = doc.sectors[i];
 
-		lump->Printf("heightfloor = %d;\n", sec->floorh);
-		lump->Printf("heightceiling = %d;\n", sec->ceilh);
+		out.IntField("heightfloor = ", sec->floorh);
+		out.IntField("heightceiling = ", sec->ceilh);
 
 		// use NormalizeTex to ensure no double quote
 
-		lump->Printf("texturefloor = \"%s\";\n", NormalizeTex(sec->FloorTex()).c_str());
-		lump->Printf("textureceiling = \"%s\";\n", NormalizeTex(sec->CeilTex()).c_str());
+		out.StringField("texturefloor = ", NormalizeTex(sec->FloorTex()));
+		out.StringField("textureceiling = ", NormalizeTex(sec->CeilTex()));
 
-		lump->Printf("lightlevel = %d;\n", sec->light);
+		out.IntField("lightlevel = ", sec->light);
 		if (sec->type != 0)
-			lump->Printf("special = %d;\n", sec->type);
+			out.IntField("special = ", sec->type);
 		if (sec->tag != 0)
-			lump->Printf("id = %d;\n", sec->tag);
+			out.IntField("id = ", sec->tag);
+
+		out.EndObject();
+	}
+}
+
+static void UDMF_WriteGroup(const Instance &inst, Udmf_WriteGroup &group)
+{
+	group.out.Reserve((size_t)(group.last - group.first) * UDMF_OBJECT_SIZE);
 
-		lump->Printf("}\n\n");
+	switch (group.type)
+	{
+	case ObjType::things:
+		UDMF_WriteThings(inst, group.out, group.first, group.last);
+		break;
+	case ObjType::vertices:
+		UDMF_WriteVertices(inst.level, group.out, group.first, group.last);
+		break;
+	case ObjType::linedefs:
+		UDMF_WriteLineDefs(inst, group.out, group.first, group.last);
+		break;
+	case ObjType::sidedefs:
+		UDMF_WriteSideDefs(inst.level, group.out, group.first, group.last);
+		break;
+	case ObjType::sectors:
+		UDMF_WriteSectors(inst.level, group.out, group.first, group.last);
+		break;
 	}
 }
 
-void Instance::UDMF_SaveLevel(const LoadingData& loading, Wad_file& wad) const
+//
+// Big levels are written on several threads (0 for one per CPU)
+//
+void Instance::UDMF_SaveLevel(const LoadingData& loading, Wad_file& wad, int num_threads) const
 {
+	static const ObjType order[] =
+	{
+		ObjType::things, ObjType::vertices, ObjType::linedefs, ObjType::sidedefs, ObjType::sectors
+	};
+
+	std::vector<Udmf_WriteGroup> groups;
+
+	for (ObjType type : order)
+	{
+		int total = level.numObjects(type);
+
+		for (int first = 0 ; first < total ; first += UDMF_WRITE_GROUP)
+			groups.push_back({ type, first, std::min(first + UDMF_WRITE_GROUP, total), {} });
+	}
+
+	if (num_threads <= 0)
+		num_threads = WorkerPool::defaultThreads();
+
+	num_threads = std::min(num_threads, (int)groups.size());
+
+	if (num_threads > 1)
+	{
+		WorkerPool pool(num_threads);
+
+		pool.parallelFor((int)groups.size(), [this, &groups](int index)
+		{
+			UDMF_WriteGroup(*this, groups[index]);
+		});
+	}
+	else
+	{
+		for (Udmf_WriteGroup &group : groups)
+			UDMF_WriteGroup(*this, group);
+	}
+
+	Udmf_Writer info;
+	UDMF_WriteInfo(loading, info);
+
 	Lump_c &lump = wad.AddLump("TEXTMAP");
 
-	UDMF_WriteInfo(loading, &lump);
-	UDMF_WriteThings(*this, &lump);
-	UDMF_WriteVertices(level, &lump);
-	UDMF_WriteLineDefs(*this, &lump);
-	UDMF_WriteSideDefs(level, &lump);
-	UDMF_WriteSectors(level, &lump);
+	lump.Write(info.Text().data(), (int)info.Text().size());
+
+	for (const Udmf_WriteGroup &group : groups)
+		lump.Write(group.out.Text().data(), (int)group.out.Text().size());
 
 	wad.AddLump("ENDMAP");
 }
@@ -25,10 +25,13 @@
 //------------------------------------------------------------------------
 
 #include "Errors.h"
+#include "ImageCache.h"
 #include "Instance.h"
 #include "main.h"
+#include "WorkerPool.h"
 
 #include <time.h>
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
@@ -98,6 +101,8 @@ bool config::map_scroll_bars  = true;
 
 SString config::default_port = "vanilla";
 
+int config::image_cache_space = 256;  // MB
+
 int config::gui_scheme    = 1;  // gtk+
 int config::gui_color_set = 1;  // bright
 
@@ -866,6 +871,63 @@ static void readPortInfo(std::unordered_map<SString, SString> &parseVars, Loadin
 	}
 }
 
+//
+// Opens the given wads all at once on several threads, since reading the
+// directories of many big wads is slow. Errors are thrown, and messages
+// logged, in the order of the list, as if each wad was opened in turn.
+// The last one is the IWAD.
+//
+static std::vector<std::shared_ptr<Wad_file>> OpenResourceWads(const std::vector<fs::path> &paths) noexcept(false)
+{
+	int count = (int)paths.size();
+
+	std::vector<std::shared_ptr<Wad_file>> wads(count);
+	std::vector<SString> errors(count);
+	std::vector<LogBuffer> logs(count);
+
+	WorkerPool pool(std::min(WorkerPool::defaultThreads(), count));
+
+	pool.parallelFor(count, [&](int i)
+	{
+		LogCapture capture(logs[i]);
+
+		try
+		{
+			bool is_iwad = (i == count - 1);
+
+			if (!is_iwad && !Wad_file::Validate(paths[i]))
+			{
+				errors[i] = SString::printf("Invalid resource WAD file: %s", paths[i].u8string().c_str());
+				return;
+			}
+
+			// only the IWAD is mapped, resource PWADs may get edited
+			// by other programs while we run
+			wads[i] = is_iwad ? Wad_file::openMapped(paths[i]) :
+					Wad_file::Open(paths[i], WadOpenMode::read);
+			if (!wads[i])
+			{
+				errors[i] = is_iwad ? SString("Could not load IWAD file") :
+						SString::printf("Cannot load resource: %s", paths[i].u8string().c_str());
+			}
+		}
+		catch (const std::runtime_error &e)
+		{
+			errors[i] = e.what();
+		}
+	});
+
+	for (int i = 0 ; i < count ; i++)
+	{
+		logs[i].replay();
+
+		if (!errors[i].empty())
+			ThrowException("%s", errors[i].c_str());
+	}
+
+	return wads;
+}
+
 NewResources loadResources(const LoadingData& loading, const WadData &waddata) noexcept(false)
 {
 	auto newres = NewResources();
@@ -877,7 +939,7 @@ NewResources loadResources(const LoadingData& loading, const WadData &waddata) n
 
 	// clear the parse variables, pre-set a few vars
 	std::unordered_map<SString, SString> parseVars = loading.prepareConfigVariables();
-	std::vector<std::shared_ptr<Wad_file>> resourceWads;
+	std::vector<fs::path> wadPaths;
 
 	try
 	{
@@ -894,20 +956,16 @@ NewResources loadResources(const LoadingData& loading, const WadData &waddata) n
 				continue;
 			}
 			// Otherwise wad
-			if (!Wad_file::Validate(resource))
-				ThrowException("Invalid resource WAD file: %s", resource.u8string().c_str());
+			wadPaths.push_back(resource);
+		}
 
-			std::shared_ptr<Wad_file> wad = Wad_file::Open(resource,
-				WadOpenMode::read);
-			if (!wad)
-				ThrowException("Cannot load resource: %s", resource.u8string().c_str());
+		// the IWAD goes last
+		wadPaths.push_back(newres.loading.iwadName);
 
-			resourceWads.push_back(wad);
-		}
+		std::vector<std::shared_ptr<Wad_file>> resourceWads = OpenResourceWads(wadPaths);
 
-		std::shared_ptr<Wad_file> gameWad = Wad_file::Open(newres.loading.iwadName, WadOpenMode::read);
-		if (!gameWad)
-			ThrowException("Could not load IWAD file");
+		std::shared_ptr<Wad_file> gameWad = resourceWads.back();
+		resourceWads.pop_back();
 
 		newres.waddata.reloadResources(gameWad, newres.config, resourceWads);
 	}
@@ -948,6 +1006,7 @@ void Instance::UpdateViewOnResources()
 
 	// reset sector info (for slopes and 3D floors)
 	Subdiv_InvalidateAll();
+	r_view.InvalidatePick();
 
 	if (main_win)
 	{
@@ -1096,6 +1155,13 @@ int main(int argc, char *argv[])
 		// and command line arguments will override both
 		M_ParseCommandLine(argc - 1, argv + 1, CommandLinePass::normal, global::Pwad_list, options);
 
+		// decoded images are kept between runs, unless disabled
+		if (config::image_cache_space > 0)
+		{
+			gInstance.wad.images.setImageCache(std::make_shared<ImageCache>(
+					global::cache_dir / "images", (uint64_t)config::image_cache_space << 20));
+		}
+
 		// TODO: create a new instance
 		gInstance.Editor_Init();
 
@@ -1165,7 +1231,7 @@ int main(int argc, char *argv[])
 		std::shared_ptr<Wad_file> gameWad;
 		if (! DetermineIWAD(gInstance))
 			goto quit;
-		gameWad = Wad_file::Open(gInstance.loaded.iwadName, WadOpenMode::read);
+		gameWad = Wad_file::openMapped(gInstance.loaded.iwadName);
 		if(!gameWad)
 			goto quit;
 
@@ -145,11 +145,13 @@ public:
 		return x;
 	}
 
-	Img_c *FindFlat(const SString &fname, byte& r, byte& g, byte& b, bool& fullbright)
+	Img_c *FindFlat(StringID fname, byte& r, byte& g, byte& b, bool& fullbright)
 	{
 		fullbright = false;
 
-		if (inst.is_sky(fname))
+		int handle = inst.wad.images.flatHandle(inst.conf, fname);
+
+		if (handle == ImageSet::IMAGE_SKY_FLAT)
 		{
 			fullbright = true;
 			glBindTexture(GL_TEXTURE_2D, 0);
@@ -168,14 +170,19 @@ public:
 			if (inst.r_view.lighting)
 				col = inst.conf.miscInfo.floor_colors[1];
 			else
-				col = HashedPalColor(fname, inst.conf.miscInfo.floor_colors);
+				col = HashedPalColor(BA_GetString(fname), inst.conf.miscInfo.floor_colors);
 
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(col), r, g, b);
 			return NULL;
 		}
 
-		Img_c *img = inst.wad.images.getMutableFlat(inst.conf, fname);
-		if (! img)
+		Img_c *img;
+
+		if (handle >= 0)
+		{
+			img = inst.wad.images.drawMutableImage(inst.conf, handle);
+		}
+		else
 		{
 			img = &inst.wad.images.getMutableUnknownFlat(inst.conf);
 			fullbright = config::render_unknown_bright;
@@ -187,7 +194,7 @@ public:
 		return img;
 	}
 
-	Img_c *FindTexture(const SString &tname, byte& r, byte& g, byte& b, bool& fullbright)
+	Img_c *FindTexture(StringID tname, byte& r, byte& g, byte& b, bool& fullbright)
 	{
 		fullbright = false;
 
@@ -201,32 +208,32 @@ public:
 			if (inst.r_view.lighting)
 				col = inst.conf.miscInfo.wall_colors[1];
 			else
-				col = HashedPalColor(tname, inst.conf.miscInfo.wall_colors);
+				col = HashedPalColor(BA_GetString(tname), inst.conf.miscInfo.wall_colors);
 
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(col), r, g, b);
 			return NULL;
 		}
 
 		Img_c *img;
+		int handle = inst.wad.images.textureHandle(inst.conf, tname);
 
-		if (is_null_tex(tname))
+		if (handle >= 0)
+		{
+			img = inst.wad.images.drawMutableImage(inst.conf, handle);
+		}
+		else if (handle == ImageSet::IMAGE_NULL_TEX)
 		{
 			img = &inst.wad.images.getMutableMissingTexture(inst.conf);
 			fullbright = config::render_missing_bright;
 		}
-		else if (is_special_tex(tname))
+		else if (handle == ImageSet::IMAGE_SPECIAL_TEX)
 		{
 			img = &inst.wad.images.getMutableSpecialTexture(inst.wad.palette);
 		}
 		else
 		{
-			img = inst.wad.images.getMutableTexture(inst.conf, tname);
-
-			if (! img)
-			{
-				img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
-				fullbright = config::render_unknown_bright;
-			}
+			img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
+			fullbright = config::render_unknown_bright;
 		}
 
 		img->bind_gl(inst.wad);
@@ -582,7 +589,7 @@ public:
 	}
 
 	void DrawSectorPolygons(const Sector *sec, sector_subdivision_c *subdiv,
-			const slope_plane_c *plane, int znormal, float z, const SString &fname)
+			const slope_plane_c *plane, int znormal, float z, StringID fname)
 	{
 		bool is_slope = plane && plane->sloped;
 
@@ -682,7 +689,7 @@ public:
 	//   - 'U' for upper
 	//   - 'E' for extrafloor side
 	void DrawSide(char where, const LineDef *ld, const SideDef *sd,
-		const SString &texname, const Sector *front, const Sector *back,
+		StringID texname, const Sector *front, const Sector *back,
 		bool sky_upper, float ld_length,
 		float x1, float y1, const slope_plane_c *p1,
 		float x2, float y2, const slope_plane_c *p2)
@@ -799,7 +806,7 @@ public:
 		bool fullbright;
 		Img_c *img;
 
-		img = FindTexture(sd->MidTex(), r, g, b, fullbright);
+		img = FindTexture(sd->mid_tex, r, g, b, fullbright);
 		if (img == NULL)
 			return;
 
@@ -875,7 +882,7 @@ public:
 
 	void DrawLine(int ld_index)
 	{
-		const auto ld = inst.level.linedefs[ld_index];
+		const LineDef *ld = inst.level.linedefs[ld_index];
 
 		if (!inst.level.isVertex(ld->start) || !inst.level.isVertex(ld->end))
 			return;
@@ -1004,14 +1011,14 @@ public:
 
 		const Sector *front = sd ? &inst.level.getSector(*sd) : NULL;
 
-		bool sky_front = inst.is_sky(front->CeilTex());
+		bool sky_front = inst.is_sky(front->ceil_tex);
 		bool sky_upper = false;
 
 		if (ld->OneSided())
 		{
 			sector_3dfloors_c *ex = inst.Subdiv_3DFloorsForSector(sd->sector);
 
-			DrawSide('W', ld.get(), sd, sd->MidTex(), front, NULL, false,
+			DrawSide('W', ld, sd, sd->mid_tex, front, NULL, false,
 				ld_len, x1, y1, &ex->f_plane, x2, y2, &ex->c_plane);
 		}
 		else
@@ -1019,14 +1026,14 @@ public:
 			const SideDef *sd_back = (side == Side::left) ? inst.level.getRight(*ld) : inst.level.getLeft(*ld);
 			const Sector *back  = sd_back ? &inst.level.getSector(*sd_back) : NULL;
 
-			sky_upper = sky_front && inst.is_sky(back->CeilTex());
+			sky_upper = sky_front && inst.is_sky(back->ceil_tex);
 
 			// check for BOOM 242 invisible platforms
 			bool invis_back = false;
 			sector_3dfloors_c *b_ex = inst.Subdiv_3DFloorsForSector(sd_back->sector);
 			if (b_ex->heightsec >= 0)
 			{
-				const auto dummy = inst.level.sectors[b_ex->heightsec];
+				const Sector *dummy = inst.level.sectors[b_ex->heightsec];
 				if (dummy->floorh < back->floorh)
 					invis_back = true;
 			}
@@ -1036,7 +1043,7 @@ public:
 			slope_plane_c dummy_fp;
 			if (f_ex->heightsec >= 0)
 			{
-				const auto dummy = inst.level.sectors[f_ex->heightsec];
+				const Sector *dummy = inst.level.sectors[f_ex->heightsec];
 				if (dummy->floorh < front->floorh)
 				{
 					dummy_fp.Init(static_cast<float>(dummy->floorh));
@@ -1050,17 +1057,17 @@ public:
 
 			// lower part
 			if ((back->floorh > front->floorh || f_sloped) && !self_ref && !invis_back)
-				DrawSide('L', ld.get(), sd, sd->LowerTex(), front, back, sky_upper,
+				DrawSide('L', ld, sd, sd->lower_tex, front, back, sky_upper,
 					ld_len, x1, y1, f_floorp, x2, y2, &b_ex->f_plane);
 
 			// upper part
 			if ((back->ceilh < front->ceilh || c_sloped) && !self_ref && !sky_upper)
-				DrawSide('U', ld.get(), sd, sd->UpperTex(), front, back, sky_upper,
+				DrawSide('U', ld, sd, sd->upper_tex, front, back, sky_upper,
 					ld_len, x1, y1, &b_ex->c_plane, x2, y2, &f_ex->c_plane);
 
 			// railing tex
-			if (!is_null_tex(sd->MidTex()) && inst.r_view.texturing)
-				DrawMidMasker(ld.get(), sd, front, back, sky_upper,
+			if (inst.wad.images.textureHandle(inst.conf, sd->mid_tex) != ImageSet::IMAGE_NULL_TEX && inst.r_view.texturing)
+				DrawMidMasker(ld, sd, front, back, sky_upper,
 					ld_len, x1, y1, x2, y2);
 
 			// draw sides of extrafloors
@@ -1069,8 +1076,8 @@ public:
 				for (size_t k = 0 ; k < b_ex->floors.size() ; k++)
 				{
 					const extrafloor_c& EF = b_ex->floors[k];
-					const auto ef_sd = inst.level.sidedefs[EF.sd];
-					const auto dummy = inst.level.sectors[ef_sd->sector];
+					const SideDef *ef_sd = inst.level.sidedefs[EF.sd];
+					const Sector *dummy = inst.level.sectors[ef_sd->sector];
 
 					if (EF.flags & (EXFL_TOP | EXFL_BOTTOM))
 						continue;
@@ -1084,18 +1091,18 @@ public:
 					if (top_h <= bottom_h)
 						continue;
 
-					SString tex = "-";
+					StringID tex;
 					if (EF.flags & EXFL_UPPER)
-						tex = sd->UpperTex();
+						tex = sd->upper_tex;
 					else if (EF.flags & EXFL_LOWER)
-						tex = sd->LowerTex();
+						tex = sd->lower_tex;
 					else
-						tex = ef_sd->MidTex();
+						tex = ef_sd->mid_tex;
 
 					slope_plane_c p1; p1.Init(static_cast<float>(bottom_h));
 					slope_plane_c p2; p2.Init(static_cast<float>(top_h));
 
-					DrawSide('E', ld.get(), sd, tex, front, back, false,
+					DrawSide('E', ld, sd, tex, front, back, false,
 						ld_len, x1, y1, &p1, x2, y2, &p2);
 				}
 			}
@@ -1113,7 +1120,7 @@ public:
 			slope_plane_c p1; p1.Init(static_cast<float>(front->ceilh));
 			slope_plane_c p2; p2.Init(static_cast<float>(front->ceilh + 16384.0));
 
-			DrawSide('U', ld.get(), sd, "-", front, NULL, true /* sky_upper */,
+			DrawSide('U', ld, sd, StringID(), front, NULL, true /* sky_upper */,
 				ld_len, x1, y1, &p1, x2, y2, &p2);
 		}
 	}
@@ -1125,7 +1132,7 @@ public:
 		if (! subdiv)
 			return;
 
-		const auto sec = inst.level.sectors[sec_index];
+		const Sector *sec = inst.level.sectors[sec_index];
 
 		sector_3dfloors_c *exfloor = inst.Subdiv_3DFloorsForSector(sec_index);
 
@@ -1134,57 +1141,57 @@ public:
 		// support for BOOM's 242 "transfer heights" line type
 		if (exfloor->heightsec >= 0)
 		{
-			const auto dummy = inst.level.sectors[exfloor->heightsec];
+			const Sector *dummy = inst.level.sectors[exfloor->heightsec];
 
 			if (dummy->floorh > sec->floorh && inst.r_view.z < dummy->floorh)
 			{
 				// space C : underwater
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->floorh), dummy->CeilTex());
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(sec->floorh), dummy->FloorTex());
+				DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(dummy->floorh), dummy->ceil_tex);
+				DrawSectorPolygons(sec, subdiv, NULL, +1, static_cast<float>(sec->floorh), dummy->floor_tex);
 
 				// this helps the view to not look weird when clipping around
 				if (dummy->ceilh > sec->floorh)
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+					DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 			else if (dummy->ceilh < sec->ceilh && inst.r_view.z > dummy->ceilh)
 			{
 				// space A : head over ceiling
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), dummy->FloorTex());
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(sec->ceilh), dummy->CeilTex());
+				DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(dummy->ceilh), dummy->floor_tex);
+				DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(sec->ceilh), dummy->ceil_tex);
 
 				if (dummy->floorh < sec->ceilh)
-					DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+					DrawSectorPolygons(sec, subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 			}
 			else if (dummy->floorh < sec->floorh)
 			{
 				// invisible platform
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+				DrawSectorPolygons(sec, subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 
-				if (!inst.is_sky(sec->CeilTex()))
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+				if (!inst.is_sky(sec->ceil_tex))
+					DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 			else
 			{
 				// space B : normal
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+				DrawSectorPolygons(sec, subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 
-				if (!inst.is_sky(sec->CeilTex()))
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+				if (!inst.is_sky(sec->ceil_tex))
+					DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 		} else {
 
 			// normal sector
-			DrawSectorPolygons(sec.get(), subdiv, &exfloor->f_plane, +1, static_cast<float>(sec->floorh), sec->FloorTex());
+			DrawSectorPolygons(sec, subdiv, &exfloor->f_plane, +1, static_cast<float>(sec->floorh), sec->floor_tex);
 
-			if (!inst.is_sky(sec->CeilTex()))
-				DrawSectorPolygons(sec.get(), subdiv, &exfloor->c_plane, -1, static_cast<float>(sec->ceilh), sec->CeilTex());
+			if (!inst.is_sky(sec->ceil_tex))
+				DrawSectorPolygons(sec, subdiv, &exfloor->c_plane, -1, static_cast<float>(sec->ceilh), sec->ceil_tex);
 		}
 
 		// draw planes of 3D floors
 		for (size_t k = 0 ; k < exfloor->floors.size() ; k++)
 		{
 			const extrafloor_c& EF = exfloor->floors[k];
-			const auto dummy = inst.level.sectors[inst.level.sidedefs[EF.sd]->sector];
+			const Sector *dummy = inst.level.sectors[inst.level.sidedefs[EF.sd]->sector];
 
 			// TODO: supporting translucent surfaces is non-trivial and needs
 			//       to be done in separate pass with a depth sort.
@@ -1194,8 +1201,8 @@ public:
 			int top_h = dummy->ceilh;
 			int bottom_h = dummy->floorh;
 
-			SString top_tex = dummy->CeilTex();
-			SString bottom_tex = dummy->FloorTex();
+			StringID top_tex = dummy->ceil_tex;
+			StringID bottom_tex = dummy->floor_tex;
 
 			if (EF.flags & EXFL_TOP)
 				bottom_h = top_h;
@@ -1207,14 +1214,14 @@ public:
 				std::swap(top_tex, bottom_tex);
 			}
 
-			DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(top_h), top_tex);
-			DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(bottom_h), bottom_tex);
+			DrawSectorPolygons(sec, subdiv, NULL, +1, static_cast<float>(top_h), top_tex);
+			DrawSectorPolygons(sec, subdiv, NULL, -1, static_cast<float>(bottom_h), bottom_tex);
 		}
 	}
 
 	void DrawThing(int th_index)
 	{
-		const auto th = inst.level.things[th_index];
+		const Thing *th = inst.level.things[th_index];
 
 		const thingtype_t &info = inst.conf.getThingType(th->type);
 
@@ -1332,7 +1339,7 @@ public:
 
 	void HighlightLine(int ld_index, int part)
 	{
-		const auto L = inst.level.linedefs[ld_index];
+		const LineDef *L = inst.level.linedefs[ld_index];
 
 		Side side = (part & PART_LF_ALL) ? Side::left : Side::right;
 
@@ -1373,7 +1380,7 @@ public:
 			{
 				int zi1, zi2;
 
-				if (! inst.LD_RailHeights(zi1, zi2, L.get(), sd, front, back))
+				if (! inst.LD_RailHeights(zi1, zi2, L, sd, front, back))
 					return;
 
 				z1 = static_cast<float>(zi1); z2 = static_cast<float>(zi2);
@@ -1400,7 +1407,7 @@ public:
 
 	void HighlightSector(int sec_index, int part)
 	{
-		const auto sec = inst.level.sectors[sec_index];
+		const Sector *sec = inst.level.sectors[sec_index];
 
 		float z = static_cast<float>((part == PART_CEIL) ? sec->ceilh : sec->floorh);
 
@@ -1440,7 +1447,7 @@ public:
 
 	void HighlightThing(int th_index)
 	{
-		const auto th = inst.level.things[th_index];
+		const Thing *th = inst.level.things[th_index];
 		float tx = static_cast<float>(th->x());
 		float ty = static_cast<float>(th->y());
 
@@ -154,6 +154,28 @@ double Render_View_t::DistToViewPlane(v2double_t map)
 	return map.x * Cos + map.y * Sin;
 }
 
+Render_View_t::PickKey Render_View_t::CurrentPickKey() const
+{
+	// things and rails are only picked in their own edit modes
+	return PickKey(x, y, z, angle, screen_w, screen_h, aspect_sh, sprites, inst.edit.mode);
+}
+
+void Render_View_t::SetPickCurrent()
+{
+	pick_key = CurrentPickKey();
+}
+
+bool Render_View_t::PickIsCurrent() const
+{
+	return (int)pick.size() == screen_w * screen_h && ! pick.empty() &&
+		   pick_key == CurrentPickKey();
+}
+
+void Render_View_t::InvalidatePick()
+{
+	pick.clear();
+}
+
 void Render_View_t::UpdateScreen(int ow, int oh)
 {
 	// in low detail mode, setup size so that expansion always covers
@@ -200,7 +222,7 @@ static const Thing *FindPlayer(const Document &doc, int typenum)
 
 	for ( int i = doc.numThings()-1 ; i >= 0 ; i--)
 		if (doc.things[i]->type == typenum)
-			return doc.things[i].get();
+			return doc.things[i];
 
 	return nullptr;  // not found
 }
@@ -264,6 +286,8 @@ void Render3D_NotifyChange(ObjType type, int objnum, int field)
 void Render3D_NotifyEnd(Instance &inst)
 {
 	thing_sec_cache::Update(inst);
+
+	inst.r_view.InvalidatePick();
 }
 
 
@@ -353,19 +377,19 @@ private:
 		switch (type)
 		{
 			case ObjType::things:
-				return reinterpret_cast<int*>(inst.level.things[objnum].get());
+				return reinterpret_cast<int*>(inst.level.things[objnum]);
 
 			case ObjType::vertices:
-				return reinterpret_cast<int *>(inst.level.vertices[objnum].get());
+				return reinterpret_cast<int *>(inst.level.vertices[objnum]);
 
 			case ObjType::sectors:
-				return reinterpret_cast<int *>(inst.level.sectors[objnum].get());
+				return reinterpret_cast<int *>(inst.level.sectors[objnum]);
 
 			case ObjType::sidedefs:
-				return reinterpret_cast<int *>(inst.level.sidedefs[objnum].get());
+				return reinterpret_cast<int *>(inst.level.sidedefs[objnum]);
 
 			case ObjType::linedefs:
-				return reinterpret_cast<int *>(inst.level.linedefs[objnum].get());
+				return reinterpret_cast<int *>(inst.level.linedefs[objnum]);
 
 			default:
 				BugError("SaveBucket with bad mode\n");
@@ -389,7 +413,7 @@ private:
 
 static void AdjustOfs_UpdateBBox(Instance &inst, int ld_num)
 {
-	const auto L = inst.level.linedefs[ld_num];
+	const LineDef *L = inst.level.linedefs[ld_num];
 
 	float lx1 = static_cast<float>(inst.level.getStart(*L).x());
 	float ly1 = static_cast<float>(inst.level.getStart(*L).y());
@@ -432,7 +456,7 @@ static void AdjustOfs_Add(Instance &inst, int ld_num, int part)
 	if (! inst.edit.adjust_bucket)
 		return;
 
-	const auto L = inst.level.linedefs[ld_num];
+	const LineDef *L = inst.level.linedefs[ld_num];
 
 	// ignore invalid sides (sanity check)
 	int sd_num = (part & PART_LF_ALL) ? L->left : L->right;
@@ -899,7 +923,7 @@ static void DragThings_Update(Instance &inst)
 	}
 #endif
 
-	const auto T = inst.level.things[inst.edit.drag_thing_num];
+	const Thing *T = inst.level.things[inst.edit.drag_thing_num];
 
 	float old_x = static_cast<float>(T->x());
 	float old_y = static_cast<float>(T->y());
@@ -1109,7 +1133,7 @@ int Instance::GrabSelectedThing()
 	{
 		for (sel_iter_c it(*edit.Selected) ; !it.done() ; it.next())
 		{
-			const auto T = level.things[*it];
+			const Thing *T = level.things[*it];
 			if (result >= 0 && T->type != result)
 			{
 				Beep("multiple thing types");
@@ -1181,18 +1205,18 @@ StringID Instance::GrabSelectedFlat()
 			return StringID(-1);
 		}
 
-		const auto S = level.sectors[edit.highlight.num];
+		const Sector *S = level.sectors[edit.highlight.num];
 
-		result = SEC_GrabFlat(S.get(), edit.highlight.parts);
+		result = SEC_GrabFlat(S, edit.highlight.parts);
 	}
 	else
 	{
 		for (sel_iter_c it(*edit.Selected) ; !it.done() ; it.next())
 		{
-			const auto S = level.sectors[*it];
+			const Sector *S = level.sectors[*it];
 			byte parts = edit.Selected->get_ext(*it);
 
-			StringID tex = SEC_GrabFlat(S.get(), parts & ~1);
+			StringID tex = SEC_GrabFlat(S, parts & ~1);
 
 			if (result.isValid() && tex != result)
 			{
@@ -1327,18 +1351,18 @@ StringID Instance::GrabSelectedTexture()
 			return StringID(-1);
 		}
 
-		const auto L = level.linedefs[edit.highlight.num];
+		const LineDef *L = level.linedefs[edit.highlight.num];
 
-		result = LD_GrabTex(L.get(), edit.highlight.parts);
+		result = LD_GrabTex(L, edit.highlight.parts);
 	}
 	else
 	{
 		for (sel_iter_c it(*edit.Selected) ; !it.done() ; it.next())
 		{
-			const auto L = level.linedefs[*it];
+			const LineDef *L = level.linedefs[*it];
 			byte parts = edit.Selected->get_ext(*it);
 
-			StringID tex = LD_GrabTex(L.get(), parts & ~1);
+			StringID tex = LD_GrabTex(L, parts & ~1);
 
 			if (result.isValid() && tex != result)
 			{
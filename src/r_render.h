@@ -28,6 +28,51 @@
 #define __EUREKA_R_RENDER__
 
 #include "im_img.h"
+#include "objid.h"
+
+#include <tuple>
+
+//
+// What the software renderer drew at one pixel: the object and part
+// under it, and enough to find the map coordinate of the wall or flat
+// behind it (see RendInfo::QueryCalcCoord). Packed into 8 bytes, since
+// there is one for every pixel of every frame.
+//
+struct Render_Pick_t
+{
+	// the largest object number which fits
+	static constexpr int MAX_NUM = (1 << 20) - 2;
+
+	// when on a flat this is its height, else the distance of the wall
+	// there, 0 when there is neither
+	float depth = 0;
+
+	void setObject(const Objid &obj) noexcept
+	{
+		bits = (bits & FLAT_BIT) | static_cast<u32_t>(obj.type) |
+			   static_cast<u32_t>(obj.parts) << 4 | static_cast<u32_t>(obj.num + 1) << 12;
+	}
+	Objid object() const noexcept
+	{
+		return Objid(static_cast<ObjType>(bits & 7), static_cast<int>(bits >> 12) - 1, (bits >> 4) & 0xFF);
+	}
+
+	void setOnFlat(bool on_flat) noexcept
+	{
+		bits = on_flat ? (bits | FLAT_BIT) : (bits & ~FLAT_BIT);
+	}
+	bool onFlat() const noexcept
+	{
+		return (bits & FLAT_BIT) != 0;
+	}
+
+private:
+	// the type in bits 0-2, then FLAT_BIT, the parts in bits 4-11 and
+	// the number plus one above those
+	static constexpr u32_t FLAT_BIT = 8;
+
+	u32_t bits = 0;
+};
 
 
 struct Render_View_t
@@ -57,14 +102,37 @@ public:
 
 	bool gravity = true;  // when true, walk on ground
 
+	// when true, only what can be seen from the camera's sector gets
+	// drawn (software renderer)
+	bool culling = true;
+
+	// how many threads draw the columns (software renderer), 0 for one
+	// per CPU
+	int threads = 0;
+
 	std::vector<int> thing_sectors;
 
+	// when true, the software renderer also notes what it drew at each
+	// pixel, so that the mouse can be looked up without rendering again
+	bool picking = true;
+
+	// what was drawn at each pixel, column by column, empty when not
+	// known
+	std::vector<Render_Pick_t> pick;
+
 	// current mouse coords (in window), invalid if -1
 	int mouse_x = -1, mouse_y = -1;
 
 private:
 	Instance &inst;
 
+	// what the pick buffer was made from
+	typedef std::tuple<double, double, double, double, int, int, float, bool, ObjType> PickKey;
+
+	PickKey CurrentPickKey() const;
+
+	PickKey pick_key;
+
 public:
 	explicit Render_View_t(Instance &inst) : inst(inst)
 	{
@@ -79,6 +147,12 @@ public:
 
 	double DistToViewPlane(v2double_t map);
 
+	// the pick buffer is only good while the view stays the same, and
+	// until the map changes
+	void SetPickCurrent();
+	bool PickIsCurrent() const;
+	void InvalidatePick();
+
 	/* r_editing_info_t stuff */
 
 	void AddAdjustSide(const Objid& obj);
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <algorithm>
+#include <tuple>
 
 #ifndef NO_OPENGL
 #include "FL/gl.h"
@@ -47,29 +48,80 @@
 #include "SideDef.h"
 #include "Thing.h"
 #include "Vertex.h"
+#include "WorkerPool.h"
 
-static img_pixel_t DoomLightRemap(const Instance &inst, int light, float dist, img_pixel_t pixel)
+//
+// R_DoomLightingEquation() worked out for every light level and distance
+// band, the band being int(1280 / dist). Lights past 255 and bands past
+// 63 give the same colormaps as those.
+//
+struct DoomLightTable
 {
-	int map = R_DoomLightingEquation(light, dist);
+	byte map[64][64];
 
-	if (pixel & IS_RGB_PIXEL)
+	DoomLightTable()
 	{
-		map = (map ^ 31) + 1;
+		for (int L = 0 ; L < 64 ; L++)
+		for (int band = 0 ; band < 64 ; band++)
+			map[L][band] = static_cast<byte>(R_DoomLightingEquation(L * 4, 1280.0f / (band + 0.5f)));
+	}
+};
+
+
+//
+// How pixels get darkened at one light level and distance, worked out
+// once for a whole column or span instead of for every pixel.
+//
+struct LightShade
+{
+	// the COLORMAP row for palette pixels
+	const byte *cmap;
 
-		int r = IMG_PIXEL_RED(pixel);
-		int g = IMG_PIXEL_GREEN(pixel);
-		int b = IMG_PIXEL_BLUE(pixel);
+	// for RGB pixels, 1 (dark) to 32 (bright)
+	int scale;
+
+	LightShade(const Instance &inst, int light, float dist)
+	{
+		static const DoomLightTable table;
 
-		r = (r * map) >> 5;
-		g = (g * map) >> 5;
-		b = (b * map) >> 5;
+		int band = int(1280 / std::max(1.0f, dist));
+		int map  = table.map[clamp(0, light >> 2, 63)][std::min(band, 63)];
 
-		return pixelMakeRGB(r, g, b);
+		cmap  = inst.wad.palette.getColormap(map);
+		scale = (map ^ 31) + 1;
 	}
-	else
+
+	inline img_pixel_t Apply(img_pixel_t pixel) const
 	{
-		return inst.wad.palette.getColormapIndex(map, pixel);
+		if (pixel & IS_RGB_PIXEL)
+		{
+			int r = (IMG_PIXEL_RED(pixel)   * scale) >> 5;
+			int g = (IMG_PIXEL_GREEN(pixel) * scale) >> 5;
+			int b = (IMG_PIXEL_BLUE(pixel)  * scale) >> 5;
+
+			return pixelMakeRGB(r, g, b);
+		}
+
+		return cmap[pixel];
 	}
+};
+
+
+//
+// The threads which draw the columns, made again when a different number
+// is asked for. Zero or less means one per CPU.
+//
+static WorkerPool &ColumnPool(int num_threads)
+{
+	static std::unique_ptr<WorkerPool> pool;
+
+	if (num_threads <= 0)
+		num_threads = WorkerPool::defaultThreads();
+
+	if (! pool || pool->numThreads() != num_threads)
+		pool = std::make_unique<WorkerPool>(num_threads);
+
+	return *pool;
 }
 
 
@@ -110,11 +162,13 @@ public:
 	~DrawSurf()
 	{ }
 
-	void FindFlat(const SString & fname)
+	void FindFlat(StringID fname)
 	{
 		fullbright = false;
 
-		if (inst.is_sky(fname))
+		int handle = inst.wad.images.flatHandle(inst.conf, fname);
+
+		if (handle == ImageSet::IMAGE_SKY_FLAT)
 		{
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.sky_color);
 			fullbright = true;
@@ -123,14 +177,14 @@ public:
 
 		if (inst.r_view.texturing)
 		{
-			img = inst.wad.images.W_GetFlat(inst.conf, fname);
-
-			if (! img)
+			if (handle >= 0)
 			{
-				img = &inst.wad.images.IM_UnknownFlat(inst.conf);
-				fullbright = config::render_unknown_bright;
+				img = inst.wad.images.drawImage(inst.conf, handle);
+				return;
 			}
 
+			img = &inst.wad.images.IM_UnknownFlat(inst.conf);
+			fullbright = config::render_unknown_bright;
 			return;
 		}
 
@@ -138,35 +192,36 @@ public:
 		if (inst.r_view.lighting)
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.floor_colors[1]);
 		else
-			col = static_cast<img_pixel_t>(HashedPalColor(fname, inst.conf.miscInfo.floor_colors));
+			col = static_cast<img_pixel_t>(HashedPalColor(BA_GetString(fname), inst.conf.miscInfo.floor_colors));
 	}
 
-	void FindTex(const SString & tname, LineDef *ld)
+	void FindTex(StringID tname, LineDef *ld)
 	{
 		fullbright = false;
 
 		if (inst.r_view.texturing)
 		{
-			if (is_null_tex(tname))
+			int handle = inst.wad.images.textureHandle(inst.conf, tname);
+
+			if (handle >= 0)
+			{
+				img = inst.wad.images.drawImage(inst.conf, handle);
+				return;
+			}
+			else if (handle == ImageSet::IMAGE_NULL_TEX)
 			{
 				img = &inst.wad.images.IM_MissingTex(inst.conf);
 				fullbright = config::render_missing_bright;
 				return;
 			}
-			else if (is_special_tex(tname))
+			else if (handle == ImageSet::IMAGE_SPECIAL_TEX)
 			{
 				img = &inst.wad.images.IM_SpecialTex(inst.wad.palette);
 				return;
 			}
 
-			img = inst.wad.images.getTexture(inst.conf, tname);
-
-			if (! img)
-			{
-				img = &inst.wad.images.IM_UnknownTex(inst.conf);
-				fullbright = config::render_unknown_bright;
-			}
-
+			img = &inst.wad.images.IM_UnknownTex(inst.conf);
+			fullbright = config::render_unknown_bright;
 			return;
 		}
 
@@ -174,7 +229,7 @@ public:
 		if (inst.r_view.lighting)
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.wall_colors[1]);
 		else
-			col = static_cast<img_pixel_t>(HashedPalColor(tname, inst.conf.miscInfo.wall_colors));
+			col = static_cast<img_pixel_t>(HashedPalColor(BA_GetString(tname), inst.conf.miscInfo.wall_colors));
 	}
 };
 
@@ -219,9 +274,6 @@ public:
 	// screen X coordinates
 	int sx1, sx2;
 
-	// for sprites, the remembered open space to clip to
-	int oy1, oy2;
-
 	/* surfaces */
 
 	DrawSurf ceil;
@@ -287,8 +339,8 @@ public:
 		else if (A->th >= 0 && B->th >= 0)
 		{
 			// prevent two things at same location from flickering
-			const auto TA = inst.level.things[A->th];
-			const auto TB = inst.level.things[B->th];
+			const Thing *TA = inst.level.things[A->th];
+			const Thing *TB = inst.level.things[B->th];
 
 			if (TA->raw_x == TB->raw_x && TA->raw_y == TB->raw_y)
 				return A->th > B->th;
@@ -379,7 +431,7 @@ public:
 
 		SideDef *back_sd = (side == Side::left) ? inst.level.getRight(*ld) : inst.level.getLeft(*ld);
 		if (back_sd)
-			back = inst.level.sectors[back_sd->sector].get();
+			back = inst.level.sectors[back_sd->sector];
 
 		// support for BOOM's 242 "transfer heights" line type
 		Sector temp_front;
@@ -388,8 +440,8 @@ public:
 		sector_3dfloors_c *exfloor = inst.Subdiv_3DFloorsForSector(sd->sector);
 		if (exfloor->heightsec >= 0)
 		{
-			const auto dummy = inst.level.sectors[exfloor->heightsec];
-			front = Boom242Sector(front, &temp_front, dummy.get());
+			const Sector *dummy = inst.level.sectors[exfloor->heightsec];
+			front = Boom242Sector(front, &temp_front, dummy);
 		}
 
 		if (back != NULL)
@@ -397,15 +449,15 @@ public:
 			exfloor = inst.Subdiv_3DFloorsForSector(back_sd->sector);
 			if (exfloor->heightsec >= 0)
 			{
-				const auto dummy = inst.level.sectors[exfloor->heightsec];
-				back = Boom242Sector(back, &temp_back, dummy.get());
+				const Sector *dummy = inst.level.sectors[exfloor->heightsec];
+				back = Boom242Sector(back, &temp_back, dummy);
 			}
 		}
 
-		bool sky_upper = back && inst.is_sky(front->CeilTex()) && inst.is_sky(back->CeilTex());
+		bool sky_upper = back && inst.is_sky(front->ceil_tex) && inst.is_sky(back->ceil_tex);
 		bool self_ref  = (front == back) ? true : false;
 
-		if ((front->ceilh > inst.r_view.z || inst.is_sky(front->CeilTex()))
+		if ((front->ceilh > inst.r_view.z || inst.is_sky(front->ceil_tex))
 		    && ! sky_upper && ! self_ref)
 		{
 			ceil.kind = DrawSurf::K_FLAT;
@@ -414,7 +466,7 @@ public:
 			ceil.tex_h = ceil.h1;
 			ceil.y_clip = DrawSurf::SOLID_ABOVE;
 
-			ceil.FindFlat(front->CeilTex());
+			ceil.FindFlat(front->ceil_tex);
 		}
 
 		if (front->floorh < inst.r_view.z && ! self_ref)
@@ -425,7 +477,7 @@ public:
 			floor.tex_h = floor.h2;
 			floor.y_clip = DrawSurf::SOLID_BELOW;
 
-			floor.FindFlat(front->FloorTex());
+			floor.FindFlat(front->floor_tex);
 		}
 
 		if (! back)
@@ -437,7 +489,7 @@ public:
 			lower.h2 = front->ceilh;
 			lower.y_clip = DrawSurf::SOLID_ABOVE | DrawSurf::SOLID_BELOW;
 
-			lower.FindTex(sd->MidTex(), ld);
+			lower.FindTex(sd->mid_tex, ld);
 
 			if (lower.img && (ld->flags & MLF_LowerUnpegged))
 				lower.tex_h = lower.h1 + lower.img->height();
@@ -457,7 +509,7 @@ public:
 			upper.h2 = front->ceilh;
 			upper.y_clip = DrawSurf::SOLID_ABOVE;
 
-			upper.FindTex(sd->UpperTex(), ld);
+			upper.FindTex(sd->upper_tex, ld);
 
 			if (upper.img && ! (ld->flags & MLF_UpperUnpegged))
 				upper.tex_h = upper.h1 + upper.img->height();
@@ -474,7 +526,7 @@ public:
 			lower.h2 = back->floorh;
 			lower.y_clip = DrawSurf::SOLID_BELOW;
 
-			lower.FindTex(sd->LowerTex(), ld);
+			lower.FindTex(sd->lower_tex, ld);
 
 			// note "sky_upper" here, needed to match original DOOM behavior
 			if (ld->flags & MLF_LowerUnpegged)
@@ -490,15 +542,15 @@ public:
 		if (! inst.r_view.texturing)
 			return;
 
-		if (is_null_tex(sd->MidTex()))
+		if (inst.wad.images.textureHandle(inst.conf, sd->mid_tex) == ImageSet::IMAGE_NULL_TEX)
 			return;
 
-		rail.FindTex(sd->MidTex(), ld);
+		rail.FindTex(sd->mid_tex, ld);
 		if (! rail.img)
 			return;
 
 		front = sec;
-		back  = inst.level.sectors[back_sd->sector].get();
+		back  = inst.level.sectors[back_sd->sector];
 
 		int c_h = std::min(front->ceilh,  back->ceilh);
 		int f_h = std::max(front->floorh, back->floorh);
@@ -563,12 +615,77 @@ public:
 	float query_map_y;
 	float query_map_z;
 
+	// the pick buffer being filled, NULL when not picking
+	Render_Pick_t *pick;
+
+	// only fill the pick buffer, drawing nothing
+	bool pick_only;
+
 	// inverse distances over X range, 0 when empty.
 	std::vector<double> depth_x;
 
-	// vertical clip window, an inclusive range
-	int open_y1;
-	int open_y2;
+	// for the visibility walk: the inverse distance of the closest solid
+	// wall found so far in each column, 0 when none.
+	std::vector<double> occlude_x;
+
+	// a wall in one column, apart from the DrawWall so that several
+	// columns can be drawn at once
+	struct ColumnWall
+	{
+		DrawWall *dw;
+
+		// the inverse distance in this column
+		double iz;
+
+		// for sprites and rails, the remembered open space to clip to
+		int oy1, oy2;
+	};
+
+	// the same flat at the same height and light over a stretch of
+	// columns. These get drawn a row at a time once the walls are done,
+	// so that the distance and light only change between rows.
+	struct FlatPlane
+	{
+		const DrawSurf *surf;
+		int light;
+
+		// the first column, and the rows covered in each column from
+		// there on (top > bottom when none)
+		int x1;
+		std::vector<int> top;
+		std::vector<int> bottom;
+	};
+
+	// the flat planes seen in a strip of columns
+	struct FlatStrip
+	{
+		std::vector<FlatPlane> planes;
+
+		// the last plane made for each flat, height and light
+		std::map<std::tuple<const Img_c *, img_pixel_t, int, bool, int>, int> last_plane;
+	};
+
+	// what is being drawn in one column
+	struct Column
+	{
+		int x;
+
+		// vertical clip window, an inclusive range
+		int open_y1;
+		int open_y2;
+
+		FlatStrip *flats;
+	};
+
+	// the sorted active list of each column, column_start[x] being
+	// where the one for column x begins
+	std::vector<ColumnWall> column_walls;
+	std::vector<int> column_start;
+
+	// for the flats, how far the map moves per unit of distance in
+	// each column
+	std::vector<float> flat_cos;
+	std::vector<float> flat_sin;
 
 	// these used by Highlight()
 	int hl_ox, hl_oy;
@@ -587,7 +704,8 @@ public:
 	explicit RendInfo(Instance &inst) :
 		walls(), active(),
 		query_mode(0), query_sx(), query_sy(),
-		depth_x(), open_y1(), open_y2(), inst(inst)
+		pick(NULL), pick_only(false),
+		depth_x(), inst(inst)
 	{ }
 
 	~RendInfo()
@@ -715,15 +833,34 @@ public:
 		return static_cast<float>(inst.r_view.z - (float(y) / inst.r_view.aspect_sh / iz));
 	}
 
-	void AddLine(int ld_index)
+	// where a linedef lands on the screen, see ProjectLine()
+	struct LineSpan
 	{
-		const auto ld = inst.level.linedefs[ld_index];
+		Side side;
+
+		float base_ang;
+		float angle1;
 
+		float dist;
+		float normal;
+
+		double iz1, iz2, diz;
+
+		int sx1, sx2;
+	};
+
+	//
+	// Works out which columns a linedef covers and how far away it is
+	// there, whether or not it has a sidedef facing the camera. Returns
+	// false when it is not on the screen at all.
+	//
+	bool ProjectLine(const LineDef *ld, LineSpan &span)
+	{
 		if (!inst.level.isVertex(ld->start) || !inst.level.isVertex(ld->end))
-			return;
+			return false;
 
 		if (! inst.level.getRight(*ld))
-			return;
+			return false;
 
 		float x1 = static_cast<float>(inst.level.getStart(*ld).x() - inst.r_view.x);
 		float y1 = static_cast<float>(inst.level.getStart(*ld).y() - inst.r_view.y);
@@ -737,26 +874,20 @@ public:
 
 		// reject line if complete behind viewplane
 		if (ty1 <= 0 && ty2 <= 0)
-			return;
+			return false;
 
 		float angle1 = PointToAngle(tx1, ty1);
 		float angle2 = PointToAngle(tx2, ty2);
-		float span = angle1 - angle2;
+		float ang_span = angle1 - angle2;
 
-		if (span < 0)
-			span += static_cast<float>(2*M_PI);
+		if (ang_span < 0)
+			ang_span += static_cast<float>(2*M_PI);
 
 		Side side = Side::right;
 
-		if (span >= M_PI)
+		if (ang_span >= M_PI)
 			side = Side::left;
 
-		// ignore the line when there is no facing sidedef
-		SideDef *sd = (side == Side::left) ? inst.level.getLeft(*ld) : inst.level.getRight(*ld);
-
-		if (! sd)
-			return;
-
 		if (side == Side::left)
 		{
 			float tmp = angle1;
@@ -781,7 +912,7 @@ public:
 		{
 			// Totally off the left edge?
 			if (tspan2 >= M_PI)
-				return;
+				return false;
 
 			angle1 = leftclip;
 		}
@@ -790,7 +921,7 @@ public:
 		{
 			// Totally off the left edge?
 			if (tspan1 >= M_PI)
-				return;
+				return false;
 
 			angle2 = rightclip;
 		}
@@ -800,11 +931,7 @@ public:
 		int sx2 = AngleToX(angle2) - 1;
 
 		if (sx1 > sx2)
-			return;
-
-		// optimisation for query mode
-		if (query_mode && (sx2 < query_sx || sx1 > query_sx))
-			return;
+			return false;
 
 		// compute distance from eye to wall
 		float wdx = x2 - x1;
@@ -814,7 +941,7 @@ public:
 		float dist = fabs((y1 * wdx / wlen) - (x1 * wdy / wlen));
 
 		if (dist < 0.01)
-			return;
+			return false;
 
 		// compute normal of wall (translated coords)
 		float normal;
@@ -830,17 +957,48 @@ public:
 
 		double diz = (iz2 - iz1) / std::max(1, sx2 - sx1);
 
+		span.side = side;
+		span.base_ang = base_ang;
+		span.angle1 = angle1;
+		span.dist = dist;
+		span.normal = normal;
+		span.iz1 = iz1;
+		span.iz2 = iz2;
+		span.diz = diz;
+		span.sx1 = sx1;
+		span.sx2 = sx2;
+
+		return true;
+	}
+
+	void AddLine(int ld_index, const LineSpan &span)
+	{
+		LineDef *ld = inst.level.linedefs[ld_index];
+
+		// ignore the line when there is no facing sidedef
+		SideDef *sd = (span.side == Side::left) ? inst.level.getLeft(*ld) : inst.level.getRight(*ld);
+
+		if (! sd)
+			return;
+
+		int sx1 = span.sx1;
+		int sx2 = span.sx2;
+
+		// optimisation for query mode
+		if (query_mode && (sx2 < query_sx || sx1 > query_sx))
+			return;
+
 		// create drawwall structure
 
 		DrawWall *dw = new DrawWall(inst);
 
 		dw->th = -1;
-		dw->ld = ld.get();
+		dw->ld = ld;
 		dw->ld_index = ld_index;
 
 		dw->sd = sd;
 		dw->sec = &inst.level.getSector(*sd);
-		dw->side = side;
+		dw->side = span.side;
 		dw->thingFlags = 0;
 
 		dw->wall_light = dw->sec->light;
@@ -851,16 +1009,16 @@ public:
 		else if (inst.level.isHorizontal(*ld))
 			dw->wall_light -= 16;
 
-		dw->delta_ang = angle1 + XToAngle(sx1) - normal;
+		dw->delta_ang = span.angle1 + XToAngle(sx1) - span.normal;
 
-		dw->dist = dist;
-		dw->normal = normal;
-		dw->t_dist = tan(base_ang - normal) * dist;
+		dw->dist = span.dist;
+		dw->normal = span.normal;
+		dw->t_dist = tan(span.base_ang - span.normal) * span.dist;
 
-		dw->iz1 = iz1;
-		dw->iz2 = iz2;
-		dw->diz = diz;
-		dw->mid_iz = iz1 + (sx2 - sx1 + 1) * diz / 2;
+		dw->iz1 = span.iz1;
+		dw->iz2 = span.iz2;
+		dw->diz = span.diz;
+		dw->mid_iz = span.iz1 + (sx2 - sx1 + 1) * span.diz / 2;
 
 		dw->sx1 = sx1;
 		dw->sx2 = sx2;
@@ -870,7 +1028,7 @@ public:
 
 	void AddThing(int th_index)
 	{
-		const auto th = inst.level.things[th_index];
+		const Thing *th = inst.level.things[th_index];
 
 		const thingtype_t &info = inst.conf.getThingType(th->type);
 
@@ -926,7 +1084,7 @@ public:
 			if (inst.level.isSector(exfloor->heightsec))
 			{
 				const auto real  = inst.level.sectors[thsec];
-				const auto dummy = inst.level.sectors[exfloor->heightsec];
+				const Sector *dummy = inst.level.sectors[exfloor->heightsec];
 
 				if (dummy->floorh > real->floorh &&
 					inst.r_view.z > dummy->floorh &&
@@ -984,6 +1142,182 @@ public:
 		walls.push_back(dw);
 	}
 
+	/* VISIBILITY */
+
+	// true when the span lies behind solid walls in every column
+	bool SpanIsHidden(const LineSpan &span) const
+	{
+		// one column of slack on each side, since the rounding to whole
+		// columns can lose a sliver which something is seen through
+		int x1 = std::max(span.sx1 - 1, 0);
+		int x2 = std::min(span.sx2 + 1, inst.r_view.screen_w - 1);
+
+		for (int x = x1 ; x <= x2 ; x++)
+		{
+			double iz = span.iz1 + span.diz * (x - span.sx1);
+
+			if (iz >= occlude_x[x] * 0.9999)
+				return false;
+		}
+
+		return true;
+	}
+
+	void OccludeSpan(const LineSpan &span)
+	{
+		for (int x = span.sx1 ; x <= span.sx2 ; x++)
+		{
+			double iz = span.iz1 + span.diz * (x - span.sx1);
+
+			occlude_x[x] = std::max(occlude_x[x], iz);
+		}
+	}
+
+	// is the camera standing (almost) on the linedef?
+	bool CameraOnLine(const LineDef *ld) const
+	{
+		v2double_t a = inst.level.getStart(*ld).xy();
+		v2double_t b = inst.level.getEnd(*ld).xy();
+
+		double dx = b.x - a.x;
+		double dy = b.y - a.y;
+		double len2 = dx * dx + dy * dy;
+
+		if (len2 < 0.0001)
+			return false;
+
+		double t = ((inst.r_view.x - a.x) * dx + (inst.r_view.y - a.y) * dy) / len2;
+		t = std::max(0.0, std::min(1.0, t));
+
+		double ex = a.x + t * dx - inst.r_view.x;
+		double ey = a.y + t * dy - inst.r_view.y;
+
+		return ex * ex + ey * ey < 1.0;
+	}
+
+	//
+	// Walks from the camera's sector through the two-sided linedefs,
+	// adding the walls of each sector reached. A linedef which is behind
+	// the solid walls found so far in all its columns is skipped, and so
+	// is whatever lies beyond it. The walk order does not matter for
+	// this, since the test compares distances per column, but nearer
+	// sectors come first and so hide the most.
+	//
+	// Things are added when their sector was reached, like DOOM does.
+	//
+	void AddVisibleObjects()
+	{
+		Objid start = hover::getNearestSector(inst.level, { inst.r_view.x, inst.r_view.y });
+
+		// outside the map, anything may be seen through the back of a wall
+		if (! start.valid())
+		{
+			AddAllObjects();
+			return;
+		}
+
+		occlude_x.assign(inst.r_view.screen_w, 0);
+
+		std::vector<byte> sector_seen(inst.level.numSectors(), 0);
+		std::vector<byte> line_seen(inst.level.numLinedefs(), 0);
+
+		std::vector<int> queue;
+		std::vector<int> sides;
+		std::vector<int> lines;
+
+		queue.push_back(start.num);
+		sector_seen[start.num] = 1;
+
+		for (size_t q = 0 ; q < queue.size() ; q++)
+		{
+			inst.level.adjacency.sidedefsOfSector(queue[q], sides);
+
+			for (int sd_num : sides)
+			{
+				inst.level.adjacency.linesOfSidedef(sd_num, lines);
+
+				for (int ld_index : lines)
+				{
+					if (line_seen[ld_index])
+						continue;
+
+					line_seen[ld_index] = 1;
+
+					const LineDef *ld = inst.level.linedefs[ld_index];
+
+					// the sector beyond it, if it can be looked through
+					int beyond = -1;
+
+					if (ld->TwoSided())
+					{
+						const SideDef *right = inst.level.getRight(*ld);
+						const SideDef *left  = inst.level.getLeft(*ld);
+
+						beyond = (right->sector == queue[q]) ? left->sector : right->sector;
+
+						if (! inst.level.isSector(beyond) || sector_seen[beyond])
+							beyond = -1;
+					}
+
+					LineSpan span;
+
+					if (! ProjectLine(ld, span))
+					{
+						if (beyond >= 0 && CameraOnLine(ld))
+						{
+							sector_seen[beyond] = 1;
+							queue.push_back(beyond);
+						}
+						continue;
+					}
+
+					if (SpanIsHidden(span))
+						continue;
+
+					AddLine(ld_index, span);
+
+					if (ld->OneSided())
+					{
+						// only a wall facing the camera hides anything
+						if (span.side == Side::right)
+							OccludeSpan(span);
+					}
+					else if (beyond >= 0)
+					{
+						sector_seen[beyond] = 1;
+						queue.push_back(beyond);
+					}
+				}
+			}
+		}
+
+		if (inst.r_view.sprites)
+		{
+			for (int k = 0 ; k < inst.level.numThings() ; k++)
+			{
+				int thsec = inst.r_view.thing_sectors[k];
+
+				if (! inst.level.isSector(thsec) || sector_seen[thsec])
+					AddThing(k);
+			}
+		}
+	}
+
+	void AddAllObjects()
+	{
+		for (int i=0 ; i < inst.level.numLinedefs(); i++)
+		{
+			LineSpan span;
+
+			if (ProjectLine(inst.level.linedefs[i], span))
+				AddLine(i, span);
+		}
+
+		if (inst.r_view.sprites)
+			for (int k=0 ; k < inst.level.numThings() ; k++)
+				AddThing(k);
+	}
+
 	void ComputeSurfaces()
 	{
 		DrawWall::vec_t::iterator S;
@@ -995,23 +1329,57 @@ public:
 		}
 	}
 
-	void QueryCalcCoord(const DrawWall *dw, ObjType what, int part)
+	// what is hit by the mouse on a part of a wall, and how to find the
+	// map coordinate there
+	Render_Pick_t PickSurface(const ColumnWall &cw, ObjType what, int part)
 	{
-		float dist = static_cast<float>(1.0 / dw->cur_iz);
+		const DrawWall *dw = cw.dw;
+
+		Render_Pick_t hit;
+
+		if (what == ObjType::linedefs)
+		{
+			if (dw->side == Side::left)
+				part <<= 4;
+
+			hit.setObject(Objid(what, dw->ld_index, part));
+		}
+		else if (dw->sd != NULL)
+		{
+			hit.setObject(Objid(what, dw->sd->sector, part));
+		}
+
+		hit.depth = static_cast<float>(1.0 / cw.iz);
 
 		if (what == ObjType::sectors)
 		{
 			// sky surfaces require a check on Z height
 			if (part == PART_CEIL && dw->sec->ceilh > inst.r_view.z + 1)
-				dist = YToDist(query_sy, dw->sec->ceilh);
+			{
+				hit.setOnFlat(true);
+				hit.depth = static_cast<float>(dw->sec->ceilh);
+			}
 			else if (part == PART_FLOOR && dw->sec->floorh < inst.r_view.z - 1)
-				dist = YToDist(query_sy, dw->sec->floorh);
+			{
+				hit.setOnFlat(true);
+				hit.depth = static_cast<float>(dw->sec->floorh);
+			}
 		}
 
+		return hit;
+	}
+
+	void QueryCalcCoord(const Render_Pick_t &hit, int sx, int sy)
+	{
+		if (! hit.onFlat() && hit.depth == 0)
+			return;
+
+		float dist = hit.onFlat() ? YToDist(sy, static_cast<int>(hit.depth)) : hit.depth;
+
 		if (dist < 4.0)
 			dist = 4.0;
 
-		float ang = XToAngle(query_sx);
+		float ang = XToAngle(sx);
 		float modv = static_cast<float>(cos(ang - M_PI/2));
 
 		float t_cos = static_cast<float>(cos(M_PI + -inst.r_view.angle + ang) / modv);
@@ -1019,13 +1387,35 @@ public:
 
 		query_map_x = static_cast<float>(inst.r_view.x - static_cast<double>(t_sin) * dist);
 		query_map_y = static_cast<float>(inst.r_view.y - static_cast<double>(t_cos) * dist);
-		query_map_z = YToSecH(query_sy, 1.0 / dist);
+		query_map_z = YToSecH(sy, 1.0 / dist);
 
 		// ensure we never produce X == 0
 		if (query_map_x == 0)
 			query_map_x = 0.01f;
 	}
 
+	// notes what is drawn in a column, for the pick buffer. That one
+	// goes column by column, so these writes are all in a row.
+	inline void PickColumn(int x, int y1, int y2, const Render_Pick_t &hit)
+	{
+		if (y1 > y2)
+			return;
+
+		Render_Pick_t *dest = pick + x * inst.r_view.screen_h + y1;
+
+		std::fill(dest, dest + (y2 - y1 + 1), hit);
+	}
+
+	// the same for a thing or rail, which keeps the map coordinate of
+	// whatever is behind it
+	inline void PickColumnObject(int x, int y1, int y2, const Objid &obj)
+	{
+		Render_Pick_t *dest = pick + x * inst.r_view.screen_h + y1;
+
+		for ( ; y1 <= y2 ; y1++, dest++)
+			dest->setObject(obj);
+	}
+
 	void HighlightWallBit(const DrawWall *dw, int ld_index, int part)
 	{
 		// check the part is on the side facing the camera
@@ -1146,7 +1536,7 @@ public:
 
 	void HighlightSectorBit(const DrawWall *dw, int sec_index, int part)
 	{
-		const auto S = inst.level.sectors[sec_index];
+		const Sector *S = inst.level.sectors[sec_index];
 
 		int z = (part == PART_CEIL) ? S->ceilh : S->floorh;
 
@@ -1283,7 +1673,7 @@ public:
 				float dy = static_cast<float>(inst.edit.drag_cur.y - inst.edit.drag_start.y);
 				float dz = static_cast<float>(inst.edit.drag_cur.z - inst.edit.drag_start.z);
 
-				const auto T = inst.level.things[dw->th];
+				const Thing *T = inst.level.things[dw->th];
 
 				float x = static_cast<float>(T->x() + dx - inst.r_view.x);
 				float y = static_cast<float>(T->y() + dy - inst.r_view.y);
@@ -1436,43 +1826,140 @@ public:
 		walls.erase(S, walls.end());
 	}
 
-	void RenderFlatColumn(DrawWall *dw, DrawSurf& surf,
-			int x, int y1, int y2)
+	void AddFlatColumn(Column &col, const DrawWall *dw, const DrawSurf &surf, int y1, int y2)
 	{
-		img_pixel_t *dest = inst.r_view.screen;
+		FlatStrip &strip = *col.flats;
+
+		auto key = std::make_tuple(surf.img, surf.col, surf.tex_h, surf.fullbright, dw->sec->light);
+
+		auto found = strip.last_plane.find(key);
+
+		FlatPlane *plane = NULL;
+
+		if (found != strip.last_plane.end())
+		{
+			plane = &strip.planes[found->second];
+
+			// already has something in this column?
+			if (plane->x1 + (int)plane->top.size() > col.x)
+				plane = NULL;
+		}
+
+		if (! plane)
+		{
+			strip.last_plane[key] = (int)strip.planes.size();
+
+			strip.planes.push_back(FlatPlane{ &surf, dw->sec->light, col.x, {}, {} });
+
+			plane = &strip.planes.back();
+		}
+
+		// the columns in between have nothing
+		while (plane->x1 + (int)plane->top.size() < col.x)
+		{
+			plane->top.push_back(inst.r_view.screen_h);
+			plane->bottom.push_back(-1);
+		}
+
+		plane->top.push_back(y1);
+		plane->bottom.push_back(y2);
+	}
+
+	void RenderFlatSpan(const FlatPlane &plane, int y, int x1, int x2)
+	{
+		const DrawSurf &surf = *plane.surf;
+
+		img_pixel_t *dest = inst.r_view.screen + y * inst.r_view.screen_w;
+
+		float dist = YToDist(y, surf.tex_h);
+
+		bool lit = inst.r_view.lighting && ! surf.fullbright;
+
+		LightShade shade(inst, plane.light, dist);
+
+		if (! surf.img)
+		{
+			img_pixel_t pix = lit ? shade.Apply(surf.col) : surf.col;
+
+			std::fill(dest + x1, dest + x2 + 1, pix);
+			return;
+		}
 
 		const img_pixel_t *src = surf.img->buf();
 
 		int tw = surf.img->width();
 		int th = surf.img->height();
 
-		float ang = XToAngle(x);
-		float modv = static_cast<float>(cos(ang - M_PI/2));
+		double view_x = inst.r_view.x;
+		double view_y = -inst.r_view.y;
 
-		float t_cos = static_cast<float>(cos(M_PI + -inst.r_view.angle + ang) / modv);
-		float t_sin = static_cast<float>(sin(M_PI + -inst.r_view.angle + ang) / modv);
+		const float *t_cos = flat_cos.data();
+		const float *t_sin = flat_sin.data();
 
-		dest += x + y1 * inst.r_view.screen_w;
+		if (lit)
+		{
+			for (int x = x1 ; x <= x2 ; x++)
+			{
+				int tx = int(view_x - static_cast<double>(t_sin[x]) * dist) & (tw - 1);
+				int ty = int(view_y + static_cast<double>(t_cos[x]) * dist) & (th - 1);
+
+				dest[x] = shade.Apply(src[ty * tw + tx]);
+			}
+		}
+		else
+		{
+			for (int x = x1 ; x <= x2 ; x++)
+			{
+				int tx = int(view_x - static_cast<double>(t_sin[x]) * dist) & (tw - 1);
+				int ty = int(view_y + static_cast<double>(t_cos[x]) * dist) & (th - 1);
 
-		int light = dw->sec->light;
+				dest[x] = src[ty * tw + tx];
+			}
+		}
+	}
 
-		for ( ; y1 <= y2 ; y1++, dest += inst.r_view.screen_w)
+	// turns the columns of a plane into rows, the same way as the
+	// R_MakeSpans() of DOOM: a row starts where a column first covers
+	// it and ends at the first column which does not.
+	void RenderFlatPlane(const FlatPlane &plane, std::vector<int> &row_start)
+	{
+		int count = (int)plane.top.size();
+
+		int t1 = inst.r_view.screen_h;
+		int b1 = -1;
+
+		for (int i = 0 ; i <= count ; i++)
 		{
-			float dist = YToDist(y1, surf.tex_h);
+			int x = plane.x1 + i;
+
+			int t2 = (i < count) ? plane.top[i]    : inst.r_view.screen_h;
+			int b2 = (i < count) ? plane.bottom[i] : -1;
+
+			int next_t = t2;
+			int next_b = b2;
+
+			for ( ; t1 < t2 && t1 <= b1 ; t1++)
+				RenderFlatSpan(plane, t1, row_start[t1], x - 1);
 
-			int tx = int( inst.r_view.x - static_cast<double>(t_sin) * dist) & (tw - 1);
-			int ty = int(-inst.r_view.y + static_cast<double>(t_cos) * dist) & (th - 1);
+			for ( ; b1 > b2 && b1 >= t1 ; b1--)
+				RenderFlatSpan(plane, b1, row_start[b1], x - 1);
 
-			*dest = src[ty * tw + tx];
+			for ( ; t2 < t1 && t2 <= b2 ; t2++)
+				row_start[t2] = x;
 
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, *dest);
+			for ( ; b2 > b1 && b2 >= t2 ; b2--)
+				row_start[b2] = x;
+
+			t1 = next_t;
+			b1 = next_b;
 		}
 	}
 
-	void RenderTexColumn(DrawWall *dw, DrawSurf& surf,
+	void RenderTexColumn(const ColumnWall &cw, DrawSurf& surf,
 			int x, int y1, int y2)
 	{
+		const DrawWall *dw = cw.dw;
+
 		img_pixel_t *dest = inst.r_view.screen;
 
 		const img_pixel_t *src = surf.img->buf();
@@ -1480,8 +1967,9 @@ public:
 		int tw = surf.img->width();
 		int th = surf.img->height();
 
-		int  light = dw->wall_light;
-		float dist = static_cast<float>(1.0 / dw->cur_iz);
+		bool lit = inst.r_view.lighting && ! surf.fullbright;
+
+		LightShade shade(inst, dw->wall_light, static_cast<float>(1.0 / cw.iz));
 
 		/* compute texture X coord */
 
@@ -1493,8 +1981,8 @@ public:
 
 		/* compute texture Y coords */
 
-		float hh = surf.tex_h - YToSecH(y1, dw->cur_iz);
-		float dh = surf.tex_h - YToSecH(y2, dw->cur_iz);
+		float hh = surf.tex_h - YToSecH(y1, cw.iz);
+		float dh = surf.tex_h - YToSecH(y2, cw.iz);
 
 		dh = (dh - hh) / std::max(1, y2 - y1);
 		hh += 0.2f;
@@ -1514,71 +2002,59 @@ public:
 			if (pix == TRANS_PIXEL)
 				continue;
 
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, pix);
-			else
-				*dest = pix;
+			*dest = lit ? shade.Apply(pix) : pix;
 		}
 	}
 
-	void SolidFlatColumn(DrawWall *dw, DrawSurf& surf, int x, int y1, int y2)
+	void SolidTexColumn(const ColumnWall &cw, DrawSurf& surf, int x, int y1, int y2)
 	{
-		img_pixel_t *dest = inst.r_view.screen;
-
-		dest += x + y1 * inst.r_view.screen_w;
+		img_pixel_t pix = surf.col;
 
-		int light = dw->sec->light;
-
-		for ( ; y1 <= y2 ; y1++, dest += inst.r_view.screen_w)
-		{
-			float dist = YToDist(y1, surf.tex_h);
-
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, surf.col);
-			else
-				*dest = surf.col;
-		}
-	}
-
-	void SolidTexColumn(DrawWall *dw, DrawSurf& surf, int x, int y1, int y2)
-	{
-		int  light = dw->wall_light;
-		float dist = static_cast<float>(1.0 / dw->cur_iz);
+		if (inst.r_view.lighting && ! surf.fullbright)
+			pix = LightShade(inst, cw.dw->wall_light, static_cast<float>(1.0 / cw.iz)).Apply(pix);
 
 		img_pixel_t *dest = inst.r_view.screen;
 
 		dest += x + y1 * inst.r_view.screen_w;
 
 		for ( ; y1 <= y2 ; y1++, dest += inst.r_view.screen_w)
-		{
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, surf.col);
-			else
-				*dest = surf.col;
-		}
+			*dest = pix;
 	}
 
-	inline void RenderWallSurface(DrawWall *dw, DrawSurf& surf, int x, ObjType what, int part)
+	inline void RenderWallSurface(Column &col, const ColumnWall &cw, DrawSurf& surf, ObjType what, int part)
 	{
 		if (surf.kind == DrawSurf::K_INVIS)
 			return;
 
-		int y1 = DistToY(dw->cur_iz, surf.h2);
-		int y2 = DistToY(dw->cur_iz, surf.h1) - 1;
+		DrawWall *dw = cw.dw;
+		int x = col.x;
+
+		int y1 = DistToY(cw.iz, surf.h2);
+		int y2 = DistToY(cw.iz, surf.h1) - 1;
 
 		// clip to the open region
-		if (y1 < open_y1)
-			y1 = open_y1;
+		if (y1 < col.open_y1)
+			y1 = col.open_y1;
+
+		if (y2 > col.open_y2)
+			y2 = col.open_y2;
 
-		if (y2 > open_y2)
-			y2 = open_y2;
+		int old_y1 = col.open_y1;
+		int old_y2 = col.open_y2;
 
 		// update open region based on ends which are "solid"
 		if (surf.y_clip & DrawSurf::SOLID_ABOVE)
-			open_y1 = std::max(open_y1, y2 + 1);
+			col.open_y1 = std::max(col.open_y1, y2 + 1);
 
 		if (surf.y_clip & DrawSurf::SOLID_BELOW)
-			open_y2 = std::min(open_y2, y1 - 1);
+			col.open_y2 = std::min(col.open_y2, y1 - 1);
+
+		// the rows closed off without being drawn have nothing
+		if (pick)
+		{
+			PickColumn(x, old_y1, std::min(y1, col.open_y1) - 1, Render_Pick_t());
+			PickColumn(x, std::max(y2, col.open_y2) + 1, old_y2, Render_Pick_t());
+		}
 
 		if (y1 > y2)
 			return;
@@ -1589,54 +2065,46 @@ public:
 		{
 			if (y1 <= query_sy && query_sy <= y2)
 			{
-				if (what == ObjType::linedefs)
-				{
-					if (dw->side == Side::left)
-						part <<= 4;
+				Render_Pick_t hit = PickSurface(cw, what, part);
 
-					query_result = Objid(what, dw->ld_index, part);
-				}
-				else if (dw->sd != NULL)
-				{
-					query_result = Objid(what, dw->sd->sector, part);
-				}
+				if (hit.object().valid())
+					query_result = hit.object();
 
-				QueryCalcCoord(dw, what, part);
+				QueryCalcCoord(hit, query_sx, query_sy);
 			}
 			return;
 		}
 
-		/* fill pixels */
-
-		if (! surf.img)
+		if (pick)
 		{
-			if (surf.kind == DrawSurf::K_FLAT)
-				SolidFlatColumn(dw, surf, x, y1, y2);
-			else
-				SolidTexColumn(dw, surf, x, y1, y2);
-		}
-		else switch (surf.kind)
-		{
-			case DrawSurf::K_FLAT:
-				RenderFlatColumn(dw, surf, x, y1, y2);
-				break;
+			PickColumn(x, y1, y2, PickSurface(cw, what, part));
 
-			case DrawSurf::K_TEXTURE:
-				RenderTexColumn(dw, surf, x, y1, y2);
-				break;
+			if (pick_only)
+				return;
 		}
+
+		/* fill pixels, or for flats remember them for later */
+
+		if (surf.kind == DrawSurf::K_FLAT)
+			AddFlatColumn(col, dw, surf, y1, y2);
+		else if (! surf.img)
+			SolidTexColumn(cw, surf, x, y1, y2);
+		else
+			RenderTexColumn(cw, surf, x, y1, y2);
 	}
 
-	inline void RenderSprite(DrawWall *dw, int x)
+	inline void RenderSprite(const ColumnWall &cw, int x)
 	{
-		int y1 = DistToY(dw->cur_iz, dw->ceil.h2);
-		int y2 = DistToY(dw->cur_iz, dw->ceil.h1) - 1;
+		const DrawWall *dw = cw.dw;
+
+		int y1 = DistToY(cw.iz, dw->ceil.h2);
+		int y2 = DistToY(cw.iz, dw->ceil.h1) - 1;
 
-		if (y1 < dw->oy1)
-			y1 = dw->oy1;
+		if (y1 < cw.oy1)
+			y1 = cw.oy1;
 
-		if (y2 > dw->oy2)
-			y2 = dw->oy2;
+		if (y2 > cw.oy2)
+			y2 = cw.oy2;
 
 		if (y1 > y2)
 			return;
@@ -1650,24 +2118,36 @@ public:
 			return;
 		}
 
+		if (pick)
+		{
+			if (inst.edit.mode == ObjType::things)
+				PickColumnObject(x, y1, y2, Objid(ObjType::things, dw->th));
+
+			if (pick_only)
+				return;
+		}
+
 		int tw = dw->ceil.img->width();
 		int th = dw->ceil.img->height();
 
 		float scale = dw->normal;
 
-		int tx = int((XToDelta(x, dw->cur_iz) - dw->spr_tx1) / scale);
+		int tx = int((XToDelta(x, cw.iz) - dw->spr_tx1) / scale);
 
 		if (tx < 0 || tx >= tw)
 			return;
 
-		float hh = dw->ceil.h2 - YToSecH(y1, dw->cur_iz);
-		float dh = dw->ceil.h2 - YToSecH(y2, dw->cur_iz);
+		float hh = dw->ceil.h2 - YToSecH(y1, cw.iz);
+		float dh = dw->ceil.h2 - YToSecH(y2, cw.iz);
 
 		dh = (dh - hh) / std::max(1, y2 - y1);
 
 		int thsec = inst.r_view.thing_sectors[dw->th];
 		int light = inst.level.isSector(thsec) ? inst.level.sectors[thsec]->light : 255;
-		float dist = static_cast<float>(1.0 / dw->cur_iz);
+
+		bool lit = inst.r_view.lighting && ! (dw->thingFlags & THINGDEF_LIT);
+
+		LightShade shade(inst, light, static_cast<float>(1.0 / cw.iz));
 
 		/* fill pixels */
 
@@ -1698,14 +2178,11 @@ public:
 				continue;
 			}
 
-			*dest = pix;
-
-			if (inst.r_view.lighting && ! (dw->thingFlags & THINGDEF_LIT))
-				*dest = DoomLightRemap(inst, light, dist, *dest);
+			*dest = lit ? shade.Apply(pix) : pix;
 		}
 	}
 
-	inline void RenderMidMasker(DrawWall *dw, DrawSurf& surf, int x)
+	inline void RenderMidMasker(const ColumnWall &cw, DrawSurf& surf, int x)
 	{
 		if (surf.kind == DrawSurf::K_INVIS)
 			return;
@@ -1713,31 +2190,43 @@ public:
 		if (! surf.img)
 			return;
 
-		int y1 = DistToY(dw->cur_iz, surf.h2);
-		int y2 = DistToY(dw->cur_iz, surf.h1) - 1;
+		const DrawWall *dw = cw.dw;
+
+		int y1 = DistToY(cw.iz, surf.h2);
+		int y2 = DistToY(cw.iz, surf.h1) - 1;
 
-		if (y1 < dw->oy1)
-			y1 = dw->oy1;
+		if (y1 < cw.oy1)
+			y1 = cw.oy1;
 
-		if (y2 > dw->oy2)
-			y2 = dw->oy2;
+		if (y2 > cw.oy2)
+			y2 = cw.oy2;
 
 		if (y1 > y2)
 			return;
 
+		int part = (dw->side == Side::left) ? PART_LF_RAIL : PART_RT_RAIL;
+
 		if (query_mode)
 		{
 			if (y1 <= query_sy && query_sy <= y2 && inst.edit.mode == ObjType::linedefs)
 			{
-				int part = (dw->side == Side::left) ? PART_LF_RAIL : PART_RT_RAIL;
 				query_result = Objid(ObjType::linedefs, dw->ld_index, part);
 			}
 			return;
 		}
 
+		if (pick)
+		{
+			if (inst.edit.mode == ObjType::linedefs)
+				PickColumnObject(x, y1, y2, Objid(ObjType::linedefs, dw->ld_index, part));
+
+			if (pick_only)
+				return;
+		}
+
 		/* fill pixels */
 
-		RenderTexColumn(dw, surf, x, y1, y2);
+		RenderTexColumn(cw, surf, x, y1, y2);
 	}
 
 	inline void Sort_Swap(int i, int k)
@@ -1931,72 +2420,167 @@ public:
 		}
 	}
 
-	void RenderWalls()
+	// draws the columns from x1 to x2, using their active lists
+	void RenderColumns(int x1, int x2)
 	{
-		// sort walls by their starting column, to allow binary search.
+		FlatStrip flats;
 
-		std::sort(walls.begin(), walls.end(), DrawWall::SX1Cmp());
+		Column col;
+		col.flats = &flats;
 
-		active.clear();
+		// where each column stopped going front to back
+		std::vector<int> last_position(x2 - x1 + 1);
 
-		for (int x=0 ; x < inst.r_view.screen_w ; x++)
+		for (col.x = x1 ; col.x <= x2 ; col.x++)
 		{
 			// clear vertical depth buffer
 
-			open_y1 = 0;
-			open_y2 = inst.r_view.screen_h - 1;
+			col.open_y1 = 0;
+			col.open_y2 = inst.r_view.screen_h - 1;
 
-			UpdateActiveList(x);
+			ColumnWall *first = column_walls.data() + column_start[col.x];
 
-			// in query mode, only care about a single column
-			if (query_mode && x != query_sx)
-				continue;
+			int activeSize = column_start[col.x + 1] - column_start[col.x];
+			int position;
 
 			// render, front to back
 
-			int activeSize = (int)active.size();
-			int position;
-
 			for (position = 0; position < activeSize; ++position)
 			{
-				DrawWall *dw = active[position];
+				ColumnWall &cw = first[position];
+				DrawWall *dw = cw.dw;
 
 				// for things, just remember the open space
 				{
-					dw->oy1 = open_y1;
-					dw->oy2 = open_y2;
+					cw.oy1 = col.open_y1;
+					cw.oy2 = col.open_y2;
 				}
 				if (dw->th >= 0)
 					continue;
 
-				RenderWallSurface(dw, dw->ceil,  x, ObjType::sectors, PART_CEIL);
-				RenderWallSurface(dw, dw->floor, x, ObjType::sectors, PART_FLOOR);
+				RenderWallSurface(col, cw, dw->ceil,  ObjType::sectors, PART_CEIL);
+				RenderWallSurface(col, cw, dw->floor, ObjType::sectors, PART_FLOOR);
 
-				RenderWallSurface(dw, dw->upper, x, ObjType::linedefs, PART_RT_UPPER);
-				RenderWallSurface(dw, dw->lower, x, ObjType::linedefs, PART_RT_LOWER);
+				RenderWallSurface(col, cw, dw->upper, ObjType::linedefs, PART_RT_UPPER);
+				RenderWallSurface(col, cw, dw->lower, ObjType::linedefs, PART_RT_LOWER);
 
-				if (open_y1 > open_y2)
+				if (col.open_y1 > col.open_y2)
 					break;
 			}
 
-			// now render things, back to front
-			// (mid-masked textures are done here too)
-
 			if (position == activeSize)
 				position--;
 
-			for ( ; position >= 0; --position)
+			last_position[col.x - x1] = position;
+
+			if (pick)
+				PickColumn(col.x, col.open_y1, col.open_y2, Render_Pick_t());
+		}
+
+		// the flats never overlap the walls or each other, but they
+		// must be there before the things go on top
+
+		if (! flats.planes.empty())
+		{
+			std::vector<int> row_start(inst.r_view.screen_h);
+
+			for (const FlatPlane &plane : flats.planes)
+				RenderFlatPlane(plane, row_start);
+		}
+
+		// now render things, back to front
+		// (mid-masked textures are done here too)
+
+		for (col.x = x1 ; col.x <= x2 ; col.x++)
+		{
+			const ColumnWall *first = column_walls.data() + column_start[col.x];
+
+			for (int position = last_position[col.x - x1] ; position >= 0 ; --position)
 			{
-				DrawWall *dw = active[position];
+				const ColumnWall &cw = first[position];
 
-				if (dw->th >= 0)
-					RenderSprite(dw, x);
+				if (cw.dw->th >= 0)
+					RenderSprite(cw, col.x);
 				else
-					RenderMidMasker(dw, dw->rail, x);
+					RenderMidMasker(cw, cw.dw->rail, col.x);
 			}
 		}
 	}
 
+	void RenderWalls()
+	{
+		// sort walls by their starting column, to allow binary search.
+
+		std::sort(walls.begin(), walls.end(), DrawWall::SX1Cmp());
+
+		active.clear();
+
+		// find the active list of every column first. The order of each
+		// one depends on the order in the previous column, since
+		// IsCloser() is not a total order, so this goes column by column.
+
+		int screen_w = inst.r_view.screen_w;
+
+		column_walls.clear();
+		column_start.resize(screen_w + 1);
+
+		for (int x=0 ; x < screen_w ; x++)
+		{
+			UpdateActiveList(x);
+
+			column_start[x] = (int)column_walls.size();
+
+			// in query mode, only care about a single column
+			if (query_mode && x != query_sx)
+				continue;
+
+			for (DrawWall *dw : active)
+				column_walls.push_back(ColumnWall{ dw, dw->cur_iz, 0, 0 });
+		}
+
+		column_start[screen_w] = (int)column_walls.size();
+
+		if (query_mode)
+		{
+			if (query_sx >= 0 && query_sx < screen_w)
+				RenderColumns(query_sx, query_sx);
+			return;
+		}
+
+		flat_cos.resize(screen_w);
+		flat_sin.resize(screen_w);
+
+		for (int x=0 ; x < screen_w ; x++)
+		{
+			float ang  = XToAngle(x);
+			float modv = static_cast<float>(cos(ang - M_PI/2));
+
+			flat_cos[x] = static_cast<float>(cos(M_PI + -inst.r_view.angle + ang) / modv);
+			flat_sin[x] = static_cast<float>(sin(M_PI + -inst.r_view.angle + ang) / modv);
+		}
+
+		// then the columns get drawn in strips, several at once. Each
+		// column only touches its own pixels and active list.
+
+		WorkerPool &pool = ColumnPool(inst.r_view.threads);
+
+		int num_strips = std::min(screen_w, pool.numThreads() * 4);
+
+		if (num_strips <= 1)
+		{
+			RenderColumns(0, screen_w - 1);
+			return;
+		}
+
+		pool.parallelFor(num_strips, [&](int strip)
+		{
+			int x1 = screen_w *  strip      / num_strips;
+			int x2 = screen_w * (strip + 1) / num_strips - 1;
+
+			RenderColumns(x1, x2);
+		});
+	}
+
 	void ClearScreen()
 	{
 		// color #0 is black (DOOM, Heretic, Hexen)
@@ -2010,23 +2594,37 @@ public:
 
 	void Render()
 	{
-		if (! query_mode)
+		if (! query_mode && ! pick_only)
 			ClearScreen();
 
-		InitDepthBuf(inst.r_view.screen_w);
+		if (! query_mode && (pick_only || inst.r_view.picking) && PickFits())
+		{
+			// every pixel gets written, so the old contents can stay
+			std::vector<Render_Pick_t> &buffer = inst.r_view.pick;
 
-		for (int i=0 ; i < inst.level.numLinedefs(); i++)
-			AddLine(i);
+			buffer.resize(static_cast<size_t>(inst.r_view.screen_w) * inst.r_view.screen_h);
 
-		if (inst.r_view.sprites)
-			for (int k=0 ; k < inst.level.numThings() ; k++)
-				AddThing(k);
+			pick = buffer.data();
+		}
+
+		InitDepthBuf(inst.r_view.screen_w);
+
+		if (inst.r_view.culling)
+			AddVisibleObjects();
+		else
+			AddAllObjects();
 
 		ClipSolids();
 
 		ComputeSurfaces();
 
 		RenderWalls();
+
+		if (pick)
+		{
+			inst.r_view.SetPickCurrent();
+			pick = NULL;
+		}
 	}
 
 	void Query(int qx, int qy)
@@ -2043,6 +2641,47 @@ public:
 
 		query_mode = 0;
 	}
+
+	// whether the object numbers fit in the pick buffer
+	bool PickFits() const
+	{
+		return inst.level.numLinedefs() <= Render_Pick_t::MAX_NUM &&
+			   inst.level.numSectors()  <= Render_Pick_t::MAX_NUM &&
+			   inst.level.numThings()   <= Render_Pick_t::MAX_NUM;
+	}
+
+	// fills the pick buffer without drawing anything
+	void Pick()
+	{
+		if (! PickFits())
+			return;
+
+		pick_only = true;
+
+		Render();
+
+		pick_only = false;
+	}
+
+	// the same as Query(), but from the pick buffer
+	void LookUpPick(int qx, int qy)
+	{
+		query_result.clear();
+		query_map_x = 0;
+		query_map_y = 0;
+		query_map_z = 0;
+
+		if (qx < 0 || qx >= inst.r_view.screen_w ||
+			qy < 0 || qy >= inst.r_view.screen_h)
+			return;
+
+		const Render_Pick_t &hit = inst.r_view.pick[qx * inst.r_view.screen_h + qy];
+
+		if (hit.object().valid())
+			query_result = hit.object();
+
+		QueryCalcCoord(hit, qx, qy);
+	}
 };
 
 
@@ -2097,6 +2736,17 @@ static void BlitLores(const Instance &inst, int ox, int oy, int ow, int oh)
 }
 
 
+//
+// Draws the view into r_view.screen, without showing it anywhere
+//
+void Instance::SW_RenderBuffer()
+{
+	RendInfo rend(*this);
+
+	rend.Render();
+}
+
+
 void Instance::SW_RenderWorld(int ox, int oy, int ow, int oh)
 {
 	RendInfo rend(*this);
@@ -2126,8 +2776,20 @@ bool Instance::SW_QueryPoint(Objid& hl, int qx, int qy)
 
 	RendInfo rend(*this);
 
-	// this runs the renderer, but *no* drawing is done
-	rend.Query(qx, qy);
+	// the last render usually made the pick buffer, else one is made
+	// for all the mouse moves until the view or the map changes
+	if (r_view.picking && ! r_view.PickIsCurrent())
+		rend.Pick();
+
+	if (r_view.picking && r_view.PickIsCurrent())
+	{
+		rend.LookUpPick(qx, qy);
+	}
+	else
+	{
+		// this runs the renderer, but *no* drawing is done
+		rend.Query(qx, qy);
+	}
 
 	if (rend.query_map_x != 0)
 	{
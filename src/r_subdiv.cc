@@ -156,61 +156,308 @@ void sector_info_cache_c::Update()
 
 	   Rebuild();
    }
+   else if (floors_dirty || ! (dirty_vertices.empty() && dirty_sidedefs.empty() &&
+							   dirty_lines.empty() && dirty_planes.empty()))
+   {
+	   Refresh();
+   }
 }
 
 void sector_info_cache_c::Rebuild()
 {
-	int sec;
+	for (int sec = 0 ; sec < total ; sec++)
+		infos[sec].ClearShape();
 
-	for (sec = 0 ; sec < total ; sec++)
+	line_sectors.resize((size_t) inst.level.numLinedefs());
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 	{
-		const auto S = inst.level.sectors[sec];
+		const LineDef *L = inst.level.linedefs[n];
 
-		infos[sec].Clear();
-		infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
-		infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
+		FileLine(n, NULL);
+
+		line_sectors[n].right = inst.level.getSectorID(*L, Side::right);
+		line_sectors[n].left  = inst.level.getSectorID(*L, Side::left);
 	}
 
-	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	RebuildFloors();
+
+	ClearDirty();
+}
+
+//
+// rebuild the sectors which the edits since the last Update() have
+// touched, keeping the polygons of all the others.
+//
+void sector_info_cache_c::Refresh()
+{
+	const Document &doc = inst.level;
+
+	// the lines which moved or changed sides
+	std::vector<int> lines = dirty_lines;
+	std::vector<int> list;
+
+	for (int v : dirty_vertices)
+	{
+		if (v >= doc.numVertices())
+			continue;
+
+		doc.adjacency.linesAtVertex(v, list);
+		lines.insert(lines.end(), list.begin(), list.end());
+	}
+	for (int sd : dirty_sidedefs)
+	{
+		if (sd >= doc.numSidedefs())
+			continue;
+
+		doc.adjacency.linesOfSidedef(sd, list);
+		lines.insert(lines.end(), list.begin(), list.end());
+	}
+
+	std::sort(lines.begin(), lines.end());
+	lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+	// new lines have not been filed anywhere yet
+	line_sectors.resize((size_t) doc.numLinedefs(), { -1, -1 });
+
+	bitvec_c sectors(total);
+	std::vector<int> sector_list;
+
+	for (int n : lines)
+	{
+		if (n >= doc.numLinedefs())
+			continue;
+
+		const LineDef *L = doc.linedefs[n];
+
+		// the sectors it was filed under lose it, the current ones gain it
+		line_sectors_t &was = line_sectors[n];
+
+		line_sectors_t now;
+		now.right = doc.getSectorID(*L, Side::right);
+		now.left  = doc.getSectorID(*L, Side::left);
+
+		for (int sec : { was.right, was.left, now.right, now.left })
+		{
+			if (sec >= 0 && sec < total && ! sectors.get(sec))
+			{
+				sectors.set(sec);
+				sector_list.push_back(sec);
+			}
+		}
+
+		was = now;
+	}
+
+	// file all the lines of those sectors again, moved or not
+	lines.clear();
+
+	std::vector<int> sides;
+
+	for (int sec : sector_list)
 	{
-		const auto L = inst.level.linedefs[n];
+		infos[sec].ClearShape();
 
-		CheckBoom242(L.get());
-		CheckExtraFloor(L.get(), n);
-		CheckLineSlope(L.get());
+		doc.adjacency.sidedefsOfSector(sec, sides);
 
-		for (int side = 0 ; side < 2 ; side++)
+		for (int sd : sides)
 		{
-			int sd_num = side ? L->left : L->right;
-			if (sd_num < 0)
-				continue;
+			doc.adjacency.linesOfSidedef(sd, list);
+			lines.insert(lines.end(), list.begin(), list.end());
+		}
+	}
 
-			sec = inst.level.sidedefs[sd_num]->sector;
+	for (int n : lines)
+		FileLine(n, &sectors);
 
-			sector_extra_info_t& info = infos[sec];
+	if (floor_specials || floors_dirty)
+	{
+		RebuildFloors();
+	}
+	else
+	{
+		// without any specials, a plane is just the sector's height
+		for (int sec : dirty_planes)
+		{
+			if (sec >= total)
+				continue;
 
-			info.AddLine(n);
+			const Sector *S = doc.sectors[sec];
 
-			info.AddVertex(&inst.level.getStart(*L));
-			info.AddVertex(&inst.level.getEnd(*L));
+			infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
+			infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
 		}
 	}
 
+	ClearDirty();
+}
+
+void sector_info_cache_c::RebuildFloors()
+{
+	floor_specials = false;
+
+	for (int sec = 0 ; sec < total ; sec++)
+	{
+		const Sector *S = inst.level.sectors[sec];
+
+		infos[sec].floors.Clear();
+		infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
+		infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
+	}
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		const LineDef *L = inst.level.linedefs[n];
+
+		CheckBoom242(L);
+		CheckExtraFloor(L, n);
+		CheckLineSlope(L);
+	}
+
 	for (const auto &thing : inst.level.things)
 	{
-		CheckSlopeThing(thing.get());
+		CheckSlopeThing(thing);
 	}
 	for (const auto &thing : inst.level.things)
 	{
-		CheckSlopeCopyThing(thing.get());
+		CheckSlopeCopyThing(thing);
 	}
 
 	for (const auto &linedef : inst.level.linedefs)
 	{
-		CheckPlaneCopy(linedef.get());
+		CheckPlaneCopy(linedef);
+	}
+}
+
+void sector_info_cache_c::ClearDirty()
+{
+	floors_dirty = false;
+
+	dirty_vertices.clear();
+	dirty_sidedefs.clear();
+	dirty_lines.clear();
+	dirty_planes.clear();
+}
+
+//
+// add the linedef to the sectors on either side of it, or only to
+// those in the 'only' set (when not NULL).
+//
+void sector_info_cache_c::FileLine(int n, const bitvec_c *only)
+{
+	const LineDef *L = inst.level.linedefs[n];
+
+	for (int side = 0 ; side < 2 ; side++)
+	{
+		int sd_num = side ? L->left : L->right;
+		if (sd_num < 0)
+			continue;
+
+		int sec = inst.level.sidedefs[sd_num]->sector;
+
+		if (only && ! only->get(sec))
+			continue;
+
+		sector_extra_info_t& info = infos[sec];
+
+		info.AddLine(n);
+
+		info.AddVertex(&inst.level.getStart(*L));
+		info.AddVertex(&inst.level.getEnd(*L));
 	}
 }
 
+void sector_info_cache_c::NotifyInsert(ObjType type, int objnum)
+{
+	// anything referring to objects after it gets renumbered
+	if (objnum < inst.level.numObjects(type) && type != ObjType::things)
+	{
+		total = -1;
+		return;
+	}
+
+	if (type == ObjType::linedefs)
+	{
+		dirty_lines.push_back(objnum);
+		floors_dirty = true;
+	}
+	else if (type == ObjType::things && SlopeThings())
+	{
+		floors_dirty = true;
+	}
+}
+
+void sector_info_cache_c::NotifyDelete(ObjType type, int objnum)
+{
+	switch (type)
+	{
+	case ObjType::things:
+		if (SlopeThings())
+			floors_dirty = true;
+		break;
+
+	case ObjType::vertices:
+	case ObjType::sidedefs:
+		// the last one goes without renumbering anything, and the lines
+		// which used it have been changed or deleted already
+		if (objnum < inst.level.numObjects(type) - 1)
+			total = -1;
+		break;
+
+	default:
+		total = -1;
+		break;
+	}
+}
+
+void sector_info_cache_c::NotifyChange(ObjType type, int objnum, int field)
+{
+	switch (type)
+	{
+	case ObjType::vertices:
+		dirty_vertices.push_back(objnum);
+		break;
+
+	case ObjType::sidedefs:
+		if (field == SideDef::F_SECTOR)
+			dirty_sidedefs.push_back(objnum);
+		break;
+
+	case ObjType::linedefs:
+		if (field == LineDef::F_START || field == LineDef::F_END ||
+			field == LineDef::F_RIGHT || field == LineDef::F_LEFT)
+		{
+			dirty_lines.push_back(objnum);
+		}
+
+		// the type, tag and args decide the specials
+		if (field != LineDef::F_START && field != LineDef::F_END && field != LineDef::F_FLAGS)
+			floors_dirty = true;
+		break;
+
+	case ObjType::sectors:
+		if (field == Sector::F_FLOORH || field == Sector::F_CEILH)
+			dirty_planes.push_back(objnum);
+		else if (field == Sector::F_TAG)
+			floors_dirty = true;
+		break;
+
+	case ObjType::things:
+		if (SlopeThings())
+			floors_dirty = true;
+		break;
+
+	default:
+		break;
+	}
+}
+
+// true when things can set up slopes (see CheckSlopeThing)
+bool sector_info_cache_c::SlopeThings() const
+{
+	return inst.loaded.levelFormat != MapFormat::doom && (inst.conf.features.slopes & 16);
+}
+
 void sector_info_cache_c::CheckBoom242(const LineDef *L)
 {
 	if (inst.conf.features.gen_types && (L->type == 242 || L->type == 280))
@@ -220,6 +467,8 @@ void sector_info_cache_c::CheckBoom242(const LineDef *L)
 	else
 		return;
 
+	floor_specials = true;
+
 	if (L->tag <= 0 || L->right < 0)
 		return;
 
@@ -298,6 +547,8 @@ void sector_info_cache_c::CheckExtraFloor(const LineDef *L, int ld_num)
 	if (flags < 0)
 		return;
 
+	floor_specials = true;
+
 	extrafloor_c EF;
 
 	EF.ld = ld_num;
@@ -422,6 +673,8 @@ void sector_info_cache_c::CheckSlopeCopyThing(const Thing *T)
 
 void sector_info_cache_c::PlaneAlign(const LineDef *L, int floor_mode, int ceil_mode)
 {
+	floor_specials = true;
+
 	if (L->left < 0 || L->right < 0)
 		return;
 
@@ -447,7 +700,7 @@ void sector_info_cache_c::PlaneAlign(const LineDef *L, int floor_mode, int ceil_
 void sector_info_cache_c::PlaneAlignPart(const LineDef *L, Side side, int plane)
 {
 	int sec_num = inst.level.getSectorID(*L, side);
-	const auto front = inst.level.sectors[inst.level.getSectorID(*L, side)];
+	const Sector *front = inst.level.sectors[inst.level.getSectorID(*L, side)];
 	const auto back  = inst.level.sectors[inst.level.getSectorID(*L, -side)];
 
 	// find a vertex belonging to sector and is far from the line
@@ -508,6 +761,8 @@ void sector_info_cache_c::PlaneAlignPart(const LineDef *L, Side side, int plane)
 
 void sector_info_cache_c::PlaneCopy(const LineDef *L, int f1_tag, int c1_tag, int f2_tag, int c2_tag, int share)
 {
+	floor_specials = true;
+
 	for (int n = 0 ; n < inst.level.numSectors(); n++)
 	{
 		if (f1_tag > 0 && inst.level.sectors[n]->tag == f1_tag && inst.level.getRight(*L))
@@ -556,6 +811,8 @@ void sector_info_cache_c::PlaneCopy(const LineDef *L, int f1_tag, int c1_tag, in
 
 void sector_info_cache_c::PlaneCopyFromThing(const Thing *T, int plane)
 {
+	floor_specials = true;
+
 	if (T->arg1 == 0)
 		return;
 
@@ -581,6 +838,8 @@ void sector_info_cache_c::PlaneCopyFromThing(const Thing *T, int plane)
 
 void sector_info_cache_c::PlaneTiltByThing(const Thing *T, int plane)
 {
+	floor_specials = true;
+
 	double tx = T->x();
 	double ty = T->y();
 
@@ -680,7 +939,7 @@ fprintf(stderr, "R_SubdivideSector %d\n", num);
 
 	for (int n = exinfo.first_line ; n <= exinfo.last_line ; n++)
 	{
-		const auto L = inst.level.linedefs[n];
+		const LineDef *L = inst.level.linedefs[n];
 
 		if (! inst.level.touchesSector(*L, num))
 			continue;
@@ -700,7 +959,7 @@ fprintf(stderr, "R_SubdivideSector %d\n", num);
 		if (edge.y1 == edge.y2)
 			continue;
 
-		edge.line = L.get();
+		edge.line = L;
 		edge.flipped = 0;
 
 		if (edge.y1 > edge.y2)
@@ -146,6 +146,13 @@ struct sector_extra_info_t
 	bool built;
 
 	void Clear()
+	{
+		ClearShape();
+		floors.Clear();
+	}
+
+	// forget the lines, bounds and polygons (but not the floors)
+	void ClearShape()
 	{
 		first_line = last_line = -1;
 
@@ -155,7 +162,6 @@ struct sector_extra_info_t
 		bound_y2 = -32767;
 
 		sub.Clear();
-		floors.Clear();
 
 		built = false;
 	}
@@ -172,9 +178,19 @@ struct sector_extra_info_t
 	void AddVertex(const Vertex *V);
 };
 
+class bitvec_c;
+
 //
 // Sector info cache
 //
+// Edits are noted by the Notify methods and handled by the next
+// Update(), which only rebuilds the sectors they touched.  Each
+// linedef remembers the sectors it was filed under, so a line which
+// moves to another sector gets it taken out of the old one too.
+//
+// The 3D floors and slopes can tie any sector to any other (by tags),
+// hence they are all worked out again whenever a special is about.
+//
 class sector_info_cache_c
 {
 public:
@@ -189,14 +205,49 @@ public:
 	{
 		total = other.total;
 		infos = other.infos;
+		line_sectors = other.line_sectors;
+		floor_specials = other.floor_specials;
+		floors_dirty = other.floors_dirty;
+		dirty_vertices = other.dirty_vertices;
+		dirty_sidedefs = other.dirty_sidedefs;
+		dirty_lines = other.dirty_lines;
+		dirty_planes = other.dirty_planes;
 		return *this;
 	}
 
 public:
 	void Update();
-	
+
+	void NotifyInsert(ObjType type, int objnum);
+	void NotifyDelete(ObjType type, int objnum);
+	void NotifyChange(ObjType type, int objnum, int field);
+
 private:
+	struct line_sectors_t
+	{
+		int right, left;
+	};
+
+	// the sectors each linedef was filed under
+	std::vector<line_sectors_t> line_sectors;
+
+	// true when some line or thing set up a 3D floor or slope
+	bool floor_specials = false;
+
+	// the edits since the last Update()
+	bool floors_dirty = false;
+
+	std::vector<int> dirty_vertices;
+	std::vector<int> dirty_sidedefs;
+	std::vector<int> dirty_lines;
+	std::vector<int> dirty_planes;	// sectors with new heights
+
 	void Rebuild();
+	void Refresh();
+	void RebuildFloors();
+	void ClearDirty();
+	void FileLine(int n, const bitvec_c *only);
+	bool SlopeThings() const;
 	void CheckBoom242(const LineDef *L);
 	void CheckExtraFloor(const LineDef *L, int ld_num);
 	void CheckLineSlope(const LineDef *L);
@@ -35,6 +35,9 @@ Log gLog;
 // hack here to avoid bringing in ui_window.h and FLTK headers
 extern void LogViewer_AddLine(const char *str);
 
+// where the messages of this thread go instead, if anywhere
+static thread_local LogBuffer *log_capture;
+
 //
 // Open a file
 //
@@ -102,6 +105,12 @@ void Log::printf(EUR_FORMAT_STRING(const char *str), ...)
 	SString buffer = SString::vprintf(str, args);
 	va_end(args);
 
+	if (log_capture)
+	{
+		log_capture->messages.push_back({ buffer.get(), false });
+		return;
+	}
+
 	if (log_fp)
 	{
 		fputs(buffer.c_str(), log_fp);
@@ -132,6 +141,12 @@ void Log::debugPrintf(EUR_FORMAT_STRING(const char *str), ...)
 		SString buffer = SString::vprintf(str, args);
 		va_end(args);
 
+		if (log_capture)
+		{
+			log_capture->messages.push_back({ buffer.get(), true });
+			return;
+		}
+
 		// prefix each debugging line with a special symbol
 
 		size_t index = 0;
@@ -156,6 +171,31 @@ void Log::debugPrintf(EUR_FORMAT_STRING(const char *str), ...)
 	}
 }
 
+//
+// Prints the kept messages, as if they were logged just now
+//
+void LogBuffer::replay()
+{
+	for (const Message &message : messages)
+	{
+		if (message.debug)
+			gLog.debugPrintf("%s", message.text.c_str());
+		else
+			gLog.printf("%s", message.text.c_str());
+	}
+	messages.clear();
+}
+
+LogCapture::LogCapture(LogBuffer &buffer) : previous(log_capture)
+{
+	log_capture = &buffer;
+}
+
+LogCapture::~LogCapture()
+{
+	log_capture = previous;
+}
+
 //
 // Save the log so far to another file
 //
@@ -28,6 +28,7 @@ namespace fs = ghc::filesystem;
 #include <stdio.h>
 #include "PrintfMacros.h"
 #include <ostream>
+#include <string>
 #include <vector>
 
 #define MSG_BUF_LEN  1024
@@ -86,6 +87,41 @@ private:
 
 extern Log gLog;
 
+//
+// Log messages kept aside instead of printed. While a LogCapture is alive
+// on a thread, the gLog messages of that thread go into its buffer. Work
+// split over several threads logs this way, and the caller then prints
+// each part's messages in a fixed order with replay().
+//
+class LogBuffer
+{
+public:
+	void replay();
+
+private:
+	friend class Log;
+
+	struct Message
+	{
+		std::string text;
+		bool debug;
+	};
+	std::vector<Message> messages;
+};
+
+class LogCapture
+{
+public:
+	explicit LogCapture(LogBuffer &buffer);
+	~LogCapture();
+
+	LogCapture(const LogCapture &other) = delete;
+	LogCapture &operator = (const LogCapture &other) = delete;
+
+private:
+	LogBuffer *previous;
+};
+
 // -------- assertion macros --------
 
 #ifdef NDEBUG
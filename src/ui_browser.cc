@@ -728,7 +728,8 @@ SString TidyLineDesc(const char *name)
 }
 
 
-void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString, Img_c> & img_list)
+void UI_Browser_Box::Populate_Images(BrowserMode imkind, const ImageSet &images,
+									 const std::unordered_map<SString, int> &img_list)
 {
 	/* Note: the side-by-side packing is done in Filter() method */
 
@@ -738,18 +739,20 @@ void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString,
 	scroll->resize_horiz(false);
 	scroll->Line_size(98);
 
-	std::map<SString, Img_c>::const_iterator TI;
+	// the registry is not in any order, but the list starts sorted by name
+	std::vector<std::pair<SString, int>> sorted(img_list.begin(), img_list.end());
+	std::sort(sorted.begin(), sorted.end());
 
 	int cx = scroll->x() + SBAR_W;
 	int cy = scroll->y();
 
 	char full_desc[256];
 
-	for (TI = img_list.begin() ; TI != img_list.end() ; TI++)
+	for (const auto &entry : sorted)
 	{
-		const SString &name = TI->first;
+		const SString &name = entry.first;
 
-		const Img_c &image = TI->second;
+		const LazyImage &image = images.getImage(entry.second);
 
 		if ((false)) /* NO PICS */
 			snprintf(full_desc, sizeof(full_desc), "%-8s : %3dx%d", name.c_str(),
@@ -972,15 +975,15 @@ void UI_Browser_Box::Populate()
 	{
 		case BrowserMode::textures:
 			if (config::browser_combine_tex)
-				Populate_Images(BrowserMode::flats, inst.wad.images.getFlats());
+				Populate_Images(BrowserMode::flats, inst.wad.images, inst.wad.images.getFlats());
 
-			Populate_Images(BrowserMode::textures, inst.wad.images.getTextures());
+			Populate_Images(BrowserMode::textures, inst.wad.images, inst.wad.images.getTextures());
 			break;
 
 		case BrowserMode::flats:
 			// the flat browser is never used when combine-tex is enabled
 			if (! config::browser_combine_tex)
-				Populate_Images(BrowserMode::flats, inst.wad.images.getFlats());
+				Populate_Images(BrowserMode::flats, inst.wad.images, inst.wad.images.getFlats());
 			break;
 
 		case BrowserMode::things:
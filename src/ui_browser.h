@@ -24,11 +24,14 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 
 class Browser_Button;
 class Fl_Check_Button;
 class Fl_Choice;
+class ImageSet;
+class LazyImage;
 
 enum class BrowserMode
 {
@@ -158,7 +161,8 @@ private:
 
 	bool SearchMatch(Browser_Item *item) const;
 
-	void Populate_Images(BrowserMode imkind, const std::map<SString, Img_c> & img_list);
+	void Populate_Images(BrowserMode imkind, const ImageSet &images,
+						 const std::unordered_map<SString, int> &img_list);
 	void Populate_Sprites();
 
 	void Populate_ThingTypes();
@@ -22,6 +22,7 @@
 #include "main.h"
 
 #include <algorithm>
+#include <tuple>
 
 #ifndef NO_OPENGL
 #include "FL/gl.h"
@@ -99,10 +100,17 @@ UI_Canvas::UI_Canvas(Instance &inst, int X, int Y, int W, int H, const char *lab
 	last_split_x(), last_split_y(),
 	snap_x(-1), snap_y(-1),
 	seen_sectors(),
+	static_valid(false),
 	inst(inst)
 {
 #ifdef NO_OPENGL
 	rgb_buf = NULL;
+	rgb_w = rgb_h = 0;
+#else
+	gl_pix = 1;
+
+	static_tex = 0;
+	static_tex_w = static_tex_h = 0;
 #endif
 }
 
@@ -118,7 +126,19 @@ void UI_Canvas::DeleteContext()
 
 	// ensure W_UnloadAllTextures() gets called on next draw()
 	invalidate();
+
+	static_tex = 0;
+	static_tex_w = static_tex_h = 0;
 #endif
+
+	// the images may have changed too
+	static_valid = false;
+}
+
+
+void UI_Canvas::InvalidateMap()
+{
+	static_valid = false;
 }
 
 
@@ -141,6 +161,11 @@ void UI_Canvas::draw()
 		// belongs to a context which was (probably) just deleted and
 		// hence refer to textures which no longer exist.
 		inst.wad.images.W_UnloadAllTextures();
+
+		// the same goes for our copy of the map
+		static_tex = 0;
+		static_tex_w = static_tex_h = 0;
+		static_valid = false;
 	}
 
 #ifndef _WIN32	// TODO: #56: reenable this for Windows
@@ -156,6 +181,10 @@ void UI_Canvas::draw()
 #endif
 #endif
 
+	// nothing holds on to a texture between frames, so now is when the
+	// ones not used lately can be let go
+	inst.wad.images.W_TrimImages();
+
 	if (inst.edit.render3d)
 	{
 		Render3D_Draw(inst, x(), y(), w(), h());
@@ -188,6 +217,8 @@ void UI_Canvas::draw()
 	int pix = iround(inst.main_win->canvas->pixels_per_unit());
 	Fl::use_high_res_GL(false);
 
+	gl_pix = pix;
+
 	glLoadIdentity();
 	glViewport(0, 0, w() * pix, h() * pix);
 	glOrtho(0, w(), 0, h(), -1, 1);
@@ -326,13 +357,23 @@ int UI_Canvas::ApproxBoxSize(int mx1, int my1, int mx2, int my2)
 
 void UI_Canvas::DrawEverything()
 {
-	// setup for drawing sector numbers
-	if (inst.edit.show_object_numbers && inst.edit.mode == ObjType::sectors)
+	if (! RestoreStaticLayer())
 	{
-		seen_sectors.clear_all();
+		// setup for drawing sector numbers
+		if (inst.edit.show_object_numbers && inst.edit.mode == ObjType::sectors)
+		{
+			seen_sectors.clear_all();
+		}
+
+		DrawMap();
+
+		SaveStaticLayer();
 	}
 
-	DrawMap();
+	DrawSplitter();
+
+	if (inst.grid.snap && config::grid_snap_indicator)
+		DrawSnapPoint();
 
 	DrawSelection(&*inst.edit.Selected);
 
@@ -366,8 +407,8 @@ void UI_Canvas::DrawEverything()
 		// when ratio lock is on, want to see the new line
 		if (inst.edit.mode == ObjType::vertices && inst.grid.ratio > 0 && inst.edit.drag_other_vert >= 0)
 		{
-			const auto v0 = inst.level.vertices[inst.edit.drag_other_vert];
-			const auto v1 = inst.level.vertices[inst.edit.dragged.num];
+			const Vertex *v0 = inst.level.vertices[inst.edit.drag_other_vert];
+			const Vertex *v1 = inst.level.vertices[inst.edit.dragged.num];
 
 			RenderColor(RED);
 			DrawKnobbyLine(v0->x(), v0->y(), v1->x() + delta.x, v1->y() + delta.y);
@@ -395,7 +436,7 @@ void UI_Canvas::DrawEverything()
 
 		if (inst.edit.mode == ObjType::linedefs && !inst.edit.show_object_numbers)
 		{
-			const auto L = inst.level.linedefs[inst.edit.highlight.num];
+			const LineDef *L = inst.level.linedefs[inst.edit.highlight.num];
 			DrawLineInfo(inst.level.getStart(*L).x(), inst.level.getStart(*L).y(), inst.level.getEnd(*L).x(), inst.level.getEnd(*L).y(), false);
 		}
 
@@ -411,7 +452,8 @@ void UI_Canvas::DrawEverything()
 
 
 //
-// draw the whole map, except for hilight/selection/selbox
+// draw the whole map, except for hilight/selection/selbox and the
+// snap point and line being split.
 //
 void UI_Canvas::DrawMap()
 {
@@ -441,9 +483,6 @@ void UI_Canvas::DrawMap()
 	if (inst.edit.mode != ObjType::things)
 		DrawThings();
 
-	if (inst.grid.snap && config::grid_snap_indicator)
-		DrawSnapPoint();
-
 	DrawLinedefs();
 
 	if (inst.edit.mode == ObjType::vertices)
@@ -465,6 +504,156 @@ void UI_Canvas::DrawMap()
 }
 
 
+bool UI_Canvas::StaticKey::operator== (const StaticKey &other) const
+{
+	return
+		std::tie(x, y, w, h, pix, orig_x, orig_y, scale, grid_shown, grid_step) ==
+		std::tie(other.x, other.y, other.w, other.h, other.pix, other.orig_x, other.orig_y,
+				 other.scale, other.grid_shown, other.grid_step) &&
+
+		std::tie(mode, sector_render_mode, thing_render_mode, error_mode, show_object_numbers,
+				 split_line, sound_source, camera_x, camera_y, camera_angle) ==
+		std::tie(other.mode, other.sector_render_mode, other.thing_render_mode, other.error_mode,
+				 other.show_object_numbers, other.split_line, other.sound_source,
+				 other.camera_x, other.camera_y, other.camera_angle);
+}
+
+
+UI_Canvas::StaticKey UI_Canvas::CurrentStaticKey()
+{
+	StaticKey key;
+
+	key.x = xx;
+	key.y = yy;
+	key.w = w();
+	key.h = h();
+#ifdef NO_OPENGL
+	key.pix = 1;
+#else
+	key.pix = gl_pix;
+#endif
+
+	key.orig_x = inst.grid.orig.x;
+	key.orig_y = inst.grid.orig.y;
+	key.scale  = inst.grid.Scale;
+
+	key.grid_shown = inst.grid.shown;
+	key.grid_step  = inst.grid.step;
+
+	key.mode = inst.edit.mode;
+	key.sector_render_mode  = inst.edit.sector_render_mode;
+	key.thing_render_mode   = inst.edit.thing_render_mode;
+	key.error_mode          = inst.edit.error_mode;
+	key.show_object_numbers = inst.edit.show_object_numbers;
+
+	key.split_line = -1;
+	if (inst.edit.mode == ObjType::vertices && inst.edit.split_line.valid())
+		key.split_line = inst.edit.split_line.num;
+
+	// sound propagation is shown from the highlighted sector
+	key.sound_source = -1;
+	if (inst.edit.sector_render_mode == SREND_SoundProp &&
+		inst.edit.mode == ObjType::sectors && inst.edit.highlight.valid())
+	{
+		key.sound_source = inst.edit.highlight.num;
+	}
+
+	v2double_t camera;
+	inst.Render3D_GetCameraPos(camera, &key.camera_angle);
+
+	key.camera_x = camera.x;
+	key.camera_y = camera.y;
+
+	return key;
+}
+
+
+//
+// put back the map from the last draw() if nothing it depends on has
+// changed since then, returns false if it has to be drawn again.
+//
+bool UI_Canvas::RestoreStaticLayer()
+{
+	StaticKey key = CurrentStaticKey();
+
+	if (! (static_valid && key == static_key))
+	{
+		static_key = key;
+		static_valid = false;
+		return false;
+	}
+
+#ifdef NO_OPENGL
+	memcpy(rgb_buf, static_buf.data(), static_buf.size());
+
+#else
+	float tx2 = (float)(w() * gl_pix) / (float)static_tex_w;
+	float ty2 = (float)(h() * gl_pix) / (float)static_tex_h;
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, static_tex);
+
+	glColor3f(1, 1, 1);
+
+	glBegin(GL_QUADS);
+
+	glTexCoord2f(0,   0);   glVertex2i(0,   0);
+	glTexCoord2f(0,   ty2); glVertex2i(0,   h());
+	glTexCoord2f(tx2, ty2); glVertex2i(w(), h());
+	glTexCoord2f(tx2, 0);   glVertex2i(w(), 0);
+
+	glEnd();
+
+	glDisable(GL_TEXTURE_2D);
+#endif
+
+	return true;
+}
+
+
+void UI_Canvas::SaveStaticLayer()
+{
+#ifdef NO_OPENGL
+	static_buf.assign(rgb_buf, rgb_buf + rgb_w * rgb_h * 3);
+
+#else
+	int fw = w() * gl_pix;
+	int fh = h() * gl_pix;
+
+	if (static_tex == 0)
+		glGenTextures(1, &static_tex);
+
+	glBindTexture(GL_TEXTURE_2D, static_tex);
+
+	if (static_tex_w < fw || static_tex_h < fh)
+	{
+		if (global::use_npot_textures)
+		{
+			static_tex_w = fw;
+			static_tex_h = fh;
+		}
+		else
+		{
+			static_tex_w = RoundPOW2(fw);
+			static_tex_h = RoundPOW2(fh);
+		}
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, static_tex_w, static_tex_h,
+					 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+	}
+
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, fw, fh);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+#endif
+
+	static_valid = true;
+}
+
+
 //
 //  draw the grid in the background of the inst.edit window
 //
@@ -718,7 +907,7 @@ void UI_Canvas::DrawLinedefs()
 {
 	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 	{
-		const auto L = inst.level.linedefs[n];
+		const LineDef *L = inst.level.linedefs[n];
 
 		double x1 = inst.level.getStart(*L).x();
 		double y1 = inst.level.getStart(*L).y();
@@ -732,29 +921,28 @@ void UI_Canvas::DrawLinedefs()
 
 		Fl_Color col = LIGHTGREY;
 
-		// 'p' for plain, 'k' for knobbly, 's' for split
+		// 'p' for plain, 'k' for knobbly
 		char line_kind = 'p';
 
 		switch (inst.edit.mode)
 		{
 			case ObjType::vertices:
 			{
+				// the line being split is drawn by DrawSplitter()
 				if (n == inst.edit.split_line.num)
-					col = HI_AND_SEL_COL;
-				else if (inst.edit.error_mode)
+					continue;
+
+				if (inst.edit.error_mode)
 					col = LIGHTGREY;
 				else if (L->right < 0)
 					col = RED;
 				else if (one_sided)
 					col = WHITE;
 
-				if (n == inst.edit.split_line.num)
-					line_kind = 's';
-				else
-					line_kind = 'k';
+				line_kind = 'k';
 
 				// show info of last four added lines
-				if (n != inst.edit.split_line.num && n >= (inst.level.numLinedefs() - 4) &&
+				if (n >= (inst.level.numLinedefs() - 4) &&
 					!inst.edit.show_object_numbers)
 				{
 					DrawLineInfo(x1, y1, x2, y2, false);
@@ -863,10 +1051,6 @@ void UI_Canvas::DrawLinedefs()
 			case 'k':
 				DrawKnobbyLine(x1, y1, x2, y2);
 				break;
-
-			case 's':
-				DrawSplitLine(x1, y1, x2, y2);
-				break;
 		}
 	}
 
@@ -1639,10 +1823,10 @@ void UI_Canvas::DrawTagged(ObjType objtype, int objnum)
         {
             if(objtype == ObjType::linedefs && m == objnum)
                 continue;
-            const auto line = inst.level.linedefs[m];
+            const LineDef *line = inst.level.linedefs[m];
             assert(line);
             SpecialTagInfo info;
-            if(!getSpecialTagInfo(ObjType::linedefs, m, line->type, line.get(), inst.conf, info))
+            if(!getSpecialTagInfo(ObjType::linedefs, m, line->type, line, inst.conf, info))
                 continue;
 
             for(int i = 0; i < info.*numtags; ++i)
@@ -1658,10 +1842,10 @@ void UI_Canvas::DrawTagged(ObjType objtype, int objnum)
         {
             if(objtype == ObjType::things && m == objnum)
                 continue;
-            const auto thing = inst.level.things[m];
+            const Thing *thing = inst.level.things[m];
             assert(thing);
             SpecialTagInfo info;
-            if(!getSpecialTagInfo(ObjType::things, m, thing->special, thing.get(), inst.conf, info))
+            if(!getSpecialTagInfo(ObjType::things, m, thing->special, thing, inst.conf, info))
                 continue;
 
             for(int i = 0; i < info.*numtags; ++i)
@@ -1675,10 +1859,10 @@ void UI_Canvas::DrawTagged(ObjType objtype, int objnum)
 
 	if (objtype == ObjType::linedefs)
     {
-        const auto line = inst.level.linedefs[objnum];
+        const LineDef *line = inst.level.linedefs[objnum];
         assert(line);
         SpecialTagInfo info;
-        if(getSpecialTagInfo(objtype, objnum, line->type, line.get(), inst.conf, info))
+        if(getSpecialTagInfo(objtype, objnum, line->type, line, inst.conf, info))
             highlightTaggedItems(info);
         if(inst.loaded.levelFormat == MapFormat::doom)
         {
@@ -1688,7 +1872,7 @@ void UI_Canvas::DrawTagged(ObjType objtype, int objnum)
         else
         {
             SpecialTagInfo linfo;
-            if(!getSpecialTagInfo(objtype, objnum, line->type, line.get(), inst.conf, linfo))
+            if(!getSpecialTagInfo(objtype, objnum, line->type, line, inst.conf, linfo))
                 return;
             // TODO: also UDMF line ID
             if(inst.loaded.levelFormat == MapFormat::hexen && linfo.selflineid > 0)
@@ -1700,10 +1884,10 @@ void UI_Canvas::DrawTagged(ObjType objtype, int objnum)
     }
     else if(inst.loaded.levelFormat != MapFormat::doom && objtype == ObjType::things)
     {
-        const auto thing = inst.level.things[objnum];
+        const Thing *thing = inst.level.things[objnum];
         assert(thing);
         SpecialTagInfo info;
-        if(getSpecialTagInfo(objtype, objnum, thing->special, thing.get(), inst.conf, info))
+        if(getSpecialTagInfo(objtype, objnum, thing->special, thing, inst.conf, info))
             highlightTaggedItems(info);
         highlightTaggingTriggers(thing->tid, &SpecialTagInfo::tids, &SpecialTagInfo::numtids);
         const thingtype_t *type = get(inst.conf.thing_types, thing->type);
@@ -2067,12 +2251,33 @@ void UI_Canvas::DrawSnapPoint()
 }
 
 
+void UI_Canvas::DrawSplitter()
+{
+	if (inst.edit.mode != ObjType::vertices || ! inst.edit.split_line.valid())
+		return;
+
+	const LineDef *L = inst.level.linedefs[inst.edit.split_line.num];
+
+	double x1 = inst.level.getStart(*L).x();
+	double y1 = inst.level.getStart(*L).y();
+	double x2 = inst.level.getEnd(*L).x();
+	double y2 = inst.level.getEnd(*L).y();
+
+	if (! Vis(std::min(x1,x2), std::min(y1,y2), std::max(x1,x2), std::max(y1,y2)))
+		return;
+
+	RenderColor(HI_AND_SEL_COL);
+
+	DrawSplitLine(x1, y1, x2, y2);
+}
+
+
 void UI_Canvas::DrawCurrentLine()
 {
 	if (inst.edit.drawLine.from.is_nil())
 		return;
 
-	const auto V = inst.level.vertices[inst.edit.drawLine.from.num];
+	const Vertex *V = inst.level.vertices[inst.edit.drawLine.from.num];
 
 	v2double_t newpos = inst.edit.drawLine.to;
 
@@ -2164,8 +2369,8 @@ v2double_t UI_Canvas::DragDelta()
 	if (inst.edit.mode == ObjType::vertices && inst.grid.ratio > 0 &&
 		inst.edit.dragged.num >= 0 && inst.edit.drag_other_vert >= 0)
 	{
-		const auto v0 = inst.level.vertices[inst.edit.drag_other_vert];
-		const auto v1 = inst.level.vertices[inst.edit.dragged.num];
+		const Vertex *v0 = inst.level.vertices[inst.edit.drag_other_vert];
+		const Vertex *v1 = inst.level.vertices[inst.edit.dragged.num];
 
 		v2double_t newpos = inst.edit.drag_cur.xy;
 
@@ -2211,7 +2416,7 @@ void UI_Canvas::RenderSector(int num)
 	rgb_color_t light_col = SectorLightColor(inst.level.sectors[num]->light);
 	bool light_and_tex = false;
 
-	SString tex_name;
+	StringID tex_name;
 
 	Img_c * img = NULL;
 
@@ -2241,22 +2446,23 @@ void UI_Canvas::RenderSector(int num)
 
 		if (inst.edit.sector_render_mode == SREND_Ceiling ||
 			inst.edit.sector_render_mode == SREND_CeilBright)
-			tex_name = inst.level.sectors[num]->CeilTex();
+			tex_name = inst.level.sectors[num]->ceil_tex;
 		else
-			tex_name = inst.level.sectors[num]->FloorTex();
+			tex_name = inst.level.sectors[num]->floor_tex;
 
-		if (inst.is_sky(tex_name))
+		int handle = inst.wad.images.flatHandle(inst.conf, tex_name);
+
+		if (handle == ImageSet::IMAGE_SKY_FLAT)
 		{
 			RenderColor(inst.wad.palette.getPaletteColor(inst.conf.miscInfo.sky_color));
 		}
+		else if (handle >= 0)
+		{
+			img = inst.wad.images.drawMutableImage(inst.conf, handle);
+		}
 		else
 		{
-			img = inst.wad.images.getMutableFlat(inst.conf, tex_name);
-
-			if (! img)
-			{
-				img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
-			}
+			img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
 		}
 	}
 
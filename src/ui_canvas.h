@@ -33,6 +33,8 @@
 #include "r_grid.h"
 #include "sys_macro.h"
 
+#include <vector>
+
 class Img_c;
 enum class Side;
 struct v2double_t;
@@ -76,6 +78,43 @@ private:
 #endif
 	int cur_font;  // 14 or 19
 
+	// everything which DrawMap() depends on, except for the level and
+	// the config [ changes to those go through InvalidateMap() ]
+	struct StaticKey
+	{
+		int x, y, w, h, pix;
+		double orig_x, orig_y, scale;
+		bool grid_shown;
+		int grid_step;
+		ObjType mode;
+		int sector_render_mode;
+		int thing_render_mode;
+		bool error_mode;
+		bool show_object_numbers;
+		int split_line;
+		int sound_source;
+		double camera_x, camera_y;
+		float camera_angle;
+
+		bool operator== (const StaticKey &other) const;
+	};
+
+	// the map as drawn by DrawMap(), kept from the last draw() so that
+	// a new highlight or selection only needs the overlays drawn on top
+	StaticKey static_key;
+	bool static_valid;
+
+#ifdef NO_OPENGL
+	std::vector<byte> static_buf;
+#else
+	// real pixels per unit (for retina displays)
+	int gl_pix;
+
+	// a texture holding a copy of the framebuffer
+	unsigned int static_tex;
+	int static_tex_w, static_tex_h;
+#endif
+
 public:
 	UI_Canvas(Instance &inst, int X, int Y, int W, int H, const char *label = NULL);
 	virtual ~UI_Canvas();
@@ -91,6 +130,11 @@ public:
 	// call this whenever OpenGL textures need to be reloaded.
 	void DeleteContext();
 
+	// call this whenever the level or the config changes, so that the
+	// next draw() draws the whole map again.  changes to the view are
+	// noticed without this.
+	void InvalidateMap();
+
 	void DrawEverything();
 
 	void UpdateHighlight();
@@ -120,6 +164,10 @@ private:
 
 	void DrawMap();
 
+	StaticKey CurrentStaticKey();
+	bool RestoreStaticLayer();
+	void SaveStaticLayer();
+
 	void DrawGrid_Dotty();
 	void DrawGrid_Normal();
 	void DrawAxes(Fl_Color col);
@@ -148,6 +196,7 @@ private:
 	void DrawNumber(int x, int y, int num);
 	void DrawCurrentLine();
 	void DrawSnapPoint();
+	void DrawSplitter();
 
 	void SelboxDraw();
 
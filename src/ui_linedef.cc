@@ -733,7 +733,7 @@ void UI_LineBox::UpdateField(int field)
 
 		if (inst.level.isLinedef(obj))
 		{
-			const auto L = inst.level.linedefs[obj];
+			const LineDef *L = inst.level.linedefs[obj];
 
 			mFixUp.setInputValue(tag, SString(inst.level.linedefs[obj]->tag).c_str());
 
@@ -767,10 +767,10 @@ void UI_LineBox::UpdateField(int field)
 	{
 		if (inst.level.isLinedef(obj))
 		{
-			const auto L = inst.level.linedefs[obj];
+			const LineDef *L = inst.level.linedefs[obj];
 
-			int right_mask = SolidMask(L.get(), Side::right);
-			int  left_mask = SolidMask(L.get(), Side::left);
+			int right_mask = SolidMask(L, Side::right);
+			int  left_mask = SolidMask(L, Side::left);
 
 			front->SetObj(L->right, right_mask, L->TwoSided());
 			 back->SetObj(L->left,   left_mask, L->TwoSided());
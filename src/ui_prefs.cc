@@ -718,6 +718,7 @@ public:
 	Fl_Check_Button *nod_on_save;
 	Fl_Check_Button *nod_fast;
 	Fl_Check_Button *nod_warn;
+	Fl_Check_Button *nod_full_reject;
 
 	Fl_Choice *nod_factor;
 
@@ -1070,6 +1071,8 @@ UI_Preferences::UI_Preferences(const opt_desc_t *options) :
 		}
 		{ nod_warn = new Fl_Check_Button(50, 140, 220, 30, " Warning messages in the logs");
 		}
+		{ nod_full_reject = new Fl_Check_Button(50, 170, 440, 30, " Full REJECT   (checks the lines of sight, slower)");
+		}
 
 		{ Fl_Box* o = new Fl_Box(25, 205, 250, 30, "Advanced BSP Settings");
 		  o->labelfont(FL_BOLD);
@@ -1532,6 +1535,7 @@ void UI_Preferences::LoadValues()
 	nod_on_save->value(config::bsp_on_save ? 1 : 0);
 	nod_fast->value(config::bsp_fast ? 1 : 0);
 	nod_warn->value(config::bsp_warnings ? 1 : 0);
+	nod_full_reject->value(config::bsp_full_reject ? 1 : 0);
 
 	if (config::bsp_split_factor < 7)
 		nod_factor->value(2);	// Balanced BSP tree
@@ -1664,11 +1668,15 @@ void UI_Preferences::SaveValues()
 	config::normal_flat_col  = (rgb_color_t) normal_flat ->color();
 	config::normal_small_col = (rgb_color_t) normal_small->color();
 
+	// the map gets drawn again in the new colors
+	gInstance.main_win->canvas->InvalidateMap();
+
 	/* Nodes Tab */
 
 	config::bsp_on_save = nod_on_save->value() ? true : false;
 	config::bsp_fast = nod_fast->value() ? true : false;
 	config::bsp_warnings = nod_warn->value() ? true : false;
+	config::bsp_full_reject = nod_full_reject->value() ? true : false;
 
 	if (nod_factor->value() == 1)			// Minimize Splits
 		config::bsp_split_factor = 29;
@@ -1460,7 +1460,7 @@ void UI_FindAndReplace::DoAll(bool replace)
 
 bool UI_FindAndReplace::Match_Thing(int idx)
 {
-	const auto T = inst.level.things[idx];
+	const Thing *T = inst.level.things[idx];
 
 	if (! find_numbers->get(T->type))
 		return false;
@@ -1478,9 +1478,9 @@ bool UI_FindAndReplace::Match_Thing(int idx)
 
 bool UI_FindAndReplace::Match_LineDef(int idx)
 {
-	const auto L = inst.level.linedefs[idx];
+	const LineDef *L = inst.level.linedefs[idx];
 
-	if (! Filter_Tag(L->tag) || ! Filter_Sides(L.get()))
+	if (! Filter_Tag(L->tag) || ! Filter_Sides(L))
 		return false;
 
 	const char *pattern = find_match->value();
@@ -1521,7 +1521,7 @@ bool UI_FindAndReplace::Match_LineDef(int idx)
 
 bool UI_FindAndReplace::Match_Sector(int idx)
 {
-	const auto sector = inst.level.sectors[idx];
+	const Sector *sector = inst.level.sectors[idx];
 
 	if (! Filter_Tag(sector->tag))
 		return false;
@@ -1545,12 +1545,12 @@ bool UI_FindAndReplace::Match_Sector(int idx)
 
 bool UI_FindAndReplace::Match_LineType(int idx)
 {
-	const auto L = inst.level.linedefs[idx];
+	const LineDef *L = inst.level.linedefs[idx];
 
 	if (! find_numbers->get(L->type))
 		return false;
 
-	if (! Filter_Tag(L->tag) || ! Filter_Sides(L.get()))
+	if (! Filter_Tag(L->tag) || ! Filter_Sides(L))
 		return false;
 
 	return true;
@@ -1559,7 +1559,7 @@ bool UI_FindAndReplace::Match_LineType(int idx)
 
 bool UI_FindAndReplace::Match_SectorType(int idx)
 {
-	const auto sector = inst.level.sectors[idx];
+	const Sector *sector = inst.level.sectors[idx];
 
 	int mask = (inst.conf.features.gen_sectors == GenSectorFamily::zdoom) ? 255 :
 				(inst.conf.features.gen_sectors != GenSectorFamily::none) ? 31 : 65535;
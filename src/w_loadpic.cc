@@ -107,11 +107,8 @@ static void DrawColumn(const Palette &pal, const ConfigData &config,Img_c& img,
 
 tl::optional<Img_c> LoadImage_PNG(const Lump_c &lump, const SString &name)
 {
-	// load the raw data
-	const std::vector<byte> &tex_data = lump.getData();
-
 	// pass it to FLTK for decoding
-	Fl_PNG_Image fltk_img(NULL, tex_data.data(), (int)tex_data.size());
+	Fl_PNG_Image fltk_img(NULL, lump.data(), lump.Length());
 
 	if (fltk_img.w() <= 0)
 	{
@@ -128,11 +125,8 @@ tl::optional<Img_c> LoadImage_PNG(const Lump_c &lump, const SString &name)
 
 tl::optional<Img_c> LoadImage_JPEG(const Lump_c &lump, const SString &name)
 {
-	// load the raw data
-	const std::vector<byte> &tex_data = lump.getData();
-
 	// pass it to FLTK for decoding
-	Fl_JPEG_Image fltk_img(NULL, tex_data.data());
+	Fl_JPEG_Image fltk_img(NULL, lump.data());
 
 	if (fltk_img.w() <= 0)
 	{
@@ -149,14 +143,11 @@ tl::optional<Img_c> LoadImage_JPEG(const Lump_c &lump, const SString &name)
 
 tl::optional<Img_c> LoadImage_TGA(const Lump_c &lump, const SString &name)
 {
-	// load the raw data
-	const std::vector<byte> &tex_data = lump.getData();
-
 	// decode it
 	int width;
 	int height;
 
-	rgba_color_t * rgba = TGA_DecodeImage(tex_data.data(), tex_data.size(),  width, height);
+	rgba_color_t * rgba = TGA_DecodeImage(lump.data(), lump.Length(),  width, height);
 
 	if (! rgba)
 	{
@@ -275,9 +266,7 @@ bool LoadPicture(const Palette &pal, const ConfigData &config, Img_c& dest,
 
 	/* DOOM format */
 
-	const std::vector<byte> &raw_data = lump.getData();
-
-	auto pat = reinterpret_cast<const patch_t *>(raw_data.data());
+	auto pat = reinterpret_cast<const patch_t *>(lump.data());
 
 	int width    = LE_S16(pat->width);
 	int height   = LE_S16(pat->height);
@@ -324,7 +313,7 @@ ImageFormat W_DetectImageFormat(const Lump_c &lump)
 	if (length < 20)
 		return ImageFormat::unrecognized;
 	
-	const byte *header = lump.getData().data();
+	const byte *header = lump.data();
 
 	// PNG is clearly marked in the header, so check it first.
 
@@ -25,37 +25,164 @@
 //------------------------------------------------------------------------
 
 #include "Errors.h"
+#include "ImageCache.h"
 #include "Instance.h"
 #include "main.h"
+#include "WorkerPool.h"
 
 #include <map>
 #include <algorithm>
+#include <functional>
 #include <string>
 
+#include "lib_adler.h"
 #include "m_game.h"      /* yg_picture_format */
 #include "w_loadpic.h"
 #include "w_rawdef.h"
 #include "w_texture.h"
 
 
+// what the StringID lookup tables hold for names not looked up yet
+static const int IMAGE_NOT_LOOKED_UP = -100;
+
+
+//----------------------------------------------------------------------
+//    IMAGE CACHE KEYS
+//----------------------------------------------------------------------
+
+//
+// Starts the cache key of an image with the settings which change how
+// lumps get decoded. 'kind' keeps apart the ways of making an image.
+//
+static crc32_c ImageKey(char kind, const Palette &palette, const ConfigData &config)
+{
+	crc32_c key;
+
+	key += (u8_t)kind;
+	key += (s32_t)palette.getTransReplace();
+	key += (s32_t)config.features.neg_patch_offsets;
+
+	return key;
+}
+
+static void AddLumpToKey(crc32_c &key, const Lump_c &lump)
+{
+	key += (s32_t)lump.Length();
+	key.AddBlock(lump.data(), lump.Length());
+}
+
+
+//
+// Gives the image made by 'decode', or the copy of it which an earlier
+// run left in the cache. Failures are not cached.
+//
+static tl::optional<Img_c> CachedImage(ImageCache *cache, const crc32_c &key,
+									   const std::function<tl::optional<Img_c>()> &decode)
+{
+	Img_c img;
+	if (cache && cache->load(key, img))
+		return img;
+
+	tl::optional<Img_c> result = decode();
+
+	if (cache && result)
+		cache->store(key, *result);
+
+	return result;
+}
+
+
 //----------------------------------------------------------------------
 //    TEXTURE HANDLING
 //----------------------------------------------------------------------
 
-void ImageSet::W_ClearTextures()
+//
+// Gives the registry slot for a new texture or flat, reusing the slot of
+// any existing one with the same name
+//
+int ImageSet::addImage(std::unordered_map<SString, int> &names, const SString &name)
+{
+	auto P = names.find(name);
+
+	if (P != names.end())
+	{
+		// free the existing one
+		dropImage(registry[P->second], false);
+		return P->second;
+	}
+
+	int handle = (int)registry.size();
+	registry.emplace_back();
+	names[name] = handle;
+
+	// a name looked up before may mean this one now
+	texture_lookup.clear();
+	flat_lookup.clear();
+
+	return handle;
+}
+
+
+//
+// Removes all the textures or all the flats. The registry is packed
+// again, so the handles of the rest change.
+//
+void ImageSet::clearImages(std::unordered_map<SString, int> &names)
 {
-	textures.clear();
+	for (const auto &P : names)
+		dropImage(registry[P.second], false);
+
+	names.clear();
+
+	std::vector<LazyImage> kept;
+	kept.reserve(textures.size() + flats.size());
+
+	for (auto *other : { &textures, &flats })
+	{
+		for (auto &P : *other)
+		{
+			kept.push_back(std::move(registry[P.second]));
+			P.second = (int)kept.size() - 1;
+		}
+	}
 
-	medusa_textures.clear();
+	registry = std::move(kept);
+
+	texture_lookup.clear();
+	flat_lookup.clear();
+}
+
+
+void ImageSet::W_ClearTextures()
+{
+	clearImages(textures);
 }
 
 
+//
+// Adds an image which is already drawn, and is always kept
+//
 void ImageSet::W_AddTexture(const SString &name, Img_c &&img, bool is_medusa)
 {
-	// free any existing one with the same name
+	LazyImage &entry = registry[addImage(textures, name)];
+
+	entry = LazyImage(img.width(), img.height());
+	entry.medusa = is_medusa;
+	entry.image = std::move(img);
+}
+
+
+//
+// Adds a texture which gets composed from the patches when first used
+//
+void ImageSet::W_AddTexture(const SString &name, int width, int height, std::vector<TexturePatch> &&patches,
+							bool is_medusa)
+{
+	LazyImage &entry = registry[addImage(textures, name)];
 
-	textures[name] = std::move(img);
-	medusa_textures[name] = is_medusa ? 1 : 0;
+	entry = LazyImage(width, height);
+	entry.patches = std::move(patches);
+	entry.medusa = is_medusa;
 }
 
 
@@ -103,10 +230,10 @@ static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, cons
 	if (width == 0 || height == 0)
 		ThrowException("W_LoadTextures: Texture '%.8s' has zero size\n", raw->name);
 
-	Img_c img(width, height, false);
+	std::vector<TexturePatch> patches;
 	bool is_medusa = false;
 
-	// apply all the patches
+	// find all the patches, they are drawn when the texture is used
 	int num_patches = LE_S16(raw->patch_count);
 
 	if (! num_patches)
@@ -138,11 +265,12 @@ static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, cons
 
 		const Lump_c *lump = wad.master.findGlobalLump(picname);
 
-		if (! lump ||
-			! LoadPicture(wad.palette, config, img, *lump, picname, xofs, yofs))
+		if (! lump)
 		{
 			gLog.printf("texture '%.8s': patch '%.8s' not found.\n", raw->name, picname);
 		}
+
+		patches.push_back({ lump ? lump->shared_from_this() : nullptr, picname, xofs, yofs });
 	}
 
 	// store the new texture
@@ -150,7 +278,7 @@ static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, cons
 	memcpy(namebuf, raw->name, 8);
 	namebuf[8] = 0;
 
-	wad.images.W_AddTexture(namebuf, std::move(img), is_medusa);
+	wad.images.W_AddTexture(namebuf, width, height, std::move(patches), is_medusa);
 }
 
 
@@ -168,10 +296,10 @@ static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, const
 	if (width == 0 || height == 0)
 		ThrowException("W_LoadTextures: Texture '%.8s' has zero size\n", raw->name);
 
-	Img_c img(width, height, false);
+	std::vector<TexturePatch> patches;
 	bool is_medusa = false;
 
-	// apply all the patches
+	// find all the patches, they are drawn when the texture is used
 	int num_patches = LE_S16(raw->patch_count);
 
 	if (! num_patches)
@@ -205,11 +333,12 @@ static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, const
 //gLog.debugPrintf("-- %d patch [%s]\n", j, picname);
 		const Lump_c *lump = wad.master.findGlobalLump(picname);
 
-		if (! lump ||
-			! LoadPicture(wad.palette, config, img, *lump, picname, xofs, yofs))
+		if (! lump)
 		{
 			gLog.printf("texture '%.8s': patch '%.8s' not found.\n", raw->name, picname);
 		}
+
+		patches.push_back({ lump ? lump->shared_from_this() : nullptr, picname, xofs, yofs });
 	}
 
 	// store the new texture
@@ -217,7 +346,7 @@ static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, const
 	memcpy(namebuf, raw->name, 8);
 	namebuf[8] = 0;
 
-	wad.images.W_AddTexture(namebuf, std::move(img), is_medusa);
+	wad.images.W_AddTexture(namebuf, width, height, std::move(patches), is_medusa);
 }
 
 
@@ -232,10 +361,11 @@ static void LoadTexturesLump(WadData &wad, const ConfigData &config, const Lump_
 	pname_size /= 8;
 
 	// load TEXTUREx data into memory for easier processing
-	const std::vector<byte> &tex_data = lump.getData();
+	const byte *tex_data = lump.data();
+	int tex_length = lump.Length();
 
 	// at the front of the TEXTUREx lump are some 4-byte integers
-	s32_t *tex_data_s32 = (s32_t *)tex_data.data();
+	const s32_t *tex_data_s32 = (const s32_t *)tex_data;
 
 	int num_tex = LE_S32(tex_data_s32[0]);
 
@@ -248,7 +378,7 @@ static void LoadTexturesLump(WadData &wad, const ConfigData &config, const Lump_
 	if (num_tex < 0 || num_tex > (1<<20))
 		ThrowException("W_LoadTextures: TEXTURE1/2 lump is corrupt, bad count.\n");
 
-	bool is_strife = CheckTexturesAreStrife(tex_data.data(), (int)tex_data.size(), num_tex, skip_first);
+	bool is_strife = CheckTexturesAreStrife(tex_data, tex_length, num_tex, skip_first);
 
 	// Note: we skip the first entry (e.g. AASHITTY) which is not really
     //       usable (in the DOOM engine the #0 texture means "do not draw").
@@ -257,74 +387,151 @@ static void LoadTexturesLump(WadData &wad, const ConfigData &config, const Lump_
 	{
 		int offset = LE_S32(tex_data_s32[1 + n]);
 
-		if (offset < 4 * num_tex || offset >= (int)tex_data.size())
+		if (offset < 4 * num_tex || offset >= tex_length)
 			ThrowException("W_LoadTextures: TEXTURE1/2 lump is corrupt, bad offset.\n");
 
 		if (is_strife)
-			LoadTextureEntry_Strife(wad, config, tex_data.data(), (int)tex_data.size(), offset, pnames, pname_size, skip_first);
+			LoadTextureEntry_Strife(wad, config, tex_data, tex_length, offset, pnames, pname_size, skip_first);
 		else
-			LoadTextureEntry_DOOM(wad, config, tex_data.data(), (int)tex_data.size(), offset, pnames, pname_size, skip_first);
+			LoadTextureEntry_DOOM(wad, config, tex_data, tex_length, offset, pnames, pname_size, skip_first);
 	}
 }
 
 
-static void W_LoadTextures_TX_START(WadData &wad, const ConfigData &config, const Wad_file *wf)
+static tl::optional<Img_c> DecodeTextureLump(const Palette &palette, const ConfigData &config, const Lump_c *lump)
 {
-	for(const LumpRef &lumpRef : wf->getDir())
+	ImageFormat img_fmt = W_DetectImageFormat(*lump);
+	const SString &name = lump->Name();
+	tl::optional<Img_c> img;
+
+	switch (img_fmt)
 	{
-		if(lumpRef.ns != WadNamespace::TextureLumps)
-			continue;
-		const Lump_c *lump = lumpRef.lump.get();
+		case ImageFormat::doom: /* Doom patch */
+			img = Img_c();
+			if (! LoadPicture(palette, config, *img, *lump, name, 0, 0))
+			{
+				img.reset();
+			}
+			break;
 
-		ImageFormat img_fmt = W_DetectImageFormat(*lump);
-		const SString &name = lump->Name();
-		tl::optional<Img_c> img;
+		case ImageFormat::png: /* PNG */
+			img = LoadImage_PNG(*lump, name);
+			break;
 
-		switch (img_fmt)
-		{
-			case ImageFormat::doom: /* Doom patch */
-				img = Img_c();
-				if (! LoadPicture(wad.palette, config, *img, *lump, name, 0, 0))
-				{
-					img.reset();
-				}
-				break;
+		case ImageFormat::tga: /* TGA */
+			img = LoadImage_TGA(*lump, name);
+			break;
 
-			case ImageFormat::png: /* PNG */
-				img = LoadImage_PNG(*lump, name);
-				break;
+		case ImageFormat::jpeg: /* JPEG */
+			img = LoadImage_JPEG(*lump, name);
+			break;
 
-			case ImageFormat::tga: /* TGA */
-				img = LoadImage_TGA(*lump, name);
-				break;
+		case ImageFormat::unrecognized:
+			gLog.printf("Unknown texture format in '%s' lump\n", name.c_str());
+			break;
 
-			case ImageFormat::jpeg: /* JPEG */
-				img = LoadImage_JPEG(*lump, name);
-				break;
+		default:
+			gLog.printf("Unsupported texture format in '%s' lump\n", lump->Name().c_str());
+			break;
+	}
 
-			case ImageFormat::unrecognized:
-				gLog.printf("Unknown texture format in '%s' lump\n", name.c_str());
-				break;
+	return img;
+}
 
-			default:
-				gLog.printf("Unsupported texture format in '%s' lump\n", lump->Name().c_str());
-				break;
+
+//
+// A TX_START image decoded ahead of being added, with what it logged
+//
+struct DecodedTexture
+{
+	const Lump_c *lump;
+	tl::optional<Img_c> img;
+	LogBuffer log;
+	std::exception_ptr error;
+};
+
+
+//
+// Decodes the TX_START images of every wad up front, on several threads,
+// since they take the longest of all the resources. The result is in the
+// order of the wads and their directories, whatever the thread count.
+//
+static std::vector<std::vector<DecodedTexture>> W_DecodeTextures_TX_START(const WadData &wad,
+		const ConfigData &config, const std::vector<std::shared_ptr<Wad_file>> &wads, int num_threads)
+{
+	std::vector<std::vector<DecodedTexture>> result(wads.size());
+
+	for (size_t i = 0 ; i < wads.size() ; i++)
+	{
+		for (const LumpRef &lumpRef : wads[i]->getDir())
+			if (lumpRef.ns == WadNamespace::TextureLumps)
+				result[i].push_back({ lumpRef.lump.get(), {}, {}, nullptr });
+	}
+
+	std::vector<DecodedTexture *> jobs;
+	for (std::vector<DecodedTexture> &list : result)
+		for (DecodedTexture &job : list)
+			jobs.push_back(&job);
+
+	if (num_threads <= 0)
+		num_threads = WorkerPool::defaultThreads();
+
+	WorkerPool pool(std::min(num_threads, (int)jobs.size()));
+
+	pool.parallelFor((int)jobs.size(), [&](int index)
+	{
+		DecodedTexture &job = *jobs[index];
+		LogCapture capture(job.log);
+
+		try
+		{
+			crc32_c key = ImageKey('T', wad.palette, config);
+			AddLumpToKey(key, *job.lump);
+
+			job.img = CachedImage(wad.images.imageCache(), key, [&]()
+			{
+				return DecodeTextureLump(wad.palette, config, job.lump);
+			});
+		}
+		catch (...)
+		{
+			job.error = std::current_exception();
 		}
+	});
+
+	return result;
+}
+
+
+static void W_LoadTextures_TX_START(WadData &wad, std::vector<DecodedTexture> &decoded)
+{
+	for (DecodedTexture &entry : decoded)
+	{
+		entry.log.replay();
+
+		if (entry.error)
+			std::rethrow_exception(entry.error);
 
 		// if we successfully loaded the texture, add it
-		if (img)
+		if (entry.img)
 		{
-			wad.images.W_AddTexture(name, std::move(*img), false /* is_medusa */);
+			wad.images.W_AddTexture(entry.lump->Name(), std::move(*entry.img), false /* is_medusa */);
 		}
 	}
 }
 
 
-void WadData::W_LoadTextures(const ConfigData &config)
+void WadData::W_LoadTextures(const ConfigData &config, int num_threads)
 {
 	images.W_ClearTextures();
 
 	std::vector<std::shared_ptr<Wad_file>> wads = master.getAll();
+	images.W_SetImageSource(palette, wads);
+
+	std::vector<std::vector<DecodedTexture>> decoded;
+	if (config.features.tx_start)
+		decoded = W_DecodeTextures_TX_START(*this, config, wads, num_threads);
+
 	for (int i = 0 ; i < (int)wads.size() ; i++)
 	{
 		gLog.printf("Loading Textures from WAD #%d\n", i+1);
@@ -342,62 +549,113 @@ void WadData::W_LoadTextures(const ConfigData &config)
 
 		if (pnames)
 		{
-			const std::vector<byte> &pname_data = pnames->getData();
-
 			if (texture1)
-				LoadTexturesLump(*this, config, *texture1, pname_data.data(), (int)pname_data.size(), true);
+				LoadTexturesLump(*this, config, *texture1, pnames->data(), pnames->Length(), true);
 
 			if (texture2)
-				LoadTexturesLump(*this, config, *texture2, pname_data.data(), (int)pname_data.size(), false);
+				LoadTexturesLump(*this, config, *texture2, pnames->data(), pnames->Length(), false);
 		}
 
 		if (config.features.tx_start)
 		{
-			W_LoadTextures_TX_START(*this, config, wads[i].get());
+			W_LoadTextures_TX_START(*this, decoded[i]);
 		}
 	}
 }
 
 
-const Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+int ImageSet::findTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
 {
 	if (is_null_tex(name))
-		return NULL;
+		return IMAGE_UNKNOWN;
 
 	if (name.empty())
-		return NULL;
+		return IMAGE_UNKNOWN;
 
-	SString t_str = name;
-	std::map<SString, Img_c>::const_iterator P = textures.find(t_str);
+	auto P = textures.find(name);
 
 	if (P != textures.end())
-		return &P->second;
+		return P->second;
 
 	if (try_uppercase)
 	{
-		return getTexture(config, NormalizeTex(name), false);
+		return findTexture(config, NormalizeTex(name), false);
 	}
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c>::const_iterator P = flats.find(t_str);
+		auto P = flats.find(name);
 
 		if (P != flats.end())
-			return &P->second;
+			return P->second;
 	}
 
-	return NULL;
+	return IMAGE_UNKNOWN;
 }
 
 
+const Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	int handle = findTexture(config, name, try_uppercase);
+
+	return handle >= 0 ? drawImage(config, registry[handle]) : NULL;
+}
+
+
+//
+// Gives the place for a name in a StringID lookup table, growing it as
+// needed. The tables are emptied when used with another config.
+//
+int & ImageSet::lookupSlot(std::vector<int> &table, const ConfigData &config, StringID name) const
+{
+	if (lookup_config != &config)
+	{
+		texture_lookup.clear();
+		flat_lookup.clear();
+		lookup_config = &config;
+	}
+
+	size_t index = (size_t)name.get();
+
+	if (index >= table.size())
+		table.resize(std::max(index + 1, table.size() * 2), IMAGE_NOT_LOOKED_UP);
+
+	return table[index];
+}
+
+
+int ImageSet::textureHandle(const ConfigData &config, StringID name) const
+{
+	if (name.isInvalid())
+		return IMAGE_UNKNOWN;
+
+	int &handle = lookupSlot(texture_lookup, config, name);
+
+	if (handle == IMAGE_NOT_LOOKED_UP)
+	{
+		const SString &text = BA_GetString(name);
+
+		if (is_null_tex(text))
+			handle = IMAGE_NULL_TEX;
+		else if (is_special_tex(text))
+			handle = IMAGE_SPECIAL_TEX;
+		else
+			handle = findTexture(config, text, false);
+	}
+
+	return handle;
+}
+
+
+// this does not need to draw the texture
 int ImageSet::W_GetTextureHeight(const ConfigData &config, const SString &name) const
 {
-	const Img_c *img = getTexture(config, name);
+	int handle = findTexture(config, name, false);
 
-	if (! img)
+	if (handle < 0)
 		return 128;
 
-	return img->height();
+	return registry[handle].height();
 }
 
 // accepts "-", "#xxxx" or an existing texture name
@@ -409,16 +667,12 @@ bool ImageSet::W_TextureIsKnown(const ConfigData &config, const SString &name) c
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c>::const_iterator P = textures.find(name);
-
-	if (P != textures.end())
+	if (textures.find(name) != textures.end())
 		return true;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c>::const_iterator P = flats.find(name);
-
-		if (P != flats.end())
+		if (flats.find(name) != flats.end())
 			return true;
 	}
 
@@ -428,9 +682,9 @@ bool ImageSet::W_TextureIsKnown(const ConfigData &config, const SString &name) c
 
 bool ImageSet::W_TextureCausesMedusa(const SString &name) const
 {
-	std::map<SString, int>::const_iterator P = medusa_textures.find(name);
+	auto P = textures.find(name);
 
-	return (P != medusa_textures.end() && P->second > 0);
+	return (P != textures.end() && registry[P->second].medusa);
 }
 
 
@@ -462,18 +716,23 @@ SString NormalizeTex(const SString &name)
 
 void ImageSet::W_ClearFlats()
 {
-	flats.clear();
+	clearImages(flats);
 }
 
 
-void ImageSet::W_AddFlat(const SString &name, Img_c &&img)
+//
+// Adds a flat which gets read from the lump when first used
+//
+void ImageSet::W_AddFlat(const SString &name, const std::shared_ptr<const Lump_c> &lump)
 {
-	// find any existing one with same name, and free it
-	flats[name] = std::move(img);
+	LazyImage &entry = registry[addImage(flats, name)];
+
+	entry = LazyImage(64, 64);
+	entry.flat = lump;
 }
 
 
-static Img_c LoadFlatImage(const WadData &wad, const SString &name, const Lump_c *lump)
+static Img_c LoadFlatImage(const Palette &palette, const SString &name, const Lump_c *lump)
 {
 	// TODO: check size == 64*64
 
@@ -500,7 +759,7 @@ static Img_c LoadFlatImage(const WadData &wad, const SString &name, const Lump_c
 		img_pixel_t pix = raw[i];
 
 		if (pix == TRANS_PIXEL)
-			pix = static_cast<img_pixel_t>(wad.palette.getTransReplace());
+			pix = static_cast<img_pixel_t>(palette.getTransReplace());
 
 		img.wbuf() [i] = pix;
 	}
@@ -516,6 +775,8 @@ void WadData::W_LoadFlats()
 	images.W_ClearFlats();
 
 	std::vector<std::shared_ptr<Wad_file>> wads = master.getAll();
+	images.W_SetImageSource(palette, wads);
+
 	for (int i = 0 ; i < (int)wads.size() ; i++)
 	{
 		gLog.printf("Loading Flats from WAD #%d\n", i+1);
@@ -526,35 +787,62 @@ void WadData::W_LoadFlats()
 		{
 			if(lumpRef.ns != WadNamespace::Flats)
 				continue;
-			const Lump_c *lump = lumpRef.lump.get();
-
-			images.W_AddFlat(lump->Name(), LoadFlatImage(*this, lump->Name(), lump));
+			images.W_AddFlat(lumpRef.lump->Name(), lumpRef.lump);
 		}
 	}
 }
 
 
-const Img_c * ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const noexcept
+int ImageSet::findFlat(const ConfigData &config, const SString &name, bool try_uppercase) const noexcept
 {
-	std::map<SString, Img_c>::const_iterator P = flats.find(name);
+	auto P = flats.find(name);
 
 	if (P != flats.end())
-		return &P->second;
+		return P->second;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c>::const_iterator P = textures.find(name);
+		auto P = textures.find(name);
 
 		if (P != textures.end())
-			return &P->second;
+			return P->second;
 	}
 
 	if (try_uppercase)
 	{
-		return W_GetFlat(config, NormalizeTex(name), false);
+		return findFlat(config, NormalizeTex(name), false);
 	}
 
-	return NULL;
+	return IMAGE_UNKNOWN;
+}
+
+
+const Img_c * ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	int handle = findFlat(config, name, try_uppercase);
+
+	return handle >= 0 ? drawImage(config, registry[handle]) : NULL;
+}
+
+
+int ImageSet::flatHandle(const ConfigData &config, StringID name) const
+{
+	if (name.isInvalid())
+		return IMAGE_UNKNOWN;
+
+	int &handle = lookupSlot(flat_lookup, config, name);
+
+	if (handle == IMAGE_NOT_LOOKED_UP)
+	{
+		const SString &text = BA_GetString(name);
+
+		if (text.noCaseEqual(config.miscInfo.sky_flat))
+			handle = IMAGE_SKY_FLAT;
+		else
+			handle = findFlat(config, text, false);
+	}
+
+	return handle;
 }
 
 
@@ -567,16 +855,12 @@ bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) cons
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c>::const_iterator P = flats.find(name);
-
-	if (P != flats.end())
+	if (flats.find(name) != flats.end())
 		return true;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c>::const_iterator P = textures.find(name);
-
-		if (P != textures.end())
+		if (textures.find(name) != textures.end())
 			return true;
 	}
 
@@ -584,6 +868,120 @@ bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) cons
 }
 
 
+//----------------------------------------------------------------------
+//    DRAWING TEXTURES AND FLATS
+//----------------------------------------------------------------------
+
+void ImageSet::W_SetImageSource(const Palette &palette, const std::vector<std::shared_ptr<Wad_file>> &wads)
+{
+	image_palette = std::make_shared<Palette>(palette);
+	image_wads = wads;
+}
+
+
+//
+// Gives the pixels of a texture or flat, drawing them if not done yet
+//
+const Img_c * ImageSet::drawImage(const ConfigData &config, const LazyImage &entry) const
+{
+	entry.last_used = ++image_clock;
+
+	if (entry.image)
+		return &*entry.image;
+
+	if (entry.flat)
+	{
+		entry.image = LoadFlatImage(*image_palette, entry.flat->Name(), entry.flat.get());
+	}
+	else
+	{
+		crc32_c key = ImageKey('C', *image_palette, config);
+		key += (s32_t)entry.w;
+		key += (s32_t)entry.h;
+
+		for (const TexturePatch &patch : entry.patches)
+		{
+			key += (s32_t)patch.x;
+			key += (s32_t)patch.y;
+
+			if (patch.lump)
+				AddLumpToKey(key, *patch.lump);
+			else
+				key += (s32_t)-1;
+		}
+
+		entry.image = CachedImage(image_cache.get(), key, [&]()
+		{
+			tl::optional<Img_c> img = Img_c(entry.w, entry.h, false);
+
+			for (const TexturePatch &patch : entry.patches)
+			{
+				if (patch.lump && ! LoadPicture(*image_palette, config, *img, *patch.lump, patch.name,
+												 patch.x, patch.y))
+				{
+					gLog.printf("patch '%s' could not be drawn.\n", patch.name.c_str());
+				}
+			}
+
+			return img;
+		});
+	}
+
+	image_bytes += (size_t)entry.w * entry.h * sizeof(img_pixel_t);
+
+	return &*entry.image;
+}
+
+
+//
+// Frees the pixels, if they can be drawn again
+//
+void ImageSet::dropImage(const LazyImage &entry, bool can_delete_gl) const
+{
+	if (! entry.image || (! entry.flat && entry.patches.empty()))
+		return;
+
+	entry.image->unload_gl(can_delete_gl);
+	entry.image.reset();
+
+	image_bytes -= (size_t)entry.w * entry.h * sizeof(img_pixel_t);
+}
+
+
+//
+// Drops the least recently used textures and flats until the rest fit
+// in the budget. Only call this when no image pointers are held, e.g.
+// before drawing the canvas, since it may delete GL textures.
+//
+void ImageSet::W_TrimImages()
+{
+	if (image_bytes <= image_budget)
+		return;
+
+	std::vector<const LazyImage *> drawn;
+
+	for (const LazyImage &entry : registry)
+		if (entry.image)
+			drawn.push_back(&entry);
+
+	std::sort(drawn.begin(), drawn.end(), [](const LazyImage *A, const LazyImage *B)
+	{
+		return A->last_used < B->last_used;
+	});
+
+	// go a bit under the budget, so this does not happen every frame
+	size_t target = image_budget / 4 * 3;
+
+	for (const LazyImage *entry : drawn)
+	{
+		if (image_bytes <= target)
+			break;
+
+		dropImage(*entry, true);
+	}
+}
+
+
 //----------------------------------------------------------------------
 //    SPRITE HANDLING
 //----------------------------------------------------------------------
@@ -689,12 +1087,19 @@ const Img_c *WadData::getSprite(const ConfigData &config, int type, const Loadin
 		}
 		else
 		{
-			result = Img_c();
+			crc32_c key = ImageKey('S', palette, config);
+			AddLumpToKey(key, *lump);
 
-			if (! LoadPicture(palette, config, *result, *lump, info.sprite, 0, 0))
+			result = CachedImage(images.imageCache(), key, [&]()
 			{
-				result.reset();
-			}
+				tl::optional<Img_c> img = Img_c();
+
+				if (! LoadPicture(palette, config, *img, *lump, info.sprite, 0, 0))
+				{
+					img.reset();
+				}
+				return img;
+			});
 		}
 	}
 
@@ -775,16 +1180,6 @@ const Img_c *WadData::getSprite(const ConfigData &config, int type, const Loadin
 
 //----------------------------------------------------------------------
 
-static void UnloadTex(std::map<SString, Img_c>::value_type& P)
-{
-	P.second.unload_gl(false);
-}
-
-static void UnloadFlat(std::map<SString, Img_c>::value_type& P)
-{
-	P.second.unload_gl(false);
-}
-
 static void UnloadSprite(sprite_map_t::value_type& P)
 {
 	if (P.second)
@@ -793,8 +1188,9 @@ static void UnloadSprite(sprite_map_t::value_type& P)
 
 void ImageSet::W_UnloadAllTextures()
 {
-	std::for_each(textures.begin(), textures.end(), UnloadTex);
-	std::for_each(flats.begin(),    flats.end(), UnloadFlat);
+	for (const LazyImage &entry : registry)
+		if (entry.image)
+			entry.image->unload_gl(false);
 	std::for_each(sprites.begin(), sprites.end(), UnloadSprite);
 
 	IM_UnloadDummyTextures();
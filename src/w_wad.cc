@@ -37,6 +37,11 @@
 #include "w_wad.h"
 
 #include <assert.h>
+#include <chrono>
+
+#ifdef _WIN32
+#include <io.h>
+#endif
 
 // UDMF support is unfinished and hence disabled by default.
 bool global::udmf_testing = false;
@@ -92,7 +97,7 @@ bool LumpInputStream::read(void *data, int len) noexcept
 		result = false;
 		len = lump.Length() - pos;
 	}
-	memcpy(data, lump.getData().data() + pos, len);
+	memcpy(data, lump.data() + pos, len);
 	pos += len;
 	return result;
 }
@@ -105,7 +110,7 @@ bool LumpInputStream::readLine(SString &string) noexcept
 	string.clear();
 	for(; pos < lump.Length(); ++pos)
 	{
-		string.push_back(static_cast<char>(lump.getData()[pos]));
+		string.push_back(static_cast<char>(lump.data()[pos]));
 		if(string.back() == '\n')
 		{
 			++pos;
@@ -115,8 +120,26 @@ bool LumpInputStream::readLine(SString &string) noexcept
 	return true;	// OK
 }
 
+//
+// Copy the data out of the mapped file before changing it
+//
+void Lump_c::detach()
+{
+	if (! mView)
+		return;
+
+	mData.assign(mView, mView + mViewLength);
+
+	mMapping.reset();
+	mView = nullptr;
+	mViewLength = 0;
+}
+
 void Lump_c::Write(const void *vdata, int len)
 {
+	detach();
+	mDiskPos = -1;
+
 	auto data = static_cast<const byte *>(vdata);
 	mData.insert(mData.begin() + mPos, data, data + len);
 	mPos += len;
@@ -141,6 +164,9 @@ void Lump_c::Printf(EUR_FORMAT_STRING(const char *msg), ...)
 //
 size_t Lump_c::writeData(FILE *f, int len)
 {
+	detach();
+	mDiskPos = -1;
+
 	mData.insert(mData.begin() + mPos, len, 0);
 	size_t actualRead = fread(mData.data() + mPos, 1, len, f);
 	if((int)actualRead < len)
@@ -239,6 +265,8 @@ retry:
 		return NULL;
 	}
 
+	w->noteDiskFile(total_size);
+
 	w->DetectLevels();
 	w->ProcessNamespaces();
 
@@ -247,6 +275,38 @@ retry:
 	return w;
 }
 
+
+//
+// Opens a wad for reading, leaving its lumps in the file (see MappedFile)
+// to be read only when used. Only meant for the IWAD: if another program
+// rewrites a mapped file, touching the lumps which are gone crashes us.
+// PWADs are much more likely to be edited while we run.
+//
+std::shared_ptr<Wad_file> Wad_file::openMapped(const fs::path &filename)
+{
+	std::shared_ptr<const MappedFile> file = MappedFile::open(filename);
+
+	// otherwise read it all in
+	if (! file)
+		return Open(filename, WadOpenMode::read);
+
+	gLog.printf("Opening WAD file: %s\n", filename.u8string().c_str());
+
+	auto w = std::shared_ptr<Wad_file>(new Wad_file(filename, WadOpenMode::read));
+
+	if (! w->ReadMappedDirectory(file))
+	{
+		gLog.printf("Open wad failed (reading directory)\n");
+		return NULL;
+	}
+
+	w->DetectLevels();
+	w->ProcessNamespaces();
+
+	return w;
+}
+
+
 std::shared_ptr<Wad_file> Wad_file::loadFromFile(const fs::path &filename)
 {
 	gLog.printf("Opening WAD file: %s\n", filename.u8string().c_str());
@@ -284,6 +344,8 @@ std::shared_ptr<Wad_file> Wad_file::loadFromFile(const fs::path &filename)
 		return NULL;
 	}
 
+	w->noteDiskFile(total_size);
+
 	w->DetectLevels();
 	w->ProcessNamespaces();
 
@@ -383,22 +445,53 @@ Lump_c * Wad_file::GetLump(int index) const noexcept
 }
 
 
+//
+// The key of a name in the name index: the name in uppercase, coded
+// into 8 bytes like Lump_c::getName8().  Returns false if the name is
+// too long to belong to any lump.
+//
+static bool LumpNameKey(const char *name, int64_t &key) noexcept
+{
+	union
+	{
+		char cbuf[8];
+		int64_t cint;
+	} buffer = {};
+
+	for (int i = 0 ; name[i] ; i++)
+	{
+		if (i >= 8)
+			return false;
+
+		buffer.cbuf[i] = static_cast<char>(toupper(name[i]));
+	}
+
+	key = buffer.cint;
+	return true;
+}
+
+
 Lump_c * Wad_file::FindLump(const SString &name) const noexcept
 {
-	for (auto it = directory.rbegin(); it != directory.rend(); ++it)
-		if (it->lump->name.noCaseEqual(name))
-			return it->lump.get();
+	int k = FindLumpNum(name);
 
-	return nullptr;  // not found
+	return k >= 0 ? directory[k].lump.get() : nullptr;
 }
 
 int Wad_file::FindLumpNum(const SString &name) const noexcept
 {
-	for (int k = NumLumps() - 1 ; k >= 0 ; k--)
-		if (directory[k].lump->name.noCaseEqual(name))
-			return k;
+	int64_t key;
+	if (! LumpNameKey(name.c_str(), key))
+		return -1;
 
-	return -1;  // not found
+	EnsureIndex();
+
+	auto it = name_index.find(key);
+	if (it == name_index.end())
+		return -1;  // not found
+
+	// the last one wins
+	return it->second.back();
 }
 
 
@@ -539,12 +632,19 @@ MapFormat Wad_file::LevelFormat(int lev_num) const noexcept
 
 const Lump_c * Wad_file::FindLumpInNamespace(const SString &name, WadNamespace group) const noexcept
 {
-	for(const LumpRef &lumpRef : directory)
-	{
-		if(lumpRef.ns != group || !lumpRef.lump->name.noCaseEqual(name))
-			continue;
-		return lumpRef.lump.get();
-	}
+	int64_t key;
+	if(!LumpNameKey(name.c_str(), key))
+		return nullptr;
+
+	EnsureIndex();
+
+	auto it = name_index.find(key);
+	if(it == name_index.end())
+		return nullptr; // not found!
+
+	for(int k : it->second)
+		if(directory[k].ns == group)
+			return directory[k].lump.get();
 
 	return nullptr; // not found!
 }
@@ -556,13 +656,32 @@ const Lump_c *Wad_file::findFirstSpriteLump(const SString &stem) const
 {
 	SString firstName;
 	const Lump_c *result = nullptr;
-	for(const LumpRef &lumpRef : directory)
+
+	EnsureIndex();
+
+	// only the sprites starting with the same four letters can match,
+	// unless the stem is shorter than that
+	std::vector<int> all;
+	const std::vector<int> *candidates = &all;
+	int64_t key;
+	if(stem.length() >= 4 && LumpNameKey(stem.substr(0, 4).c_str(), key))
 	{
-		if(lumpRef.ns != WadNamespace::Sprites)
-			continue;
+		auto it = sprite_index.find(key);
+		if(it == sprite_index.end())
+			return nullptr;
+		candidates = &it->second;
+	}
+	else
+	{
+		for(const auto &entry : sprite_index)
+			all.insert(all.end(), entry.second.begin(), entry.second.end());
+		std::sort(all.begin(), all.end());
+	}
+
+	for(int k : *candidates)
+	{
+		const LumpRef &lumpRef = directory[k];
 		const SString &name = lumpRef.lump->name;
-		if(name.length() != 6 && name.length() != 8)
-			continue;
 		if(stem.length() <= 4)
 		{
 			if(!name.startsWith(stem.c_str()))
@@ -609,6 +728,35 @@ const Lump_c *Wad_file::findFirstSpriteLump(const SString &stem) const
 	return result;
 }
 
+//
+// Clears the position of an empty lump or one which goes past the end
+// of the file.  Returns false if the lump is empty now.
+//
+static bool CheckLumpPosition(const Lump_c &lump, int &l_start, int &l_length, int total_size)
+{
+	if (l_length == 0)
+	{
+		l_start = 0;
+		return false;
+	}
+
+	const int max_size = 99999999;
+
+	if (l_length < 0 || l_start < 0 || l_length >= max_size ||
+		l_start > total_size || l_start + l_length > total_size)
+	{
+		gLog.printf("WARNING: clearing lump '%s' with invalid position (%d+%d > %d)\n",
+				  lump.Name().c_str(), l_start, l_length, total_size);
+
+		l_start = 0;
+		l_length = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
 bool Wad_file::ReadDirectory(FILE *fp, int total_size)
 {
 	rewind(fp);
@@ -632,6 +780,9 @@ bool Wad_file::ReadDirectory(FILE *fp, int total_size)
 		return false;
 	}
 
+	disk_dir_start = dir_start;
+	disk_dir_count = dir_count;
+
 	if (fseek(fp, dir_start, SEEK_SET) != 0)
 	{
 		gLog.printf("Error seeking to WAD directory.\n");
@@ -653,52 +804,36 @@ bool Wad_file::ReadDirectory(FILE *fp, int total_size)
 		Lump_c *lump = new Lump_c(SString(entry.name, 8));
 		int l_length = LE_U32(entry.size);
 		int l_start = LE_U32(entry.pos);
-		if(l_length == 0)
-			l_start = 0;
 
 		// check if entry is valid
 		// [ the total_size value was computed in parent function ]
-		if (l_length != 0)
+		if (CheckLumpPosition(*lump, l_start, l_length, total_size))
 		{
-			const int max_size = 99999999;
-
-			if (l_length < 0 || l_start < 0 || l_length >= max_size ||
-				l_start > total_size || l_start + l_length > total_size)
+			long curpos = ftell(fp);
+			if(curpos < 0)
 			{
-				gLog.printf("WARNING: clearing lump '%s' with invalid position (%d+%d > %d)\n",
-						  lump->name.c_str(), l_start, l_length, total_size);
-
-				l_start = 0;
-				l_length = 0;
+				gLog.printf("%s: ftell failed with error %d\n", __func__,
+							errno);
+				return false;
 			}
-
-			if(l_length > 0)
+			if(fseek(fp, l_start, SEEK_SET) < 0)
 			{
-				long curpos = ftell(fp);
-				if(curpos < 0)
-				{
-					gLog.printf("%s: ftell failed with error %d\n", __func__,
-								errno);
-					return false;
-				}
-				if(fseek(fp, l_start, SEEK_SET) < 0)
-				{
-					gLog.printf("%s: fseek failed with error %d\n", __func__,
-								errno);
-					return false;
-				}
-				if((int)lump->writeData(fp, l_length) < l_length)
-				{
-					gLog.printf("%s: failed reading %d bytes for lump '%s'\n",
-								__func__, l_length, lump->name.c_str());
-					return false;
-				}
-				if(fseek(fp, curpos, SEEK_SET) < 0)
-				{
-					gLog.printf("%s: fseek back failed with error %d\n",
-								__func__, errno);
-					return false;
-				}
+				gLog.printf("%s: fseek failed with error %d\n", __func__,
+							errno);
+				return false;
+			}
+			if((int)lump->writeData(fp, l_length) < l_length)
+			{
+				gLog.printf("%s: failed reading %d bytes for lump '%s'\n",
+							__func__, l_length, lump->name.c_str());
+				return false;
+			}
+			lump->mDiskPos = l_start;
+			if(fseek(fp, curpos, SEEK_SET) < 0)
+			{
+				gLog.printf("%s: fseek back failed with error %d\n",
+							__func__, errno);
+				return false;
 			}
 		}
 
@@ -709,6 +844,71 @@ bool Wad_file::ReadDirectory(FILE *fp, int total_size)
 	return true;
 }
 
+//
+// Like ReadDirectory, but the lumps only point into the mapped file
+//
+bool Wad_file::ReadMappedDirectory(const std::shared_ptr<const MappedFile> &file)
+{
+	const byte *base = file->data();
+	size_t total_size = file->size();
+
+	raw_wad_header_t header;
+
+	if (total_size < sizeof(header))
+	{
+		gLog.printf("Error reading WAD header.\n");
+		return false;
+	}
+
+	memcpy(&header, base, sizeof(header));
+
+	kind = header.ident[0] == 'I' ? WadKind::IWAD : WadKind::PWAD;
+
+	int dir_start = LE_S32(header.dir_start);
+	int dir_count = LE_S32(header.num_entries);
+
+	if (dir_count < 0)
+	{
+		gLog.printf("Bad WAD header, invalid number of entries (%d)\n", dir_count);
+		return false;
+	}
+
+	if (dir_start < 0 || (size_t)dir_start > total_size ||
+		(total_size - dir_start) / sizeof(raw_wad_entry_t) < (size_t)dir_count)
+	{
+		gLog.printf("Error reading entry in WAD directory.\n");
+		return false;
+	}
+
+	disk_dir_start = dir_start;
+	disk_dir_count = dir_count;
+
+	directory.reserve(dir_count);
+
+	for (int i = 0 ; i < dir_count ; i++)
+	{
+		raw_wad_entry_t entry;
+		memcpy(&entry, base + dir_start + i * sizeof(entry), sizeof(entry));
+
+		Lump_c *lump = new Lump_c(SString(entry.name, 8));
+		int l_length = LE_U32(entry.size);
+		int l_start = LE_U32(entry.pos);
+
+		if (CheckLumpPosition(*lump, l_start, l_length, (int)std::min(total_size, (size_t)INT_MAX)))
+		{
+			lump->mMapping = file;
+			lump->mView = base + l_start;
+			lump->mViewLength = l_length;
+			lump->mPos = l_length;
+		}
+
+		LumpRef lumpRef = {};	// Currently not set, will set in ResolveNamespace
+		lumpRef.lump.reset(lump);
+		directory.push_back(std::move(lumpRef));
+	}
+	return true;
+}
+
 
 void Wad_file::DetectLevels()
 {
@@ -871,6 +1071,53 @@ void Wad_file::ProcessNamespaces()
 
 	if (active != WadNamespace::Global)
 		gLog.printf("WARNING: Missing %s_END marker (at EOF)\n", WadNamespaceString(active));
+
+	index_stale = true;
+}
+
+//
+// Rebuilds the name indices if the directory changed since the last lookup.
+// Lookups may come from several threads at once (resource loading), hence
+// the lock.
+//
+void Wad_file::EnsureIndex() const
+{
+	if (! index_stale.load(std::memory_order_acquire))
+		return;
+
+	std::lock_guard<std::mutex> lock(index_mutex);
+	if (! index_stale.load(std::memory_order_relaxed))
+		return;
+
+	BuildIndex();
+	index_stale.store(false, std::memory_order_release);
+}
+
+
+void Wad_file::BuildIndex() const
+{
+	name_index.clear();
+	sprite_index.clear();
+
+	for (int k = 0 ; k < NumLumps() ; k++)
+	{
+		const LumpRef &lumpRef = directory[k];
+		const SString &name = lumpRef.lump->name;
+
+		int64_t key;
+		if (! LumpNameKey(name.c_str(), key))
+			continue;
+
+		name_index[key].push_back(k);
+
+		// findFirstSpriteLump() only looks at these
+		if (lumpRef.ns == WadNamespace::Sprites &&
+			(name.length() == 6 || name.length() == 8) &&
+			LumpNameKey(name.substr(0, 4).c_str(), key))
+		{
+			sprite_index[key].push_back(k);
+		}
+	}
 }
 
 
@@ -889,14 +1136,223 @@ void Wad_file::writeToDisk() noexcept(false)
 					   filename.u8string().c_str());
 	}
 
-	// Write to our path now
-	writeToPath(filename);
+	auto start = std::chrono::steady_clock::now();
+
+	int bytes_written;
+	bool incremental = writeChanges(bytes_written);
+
+	if(!incremental)
+	{
+		// Write the whole wad to our path now
+		writeToPath(filename);
+
+		// the lumps now follow each other, like writeToPath() puts them
+		int pos = 12;
+		for(const LumpRef &ref : directory)
+		{
+			ref.lump->mDiskPos = pos;
+			pos += ref.lump->Length();
+		}
+		disk_dir_start = pos;
+		disk_dir_count = NumLumps();
+		bytes_written = TotalSize();
+		noteDiskFile(bytes_written);
+	}
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start);
+
+	gLog.printf("Saved %s: %d bytes written in %d ms (%s)\n",
+				filename.u8string().c_str(), bytes_written, (int)elapsed.count(),
+				incremental ? "changes only" : "whole file");
 
 	// reset the insertion point
 	insert_point = -1;
 }
 
 
+// when more than this part of the file would be old data, the
+// whole file gets written again instead
+#define WAD_MAX_WASTE_PERCENT	50
+
+// smaller files are cheap enough to always write in full
+#define WAD_MIN_INCREMENTAL_SIZE	(1 << 20)
+
+static bool W_FlushToDisk(FILE *fp)
+{
+	if (fflush(fp) != 0)
+		return false;
+#ifdef _WIN32
+	return _commit(_fileno(fp)) == 0;
+#else
+	return fsync(fileno(fp)) == 0;
+#endif
+}
+
+//
+// Remembers the file as it is now on the disk, after reading or writing
+// it whole
+//
+void Wad_file::noteDiskFile(int size)
+{
+	disk_size = size;
+
+	std::error_code ec;
+	disk_time = fs::last_write_time(filename, ec);
+	if (ec)
+		disk_size = 0;	// can't tell changes apart, so always write it all
+}
+
+//
+// Whether the open file is still the one last read or written, going by
+// its size, time and header. Anything else may have moved the lumps.
+//
+bool Wad_file::diskFileUnchanged(FILE *fp) const
+{
+	std::error_code ec;
+	uintmax_t actual_size = fs::file_size(filename, ec);
+	if (ec || actual_size != (uintmax_t)disk_size)
+		return false;
+
+	fs::file_time_type actual_time = fs::last_write_time(filename, ec);
+	if (ec || actual_time != disk_time)
+		return false;
+
+	raw_wad_header_t header;
+	if (fseek(fp, 0, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, fp) != 1)
+		return false;
+
+	return memcmp(header.ident, kind == WadKind::PWAD ? "PWAD" : "IWAD", 4) == 0 &&
+		LE_S32(header.dir_start) == disk_dir_start &&
+		LE_S32(header.num_entries) == disk_dir_count;
+}
+
+//
+// Saves the wad by appending the changed lumps and a new directory to
+// the file, then pointing the header at them.  Nothing the old header
+// refers to is touched, so the file stays valid if this is interrupted.
+//
+// Returns false when the whole file should be written instead: it was
+// never saved, it is small, it was changed by someone else, or too much
+// of it would be unused.
+//
+bool Wad_file::writeChanges(int &bytes_written) noexcept(false)
+{
+	bytes_written = 0;
+
+	if (disk_size < WAD_MIN_INCREMENTAL_SIZE)
+		return false;
+
+	// the changed lumps go at the end
+	int append_size = 0;
+	for (const LumpRef &ref : directory)
+		if (ref.lump->Length() > 0 && ref.lump->mDiskPos < 0)
+			append_size += ref.lump->Length();
+
+	int dir_size = NumLumps() * (int)sizeof(raw_wad_entry_t);
+	int64_t new_size = (int64_t)disk_size + append_size + dir_size;
+
+	int64_t waste = new_size - TotalSize();
+	if (waste * 100 > new_size * WAD_MAX_WASTE_PERCENT || new_size > INT_MAX)
+		return false;
+
+	// TODO: #55 unicode
+	FILE *fp = fopen(filename.u8string().c_str(), "r+b");
+	if (! fp)
+		return false;
+
+	if (! diskFileUnchanged(fp))
+	{
+		gLog.printf("%s was changed on disk since it was loaded, writing it whole\n",
+					filename.u8string().c_str());
+		fclose(fp);
+		return false;
+	}
+
+	auto fail = [&](const char *what)
+	{
+		SString message = SString::printf("Failed %s %s: %s", what,
+				filename.u8string().c_str(), GetErrorMessage(errno).c_str());
+		fclose(fp);
+		gLog.printf("%s\n", message.c_str());
+		throw WadWriteException(message);
+	};
+
+	if (fseek(fp, disk_size, SEEK_SET) != 0)
+		fail("seeking in");
+
+	std::vector<int> positions;
+	positions.reserve(directory.size());
+
+	int pos = disk_size;
+	for (const LumpRef &ref : directory)
+	{
+		const Lump_c &lump = *ref.lump;
+		if (lump.Length() == 0)
+		{
+			positions.push_back(0);
+			continue;
+		}
+		if (lump.mDiskPos >= 0)
+		{
+			positions.push_back(lump.mDiskPos);
+			continue;
+		}
+		if (fwrite(lump.data(), lump.Length(), 1, fp) != 1)
+			fail("writing to");
+		positions.push_back(pos);
+		pos += lump.Length();
+	}
+
+	int dir_start = pos;
+	for (int k = 0 ; k < NumLumps() ; k++)
+	{
+		const Lump_c &lump = *directory[k].lump;
+
+		raw_wad_entry_t entry;
+		entry.pos  = LE_U32(positions[k]);
+		entry.size = LE_U32(lump.Length());
+		int64_t nm = lump.getName8();
+		memcpy(entry.name, &nm, 8);
+
+		if (fwrite(&entry, sizeof(entry), 1, fp) != 1)
+			fail("writing to");
+	}
+
+	// the new lumps and directory must be on the disk before the header
+	// points at them
+	if (! W_FlushToDisk(fp))
+		fail("flushing");
+
+	raw_wad_header_t header;
+	memcpy(header.ident, kind == WadKind::PWAD ? "PWAD" : "IWAD", 4);
+	header.num_entries = LE_U32(NumLumps());
+	header.dir_start   = LE_U32(dir_start);
+
+	if (fseek(fp, 0, SEEK_SET) != 0)
+		fail("seeking in");
+	if (fwrite(&header, sizeof(header), 1, fp) != 1 || ! W_FlushToDisk(fp))
+		fail("writing to");
+
+	if (fclose(fp) != 0)
+	{
+		SString message = SString::printf("Failed closing %s: %s",
+				filename.u8string().c_str(), GetErrorMessage(errno).c_str());
+		gLog.printf("%s\n", message.c_str());
+		throw WadWriteException(message);
+	}
+
+	for (int k = 0 ; k < NumLumps() ; k++)
+		directory[k].lump->mDiskPos = positions[k];
+
+	disk_dir_start = dir_start;
+	disk_dir_count = NumLumps();
+	noteDiskFile((int)new_size);
+	bytes_written = append_size + dir_size + (int)sizeof(header);
+	return true;
+}
+
+
 void Wad_file::RenameLump(int index, const char *new_name)
 {
 	SYS_ASSERT(0 <= index && index < NumLumps());
@@ -905,6 +1361,8 @@ void Wad_file::RenameLump(int index, const char *new_name)
 	SYS_ASSERT(lump);
 
 	lump->Rename(new_name);
+
+	index_stale = true;
 }
 
 
@@ -989,6 +1447,70 @@ void Wad_file::RemoveZNodes(int lev_num)
 }
 
 
+std::shared_ptr<Wad_file> Wad_file::copyLevel(int lev_num) const
+{
+	SYS_ASSERT(0 <= lev_num && lev_num < LevelCount());
+
+	int start  = LevelHeader(lev_num);
+	int finish = LevelLastLump(lev_num);
+
+	// not Create(), this one is never written out
+	std::shared_ptr<Wad_file> result(new Wad_file(filename, WadOpenMode::write));
+
+	for (int i = start ; i <= finish ; i++)
+	{
+		const LumpRef &ref = directory[i];
+
+		LumpRef copy = {};
+		copy.lump = std::make_shared<Lump_c>(ref.lump->name);
+		copy.lump->mData = ref.lump->mData;
+		copy.lump->mMapping = ref.lump->mMapping;
+		copy.lump->mView = ref.lump->mView;
+		copy.lump->mViewLength = ref.lump->mViewLength;
+		copy.lump->mDiskPos = ref.lump->mDiskPos;
+		copy.ns = ref.ns;
+
+		result->directory.push_back(std::move(copy));
+	}
+
+	result->levels.push_back(0);
+
+	return result;
+}
+
+
+void Wad_file::replaceLevel(int lev_num, Wad_file &other)
+{
+	SYS_ASSERT(0 <= lev_num && lev_num < LevelCount());
+	SYS_ASSERT(other.LevelCount() == 1 && other.LevelHeader(0) == 0);
+
+	int start  = LevelHeader(lev_num);
+	int finish = LevelLastLump(lev_num);
+
+	// the header stays, so the level keeps its place in levels[]
+	int num_removed = finish - start;
+	int num_added   = other.NumLumps() - 1;
+
+	directory.erase(directory.begin() + start + 1,
+					directory.begin() + finish + 1);
+
+	directory.insert(directory.begin() + start + 1,
+					 std::make_move_iterator(other.directory.begin() + 1),
+					 std::make_move_iterator(other.directory.end()));
+
+	FixLevelGroup(start + 1, num_added, num_removed);
+
+	other.directory.clear();
+	other.levels.clear();
+	other.index_stale = true;
+
+	// reset the insertion point
+	insert_point = -1;
+
+	ProcessNamespaces();
+}
+
+
 void Wad_file::FixLevelGroup(int index, int num_added, int num_removed)
 {
 	bool did_remove = false;
@@ -1041,7 +1563,7 @@ void Wad_file::writeToPath(const fs::path &path) const noexcept(false)
 	{
 		assert(ref.lump.get() != nullptr);
 		const Lump_c &lump = *ref.lump;
-		sof.write(lump.getData().data(), lump.Length());
+		sof.write(lump.data(), lump.Length());
 	}
 	infotableofs = 12;
 	for(const LumpRef &ref : directory)
@@ -1137,21 +1659,65 @@ bool Wad_file::Backup(const fs::path &new_filename) const
 //  GLOBAL API
 //------------------------------------------------------------------------
 
+void MasterDir::setGameWad(const std::shared_ptr<Wad_file> &gameWad)
+{
+	game_wad = gameWad;
+	buildGlobalIndex();
+}
+
+void MasterDir::setResources(const std::vector<std::shared_ptr<Wad_file>> &wads)
+{
+	resource_wads = wads;
+	buildGlobalIndex();
+}
+
+//
+// The game and resource wads are only read, so their global lumps are
+// merged once here, instead of searching each wad on every lookup.
+//
+void MasterDir::buildGlobalIndex()
+{
+	global_lumps.clear();
+
+	std::vector<std::shared_ptr<Wad_file>> wads;
+	if (game_wad)
+		wads.push_back(game_wad);
+	wads.insert(wads.end(), resource_wads.begin(), resource_wads.end());
+
+	for (const std::shared_ptr<Wad_file> &wad : wads)
+	{
+		const std::vector<LumpRef> &dir = wad->getDir();
+
+		// backwards, so the first one in each wad wins
+		for (auto it = dir.rbegin(); it != dir.rend(); ++it)
+		{
+			int64_t key;
+			if (it->ns == WadNamespace::Global && LumpNameKey(it->lump->Name().c_str(), key))
+				global_lumps[key] = it->lump.get();
+		}
+	}
+}
+
 //
 // find a lump in any loaded wad (later ones tried first),
 // returning NULL if not found.
 //
 const Lump_c *MasterDir::findGlobalLump(const SString &name) const
 {
-	std::vector<std::shared_ptr<Wad_file>> wads = getAll();
-	for (auto it = wads.rbegin(); it != wads.rend(); ++it)
+	if (edit_wad)
 	{
-		const Lump_c *L = (*it)->FindLumpInNamespace(name, WadNamespace::Global);
+		const Lump_c *L = edit_wad->FindLumpInNamespace(name, WadNamespace::Global);
 		if (L)
 			return L;
 	}
 
-	return NULL;  // not found
+	int64_t key;
+	if (! LumpNameKey(name.c_str(), key))
+		return NULL;
+
+	auto it = global_lumps.find(key);
+
+	return it != global_lumps.end() ? it->second : NULL;
 }
 
 //------------------------------------------------------------------------
@@ -1161,6 +1727,7 @@ void MasterDir::MasterDir_CloseAll()
 	resource_wads.clear();
 	edit_wad.reset();
 	game_wad.reset();
+	global_lumps.clear();
 }
 
 
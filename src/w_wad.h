@@ -29,8 +29,12 @@
 
 #include "Errors.h"
 #include "main.h"
+#include "MappedFile.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "filesystem.hpp"
 namespace fs = ghc::filesystem;
@@ -72,7 +76,12 @@ public:
 	}
 };
 
-class Lump_c
+//
+// A lump is owned by its wad's directory, and also by the lazily drawn
+// images made from it (see LazyImage), so these can still be drawn after
+// the lump got removed from the wad.
+//
+class Lump_c : public std::enable_shared_from_this<Lump_c>
 {
 friend class Wad_file;
 
@@ -82,6 +91,18 @@ private:
 	std::vector<byte> mData;
 	int mPos = 0;	// insertion point for reading or writing
 
+	// for a lump of a read-only wad, its data is in the mapped file
+	// instead of mData, until the lump gets changed
+	std::shared_ptr<const MappedFile> mMapping;
+	const byte *mView = nullptr;
+	int mViewLength = 0;
+
+	// where the same data is in the wad file, or -1 if it has changed
+	// since the wad was read or written
+	int mDiskPos = -1;
+
+	void detach();
+
 public:
 	Lump_c() = default;
 	explicit Lump_c(const SString& _nam);
@@ -94,7 +115,7 @@ public:
 	}
 	int Length() const
 	{
-		return (int)mData.size();
+		return mView ? mViewLength : (int)mData.size();
 	}
 
 	// do not call this directly, use Wad_file::RenameLump()
@@ -112,7 +133,10 @@ public:
 	size_t writeData(FILE *f, int len);
 	void setData(std::vector<byte> &&data)
 	{
+		mMapping.reset();
+		mView = nullptr;
 		mData = std::move(data);
+		mDiskPos = -1;
 	}
 
     //
@@ -120,16 +144,33 @@ public:
     //
     void clearData() noexcept
     {
+        mMapping.reset();
+        mView = nullptr;
         mData.clear();
         mPos = 0;
+        mDiskPos = -1;
     }
 
 	//
-	// Gets the data from lump without moving the insertion point.
+	// The data of the lump (Length() bytes), without copying it or moving
+	// the insertion point. Only valid until the lump is changed.
+	//
+	const byte *data() const noexcept
+	{
+		return mView ? mView : mData.data();
+	}
+
+	//
+	// Gets a copy of the data from lump without moving the insertion point.
 	//
-	const std::vector<byte> &getData() const noexcept
+	std::vector<byte> getData() const
 	{
-		return mData;
+		return std::vector<byte>(data(), data() + Length());
+	}
+
+	bool isMapped() const noexcept
+	{
+		return mView != nullptr;
 	}
 
 	int64_t getName8() const noexcept;
@@ -160,7 +201,7 @@ private:
 
 struct LumpRef
 {
-	std::unique_ptr<Lump_c> lump;
+	std::shared_ptr<Lump_c> lump;
 	WadNamespace ns;
 };
 
@@ -182,6 +223,27 @@ private:
 	// when >= 0, the next added lump is placed _before_ this
 	int insert_point = -1;
 
+	// size of the file as last read or written, 0 if the lumps are not
+	// laid out in it (see Lump_c::mDiskPos)
+	int disk_size = 0;
+
+	// the rest of what the file looked like then, to tell whether it
+	// got changed by someone else since
+	fs::file_time_type disk_time;
+	int disk_dir_start = 0;
+	int disk_dir_count = 0;
+
+	// lump indices by name (see Lump_c::getName8), in directory order.
+	// changing the directory only marks them stale, they get rebuilt by
+	// the next lookup (see EnsureIndex).
+	mutable std::unordered_map<int64_t, std::vector<int>> name_index;
+
+	// indices of the sprite lumps by their first four letters
+	mutable std::unordered_map<int64_t, std::vector<int>> sprite_index;
+
+	mutable std::atomic<bool> index_stale { true };
+	mutable std::mutex index_mutex;
+
 	// constructor is private
 	Wad_file(const fs::path &_name, WadOpenMode _mode) :
 	   filename(_name), mode(_mode)
@@ -204,6 +266,8 @@ public:
 	static std::shared_ptr<Wad_file> Open(const fs::path &filename,
 										  WadOpenMode mode
 										  = WadOpenMode::append);
+	// open a wad for reading, mapping the file instead of reading it in
+	static std::shared_ptr<Wad_file> openMapped(const fs::path &filename);
 	static std::shared_ptr<Wad_file> loadFromFile(const fs::path &filename);
 
 	// check the given wad file exists and is a WAD file
@@ -280,6 +344,16 @@ public:
 	// removes any ZNODES lump from a UDMF level.
 	void RemoveZNodes(int lev_num);
 
+	// makes a new wad in memory holding a copy of the level's lumps (as
+	// its only level), e.g. for building its nodes on another thread.
+	std::shared_ptr<Wad_file> copyLevel(int lev_num) const;
+
+	// replaces the lumps of the given level with all the lumps of the
+	// other wad, which must hold just that level (see copyLevel).
+	// the other wad is left empty.
+	// this will change index numbers on existing lumps.
+	void replaceLevel(int lev_num, Wad_file &other);
+
 	// insert a new lump.
 	// The second form is for a level marker.
 	// The 'max_size' parameter (if >= 0) specifies the most data
@@ -308,13 +382,19 @@ private:
 
 	// read the existing directory.
 	bool ReadDirectory(FILE *fp, int totalSize);
+	bool ReadMappedDirectory(const std::shared_ptr<const MappedFile> &file);
+	void noteDiskFile(int size);
+	bool diskFileUnchanged(FILE *fp) const;
 
 	void DetectLevels();
 	void ProcessNamespaces();
+	void EnsureIndex() const;
+	void BuildIndex() const;
 
 	void FixLevelGroup(int index, int num_added, int num_removed);
 
 	void writeToPath(const fs::path &path) const noexcept(false);
+	bool writeChanges(int &bytes_written) noexcept(false);
 
 	// deliberately don't implement these
 	Wad_file(const Wad_file& other);
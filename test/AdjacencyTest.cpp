@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Adjacency.h"
+
+#include "Document.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Vertex.h"
+#include "testUtils/RoomGrid.hpp"
+
+#include "gtest/gtest.h"
+
+class AdjacencyFixture : public ::testing::Test
+{
+protected:
+	AdjacencyFixture()
+	{
+		// keep the object panel (which needs a window) out of the edits
+		inst.edit.mode = ObjType::things;
+	}
+
+	~AdjacencyFixture()
+	{
+		inst.level.clear();
+	}
+
+	void makeRooms(int columns, int rows);
+	void checkAll() const;
+
+	Instance inst;
+};
+
+//
+// Builds a grid of 64x64 rooms sharing their walls
+//
+void AdjacencyFixture::makeRooms(int columns, int rows)
+{
+	RoomGrid(columns, rows).build(inst.level);
+}
+
+//
+// Compare every lookup against a scan of the whole level
+//
+void AdjacencyFixture::checkAll() const
+{
+	const Document &doc = inst.level;
+	std::vector<int> list;
+
+	for(int v = 0; v < doc.numVertices(); ++v)
+	{
+		std::vector<int> expected;
+		for(int n = 0; n < doc.numLinedefs(); ++n)
+			if(doc.linedefs[n]->TouchesVertex(v))
+				expected.push_back(n);
+
+		doc.adjacency.linesAtVertex(v, list);
+		ASSERT_EQ(list, expected) << "vertex " << v;
+		ASSERT_EQ(doc.adjacency.countLinesAtVertex(v), (int)expected.size());
+
+		const auto V = doc.vertices[v];
+		int first = -1;
+		for(int k = 0; k < doc.numVertices() && first < 0; ++k)
+			if(doc.vertices[k]->Matches(V->raw_x, V->raw_y))
+				first = k;
+		ASSERT_EQ(doc.adjacency.vertexAt(V->raw_x, V->raw_y), first);
+	}
+
+	for(int sd = 0; sd < doc.numSidedefs(); ++sd)
+	{
+		std::vector<int> expected;
+		for(int n = 0; n < doc.numLinedefs(); ++n)
+			if(doc.linedefs[n]->right == sd || doc.linedefs[n]->left == sd)
+				expected.push_back(n);
+
+		doc.adjacency.linesOfSidedef(sd, list);
+		ASSERT_EQ(list, expected) << "sidedef " << sd;
+	}
+
+	for(int sec = 0; sec < doc.numSectors(); ++sec)
+	{
+		std::vector<int> expected;
+		for(int n = 0; n < doc.numSidedefs(); ++n)
+			if(doc.sidedefs[n]->sector == sec)
+				expected.push_back(n);
+
+		doc.adjacency.sidedefsOfSector(sec, list);
+		ASSERT_EQ(list, expected) << "sector " << sec;
+	}
+
+	ASSERT_EQ(doc.adjacency.vertexAt(FFixedPoint(-12345), FFixedPoint(17)), -1);
+}
+
+TEST_F(AdjacencyFixture, MatchesBruteForce)
+{
+	makeRooms(5, 4);
+
+	checkAll();
+
+	// corner vertex has two lines, inner ones four
+	ASSERT_EQ(inst.level.vertmod.howManyLinedefs(0), 2);
+	ASSERT_EQ(inst.level.vertmod.howManyLinedefs(7), 4);
+	ASSERT_EQ(inst.level.vertmod.findExact(FFixedPoint(64), FFixedPoint(64)), 7);
+}
+
+TEST_F(AdjacencyFixture, FollowsEditsAndUndo)
+{
+	makeRooms(4, 4);
+
+	Document &doc = inst.level;
+
+	checkAll();
+
+	// reconnect a line and move a sidedef to another sector
+	{
+		EditOperation op(doc.basis);
+		op.changeLinedef(3, LineDef::F_START, 20);
+		op.changeSidedef(2, SideDef::F_SECTOR, 9);
+		op.changeVertex(6, Vertex::F_X, FFixedPoint(0));
+		op.changeVertex(6, Vertex::F_Y, FFixedPoint(0));
+	}
+	checkAll();
+
+	// append objects, with their fields set after insertion
+	{
+		EditOperation op(doc.basis);
+
+		int v = op.addNew(ObjType::vertices);
+		doc.vertices[v]->SetRawXY(MapFormat::doom, { 1000, 1000 });
+
+		int sd = op.addNew(ObjType::sidedefs);
+		doc.sidedefs[sd]->sector = 3;
+
+		int ld = op.addNew(ObjType::linedefs);
+		doc.linedefs[ld]->start = v;
+		doc.linedefs[ld]->end = 0;
+		doc.linedefs[ld]->right = sd;
+
+		// visible before the group ends
+		checkAll();
+
+		op.changeLinedef(ld, LineDef::F_END, 1);
+		checkAll();
+	}
+	checkAll();
+
+	// delete from the middle, which renumbers the references
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::vertices, 12);
+		op.del(ObjType::sectors, 5);
+	}
+	checkAll();
+
+	// delete the last objects
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::linedefs, doc.numLinedefs() - 1);
+		op.del(ObjType::sidedefs, doc.numSidedefs() - 1);
+		op.del(ObjType::vertices, doc.numVertices() - 1);
+	}
+	checkAll();
+
+	while(doc.basis.undo())
+		checkAll();
+
+	while(doc.basis.redo())
+		checkAll();
+}
+
+TEST_F(AdjacencyFixture, MergeVertices)
+{
+	makeRooms(3, 3);
+
+	Document &doc = inst.level;
+
+	// merge the middle vertex of the bottom row onto its neighbour
+	{
+		EditOperation op(doc.basis);
+
+		selection_c list(ObjType::vertices);
+		list.set(1);
+		list.set(2);
+
+		doc.vertmod.mergeList(op, list, nullptr);
+	}
+	checkAll();
+
+	while(doc.basis.undo())
+		checkAll();
+}
@@ -17,13 +17,22 @@
 //------------------------------------------------------------------------
 
 #include "Document.h"
+#include "e_main.h"
 #include "Instance.h"
 #include "lib_adler.h"
 #include "LineDef.h"
+#include "m_loadsave.h"
+#include "Sector.h"
 #include "Thing.h"
 #include "Vertex.h"
+#include "w_rawdef.h"
+#include "w_wad.h"
+#include "testUtils/RoomGrid.hpp"
+#include "testUtils/TempDirContext.hpp"
 #include "gtest/gtest.h"
 
+#include <chrono>
+
 class DocumentFixture : public ::testing::Test
 {
 protected:
@@ -45,17 +54,17 @@ TEST_F(DocumentFixture, CheckObjects)
 	ASSERT_FALSE(doc.numLinedefs());
 
 	// Add some objects
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
+	doc.things.push_back(Thing());
+	doc.things.push_back(Thing());
+	doc.things.push_back(Thing());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
 	// no sectors
-	doc.sidedefs.push_back(std::make_shared<SideDef>());
-	doc.sidedefs.push_back(std::make_shared<SideDef>());
-	doc.linedefs.push_back(std::make_shared<LineDef>());
+	doc.sidedefs.push_back(SideDef());
+	doc.sidedefs.push_back(SideDef());
+	doc.linedefs.push_back(LineDef());
 
 	ASSERT_EQ(doc.numThings(), 3);
 	ASSERT_EQ(doc.numVertices(), 4);
@@ -97,17 +106,17 @@ TEST_F(DocumentFixture, CheckObjects)
 TEST_F(DocumentFixture, CRC)
 {
 	// Add some objects
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.things.push_back(std::make_shared<Thing>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
-	doc.vertices.push_back(std::make_shared<Vertex>());
+	doc.things.push_back(Thing());
+	doc.things.push_back(Thing());
+	doc.things.push_back(Thing());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
+	doc.vertices.push_back(Vertex());
 	// no sectors
-	doc.sidedefs.push_back(std::make_shared<SideDef>());
-	doc.sidedefs.push_back(std::make_shared<SideDef>());
-	doc.linedefs.push_back(std::make_shared<LineDef>());
+	doc.sidedefs.push_back(SideDef());
+	doc.sidedefs.push_back(SideDef());
+	doc.linedefs.push_back(LineDef());
 
 	crc32_c crc;
 	doc.getLevelChecksum(crc);
@@ -122,10 +131,117 @@ TEST_F(DocumentFixture, CRC)
 	ASSERT_NE(crc.extra, crc2.extra);
 
 	// Now add back one thing
-	doc.things.push_back(std::make_shared<Thing>());
+	doc.things.push_back(Thing());
 
 	crc32_c crc3;
 	doc.getLevelChecksum(crc3);
 	ASSERT_EQ(crc.raw, crc3.raw);
 	ASSERT_EQ(crc.extra, crc3.extra);
 }
+
+//
+// Not a real test: reports how long a whole-map pass over the linedefs and
+// their vertices takes on a large map, with the objects in the level's own
+// arrays and with each one allocated on its own behind a shared_ptr (as the
+// level used to keep them)
+//
+TEST_F(DocumentFixture, DISABLED_BenchmarkIteration)
+{
+	RoomGrid(150, 150).build(doc);
+
+	std::vector<std::shared_ptr<Vertex>> heapVertices;
+	std::vector<std::shared_ptr<LineDef>> heapLines;
+	for(const Vertex *vertex : doc.vertices)
+		heapVertices.push_back(std::make_shared<Vertex>(*vertex));
+	for(const LineDef *line : doc.linedefs)
+		heapLines.push_back(std::make_shared<LineDef>(*line));
+
+	static const int passes = 50;
+
+	auto start = std::chrono::steady_clock::now();
+
+	double heap_sum = 0;
+	for(int i = 0; i < passes; ++i)
+		for(const std::shared_ptr<LineDef> &L : heapLines)
+		{
+			const Vertex *v1 = heapVertices[L->start].get();
+			const Vertex *v2 = heapVertices[L->end].get();
+			heap_sum += v2->x() - v1->x() + v2->y() - v1->y();
+		}
+
+	auto heap_done = std::chrono::steady_clock::now();
+
+	double array_sum = 0;
+	for(int i = 0; i < passes; ++i)
+		for(const LineDef *L : doc.linedefs)
+		{
+			const Vertex *v1 = doc.vertices[L->start];
+			const Vertex *v2 = doc.vertices[L->end];
+			array_sum += v2->x() - v1->x() + v2->y() - v1->y();
+		}
+
+	auto done = std::chrono::steady_clock::now();
+
+	printf("%d linedefs: %d passes took %.2f ms with shared_ptr objects, %.2f ms with the arrays\n",
+		   doc.numLinedefs(), passes,
+		   std::chrono::duration<double, std::milli>(heap_done - start).count(),
+		   std::chrono::duration<double, std::milli>(done - heap_done).count());
+
+	ASSERT_EQ(heap_sum, array_sum);
+}
+
+class DocumentLoadFixture : public TempDirContext
+{
+protected:
+	~DocumentLoadFixture()
+	{
+		inst.level.clear();
+	}
+
+	Instance inst;
+};
+
+//
+// Not a real test: reports how long loading lots of sidedefs takes, which
+// is mostly interning their texture names
+//
+TEST_F(DocumentLoadFixture, DISABLED_BenchmarkLoadSideDefs)
+{
+	static const int count = 50000;
+
+	auto wad = Wad_file::Open(getChildPath("sides.wad"), WadOpenMode::write);
+	int lev_num;
+	wad->AddLevel("MAP01", &lev_num);
+	Lump_c &lump = wad->AddLump("SIDEDEFS");
+
+	// several thousand unique names, like a map using a big texture pack
+	for(int i = 0; i < count; ++i)
+	{
+		raw_sidedef_t raw = {};
+		snprintf(raw.upper_tex, sizeof(raw.upper_tex), "U%d", i % 7919);
+		snprintf(raw.lower_tex, sizeof(raw.lower_tex), "L%d", i % 4001);
+		memcpy(raw.mid_tex, i % 3 ? "-" : "STARTAN3", i % 3 ? 1 : 8);
+		raw.sector = 0;
+		lump.Write(&raw, sizeof(raw));
+	}
+
+	Document &doc = inst.level;
+	doc.sectors.push_back(Sector());
+
+	BadCount bad = {};
+
+	auto start = std::chrono::steady_clock::now();
+	doc.LoadSideDefs(lev_num, wad.get(), inst.conf, bad);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start);
+
+	printf("LoadSideDefs: %d sidedefs took %d ms\n", count, (int)elapsed.count());
+
+	ASSERT_EQ(doc.numSidedefs(), count);
+	ASSERT_FALSE(bad.exists());
+	ASSERT_EQ(doc.sidedefs[12345]->UpperTex(), "U4426");
+	ASSERT_EQ(doc.sidedefs[12345]->LowerTex(), "L342");
+	ASSERT_EQ(doc.sidedefs[12345]->MidTex(), "STARTAN3");
+	ASSERT_EQ(doc.sidedefs[1]->MidTex(), "-");
+	ASSERT_EQ(doc.sidedefs[0]->upper_tex, doc.sidedefs[7919]->upper_tex);
+}
@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "ImageCache.h"
+#include "WadData.h"
+#include "m_game.h"
+#include "w_wad.h"
+#include "testUtils/TempDirContext.hpp"
+
+#include <chrono>
+#include <fstream>
+
+class ImageCacheFixture : public TempDirContext
+{
+protected:
+	void TearDown() override
+	{
+		fs::remove_all(getChildPath("images"));
+		TempDirContext::TearDown();
+	}
+
+	static crc32_c makeKey(int value)
+	{
+		crc32_c key;
+		key += (s32_t)value;
+		return key;
+	}
+
+	// the path of the one file in the cache
+	static fs::path onlyFile(const ImageCache &cache)
+	{
+		fs::path result;
+		for(const fs::directory_entry &entry : fs::directory_iterator(cache.directory()))
+		{
+			EXPECT_TRUE(result.empty());
+			result = entry.path();
+		}
+		return result;
+	}
+
+	static Img_c makeImage(int width, int height, int seed)
+	{
+		Img_c img(width, height);
+		for(int i = 0; i < width * height; ++i)
+			img.wbuf()[i] = static_cast<img_pixel_t>(seed + i);
+		return img;
+	}
+};
+
+TEST_F(ImageCacheFixture, ImageSurvivesToNextRun)
+{
+	Img_c img = makeImage(20, 30, 7);
+	img.setSpriteOffset(-3, 44);
+
+	{
+		ImageCache cache(getChildPath("images"));
+		cache.store(makeKey(1), img);
+	}
+
+	// a new cache over the same directory is like the next start
+	ImageCache cache(getChildPath("images"));
+	ASSERT_EQ(cache.diskBytes(), fs::file_size(onlyFile(cache)));
+
+	Img_c loaded;
+	ASSERT_TRUE(cache.load(makeKey(1), loaded));
+	ASSERT_EQ(loaded.width(), 20);
+	ASSERT_EQ(loaded.height(), 30);
+	for(int i = 0; i < 20 * 30; ++i)
+		ASSERT_EQ(loaded.buf()[i], img.buf()[i]);
+	int x, y;
+	loaded.getSpriteOffset(x, y);
+	ASSERT_EQ(x, -3);
+	ASSERT_EQ(y, 44);
+
+	ASSERT_FALSE(cache.load(makeKey(2), loaded));
+	ASSERT_EQ(cache.hits(), 1);
+	ASSERT_EQ(cache.misses(), 1);
+}
+
+TEST_F(ImageCacheFixture, DamagedFileIsNotUsed)
+{
+	ImageCache cache(getChildPath("images"));
+	cache.store(makeKey(1), makeImage(8, 8, 0));
+
+	fs::path path = onlyFile(cache);
+	fs::resize_file(path, fs::file_size(path) - 1);
+
+	Img_c loaded;
+	ASSERT_FALSE(cache.load(makeKey(1), loaded));
+
+	// a file under the wrong name is no good either
+	fs::remove(path);
+	cache.store(makeKey(2), makeImage(8, 8, 0));
+	fs::rename(onlyFile(cache), path);
+	ASSERT_FALSE(cache.load(makeKey(1), loaded));
+}
+
+TEST_F(ImageCacheFixture, OldestImagesGoWhenOverBudget)
+{
+	// each file is a bit over 1000 bytes
+	size_t file_size = 40 + 20 * 25 * sizeof(img_pixel_t);
+	ImageCache cache(getChildPath("images"), 3 * file_size - 100);
+
+	cache.store(makeKey(1), makeImage(20, 25, 1));
+	cache.store(makeKey(2), makeImage(20, 25, 2));
+	ASSERT_EQ(cache.diskBytes(), 2 * file_size);
+
+	auto now = fs::file_time_type::clock::now();
+	for(const fs::directory_entry &entry : fs::directory_iterator(cache.directory()))
+		fs::last_write_time(entry.path(), now - std::chrono::hours(1));
+
+	// using the first one keeps it around
+	Img_c loaded;
+	ASSERT_TRUE(cache.load(makeKey(1), loaded));
+
+	cache.store(makeKey(3), makeImage(20, 25, 3));
+	ASSERT_EQ(cache.diskBytes(), 2 * file_size);
+	ASSERT_TRUE(cache.load(makeKey(1), loaded));
+	ASSERT_FALSE(cache.load(makeKey(2), loaded));
+	ASSERT_TRUE(cache.load(makeKey(3), loaded));
+}
+
+//
+// Makes an uncompressed 32-bit TGA image of a colour gradient
+//
+static std::vector<uint8_t> makeTGA(int width, int height, int seed)
+{
+	std::vector<uint8_t> data(18, 0);
+	data[2] = 2;
+	data[12] = static_cast<uint8_t>(width);
+	data[13] = static_cast<uint8_t>(width >> 8);
+	data[14] = static_cast<uint8_t>(height);
+	data[15] = static_cast<uint8_t>(height >> 8);
+	data[16] = 32;
+	data[17] = 0x28;
+	for(int y = 0; y < height; ++y)
+		for(int x = 0; x < width; ++x)
+		{
+			data.push_back(static_cast<uint8_t>(x + seed));
+			data.push_back(static_cast<uint8_t>(y));
+			data.push_back(static_cast<uint8_t>(x ^ y));
+			data.push_back(255);
+		}
+	return data;
+}
+
+//
+// Makes a wad with a palette and some TGA textures between TX_START and
+// TX_END
+//
+static std::shared_ptr<Wad_file> makeTextureWad(int count, int size)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+
+	std::vector<uint8_t> data(768);
+	for(int i = 0; i < 768; ++i)
+		data[i] = static_cast<uint8_t>(i / 3);
+	wad->AddLump("PLAYPAL").Write(data.data(), (int)data.size());
+	data.assign(8192, 0);
+	wad->AddLump("COLORMAP").Write(data.data(), (int)data.size());
+
+	wad->AddLump("TX_START");
+	for(int i = 0; i < count; ++i)
+	{
+		data = makeTGA(size, size, i);
+		wad->AddLump(SString::printf("TGA%d", i)).Write(data.data(), (int)data.size());
+	}
+	wad->AddLump("TX_END");
+	return wad;
+}
+
+TEST_F(ImageCacheFixture, TexturesComeFromCacheOnWarmStart)
+{
+	ConfigData config;
+	config.features.tx_start = 1;
+	std::shared_ptr<Wad_file> wad = makeTextureWad(4, 16);
+	auto cache = std::make_shared<ImageCache>(getChildPath("images"));
+
+	WadData cold;
+	cold.images.setImageCache(cache);
+	cold.reloadResources(wad, config, {});
+	ASSERT_EQ(cache->misses(), 4);
+	ASSERT_EQ(cache->hits(), 0);
+
+	WadData warm;
+	warm.images.setImageCache(cache);
+	warm.reloadResources(wad, config, {});
+	ASSERT_EQ(cache->misses(), 4);
+	ASSERT_EQ(cache->hits(), 4);
+
+	for(int i = 0; i < 4; ++i)
+	{
+		SString name = SString::printf("TGA%d", i);
+		const Img_c *made = cold.images.getTexture(config, name);
+		const Img_c *loaded = warm.images.getTexture(config, name);
+		ASSERT_TRUE(made);
+		ASSERT_TRUE(loaded);
+		ASSERT_EQ(loaded->width(), 16);
+		for(int p = 0; p < 16 * 16; ++p)
+			ASSERT_EQ(loaded->buf()[p], made->buf()[p]);
+	}
+
+	// a changed lump is decoded again
+	std::vector<uint8_t> data = makeTGA(16, 16, 99);
+	Lump_c *lump = wad->FindLump("TGA2");
+	ASSERT_TRUE(lump);
+	lump->clearData();
+	lump->Write(data.data(), (int)data.size());
+
+	WadData changed;
+	changed.images.setImageCache(cache);
+	changed.reloadResources(wad, config, {});
+	ASSERT_EQ(cache->misses(), 5);
+	ASSERT_EQ(cache->hits(), 7);
+}
+
+//
+// Not a real test: reports how long loading resources takes without the
+// cache, with an empty cache and with a full one
+//
+TEST_F(ImageCacheFixture, DISABLED_BenchmarkColdAndWarmStart)
+{
+	ConfigData config;
+	config.features.tx_start = 1;
+	std::shared_ptr<Wad_file> wad = makeTextureWad(200, 128);
+
+	auto timeLoad = [&](const std::shared_ptr<ImageCache> &cache)
+	{
+		auto start = std::chrono::steady_clock::now();
+		WadData wadData;
+		wadData.images.setImageCache(cache);
+		wadData.reloadResources(wad, config, {});
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	double none = timeLoad(nullptr);
+	auto cache = std::make_shared<ImageCache>(getChildPath("images"));
+	double cold = timeLoad(cache);
+	double warm = timeLoad(std::make_shared<ImageCache>(getChildPath("images")));
+
+	printf("200 TGA textures: no cache %.1f ms, cold cache %.1f ms, warm cache %.1f ms\n", none, cold, warm);
+}
@@ -0,0 +1,391 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "SpatialIndex.h"
+
+#include "Document.h"
+#include "e_hover.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "testUtils/RoomGrid.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+
+class SpatialIndexFixture : public ::testing::Test
+{
+protected:
+	SpatialIndexFixture()
+	{
+		// keep the object panel (which needs a window) out of the edits
+		inst.edit.mode = ObjType::sectors;
+	}
+
+	~SpatialIndexFixture()
+	{
+		inst.level.clear();
+	}
+
+	void makeRooms(int columns, int rows);
+	void addThing(double x, double y);
+
+	void checkVertices(const v2double_t &lo, const v2double_t &hi) const;
+	void checkLinedefs(const v2double_t &lo, const v2double_t &hi) const;
+	void checkThings(const v2double_t &lo, const v2double_t &hi) const;
+	void checkEverywhere() const;
+
+	Instance inst;
+};
+
+//
+// Builds a grid of square 64x64 rooms, each a separate sector, with
+// one-sided walls. Spacing rooms 128 units apart leaves void in-between.
+//
+void SpatialIndexFixture::makeRooms(int columns, int rows)
+{
+	// a room in every other cell
+	std::vector<std::string> picture(2 * rows - 1, std::string(2 * columns - 1, '.'));
+	for(int row = 0; row < 2 * rows - 1; row += 2)
+		for(int col = 0; col < 2 * columns - 1; col += 2)
+			picture[row][col] = '#';
+
+	RoomGrid(picture).build(inst.level);
+}
+
+void SpatialIndexFixture::addThing(double x, double y)
+{
+	Thing thing;
+	thing.SetRawXY(MapFormat::doom, { x, y });
+	inst.level.things.push_back(std::move(thing));
+}
+
+//
+// The index may return extra candidates, but never miss one
+//
+void SpatialIndexFixture::checkVertices(const v2double_t &lo, const v2double_t &hi) const
+{
+	const Document &doc = inst.level;
+
+	std::vector<int> list;
+	doc.spatial.findVertices(lo, hi, list);
+
+	ASSERT_TRUE(std::is_sorted(list.begin(), list.end()));
+
+	for(int n = 0; n < doc.numVertices(); ++n)
+	{
+		if(doc.vertices[n]->xy().inbounds(lo, hi))
+		{
+			ASSERT_TRUE(std::binary_search(list.begin(), list.end(), n)) << "vertex " << n;
+		}
+	}
+}
+
+void SpatialIndexFixture::checkLinedefs(const v2double_t &lo, const v2double_t &hi) const
+{
+	const Document &doc = inst.level;
+
+	std::vector<int> list;
+	doc.spatial.findLinedefs(lo, hi, list);
+
+	ASSERT_TRUE(std::is_sorted(list.begin(), list.end()));
+
+	for(int n = 0; n < doc.numLinedefs(); ++n)
+	{
+		v2double_t pos1 = doc.getStart(*doc.linedefs[n]).xy();
+		v2double_t pos2 = doc.getEnd(*doc.linedefs[n]).xy();
+
+		if(std::max(pos1.x, pos2.x) < lo.x || std::min(pos1.x, pos2.x) > hi.x ||
+		   std::max(pos1.y, pos2.y) < lo.y || std::min(pos1.y, pos2.y) > hi.y)
+			continue;
+
+		ASSERT_TRUE(std::binary_search(list.begin(), list.end(), n)) << "linedef " << n;
+	}
+}
+
+void SpatialIndexFixture::checkThings(const v2double_t &lo, const v2double_t &hi) const
+{
+	const Document &doc = inst.level;
+
+	std::vector<int> list;
+	doc.spatial.findThings(lo, hi, list);
+
+	ASSERT_TRUE(std::is_sorted(list.begin(), list.end()));
+
+	for(int n = 0; n < doc.numThings(); ++n)
+	{
+		if(doc.things[n]->xy().inbounds(lo, hi))
+		{
+			ASSERT_TRUE(std::binary_search(list.begin(), list.end(), n)) << "thing " << n;
+		}
+	}
+}
+
+void SpatialIndexFixture::checkEverywhere() const
+{
+	for(double y = -200; y < 1200; y += 97)
+		for(double x = -200; x < 1200; x += 89)
+		{
+			v2double_t lo = { x, y };
+			v2double_t hi = { x + 40, y + 150 };
+
+			checkVertices(lo, hi);
+			checkLinedefs(lo, hi);
+			checkThings(lo, hi);
+		}
+}
+
+TEST_F(SpatialIndexFixture, QueriesMatchBruteForce)
+{
+	makeRooms(8, 8);
+	addThing(32, 32);
+	addThing(1000, -1000);
+	addThing(-5000, 200);
+
+	checkEverywhere();
+
+	// Huge boxes visit the occupied cells instead
+	checkVertices({ -1e9, -1e9 }, { 1e9, 1e9 });
+	checkLinedefs({ -1e9, -1e9 }, { 1e9, 1e9 });
+	checkThings({ -1e9, -1e9 }, { 1e9, 1e9 });
+
+	// A line longer than the cell limit goes to the "big" list
+	Document &doc = inst.level;
+	Vertex far1;
+	far1.SetRawXY(MapFormat::doom, { -30000, -30000 });
+	Vertex far2;
+	far2.SetRawXY(MapFormat::doom, { 30000, 30000 });
+	doc.vertices.push_back(std::move(far1));
+	doc.vertices.push_back(std::move(far2));
+	LineDef line;
+	line.start = doc.numVertices() - 2;
+	line.end = doc.numVertices() - 1;
+	doc.linedefs.push_back(std::move(line));
+
+	checkLinedefs({ 10, 10 }, { 12, 12 });
+	doc.spatial.invalidate();
+	checkLinedefs({ 10, 10 }, { 12, 12 });
+	checkEverywhere();
+}
+
+TEST_F(SpatialIndexFixture, FollowsEditsAndUndo)
+{
+	makeRooms(6, 6);
+	addThing(32, 32);
+
+	Document &doc = inst.level;
+
+	checkEverywhere();
+
+	// Move a vertex: both the vertex and its lines must be found at the new place
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(0, Vertex::F_X, FFixedPoint(500));
+		op.changeVertex(0, Vertex::F_Y, FFixedPoint(900));
+	}
+	checkVertices({ 490, 890 }, { 510, 910 });
+	checkLinedefs({ 490, 890 }, { 510, 910 });
+	checkEverywhere();
+
+	// Move a thing
+	{
+		EditOperation op(doc.basis);
+		op.changeThing(0, Thing::F_X, FFixedPoint(700));
+	}
+	checkThings({ 690, 20 }, { 710, 40 });
+
+	// Add a vertex and a line (fields set after insertion)
+	{
+		EditOperation op(doc.basis);
+
+		int v = op.addNew(ObjType::vertices);
+		doc.vertices[v]->SetRawXY(MapFormat::doom, { 1100, 1100 });
+
+		int l = op.addNew(ObjType::linedefs);
+		doc.linedefs[l]->start = v;
+		doc.linedefs[l]->end = 1;
+
+		// queries inside the group must still see the new objects
+		checkVertices({ 1090, 1090 }, { 1110, 1110 });
+		checkLinedefs({ 1090, 1090 }, { 1110, 1110 });
+	}
+	checkVertices({ 1090, 1090 }, { 1110, 1110 });
+	checkLinedefs({ 1090, 1090 }, { 1110, 1110 });
+	checkEverywhere();
+
+	// Delete from the middle, which renumbers everything after
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::linedefs, 5);
+		op.del(ObjType::things, 0);
+	}
+	checkEverywhere();
+
+	// Undo everything
+	while(doc.basis.undo())
+		checkEverywhere();
+
+	checkThings({ 20, 20 }, { 40, 40 });
+	checkVertices({ -10, -10 }, { 10, 10 });
+
+	// And redo it all again
+	while(doc.basis.redo())
+		checkEverywhere();
+}
+
+TEST_F(SpatialIndexFixture, HoverMatchesReference)
+{
+	makeRooms(10, 10);
+
+	const Document &doc = inst.level;
+
+	for(double y = -100; y < 1300; y += 13.7)
+		for(double x = -100; x < 1300; x += 17.3)
+		{
+			v2double_t pos = { x, y };
+
+			// reference: the sector is whatever room contains the point
+			int col = (int)floor(x / 128);
+			int row = (int)floor(y / 128);
+
+			bool inside = col >= 0 && col < 10 && row >= 0 && row < 10 &&
+						  x - col * 128 > 0.5 && x - col * 128 < 63.5 &&
+						  y - row * 128 > 0.5 && y - row * 128 < 63.5;
+
+			if(inside)
+			{
+				ASSERT_EQ(hover::getNearestSector(doc, pos), Objid(ObjType::sectors, row * 10 + col));
+				ASSERT_FALSE(hover::isPointOutsideOfMap(doc, pos));
+			}
+
+			bool outside = x < -1 || y < -1 || x > 1217 || y > 1217 ||
+						   (x - floor(x / 128) * 128 > 65 && y - floor(y / 128) * 128 > 65);
+			if(outside)
+			{
+				ASSERT_TRUE(hover::isPointOutsideOfMap(doc, pos));
+			}
+		}
+
+	// closest vertex and line near a room corner
+	Grid_State_c grid(inst);
+	grid.Scale = 1.0;
+
+	Objid vert = hover::getNearbyObject(ObjType::vertices, doc, inst.conf, grid, { 129, 1 });
+	ASSERT_EQ(vert, Objid(ObjType::vertices, 2));
+
+	// the west wall of the second room
+	Objid line = hover::getNearbyObject(ObjType::linedefs, doc, inst.conf, grid, { 130, 30 });
+	ASSERT_TRUE(line.valid());
+	const LineDef *L = doc.linedefs[line.num];
+	ASSERT_EQ(std::min(L->start, L->end), 2);
+	ASSERT_EQ(std::max(L->start, L->end), 2 + 20);
+}
+
+//
+// The sector lookup as it was before the index: a horizontal and a
+// vertical ray over every linedef, taking the nearest crossing
+//
+static Objid linearNearestSector(const Document &doc, v2double_t pos)
+{
+	// off the vertices, like the hover code
+	pos.x += 0.04;
+	pos.y += 0.04;
+
+	int best = -1;
+	double best_dist = 9e9;
+	bool best_right = false;
+
+	for(int n = 0; n < doc.numLinedefs(); ++n)
+	{
+		v2double_t p1 = doc.getStart(*doc.linedefs[n]).xy();
+		v2double_t p2 = doc.getEnd(*doc.linedefs[n]).xy();
+
+		if(p1.y != p2.y && std::min(p1.y, p2.y) < pos.y && std::max(p1.y, p2.y) > pos.y)
+		{
+			double dist = p1.x - pos.x + (p2.x - p1.x) * (pos.y - p1.y) / (p2.y - p1.y);
+			if(fabs(dist) < best_dist)
+			{
+				best = n;
+				best_dist = fabs(dist);
+				best_right = (p1.y > p2.y) == (dist > 0);
+			}
+		}
+
+		if(p1.x != p2.x && std::min(p1.x, p2.x) < pos.x && std::max(p1.x, p2.x) > pos.x)
+		{
+			double dist = p1.y - pos.y + (p2.y - p1.y) * (pos.x - p1.x) / (p2.x - p1.x);
+			if(fabs(dist) < best_dist)
+			{
+				best = n;
+				best_dist = fabs(dist);
+				best_right = (p1.x > p2.x) == (dist < 0);
+			}
+		}
+	}
+
+	if(best < 0)
+		return Objid();
+
+	int sd = best_right ? doc.linedefs[best]->right : doc.linedefs[best]->left;
+	return sd >= 0 ? Objid(ObjType::sectors, doc.sidedefs[sd]->sector) : Objid();
+}
+
+//
+// Not a real test: reports how long picking takes on a large map, with
+// the index and with a scan of every linedef
+//
+TEST_F(SpatialIndexFixture, DISABLED_Benchmark)
+{
+	makeRooms(100, 100);
+
+	const Document &doc = inst.level;
+
+	// points inside the rooms, so that both ways give the same answer
+	std::vector<v2double_t> points;
+	for(int i = 0; i < 2000; ++i)
+	{
+		int col = i * 7919 % 100;
+		int row = i * 104729 % 100;
+		points.push_back({ col * 128.0 + i * 37 % 60 + 2.5, row * 128.0 + i * 53 % 60 + 2.5 });
+	}
+
+	auto timeQueries = [&](Objid (*query)(const Document &, const v2double_t &), std::vector<Objid> &found)
+	{
+		found.clear();
+		auto start = std::chrono::steady_clock::now();
+		for(const v2double_t &pos : points)
+			found.push_back(query(doc, pos));
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+			   (double)points.size();
+	};
+
+	std::vector<Objid> indexed, scanned;
+	double indexTime = timeQueries(hover::getNearestSector, indexed);
+	double scanTime = timeQueries([](const Document &doc, const v2double_t &pos)
+	{
+		return linearNearestSector(doc, pos);
+	}, scanned);
+
+	ASSERT_EQ(indexed, scanned);
+
+	printf("getNearestSector on %d linedefs: %.2f us per query with the index, %.2f us scanning every line\n",
+		   doc.numLinedefs(), indexTime, scanTime);
+}
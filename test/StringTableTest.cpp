@@ -75,3 +75,41 @@ TEST(StringTable, Test)
     ASSERT_EQ(table.get(index), "Jackson");
     ASSERT_EQ(table.get(index4), "jackson");
 }
+
+TEST(StringTable, StableReferences)
+{
+	StringTable table;
+	ASSERT_EQ(table.get(StringID()), "");
+	ASSERT_EQ(table.add(""), StringID());
+
+	StringID first = table.add("FIRST");
+	const SString &ref = table.get(first);
+	const char *chars = ref.c_str();
+
+	// adding lots more must not move the earlier strings
+	for(int i = 0; i < 10000; ++i)
+		table.add(SString::printf("T%d", i));
+
+	ASSERT_EQ(&table.get(first), &ref);
+	ASSERT_EQ(ref.c_str(), chars);
+	ASSERT_EQ(table.size(), 10002);
+	ASSERT_EQ(table.add("T5000"), table.find("T5000"));
+	ASSERT_EQ(table.get(table.find("T9999")), "T9999");
+
+	ASSERT_EQ(table.get(StringID(-1)), "???ERROR");
+	ASSERT_EQ(table.get(StringID(10002)), "???ERROR");
+}
+
+TEST(StringTable, Find)
+{
+	StringTable table;
+	StringID upper = table.add("STARTAN3");
+	StringID lower = table.add("startan3");
+	ASSERT_NE(upper, lower);
+
+	ASSERT_EQ(table.find("STARTAN3"), upper);
+	ASSERT_EQ(table.find("startan3"), lower);
+	ASSERT_EQ(table.find(""), StringID());
+	ASSERT_TRUE(table.find("StartAn3").isInvalid());
+	ASSERT_TRUE(table.find("STARTAN").isInvalid());
+}
@@ -17,6 +17,7 @@
 //------------------------------------------------------------------------
 
 #include "WadData.h"
+#include "m_game.h"
 #include "w_wad.h"
 #include "gtest/gtest.h"
 
@@ -106,3 +107,122 @@ TEST(MasterDir, FindFirstSpriteLump)
 	ASSERT_EQ(master.findFirstSpriteLump("POSS"), &wad2possa1);
 	ASSERT_EQ(master.findFirstSpriteLump("TROO"), &wad1troob1);
 }
+
+TEST(MasterDir, FindGlobalLumpInResources)
+{
+	MasterDir master;
+
+	auto game = Wad_file::Open("game.wad", WadOpenMode::write);
+	ASSERT_TRUE(game);
+	addValidLump(game, "LUMP1");	// 0
+	addValidLump(game, "LUMP2");
+	addValidLump(game, "LUMP3");
+	addValidLump(game, "LUMP1");	// 3
+
+	auto res1 = Wad_file::Open("res1.wad", WadOpenMode::write);
+	ASSERT_TRUE(res1);
+	addValidLump(res1, "LUMP2");	// 0
+	addValidLump(res1, "F_START");
+	addValidLump(res1, "LUMP3");
+	addValidLump(res1, "F_END");
+
+	auto res2 = Wad_file::Open("res2.wad", WadOpenMode::write);
+	ASSERT_TRUE(res2);
+	addValidLump(res2, "LUMP2");	// 0
+
+	master.setGameWad(game);
+	master.setResources({ res1, res2 });
+
+	// first one in a wad, last wad wins, flats don't count
+	ASSERT_EQ(master.findGlobalLump("LUMP1"), game->GetLump(0));
+	ASSERT_EQ(master.findGlobalLump("lump1"), game->GetLump(0));
+	ASSERT_EQ(master.findGlobalLump("LUMP2"), res2->GetLump(0));
+	ASSERT_EQ(master.findGlobalLump("LUMP3"), game->GetLump(2));
+	ASSERT_EQ(master.findGlobalLump("LUMP"), nullptr);
+	ASSERT_EQ(master.findGlobalLump("LUMP1LUMP1"), nullptr);
+
+	// the edit wad comes before all of them, and can change
+	auto edit = Wad_file::Open("edit.wad", WadOpenMode::write);
+	ASSERT_TRUE(edit);
+	master.ReplaceEditWad(edit);
+	ASSERT_EQ(master.findGlobalLump("LUMP3"), game->GetLump(2));
+	addValidLump(edit, "LUMP3");
+	ASSERT_EQ(master.findGlobalLump("LUMP3"), edit->GetLump(0));
+
+	master.RemoveEditWad();
+	master.setResources({});
+	ASSERT_EQ(master.findGlobalLump("LUMP2"), game->GetLump(1));
+
+	master.MasterDir_CloseAll();
+	ASSERT_EQ(master.findGlobalLump("LUMP1"), nullptr);
+}
+
+//
+// Adds an uncompressed 32-bit TGA image of one colour
+//
+static void addTGA(const std::shared_ptr<Wad_file> &wad, const char *name, int size, uint8_t shade)
+{
+	std::vector<uint8_t> data(18, 0);
+	data[2] = 2;
+	data[12] = static_cast<uint8_t>(size);
+	data[14] = static_cast<uint8_t>(size);
+	data[16] = 32;
+	data[17] = 0x28;
+	for(int i = 0; i < size * size; ++i)
+	{
+		data.push_back(shade);
+		data.push_back(shade);
+		data.push_back(shade);
+		data.push_back(255);
+	}
+	wad->AddLump(name).Write(data.data(), (int)data.size());
+}
+
+TEST(WadData, ReloadResourcesIsTheSameOnAnyThreadCount)
+{
+	ConfigData config;
+	config.features.tx_start = 1;
+
+	auto game = Wad_file::Open("game.wad", WadOpenMode::write);
+	ASSERT_TRUE(game);
+	std::vector<uint8_t> data(768);
+	for(int i = 0; i < 768; ++i)
+		data[i] = static_cast<uint8_t>(i / 3);
+	game->AddLump("PLAYPAL").Write(data.data(), (int)data.size());
+	data.assign(8192, 0);
+	game->AddLump("COLORMAP").Write(data.data(), (int)data.size());
+	game->AddLump("TX_START");
+	for(int i = 0; i < 20; ++i)
+		addTGA(game, SString::printf("GAME%d", i).c_str(), 8 + i, static_cast<uint8_t>(i * 10));
+	addTGA(game, "SHARED", 4, 1);
+	addValidLump(game, "BROKEN");
+	game->AddLump("TX_END");
+
+	// a resource wad replaces the texture of the same name
+	auto res = Wad_file::Open("res.wad", WadOpenMode::write);
+	ASSERT_TRUE(res);
+	res->AddLump("TX_START");
+	addTGA(res, "SHARED", 6, 200);
+	res->AddLump("TX_END");
+
+	WadData serial;
+	serial.reloadResources(game, config, { res }, 1);
+	WadData parallel;
+	parallel.reloadResources(game, config, { res }, 4);
+
+	const auto &textures = serial.images.getTextures();
+	ASSERT_EQ(textures.size(), 21);
+	ASSERT_EQ(parallel.images.getTextures().size(), textures.size());
+	for(const auto &entry : textures)
+	{
+		const Img_c *one = serial.images.getTexture(config, entry.first);
+		const Img_c *other = parallel.images.getTexture(config, entry.first);
+		ASSERT_TRUE(one);
+		ASSERT_TRUE(other);
+		ASSERT_EQ(one->width(), other->width());
+		ASSERT_EQ(one->height(), other->height());
+		for(int i = 0; i < one->width() * one->height(); ++i)
+			ASSERT_EQ(one->buf()[i], other->buf()[i]);
+	}
+	ASSERT_EQ(parallel.images.getTexture(config, "SHARED")->width(), 6);
+}
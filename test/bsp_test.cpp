@@ -0,0 +1,524 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "bsp.h"
+
+#include "Document.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "m_loadsave.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_wad.h"
+#include "testUtils/RoomGrid.hpp"
+#include "testUtils/TempDirContext.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+
+class BSPFixture : public TempDirContext
+{
+protected:
+	void addRooms(Wad_file &wad, const SString &name, const std::vector<std::string> &cells);
+	void addLevel(Wad_file &wad, const SString &name, int columns, int rows);
+	std::shared_ptr<Wad_file> makeWad(const fs::path &path);
+
+	Instance inst;
+};
+
+//
+// Adds a level of 128x128 rooms, one for each '#' in 'cells' (the first
+// string is the top row), sharing their walls.  The inner corners are
+// moved around a bit so that the lines are not all axis-aligned.  The
+// sectors are numbered row by row from the bottom, with a thing in each.
+//
+void BSPFixture::addRooms(Wad_file &wad, const SString &name, const std::vector<std::string> &cells)
+{
+	Document doc(inst);
+
+	RoomGrid grid(cells, 128);
+	grid.build(doc);
+
+	for(int row = 1; row < grid.rows; ++row)
+		for(int col = 1; col < grid.columns; ++col)
+		{
+			double x = col * 128.0 + (col * 7 + row * 13) % 5 * 8 - 16;
+			double y = row * 128.0 + (col * 11 + row * 3) % 5 * 8 - 16;
+			doc.vertices[grid.vertexAt(col, row)]->SetRawXY(MapFormat::doom, { x, y });
+		}
+
+	for(int row = 0; row < grid.rows; ++row)
+		for(int col = 0; col < grid.columns; ++col)
+		{
+			int sector = grid.sectorAt(col, row);
+			if(sector < 0)
+				continue;
+
+			doc.sectors[sector]->floorh = sector % 3 * 16;
+			doc.sectors[sector]->ceilh = 128;
+
+			Thing thing;
+			thing.SetRawXY(MapFormat::doom, { col * 128.0 + 64, row * 128.0 + 64 });
+			thing.type = doc.numThings() == 0 ? 1 : 2001;
+			doc.things.push_back(std::move(thing));
+		}
+
+	doc.SaveHeader(wad, name);
+	doc.SaveThings(wad);
+	doc.SaveLineDefs(wad);
+	doc.SaveSideDefs(wad);
+	doc.SaveVertices(wad);
+	doc.SaveSectors(wad);
+
+	doc.clear();
+}
+
+//
+// Adds a full grid of rooms
+//
+void BSPFixture::addLevel(Wad_file &wad, const SString &name, int columns, int rows)
+{
+	addRooms(wad, name, std::vector<std::string>(rows, std::string(columns, '#')));
+}
+
+std::shared_ptr<Wad_file> BSPFixture::makeWad(const fs::path &path)
+{
+	auto wad = Wad_file::Open(path, WadOpenMode::write);
+
+	for(int n = 0; n < 7; ++n)
+		addLevel(*wad, SString::printf("MAP%02d", n + 1), 3 + n % 4, 2 + n);
+
+	return wad;
+}
+
+//
+// The GL marker has the build time in it
+//
+static std::vector<byte> maskedData(const Lump_c &lump)
+{
+	std::vector<byte> data = lump.getData();
+
+	static const char key[] = "TIME=";
+	auto it = std::search(data.begin(), data.end(), key, key + 5);
+	for(it = it == data.end() ? it : it + 5; it != data.end() && *it != '\n'; ++it)
+		*it = '#';
+
+	return data;
+}
+
+static void checkSameLumps(const Wad_file &a, const Wad_file &b)
+{
+	ASSERT_EQ(a.NumLumps(), b.NumLumps());
+	ASSERT_EQ(a.LevelCount(), b.LevelCount());
+
+	for(int n = 0; n < a.NumLumps(); ++n)
+	{
+		ASSERT_EQ(a.GetLump(n)->Name(), b.GetLump(n)->Name()) << "lump " << n;
+		ASSERT_EQ(maskedData(*a.GetLump(n)), maskedData(*b.GetLump(n))) << a.GetLump(n)->Name().c_str();
+	}
+
+	for(int n = 0; n < a.LevelCount(); ++n)
+		ASSERT_EQ(a.LevelHeader(n), b.LevelHeader(n));
+}
+
+//
+// One level at a time, in place, like it used to be done
+//
+static void buildSequential(Instance &inst, Wad_file &wad, nodebuildinfo_t &info,
+							std::vector<SString> &messages, int num_threads = 1)
+{
+	for(int n = 0; n < wad.LevelCount(); ++n)
+	{
+		NewDocument newdoc = inst.openDocument(inst.loaded, wad, n);
+
+		ajbsp::LevelData lev_data(newdoc.loading.levelFormat, wad, newdoc.doc, inst.conf,
+								  [&messages](const SString &message)
+								  {
+									  messages.push_back(message);
+								  });
+		ASSERT_EQ(lev_data.BuildLevel(&info, n, num_threads), BUILD_OK);
+	}
+}
+
+TEST_F(BSPFixture, ParallelMatchesSequential)
+{
+	// with 16 threads, each level also gets two for its partitions
+	for(int threads : { 4, 16 })
+		for(bool fast : { false, true })
+		{
+			auto seqWad = makeWad(getChildPath("seq.wad"));
+			auto parWad = makeWad(getChildPath("par.wad"));
+
+			nodebuildinfo_t seqInfo;
+			seqInfo.fast = fast;
+			std::vector<SString> seqMessages;
+
+			buildSequential(inst, *seqWad, seqInfo, seqMessages);
+
+			nodebuildinfo_t parInfo;
+			parInfo.fast = fast;
+			parInfo.threads = threads;
+			std::vector<SString> parMessages;
+			int lastDone = 0;
+
+			build_result_e ret = AJBSP_BuildAllLevels(&parInfo, inst.conf, *parWad,
+				[this, &parWad](int lev_idx)
+				{
+					return inst.openDocument(inst.loaded, *parWad, lev_idx);
+				},
+				[&parMessages](const SString &message)
+				{
+					parMessages.push_back(message);
+				},
+				[&lastDone](int num_done)
+				{
+					ASSERT_GE(num_done, lastDone);
+					lastDone = num_done;
+				});
+
+			ASSERT_EQ(ret, BUILD_OK);
+			ASSERT_EQ(lastDone, parWad->LevelCount());
+
+			// the nodes really got built
+			ASSERT_GE(parWad->LevelLookupLump(0, "NODES"), 0);
+			ASSERT_GT(parWad->GetLump(parWad->LevelLookupLump(6, "SEGS"))->Length(), 0);
+
+			checkSameLumps(*seqWad, *parWad);
+
+			ASSERT_EQ(parMessages, seqMessages);
+			ASSERT_EQ(parInfo.total_warnings.load(), seqInfo.total_warnings.load());
+			ASSERT_EQ(parInfo.total_failed_maps.load(), seqInfo.total_failed_maps.load());
+		}
+}
+
+TEST_F(BSPFixture, ParallelPartitionsMatchSequential)
+{
+	auto seqWad = Wad_file::Open(getChildPath("seq.wad"), WadOpenMode::write);
+	auto parWad = Wad_file::Open(getChildPath("par.wad"), WadOpenMode::write);
+	addLevel(*seqWad, "MAP01", 12, 9);
+	addLevel(*parWad, "MAP01", 12, 9);
+
+	nodebuildinfo_t seqInfo;
+	std::vector<SString> seqMessages;
+	buildSequential(inst, *seqWad, seqInfo, seqMessages);
+
+	nodebuildinfo_t parInfo;
+	std::vector<SString> parMessages;
+	buildSequential(inst, *parWad, parInfo, parMessages, 4);
+
+	checkSameLumps(*seqWad, *parWad);
+	ASSERT_EQ(parMessages, seqMessages);
+}
+
+TEST_F(BSPFixture, CancelKeepsUnbuiltLevels)
+{
+	auto wad = makeWad(getChildPath("cancel.wad"));
+	auto original = makeWad(getChildPath("original.wad"));
+
+	nodebuildinfo_t info;
+	info.threads = 3;
+
+	build_result_e ret = AJBSP_BuildAllLevels(&info, inst.conf, *wad,
+		[this, &wad](int lev_idx)
+		{
+			return inst.openDocument(inst.loaded, *wad, lev_idx);
+		},
+		[](const SString &message)
+		{
+		},
+		[&info](int num_done)
+		{
+			// stop after the first level
+			if(num_done >= 1)
+				info.cancelled = true;
+		});
+
+	ASSERT_EQ(ret, BUILD_Cancelled);
+
+	// the first level got built, the last one was never started
+	ASSERT_GE(wad->LevelLookupLump(0, "NODES"), 0);
+	ASSERT_EQ(wad->LevelCount(), original->LevelCount());
+
+	int start = wad->LevelHeader(6);
+	int origStart = original->LevelHeader(6);
+	ASSERT_EQ(wad->NumLumps() - start, original->NumLumps() - origStart);
+
+	for(int n = 0; start + n < wad->NumLumps(); ++n)
+	{
+		ASSERT_EQ(wad->GetLump(start + n)->Name(), original->GetLump(origStart + n)->Name());
+		ASSERT_EQ(wad->GetLump(start + n)->getData(), original->GetLump(origStart + n)->getData());
+	}
+}
+
+TEST_F(BSPFixture, FailedLevelDoesNotStopTheOthers)
+{
+	auto wad = makeWad(getChildPath("failed.wad"));
+
+	nodebuildinfo_t info;
+	info.threads = 3;
+
+	std::vector<SString> messages;
+	build_result_e ret = AJBSP_BuildAllLevels(&info, inst.conf, *wad,
+		[this, &wad](int lev_idx)
+		{
+			// not a std::runtime_error
+			if(lev_idx == 2)
+				throw std::bad_alloc();
+			return inst.openDocument(inst.loaded, *wad, lev_idx);
+		},
+		[&messages](const SString &message)
+		{
+			messages.push_back(message);
+		},
+		[](int num_done)
+		{
+		});
+
+	ASSERT_EQ(ret, BUILD_OK);
+	ASSERT_EQ(std::count_if(messages.begin(), messages.end(), [](const SString &message)
+	{
+		return message.startsWith("Failed building nodes for level 2:");
+	}), 1);
+
+	// the failed level is untouched, the ones after it got built
+	ASSERT_LT(wad->LevelLookupLump(2, "NODES"), 0);
+	for(int n = 0; n < wad->LevelCount(); ++n)
+	{
+		if(n != 2)
+		{
+			ASSERT_GE(wad->LevelLookupLump(n, "NODES"), 0) << n;
+		}
+	}
+}
+
+static bool isRejected(const std::vector<byte> &reject, int numSectors, int view, int target)
+{
+	int p = view * numSectors + target;
+	return (reject[p >> 3] & (1 << (p & 7))) != 0;
+}
+
+static std::vector<byte> rejectOf(const Wad_file &wad)
+{
+	return wad.GetLump(wad.LevelLookupLump(0, "REJECT"))->getData();
+}
+
+TEST_F(BSPFixture, FullRejectHidesAroundCorners)
+{
+	auto wad = Wad_file::Open(getChildPath("reject.wad"), WadOpenMode::write);
+	addRooms(*wad, "MAP01", {
+		"#.#",
+		"#.#",
+		"###",
+	});
+
+	nodebuildinfo_t info;
+	info.full_reject = true;
+	std::vector<SString> messages;
+	buildSequential(inst, *wad, info, messages);
+
+	std::vector<byte> reject = rejectOf(*wad);
+	ASSERT_EQ(reject.size(), 7u);
+
+	// the top of one arm (sector 5) cannot see the other arm
+	for(int target : { 2, 4, 6 })
+	{
+		ASSERT_TRUE(isRejected(reject, 7, 5, target)) << target;
+		ASSERT_TRUE(isRejected(reject, 7, target, 5)) << target;
+	}
+
+	// but it sees down its own arm and into the bottom middle
+	for(int target : { 0, 1, 3, 5 })
+	{
+		ASSERT_FALSE(isRejected(reject, 7, 5, target)) << target;
+		ASSERT_FALSE(isRejected(reject, 7, target, 5)) << target;
+	}
+
+	// the timing goes into the log
+	ASSERT_EQ(messages.size(), 2u);
+	ASSERT_EQ(messages[1].find("Full reject for MAP01: 7 sectors in "), 0u);
+}
+
+//
+// Any two points in different sectors without a one-sided line between
+// them must not be rejected.  The points are the middle of each room and
+// points close to its corners and the middle of its walls.
+//
+TEST_F(BSPFixture, FullRejectKeepsLinesOfSight)
+{
+	const std::vector<std::string> cells = {
+		"#####.###",
+		"#...#.#.#",
+		"#.#.###.#",
+		"#.#.....#",
+		"#.#######",
+		"#........",
+		"####..#..",
+	};
+
+	std::vector<std::vector<byte>> rejects;
+
+	for(int threads : { 1, 4 })
+		for(bool full : { true, false })
+		{
+			auto wad = Wad_file::Open(getChildPath(SString::printf("maze%d%d.wad", threads, full).c_str()),
+									  WadOpenMode::write);
+			addRooms(*wad, "MAP01", cells);
+
+			nodebuildinfo_t info;
+			info.full_reject = full;
+			std::vector<SString> messages;
+			buildSequential(inst, *wad, info, messages, threads);
+
+			rejects.push_back(rejectOf(*wad));
+		}
+
+	// the same on any number of threads
+	ASSERT_EQ(rejects[2], rejects[0]);
+	ASSERT_EQ(rejects[3], rejects[1]);
+
+	const std::vector<byte> &full = rejects[0];
+	const std::vector<byte> &simple = rejects[1];
+
+	auto wad = Wad_file::Open(getChildPath("maze.wad"), WadOpenMode::write);
+	addRooms(*wad, "MAP01", cells);
+	NewDocument newdoc = inst.openDocument(inst.loaded, *wad, 0);
+	const Document &doc = newdoc.doc;
+
+	const int numSectors = doc.numSectors();
+
+	std::vector<std::vector<std::pair<double, double>>> points(numSectors);
+	for(int sec = 0; sec < numSectors; ++sec)
+	{
+		std::vector<std::pair<double, double>> corners;
+		for(const auto &line : doc.linedefs)
+		{
+			if(doc.getRight(*line)->sector != sec && (line->left < 0 || doc.getLeft(*line)->sector != sec))
+				continue;
+			for(const Vertex *vertex : { &doc.getStart(*line), &doc.getEnd(*line) })
+				if(std::find(corners.begin(), corners.end(), std::make_pair(vertex->x(), vertex->y())) == corners.end())
+					corners.emplace_back(vertex->x(), vertex->y());
+		}
+		ASSERT_EQ(corners.size(), 4u);
+
+		double mx = 0, my = 0;
+		for(const auto &corner : corners)
+		{
+			mx += corner.first / 4;
+			my += corner.second / 4;
+		}
+
+		points[sec].emplace_back(mx, my);
+		for(const auto &corner : corners)
+		{
+			points[sec].emplace_back(mx + (corner.first - mx) * 0.9, my + (corner.second - my) * 0.9);
+			for(const auto &other : corners)
+			{
+				double wx = (corner.first + other.first) / 2;
+				double wy = (corner.second + other.second) / 2;
+				points[sec].emplace_back(mx + (wx - mx) * 0.9, my + (wy - my) * 0.9);
+			}
+		}
+	}
+
+	auto side = [](double x1, double y1, double x2, double y2, double x, double y)
+	{
+		return (x - x1) * (y2 - y1) - (y - y1) * (x2 - x1);
+	};
+	auto canSee = [&doc, &side](const std::pair<double, double> &a, const std::pair<double, double> &b)
+	{
+		for(const auto &line : doc.linedefs)
+		{
+			if(line->left >= 0)
+				continue;
+			const Vertex &v1 = doc.getStart(*line);
+			const Vertex &v2 = doc.getEnd(*line);
+			if(side(v1.x(), v1.y(), v2.x(), v2.y(), a.first, a.second) *
+			   side(v1.x(), v1.y(), v2.x(), v2.y(), b.first, b.second) < 0 &&
+			   side(a.first, a.second, b.first, b.second, v1.x(), v1.y()) *
+			   side(a.first, a.second, b.first, b.second, v2.x(), v2.y()) < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	int numFullRejected = 0;
+	int numSimpleRejected = 0;
+
+	for(int view = 0; view < numSectors; ++view)
+		for(int target = 0; target < numSectors; ++target)
+		{
+			// the full reject also finds the isolated groups
+			if(isRejected(simple, numSectors, view, target))
+			{
+				ASSERT_TRUE(isRejected(full, numSectors, view, target));
+				++numSimpleRejected;
+			}
+
+			if(!isRejected(full, numSectors, view, target))
+				continue;
+
+			++numFullRejected;
+
+			for(const auto &a : points[view])
+				for(const auto &b : points[target])
+					ASSERT_FALSE(canSee(a, b)) << view << " sees " << target;
+		}
+
+	// the lone room, from both sides
+	ASSERT_EQ(numSimpleRejected, 2 * (numSectors - 1));
+	ASSERT_GT(numFullRejected, numSimpleRejected + numSectors * numSectors / 4);
+}
+
+//
+// Not a real test: reports how long building the nodes of a big level
+// takes, with the partitions evaluated on one thread and on all of them
+//
+TEST_F(BSPFixture, DISABLED_BenchmarkPickNode)
+{
+	int num_threads = std::max(2, WorkerPool::defaultThreads());
+
+	std::vector<std::shared_ptr<Wad_file>> wads;
+	std::vector<int> times;
+
+	for(int threads : { 1, num_threads })
+	{
+		auto wad = Wad_file::Open(getChildPath(SString::printf("big%d.wad", threads).c_str()), WadOpenMode::write);
+		addLevel(*wad, "MAP01", 40, 40);
+
+		nodebuildinfo_t info;
+		std::vector<SString> messages;
+
+		auto start = std::chrono::steady_clock::now();
+		buildSequential(inst, *wad, info, messages, threads);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		wads.push_back(wad);
+		times.push_back((int)elapsed.count());
+	}
+
+	printf("building 40x40 rooms took %d ms on 1 thread, %d ms on %d threads\n",
+		   times[0], times[1], num_threads);
+
+	checkSameLumps(*wads[0], *wads[1]);
+}
@@ -0,0 +1,243 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "e_basis.h"
+
+#include "Document.h"
+#include "e_cutpaste.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "testUtils/RoomGrid.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+//
+// Builds a grid of 64x64 rooms sharing their walls, with a thing in
+// each room.  The objects get distinct fields, so that a snapshot shows
+// which is which.
+//
+static void makeRooms(Document &doc, int columns, int rows)
+{
+	RoomGrid(columns, rows).build(doc);
+
+	for(int n = 0; n < doc.numSectors(); ++n)
+	{
+		doc.sectors[n]->floorh = n;
+
+		Thing thing;
+		thing.SetRawXY(MapFormat::doom, { (n % columns) * 64.0 + 32, (n / columns) * 64.0 + 32 });
+		thing.type = n;
+		doc.things.push_back(std::move(thing));
+	}
+	for(int n = 0; n < doc.numSidedefs(); ++n)
+		doc.sidedefs[n]->x_offset = n;
+	for(int n = 0; n < doc.numLinedefs(); ++n)
+		doc.linedefs[n]->tag = n;
+}
+
+//
+// Flatten the level, following the references, for comparing
+//
+static std::vector<int> snapshot(const Document &doc)
+{
+	std::vector<int> result;
+
+	for(const auto &T : doc.things)
+	{
+		result.push_back(T->type);
+		result.push_back(T->raw_x.raw());
+	}
+	result.push_back(-1);
+
+	for(const auto &L : doc.linedefs)
+	{
+		result.push_back(L->tag);
+		result.push_back(doc.vertices[L->start]->raw_x.raw());
+		result.push_back(doc.vertices[L->start]->raw_y.raw());
+		result.push_back(doc.vertices[L->end]->raw_x.raw());
+		result.push_back(doc.vertices[L->end]->raw_y.raw());
+
+		for(int sd : { L->right, L->left })
+		{
+			if(sd < 0)
+			{
+				result.push_back(-1);
+				continue;
+			}
+			result.push_back(doc.sidedefs[sd]->x_offset);
+			result.push_back(doc.sectors[doc.sidedefs[sd]->sector]->floorh);
+		}
+	}
+	result.push_back(-1);
+
+	for(const auto &S : doc.sidedefs)
+	{
+		result.push_back(S->x_offset);
+		result.push_back(doc.sectors[S->sector]->floorh);
+	}
+	result.push_back(-1);
+
+	for(const auto &V : doc.vertices)
+	{
+		result.push_back(V->raw_x.raw());
+		result.push_back(V->raw_y.raw());
+	}
+	result.push_back(-1);
+
+	for(const auto &S : doc.sectors)
+		result.push_back(S->floorh);
+
+	return result;
+}
+
+class EBasisFixture : public ::testing::Test
+{
+protected:
+	~EBasisFixture()
+	{
+		inst.level.clear();
+		ref.level.clear();
+	}
+
+	Instance inst;
+	Instance ref;	// gets the same edits, one object at a time
+};
+
+TEST_F(EBasisFixture, BatchDeleteMatchesSingleDeletes)
+{
+	makeRooms(inst.level, 6, 5);
+	makeRooms(ref.level, 6, 5);
+
+	const std::vector<int> original = snapshot(inst.level);
+	ASSERT_EQ(snapshot(ref.level), original);
+
+	struct Case
+	{
+		ObjType type;
+		std::vector<int> objnums;
+	};
+
+	// each type has its own cascade: sectors take their sidedefs,
+	// sidedefs get unbound from linedefs, vertices take their linedefs
+	const Case cases[] =
+	{
+		{ ObjType::things, { 0, 3, 4, 29 } },
+		{ ObjType::sectors, { 1, 2, 7, 8, 20 } },
+		{ ObjType::sidedefs, { 0, 5, 6, 30, 31 } },
+		{ ObjType::vertices, { 8, 9, 10, 24 } },
+		{ ObjType::linedefs, { 0, 1, 17, 18, 40 } },
+	};
+
+	std::vector<std::vector<int>> states;
+
+	for(const Case &c : cases)
+	{
+		{
+			EditOperation op(inst.level.basis);
+			op.del(c.type, c.objnums);
+		}
+		{
+			EditOperation op(ref.level.basis);
+			for(auto it = c.objnums.rbegin(); it != c.objnums.rend(); ++it)
+				op.del(c.type, *it);
+		}
+
+		states.push_back(snapshot(ref.level));
+		ASSERT_EQ(snapshot(inst.level), states.back());
+	}
+
+	// undo and redo replay the same way
+	for(int n = (int)states.size() - 1; n >= 0; --n)
+	{
+		ASSERT_EQ(snapshot(inst.level), states[n]);
+		ASSERT_TRUE(inst.level.basis.undo());
+	}
+	ASSERT_EQ(snapshot(inst.level), original);
+
+	for(const std::vector<int> &state : states)
+	{
+		ASSERT_TRUE(inst.level.basis.redo());
+		ASSERT_EQ(snapshot(inst.level), state);
+	}
+}
+
+TEST_F(EBasisFixture, DeleteSectorRegion)
+{
+	makeRooms(inst.level, 8, 8);
+
+	const std::vector<int> original = snapshot(inst.level);
+
+	// delete a 4x4 block of rooms in the middle, like the Delete command
+	selection_c list(ObjType::sectors);
+	for(int row = 2; row < 6; ++row)
+		for(int col = 2; col < 6; ++col)
+			list.set(row * 8 + col);
+
+	{
+		EditOperation op(inst.level.basis);
+		DeleteObjects_WithUnused(op, inst.level, list, false, false, false);
+	}
+
+	ASSERT_EQ(inst.level.numSectors(), 64 - 16);
+	ASSERT_EQ(inst.level.numThings(), 64 - 16);
+	ASSERT_EQ(inst.level.numVertices(), 81 - 9);	// the inner vertices
+	ASSERT_EQ(inst.level.numLinedefs(), 144 - 24);	// the inner walls
+
+	const std::vector<int> deleted = snapshot(inst.level);
+
+	ASSERT_TRUE(inst.level.basis.undo());
+	ASSERT_EQ(snapshot(inst.level), original);
+
+	ASSERT_TRUE(inst.level.basis.redo());
+	ASSERT_EQ(snapshot(inst.level), deleted);
+}
+
+//
+// Not a real test: reports how long a large delete (and its undo) takes
+//
+TEST_F(EBasisFixture, DISABLED_BenchmarkLargeDelete)
+{
+	makeRooms(inst.level, 100, 100);
+
+	selection_c list(ObjType::sectors);
+	for(int n = 0; n < inst.level.numSectors(); n += 2)
+		list.set(n);
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		EditOperation op(inst.level.basis);
+		DeleteObjects_WithUnused(op, inst.level, list, false, false, false);
+	}
+	auto deleted = std::chrono::steady_clock::now();
+
+	ASSERT_TRUE(inst.level.basis.undo());
+
+	auto undone = std::chrono::steady_clock::now();
+
+	printf("deleting %d of %d sectors took %d ms, undo %d ms\n", list.count_obj(), 100 * 100,
+		   (int)std::chrono::duration_cast<std::chrono::milliseconds>(deleted - start).count(),
+		   (int)std::chrono::duration_cast<std::chrono::milliseconds>(undone - deleted).count());
+
+	ASSERT_EQ(inst.level.numSectors(), 100 * 100);
+}
@@ -50,23 +50,15 @@ TEST(EChecks, FindFreeTag)
 	auto assignLines = [&inst, &lines]()
 	{
 		inst.level.linedefs.clear();
-		for(LineDef &line : lines)
-		{
-			auto addedLine = std::make_shared<LineDef>();
-			*addedLine = line;
-			inst.level.linedefs.push_back(std::move(addedLine));
-		}
+		for(const LineDef &line : lines)
+			inst.level.linedefs.push_back(line);
 	};
 	std::vector<Sector> sectors;
 	auto assignSectors = [&inst, &sectors]()
 	{
 		inst.level.sectors.clear();
-		for(Sector &sector : sectors)
-		{
-			auto newSector = std::make_shared<Sector>();
-			*newSector = sector;
-			inst.level.sectors.push_back(std::move(newSector));
-		}
+		for(const Sector &sector : sectors)
+			inst.level.sectors.push_back(sector);
 	};
 
 	// Check a level just with lines
@@ -204,18 +196,10 @@ TEST(EChecks, TagsApplyNewValue)
 	lines.resize(7);
 	sectors.resize(5);
 
-	for(LineDef &line : lines)
-	{
-		auto newLine = std::make_shared<LineDef>();
-		*newLine = line;
-		inst.level.linedefs.push_back(std::move(newLine));
-	}
-	for(Sector &sector : sectors)
-	{
-		auto newSector = std::make_shared<Sector>();
-		*newSector = sector;
-		inst.level.sectors.push_back(std::move(newSector));
-	}
+	for(const LineDef &line : lines)
+		inst.level.linedefs.push_back(line);
+	for(const Sector &sector : sectors)
+		inst.level.sectors.push_back(sector);
 
 	// Start with linedefs
 	inst.edit.mode = ObjType::linedefs;
@@ -254,7 +238,7 @@ TEST(EChecks, TagsApplyNewValue)
 		else
 			ASSERT_EQ(line->tag, 0);
 	for(const auto &sector : inst.level.sectors)
-		if(sector.get() == inst.level.sectors[2].get() || sector.get() == inst.level.sectors[4].get())
+		if(sector == inst.level.sectors[2] || sector == inst.level.sectors[4])
 			ASSERT_EQ(sector->tag, 2);
 		else
 			ASSERT_EQ(sector->tag, 0);
@@ -268,7 +252,7 @@ TEST(EChecks, TagsApplyNewValue)
 		else
 			ASSERT_EQ(line->tag, 0);
 	for(const auto &sector : inst.level.sectors)
-		if(sector.get() == inst.level.sectors[2].get())
+		if(sector == inst.level.sectors[2])
 			ASSERT_EQ(sector->tag, 1);
 		else if(sector == inst.level.sectors[4])
 			ASSERT_EQ(sector->tag, 2);
@@ -46,43 +46,43 @@ protected:
 
 void SelectNeighbor::addVertex(int x, int y)
 {
-    Vertex *vertex = new Vertex;
-    vertex->SetRawXY(MapFormat::doom, v2double_t{ (double)x, (double)y });
-    doc.vertices.emplace_back(vertex);
+    Vertex vertex;
+    vertex.SetRawXY(MapFormat::doom, v2double_t{ (double)x, (double)y });
+    doc.vertices.push_back(std::move(vertex));
 }
 
 void SelectNeighbor::addSector(int floorh, int ceilh)
 {
-    Sector *sector = new Sector;
-    sector->floorh = floorh;
-    sector->ceilh = ceilh;
-    sector->floor_tex = BA_InternaliseString("FLOOR");
-    sector->ceil_tex = BA_InternaliseString("CEIL");
-    sector->light = 160;
-    sector->type = sector->tag = 0;
-    doc.sectors.emplace_back(sector);
+    Sector sector;
+    sector.floorh = floorh;
+    sector.ceilh = ceilh;
+    sector.floor_tex = BA_InternaliseString("FLOOR");
+    sector.ceil_tex = BA_InternaliseString("CEIL");
+    sector.light = 160;
+    sector.type = sector.tag = 0;
+    doc.sectors.push_back(std::move(sector));
 }
 
 void SelectNeighbor::addSide(const SString &upper, const SString &middle, const SString &lower,
     int sector, int yoffset)
 {
-    SideDef *side = new SideDef{};
-    side->upper_tex = BA_InternaliseString(upper);
-    side->mid_tex = BA_InternaliseString(middle);
-    side->lower_tex = BA_InternaliseString(lower);
-    side->sector = sector;
-	side->y_offset = yoffset;
-    doc.sidedefs.emplace_back(side);
+    SideDef side;
+    side.upper_tex = BA_InternaliseString(upper);
+    side.mid_tex = BA_InternaliseString(middle);
+    side.lower_tex = BA_InternaliseString(lower);
+    side.sector = sector;
+	side.y_offset = yoffset;
+    doc.sidedefs.push_back(std::move(side));
 }
 
 void SelectNeighbor::addLine(int v1, int v2, int s1, int s2)
 {
-    LineDef *line = new LineDef{};
-    line->start = v1;
-    line->end = v2;
-    line->right = s1;
-    line->left = s2;
-    doc.linedefs.emplace_back(line);
+    LineDef line;
+    line.start = v1;
+    line.end = v2;
+    line.right = s1;
+    line.left = s2;
+    doc.linedefs.push_back(std::move(line));
 }
 
 class SelectNeighborTexture : public SelectNeighbor
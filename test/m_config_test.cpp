@@ -717,6 +717,7 @@ rgb_color_t config::transparent_col = rgbMake(0, 255, 255);
 bool config::auto_load_recent = false;
 int config::backup_max_files = 30;
 int config::backup_max_space = 60;  // MB
+int config::backup_min_interval = 10;  // minutes
 int  config::bsp_split_factor    = DEFAULT_FACTOR;
 int config::floor_bump_medium = 8;
 int config::floor_bump_large  = 64;
@@ -747,6 +748,9 @@ bool config::grid_hide_in_free_mode = false;
 bool config::sidedef_add_del_buttons = false;
 bool config::same_mode_clears_selection = false;
 bool config::bsp_fast        = false;
+int  config::bsp_threads     = 0;
+bool config::bsp_full_reject = false;
+int config::image_cache_space = 256;  // MB
 fs::path global::config_file;
 fs::path global::install_dir;
 int global::show_version  = 0;
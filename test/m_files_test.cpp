@@ -18,10 +18,13 @@
 
 #include "testUtils/TempDirContext.hpp"
 
+#include "m_config.h"
 #include "m_files.h"
 #include "m_loadsave.h"
 #include "m_parse.h"
 #include "m_streams.h"
+#include "main.h"
+#include "w_wad.h"
 
 #include "filesystem.hpp"
 namespace fs = ghc::filesystem;
@@ -828,3 +831,46 @@ TEST_F(RecentFilesFixture, MSaveRecent)
 	}
 }
 
+class BackupFixture : public TempDirContext
+{
+protected:
+	void SetUp() override
+	{
+		TempDirContext::SetUp();
+		global::cache_dir = mTempDir;
+		// made at startup, in the real program
+		fs::create_directory(getChildPath("backups"));
+	}
+
+	void TearDown() override
+	{
+		config::backup_min_interval = 10;
+		global::cache_dir.clear();
+		fs::remove_all(getChildPath("backups"));
+		TempDirContext::TearDown();
+	}
+};
+
+TEST_F(BackupFixture, RecentBackupIsNotRepeated)
+{
+	fs::path path = getChildPath("backed.wad");
+	auto wad = Wad_file::Open(path, WadOpenMode::write);
+	ASSERT_TRUE(wad);
+	wad->AddLump("LUMP").Printf("Hello");
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	fs::path dir = getChildPath("backups/backed");
+
+	config::backup_min_interval = 10;
+	M_BackupWad(wad.get());
+	ASSERT_TRUE(fs::exists(dir / "1.wad"));
+
+	// the first backup is still recent
+	M_BackupWad(wad.get());
+	ASSERT_FALSE(fs::exists(dir / "2.wad"));
+
+	config::backup_min_interval = 0;
+	M_BackupWad(wad.get());
+	ASSERT_TRUE(fs::exists(dir / "2.wad"));
+}
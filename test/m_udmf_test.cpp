@@ -0,0 +1,487 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Document.h"
+#include "Instance.h"
+#include "lib_adler.h"
+#include "LineDef.h"
+#include "m_loadsave.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+#include "w_wad.h"
+#include "WorkerPool.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+class UDMFFixture : public ::testing::Test
+{
+protected:
+	void load(const std::string &textmap, int num_threads = 0);
+	void load(const std::string &textmap, Document &into, LoadingData &into_loading, int num_threads);
+
+	Instance inst;
+	Document doc{ inst };
+	LoadingData loading;
+	BadCount bad = {};
+};
+
+//
+// Loads the TEXTMAP into doc
+//
+void UDMFFixture::load(const std::string &textmap, int num_threads)
+{
+	load(textmap, doc, loading, num_threads);
+}
+
+void UDMFFixture::load(const std::string &textmap, Document &into, LoadingData &into_loading, int num_threads)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	wad->AddLump("TEXTMAP").Write(textmap.data(), (int)textmap.size());
+	wad->AddLump("ENDMAP");
+
+	inst.UDMF_LoadLevel(0, wad.get(), into, into_loading, bad, num_threads);
+}
+
+//
+// Makes a TEXTMAP of size * size square sectors, written the way editors
+// write them
+//
+static std::string makeBigTextmap(int size)
+{
+	std::string text = "namespace = \"zdoom\";\n\n";
+	char buffer[256];
+
+	for(int row = 0; row <= size; ++row)
+		for(int col = 0; col <= size; ++col)
+		{
+			snprintf(buffer, sizeof(buffer), "vertex // %d\n{\nx = %1.3f;\ny = %1.3f;\n}\n\n",
+					 row * (size + 1) + col, col * 64.0, row * 64.0);
+			text += buffer;
+		}
+	for(int n = 0; n < size * size; ++n)
+	{
+		snprintf(buffer, sizeof(buffer), "linedef // %d\n{\nv1 = %d;\nv2 = %d;\nsidefront = %d;\n"
+				 "blocking = true;\n}\n\n", n, n / size * (size + 1) + n % size,
+				 n / size * (size + 1) + n % size + 1, n);
+		text += buffer;
+		snprintf(buffer, sizeof(buffer), "sidedef // %d\n{\nsector = %d;\noffsetx = 16;\n"
+				 "texturemiddle = \"WALL%02d\";\n}\n\n", n, n, n % 37);
+		text += buffer;
+		snprintf(buffer, sizeof(buffer), "sector // %d\n{\nheightfloor = %d;\nheightceiling = 128;\n"
+				 "texturefloor = \"FLOOR0_1\";\ntextureceiling = \"CEIL1_1\";\nlightlevel = 160;\n}\n\n",
+				 n, n % 5 * 8);
+		text += buffer;
+		snprintf(buffer, sizeof(buffer), "thing // %d\n{\nx = %1.3f;\ny = %1.3f;\nangle = 90;\n"
+				 "type = 3001;\nskill1 = true;\nskill2 = true;\nsingle = true;\n}\n\n",
+				 n, n % size * 64.0 + 32, n / size * 64.0 + 32);
+		text += buffer;
+	}
+	return text;
+}
+
+TEST_F(UDMFFixture, LoadFields)
+{
+	load("// a comment\n"
+		 "namespace = \"zdoom\";\n"
+		 "/* a comment\n"
+		 "   over lines */\n"
+		 "thing // 0\n"
+		 "{\n"
+		 "x = 64.5;\n"
+		 "Y = -32;\n"
+		 "height = +8.25;\n"
+		 "type = 3001;\n"
+		 "angle = 90;\n"
+		 "skill2 = true;\n"
+		 "skill3 = false;\n"
+		 "single = true;\n"
+		 "unknownfield = 7;\n"
+		 "}\n"
+		 "vertex { x = 0.0; y = 0.0; }\n"
+		 "vertex { x = 128.0; y = 1e2; }\n"
+		 "linedef\n"
+		 "{\n"
+		 "v1 = 0; v2 = 1; sidefront = 0; special = 11; arg0 = 3;\n"
+		 "blocking = true; DontPegTop = true; secret = false;\n"
+		 "}\n"
+		 "sidedef\n"
+		 "{\n"
+		 "sector = 0; offsetx = -16; offsety = 4;\n"
+		 "texturemiddle = \"STARTAN3\"; texturetop = \"BIGNAMEISTOOLONG\";\n"
+		 "}\n"
+		 "sector\n"
+		 "{\n"
+		 "heightfloor = -8; heightceiling = 128; lightlevel = 192;\n"
+		 "texturefloor = \"FLOOR0_1\"; textureceiling = \"CEIL1_1\"; id = 5;\n"
+		 "}\n"
+		 "unknownblock { x = 1; }\n");
+
+	ASSERT_EQ(loading.udmfNamespace, "zdoom");
+
+	ASSERT_EQ(doc.numThings(), 1);
+	const Thing &thing = *doc.things[0];
+	ASSERT_EQ(thing.x(), 64.5);
+	ASSERT_EQ(thing.y(), -32);
+	ASSERT_EQ(thing.h(), 8.25);
+	ASSERT_EQ(thing.type, 3001);
+	ASSERT_EQ(thing.angle, 90);
+	ASSERT_EQ(thing.options, MTF_Easy | MTF_Not_COOP | MTF_Not_DM);
+
+	ASSERT_EQ(doc.numVertices(), 2);
+	ASSERT_EQ(doc.vertices[1]->x(), 128);
+	ASSERT_EQ(doc.vertices[1]->y(), 100);
+
+	ASSERT_EQ(doc.numLinedefs(), 1);
+	const LineDef &line = *doc.linedefs[0];
+	ASSERT_EQ(line.start, 0);
+	ASSERT_EQ(line.end, 1);
+	ASSERT_EQ(line.right, 0);
+	ASSERT_EQ(line.left, -1);
+	ASSERT_EQ(line.type, 11);
+	ASSERT_EQ(line.tag, 3);
+	ASSERT_EQ(line.flags, MLF_Blocking | MLF_UpperUnpegged);
+
+	ASSERT_EQ(doc.numSidedefs(), 1);
+	const SideDef &side = *doc.sidedefs[0];
+	ASSERT_EQ(side.sector, 0);
+	ASSERT_EQ(side.x_offset, -16);
+	ASSERT_EQ(side.y_offset, 4);
+	ASSERT_EQ(side.MidTex(), "STARTAN3");
+	ASSERT_EQ(side.UpperTex(), "BIGNAMEI");
+	ASSERT_EQ(side.LowerTex(), "-");
+
+	ASSERT_EQ(doc.numSectors(), 1);
+	const Sector &sector = *doc.sectors[0];
+	ASSERT_EQ(sector.floorh, -8);
+	ASSERT_EQ(sector.ceilh, 128);
+	ASSERT_EQ(sector.light, 192);
+	ASSERT_EQ(sector.tag, 5);
+	ASSERT_EQ(sector.FloorTex(), "FLOOR0_1");
+	ASSERT_EQ(sector.CeilTex(), "CEIL1_1");
+}
+
+TEST_F(UDMFFixture, LoadBrokenText)
+{
+	// a missing value skips the rest of its line, and a comment which is
+	// never closed runs to the end
+	load("vertex\n{\nx = ; y = 8;\ny = 16;\n}\n"
+		 "vertex { x = 32; y = 48; }\n"
+		 "/* never closed\n"
+		 "vertex { x = 64; y = 64; }\n");
+
+	ASSERT_EQ(doc.numVertices(), 2);
+	ASSERT_EQ(doc.vertices[1]->x(), 32);
+	ASSERT_EQ(doc.vertices[1]->y(), 48);
+}
+
+TEST_F(UDMFFixture, LoadInParallel)
+{
+	std::string text = makeBigTextmap(60);
+
+	// a long comment full of blocks in the middle, which the lump must not
+	// be split inside of
+	std::string comment = "/*\n";
+	for(int n = 0; n < 30000; ++n)
+		comment += "thing\n{\ntype = 1;\n}\n";
+	comment += "*/\n";
+	text.insert(text.find("}\n\nsector", text.size() / 2) + 3, comment);
+
+	load(text, 1);
+
+	Document parallel(inst);
+	LoadingData parallel_loading;
+	load(text, parallel, parallel_loading, 4);
+
+	ASSERT_EQ(parallel_loading.udmfNamespace, "zdoom");
+	ASSERT_EQ(parallel.numThings(), doc.numThings());
+	ASSERT_EQ(parallel.numVertices(), doc.numVertices());
+	ASSERT_EQ(parallel.numLinedefs(), doc.numLinedefs());
+	ASSERT_EQ(parallel.numSidedefs(), doc.numSidedefs());
+	ASSERT_EQ(parallel.numSectors(), doc.numSectors());
+
+	crc32_c serial_crc;
+	doc.getLevelChecksum(serial_crc);
+	crc32_c parallel_crc;
+	parallel.getLevelChecksum(parallel_crc);
+
+	ASSERT_EQ(parallel_crc.raw, serial_crc.raw);
+	ASSERT_EQ(parallel_crc.extra, serial_crc.extra);
+}
+
+//
+// Not a real test: reports how long loading a big UDMF map takes, on one
+// thread and on all of them
+//
+TEST_F(UDMFFixture, DISABLED_BenchmarkLoad)
+{
+	static const int size = 120;
+
+	std::string text = makeBigTextmap(size);
+
+	for(int num_threads : { 1, 0 })
+	{
+		Document big(inst);
+		LoadingData big_loading;
+
+		auto start = std::chrono::steady_clock::now();
+		load(text, big, big_loading, num_threads);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		ASSERT_EQ(big.numSectors(), size * size);
+		ASSERT_EQ(big.numThings(), size * size);
+
+		printf("loading a %d KB TEXTMAP on %d threads took %d ms\n", (int)(text.size() / 1024),
+			   num_threads ? num_threads : WorkerPool::defaultThreads(), (int)elapsed.count());
+	}
+}
+
+//
+// Gives the TEXTMAP which inst.UDMF_SaveLevel writes
+//
+static std::string saveTextmap(const Instance &inst, const LoadingData &loading, int num_threads)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	inst.UDMF_SaveLevel(loading, *wad, num_threads);
+
+	const Lump_c &lump = *wad->GetLump(wad->LevelLookupLump(0, "TEXTMAP"));
+	return std::string(reinterpret_cast<const char *>(lump.data()), lump.Length());
+}
+
+TEST_F(UDMFFixture, SaveFields)
+{
+	inst.conf.features.friend_flag = 1;
+	inst.conf.features.pass_through = 1;
+	inst.conf.features.midtex_3d = 1;
+
+	loading.udmfNamespace = "eternity";
+
+	Document &level = inst.level;
+
+	Thing thing;
+	thing.raw_x = FFixedPoint(-3.0009765625);
+	thing.raw_y = FFixedPoint(1000.0625);
+	thing.raw_h = FFixedPoint(24);
+	thing.angle = 270;
+	thing.type = 2001;
+	thing.options = MTF_Easy | MTF_Hard | MTF_Ambush | MTF_Friend | MTF_Not_SP;
+	level.things.push_back(thing);
+	level.things.push_back(Thing());
+
+	Vertex vertex;
+	vertex.raw_x = FFixedPoint(-0.000244140625);
+	vertex.raw_y = FFixedPoint(32767.5);
+	level.vertices.push_back(vertex);
+	vertex = Vertex();
+	vertex.raw_x = FFixedPoint(0.0005);
+	vertex.raw_y = FFixedPoint(-128);
+	level.vertices.push_back(vertex);
+
+	LineDef line;
+	line.start = 0;
+	line.end = 1;
+	line.right = 0;
+	line.left = 1;
+	line.type = 80;
+	line.tag = 1;
+	line.arg2 = 2;
+	line.arg3 = -3;
+	line.arg4 = 4;
+	line.arg5 = 5;
+	line.flags = 0xffff;
+	level.linedefs.push_back(line);
+	line = LineDef();
+	line.start = 1;
+	line.end = 0;
+	line.right = -1;
+	line.left = -1;
+	level.linedefs.push_back(line);
+
+	SideDef side;
+	side.sector = 0;
+	side.x_offset = -16;
+	side.y_offset = 1024;
+	side.upper_tex = BA_InternaliseString("startan3");
+	side.mid_tex = BA_InternaliseString("-");
+	side.lower_tex = BA_InternaliseString("QUOTE\"D_TOOLONG");
+	level.sidedefs.push_back(side);
+	side = SideDef();
+	side.sector = 0;
+	side.upper_tex = side.mid_tex = side.lower_tex = BA_InternaliseString("-");
+	level.sidedefs.push_back(side);
+
+	Sector sector;
+	sector.floorh = -32;
+	sector.ceilh = 200;
+	sector.floor_tex = BA_InternaliseString("nukage1");
+	sector.ceil_tex = BA_InternaliseString("F_SKY1");
+	sector.light = 255;
+	sector.type = 9;
+	sector.tag = 12;
+	level.sectors.push_back(sector);
+	sector = Sector();
+	sector.floor_tex = BA_InternaliseString("");
+	sector.ceil_tex = BA_InternaliseString("-");
+	level.sectors.push_back(sector);
+
+	static const char golden[] =
+		"namespace = \"eternity\";\n"
+		"\n"
+		"thing // 0\n"
+		"{\n"
+		"x = -3.001;\n"
+		"y = 1000.062;\n"
+		"height = 24.000;\n"
+		"angle = 270;\n"
+		"type = 2001;\n"
+		"skill1 = true;\n"
+		"skill2 = true;\n"
+		"skill4 = true;\n"
+		"skill5 = true;\n"
+		"coop = true;\n"
+		"dm = true;\n"
+		"ambush = true;\n"
+		"friend = true;\n"
+		"}\n"
+		"\n"
+		"thing // 1\n"
+		"{\n"
+		"x = 0.000;\n"
+		"y = 0.000;\n"
+		"angle = 0;\n"
+		"type = 0;\n"
+		"single = true;\n"
+		"coop = true;\n"
+		"dm = true;\n"
+		"}\n"
+		"\n"
+		"vertex // 0\n"
+		"{\n"
+		"x = -0.000;\n"
+		"y = 32767.500;\n"
+		"}\n"
+		"\n"
+		"vertex // 1\n"
+		"{\n"
+		"x = 0.000;\n"
+		"y = -128.000;\n"
+		"}\n"
+		"\n"
+		"linedef // 0\n"
+		"{\n"
+		"v1 = 0;\n"
+		"v2 = 1;\n"
+		"sidefront = 0;\n"
+		"sideback = 1;\n"
+		"special = 80;\n"
+		"arg0 = 1;\n"
+		"arg1 = 2;\n"
+		"arg2 = -3;\n"
+		"arg3 = 4;\n"
+		"arg4 = 5;\n"
+		"blocking = true;\n"
+		"blockmonsters = true;\n"
+		"twosided = true;\n"
+		"dontpegtop = true;\n"
+		"dontpegbottom = true;\n"
+		"secret = true;\n"
+		"blocksound = true;\n"
+		"dontdraw = true;\n"
+		"mapped = true;\n"
+		"passuse = true;\n"
+		"midtex3d = true;\n"
+		"}\n"
+		"\n"
+		"linedef // 1\n"
+		"{\n"
+		"v1 = 1;\n"
+		"v2 = 0;\n"
+		"}\n"
+		"\n"
+		"sidedef // 0\n"
+		"{\n"
+		"sector = 0;\n"
+		"offsetx = -16;\n"
+		"offsety = 1024;\n"
+		"texturetop = \"STARTAN3\";\n"
+		"texturebottom = \"QUOTE_D_\";\n"
+		"}\n"
+		"\n"
+		"sidedef // 1\n"
+		"{\n"
+		"sector = 0;\n"
+		"}\n"
+		"\n"
+		"sector // 0\n"
+		"{\n"
+		"heightfloor = -32;\n"
+		"heightceiling = 200;\n"
+		"texturefloor = \"NUKAGE1\";\n"
+		"textureceiling = \"F_SKY1\";\n"
+		"lightlevel = 255;\n"
+		"special = 9;\n"
+		"id = 12;\n"
+		"}\n"
+		"\n"
+		"sector // 1\n"
+		"{\n"
+		"heightfloor = 0;\n"
+		"heightceiling = 0;\n"
+		"texturefloor = \"-\";\n"
+		"textureceiling = \"-\";\n"
+		"lightlevel = 0;\n"
+		"}\n"
+		"\n";
+
+	ASSERT_EQ(saveTextmap(inst, loading, 1), golden);
+}
+
+TEST_F(UDMFFixture, SaveInParallel)
+{
+	load(makeBigTextmap(60), inst.level, loading, 1);
+
+	std::string text = saveTextmap(inst, loading, 1);
+
+	ASSERT_EQ(saveTextmap(inst, loading, 4), text);
+}
+
+//
+// Not a real test: reports how long saving a big UDMF map takes, on one
+// thread and on all of them
+//
+TEST_F(UDMFFixture, DISABLED_BenchmarkSave)
+{
+	load(makeBigTextmap(120), inst.level, loading, 1);
+
+	for(int num_threads : { 1, 0 })
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::string text = saveTextmap(inst, loading, num_threads);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		printf("saving a %d KB TEXTMAP on %d threads took %d ms\n", (int)(text.size() / 1024),
+			   num_threads ? num_threads : WorkerPool::defaultThreads(), (int)elapsed.count());
+	}
+}
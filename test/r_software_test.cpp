@@ -0,0 +1,559 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Document.h"
+#include "e_basis.h"
+#include "e_hover.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+#include "w_wad.h"
+#include "WorkerPool.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+
+class SoftwareRenderFixture : public ::testing::Test
+{
+protected:
+	SoftwareRenderFixture()
+	{
+		inst.conf.miscInfo.wall_colors[0] = 16;
+		inst.conf.miscInfo.wall_colors[1] = 80;
+		inst.conf.miscInfo.floor_colors[0] = 96;
+		inst.conf.miscInfo.floor_colors[1] = 160;
+	}
+
+	~SoftwareRenderFixture()
+	{
+		inst.r_view.screen = nullptr;
+		inst.level.clear();
+	}
+
+	static bool isOpen(int col, int row, int size);
+	void makeMaze(int size);
+	void makeRoom(int size, int light);
+	void loadResources();
+	void setView(double x, double y, double angle, int width, int height);
+	std::vector<img_pixel_t> render(bool culling);
+
+	Instance inst;
+	std::vector<img_pixel_t> screen;
+	std::vector<int> cellSector;
+};
+
+//
+// Long walls with doorways, broken up by pillars, so that most of the
+// map is hidden from any spot
+//
+bool SoftwareRenderFixture::isOpen(int col, int row, int size)
+{
+	if(col < 0 || row < 0 || col >= size || row >= size)
+		return false;
+	if(row % 4 == 3 && col % 5 != 2)
+		return false;
+	if(col % 6 == 5 && row % 3 != 1)
+		return false;
+	return true;
+}
+
+//
+// Builds a grid of 128x128 cells, each open one a sector with its own
+// heights. Neighbouring open cells share a two-sided linedef, and the
+// edges towards closed cells are one-sided walls.
+//
+void SoftwareRenderFixture::makeMaze(int size)
+{
+	Document &doc = inst.level;
+
+	for(int row = 0; row <= size; ++row)
+		for(int col = 0; col <= size; ++col)
+		{
+			Vertex vertex;
+			vertex.SetRawXY(MapFormat::doom, { col * 128.0, row * 128.0 });
+			doc.vertices.push_back(std::move(vertex));
+		}
+
+	cellSector.assign(size * size, -1);
+	for(int row = 0; row < size; ++row)
+		for(int col = 0; col < size; ++col)
+		{
+			if(!isOpen(col, row, size))
+				continue;
+			Sector sector;
+			sector.floorh = (row * 7 + col * 13) % 5 * 8;
+			sector.ceilh = 128 + (row * 3 + col * 5) % 4 * 16;
+			sector.light = 160;
+			sector.floor_tex = BA_InternaliseString(SString::printf("FL%d", (row + col) % 7));
+			sector.ceil_tex = BA_InternaliseString(SString::printf("CE%d", (row * col) % 5));
+			cellSector[row * size + col] = doc.numSectors();
+			doc.sectors.push_back(std::move(sector));
+		}
+
+	auto vertexAt = [size](int col, int row)
+	{
+		return row * (size + 1) + col;
+	};
+	auto sectorAt = [&](int col, int row)
+	{
+		return isOpen(col, row, size) ? cellSector[row * size + col] : -1;
+	};
+	auto addSide = [&](int sector, int seed)
+	{
+		SideDef side;
+		side.sector = sector;
+		side.lower_tex = BA_InternaliseString(SString::printf("LO%d", seed % 3));
+		side.mid_tex = BA_InternaliseString(SString::printf("WALL%d", seed % 9));
+		side.upper_tex = BA_InternaliseString(SString::printf("UP%d", seed % 4));
+		doc.sidedefs.push_back(std::move(side));
+		return doc.numSidedefs() - 1;
+	};
+	// the line goes from v1 to v2 with 'right' on its right side
+	auto addLine = [&](int v1, int v2, int right, int left)
+	{
+		LineDef line;
+		line.start = v1;
+		line.end = v2;
+		line.right = addSide(right, doc.numLinedefs());
+		line.left = left >= 0 ? addSide(left, doc.numLinedefs() + 1) : -1;
+		line.flags = left >= 0 ? MLF_TwoSided : MLF_Blocking;
+		doc.linedefs.push_back(std::move(line));
+	};
+
+	for(int row = 0; row <= size; ++row)
+		for(int col = 0; col <= size; ++col)
+		{
+			// the vertical edge at the west of the cell
+			if(row < size)
+			{
+				int west = sectorAt(col - 1, row);
+				int east = sectorAt(col, row);
+				if(east >= 0)
+					addLine(vertexAt(col, row), vertexAt(col, row + 1), east, west);
+				else if(west >= 0)
+					addLine(vertexAt(col, row + 1), vertexAt(col, row), west, -1);
+			}
+			// the horizontal edge at the south of the cell
+			if(col < size)
+			{
+				int south = sectorAt(col, row - 1);
+				int north = sectorAt(col, row);
+				if(south >= 0)
+					addLine(vertexAt(col, row), vertexAt(col + 1, row), south, north);
+				else if(north >= 0)
+					addLine(vertexAt(col + 1, row), vertexAt(col, row), north, -1);
+			}
+		}
+
+	// a thing in some of the cells
+	for(int row = 0; row < size; ++row)
+		for(int col = 0; col < size; ++col)
+			if(isOpen(col, row, size) && (row * size + col) % 7 == 0)
+			{
+				Thing thing;
+				thing.SetRawXY(MapFormat::doom, { col * 128.0 + 40, row * 128.0 + 70 });
+				thing.type = 2001;
+				doc.things.push_back(std::move(thing));
+			}
+
+	inst.r_view.thing_sectors.clear();
+	for(const auto &thing : doc.things)
+		inst.r_view.thing_sectors.push_back(hover::getNearestSector(doc, thing->xy()).num);
+}
+
+//
+// One square sector of the given size, with the corner at 0,0
+//
+void SoftwareRenderFixture::makeRoom(int size, int light)
+{
+	Document &doc = inst.level;
+
+	static const int corners[4][2] = { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 0 } };
+	for(const auto &corner : corners)
+	{
+		Vertex vertex;
+		vertex.SetRawXY(MapFormat::doom, { corner[0] * (double)size, corner[1] * (double)size });
+		doc.vertices.push_back(std::move(vertex));
+	}
+
+	Sector sector;
+	sector.floorh = 0;
+	sector.ceilh = 256;
+	sector.light = light;
+	sector.floor_tex = BA_InternaliseString("FLAT");
+	sector.ceil_tex = BA_InternaliseString("FLAT");
+	doc.sectors.push_back(std::move(sector));
+
+	for(int i = 0; i < 4; ++i)
+	{
+		SideDef side;
+		side.sector = 0;
+		side.mid_tex = BA_InternaliseString("WALL");
+		doc.sidedefs.push_back(std::move(side));
+
+		LineDef line;
+		line.start = i;
+		line.end = (i + 1) % 4;
+		line.right = i;
+		line.flags = MLF_Blocking;
+		doc.linedefs.push_back(std::move(line));
+	}
+
+	inst.r_view.thing_sectors.clear();
+}
+
+//
+// A palette, a COLORMAP whose row N turns every color into N + 1, and
+// some patterned flats: "FLAT" is all color 100, the rest are used by
+// makeMaze()
+//
+void SoftwareRenderFixture::loadResources()
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+
+	std::vector<uint8_t> data(768);
+	for(int i = 0; i < 768; ++i)
+		data[i] = static_cast<uint8_t>(i / 3);
+	wad->AddLump("PLAYPAL").Write(data.data(), (int)data.size());
+	data.resize(32 * 256);
+	for(int i = 0; i < 32 * 256; ++i)
+		data[i] = static_cast<uint8_t>(i / 256 + 1);
+	wad->AddLump("COLORMAP").Write(data.data(), (int)data.size());
+
+	wad->AddLump("F_START");
+	data.assign(64 * 64, 100);
+	wad->AddLump("FLAT").Write(data.data(), (int)data.size());
+	for(int i = 0; i < 7; ++i)
+	{
+		for(int p = 0; p < 64 * 64; ++p)
+			data[p] = static_cast<uint8_t>((p % 64) * 3 + (p / 64) * 5 + i * 17);
+		wad->AddLump(SString::printf("FL%d", i)).Write(data.data(), (int)data.size());
+		if(i < 5)
+			wad->AddLump(SString::printf("CE%d", i)).Write(data.data(), (int)data.size());
+	}
+	wad->AddLump("F_END");
+
+	inst.wad.reloadResources(wad, inst.conf, {});
+}
+
+void SoftwareRenderFixture::setView(double x, double y, double angle, int width, int height)
+{
+	Render_View_t &view = inst.r_view;
+
+	view.x = x;
+	view.y = y;
+	view.z = 41;
+	view.SetAngle(static_cast<float>(angle));
+
+	screen.assign(width * height, 0);
+	view.screen = screen.data();
+	view.screen_w = width;
+	view.screen_h = height;
+	view.CalcAspect();
+
+	view.texturing = false;
+	view.lighting = false;
+	view.sprites = true;
+}
+
+std::vector<img_pixel_t> SoftwareRenderFixture::render(bool culling)
+{
+	inst.r_view.culling = culling;
+	inst.SW_RenderBuffer();
+	return screen;
+}
+
+TEST_F(SoftwareRenderFixture, CullingDrawsTheSamePicture)
+{
+	static const int size = 16;
+	makeMaze(size);
+
+	int views = 0;
+	for(int row = 0; row < size; row += 3)
+		for(int col = 0; col < size; col += 2)
+		{
+			if(!isOpen(col, row, size))
+				continue;
+			for(int dir = 0; dir < 8; ++dir)
+			{
+				double x = col * 128 + 37 + dir * 7;
+				double y = row * 128 + 90 - dir * 9;
+				setView(x, y, dir * M_PI / 4 + 0.1, 160, 100);
+
+				std::vector<img_pixel_t> all = render(false);
+				std::vector<img_pixel_t> culled = render(true);
+				ASSERT_EQ(culled, all) << "at " << x << "," << y << " dir " << dir;
+				ASSERT_LT(std::count(all.begin(), all.end(), 0), (long)all.size() / 2);
+				++views;
+			}
+		}
+	ASSERT_GT(views, 50);
+
+	// standing right on a two-sided linedef still sees both sides
+	setView(5 * 128, 1 * 128 + 64, 0.3, 160, 100);
+	ASSERT_EQ(render(true), render(false));
+	setView(5 * 128, 1 * 128 + 64, M_PI + 0.3, 160, 100);
+	ASSERT_EQ(render(true), render(false));
+
+	// outside the map everything gets drawn
+	setView(-300, -300, M_PI / 4, 160, 100);
+	ASSERT_EQ(render(true), render(false));
+}
+
+TEST_F(SoftwareRenderFixture, ThreadsDrawTheSamePicture)
+{
+	static const int size = 16;
+	makeMaze(size);
+
+	loadResources();
+
+	static const int sizes[][2] = { { 160, 100 }, { 333, 201 }, { 7, 50 }, { 1, 10 } };
+
+	for(const auto &screenSize : sizes)
+		for(int view = 0; view < 12; ++view)
+		{
+			setView(3 * 128 + view * 31, 2 * 128 + 50 + view * 11, view * 0.55, screenSize[0], screenSize[1]);
+			inst.r_view.texturing = view % 2 == 1;
+			inst.r_view.lighting = view % 4 >= 2;
+
+			inst.r_view.threads = 1;
+			std::vector<img_pixel_t> single = render(true);
+			inst.r_view.threads = 4;
+			ASSERT_EQ(render(true), single) << screenSize[0] << "x" << screenSize[1] << " view " << view;
+			inst.r_view.threads = 3;
+			ASSERT_EQ(render(false), single) << screenSize[0] << "x" << screenSize[1] << " view " << view;
+		}
+}
+
+TEST_F(SoftwareRenderFixture, FlatLightingFollowsTheEquation)
+{
+	makeRoom(8192, 0);
+	loadResources();
+
+	static const int lights[] = { 0, 24, 96, 144, 160, 200, 240, 255, 300, -8 };
+
+	for(int light : lights)
+		for(double z : { 41.0, 200.0 })
+		{
+			inst.level.sectors[0]->light = light;
+			setView(4096, 4096, 1.0, 160, 100);
+			inst.r_view.z = z;
+			inst.r_view.texturing = true;
+			inst.r_view.lighting = true;
+
+			std::vector<img_pixel_t> pic = render(true);
+
+			const Render_View_t &view = inst.r_view;
+			int checked = 0;
+			for(int y = 0; y < view.screen_h; ++y)
+			{
+				// the floor below the middle, the ceiling above
+				int sec_h = y * 2 > view.screen_h ? 0 : 256;
+				float dist = static_cast<float>(view.aspect_sh * (sec_h - view.z) / (view.screen_h - y * 2));
+				if(dist <= 0 || dist > 2000)
+					continue;
+
+				// the COLORMAP makes row N into N + 1
+				int expected = R_DoomLightingEquation(light, dist) + 1;
+				for(int x = 0; x < view.screen_w; x += 13)
+					ASSERT_EQ(pic[y * view.screen_w + x], expected) << "light " << light << " z " << z << " at " << x << "," << y;
+				++checked;
+			}
+			ASSERT_GT(checked, 80);
+		}
+}
+
+TEST_F(SoftwareRenderFixture, PickBufferAnswersLikeAQuery)
+{
+	static const int size = 16;
+	makeMaze(size);
+	loadResources();
+
+	// the pixels are halved by the query in low detail mode
+	auto query = [this](int x, int y, Objid &hl, v3double_t &map)
+	{
+		hl.clear();
+		inst.edit.map = {};
+		bool hit = inst.SW_QueryPoint(hl, x * 2, y * 2);
+		map = inst.edit.map;
+		return hit;
+	};
+
+	static const ObjType modes[] = { ObjType::things, ObjType::linedefs, ObjType::sectors };
+
+	int hits = 0;
+	for(int view = 0; view < 8; ++view)
+		for(ObjType mode : modes)
+		{
+			inst.edit.mode = mode;
+			setView(3 * 128 + view * 31, 2 * 128 + 50 + view * 11, view * 0.8, 160, 100);
+			inst.r_view.texturing = true;
+
+			inst.r_view.picking = true;
+			render(true);
+			ASSERT_TRUE(inst.r_view.PickIsCurrent());
+
+			for(int y = 0; y < 100; y += 3)
+				for(int x = 0; x < 160; x += 7)
+				{
+					Objid picked, queried;
+					v3double_t picked_map, queried_map;
+
+					inst.r_view.picking = true;
+					bool picked_hit = query(x, y, picked, picked_map);
+					inst.r_view.picking = false;
+					bool queried_hit = query(x, y, queried, queried_map);
+
+					ASSERT_EQ(picked_hit, queried_hit) << "view " << view << " at " << x << "," << y;
+					ASSERT_EQ(picked.type, queried.type);
+					ASSERT_EQ(picked.num, queried.num);
+					ASSERT_EQ(picked.parts, queried.parts);
+					ASSERT_EQ(picked_map.x, queried_map.x);
+					ASSERT_EQ(picked_map.y, queried_map.y);
+					ASSERT_EQ(picked_map.z, queried_map.z);
+					hits += picked_hit;
+				}
+		}
+	ASSERT_GT(hits, 3000);
+
+	// turning makes the buffer stale, and the next query makes a new
+	// one without drawing anything
+	inst.edit.mode = ObjType::sectors;
+	inst.r_view.picking = true;
+	render(true);
+	inst.r_view.SetAngle(static_cast<float>(inst.r_view.angle + 0.5));
+	ASSERT_FALSE(inst.r_view.PickIsCurrent());
+
+	screen.assign(screen.size(), 7);
+	Objid picked;
+	v3double_t map;
+	ASSERT_TRUE(query(80, 70, picked, map));
+	ASSERT_TRUE(inst.r_view.PickIsCurrent());
+	ASSERT_EQ(std::count(screen.begin(), screen.end(), 7), (long)screen.size());
+
+	inst.r_view.picking = false;
+	Objid queried;
+	ASSERT_TRUE(query(80, 70, queried, map));
+	ASSERT_EQ(picked.num, queried.num);
+	ASSERT_EQ(picked.parts, queried.parts);
+
+	// so does changing the map
+	inst.r_view.InvalidatePick();
+	ASSERT_FALSE(inst.r_view.PickIsCurrent());
+}
+
+//
+// Not a real test: reports how long a frame takes on a big map, with and
+// without the visibility walk
+//
+TEST_F(SoftwareRenderFixture, DISABLED_BenchmarkFrameTime)
+{
+	static const int size = 80;
+	makeMaze(size);
+
+	auto timeFrames = [this](bool culling)
+	{
+		auto start = std::chrono::steady_clock::now();
+		int frames = 0;
+		for(int row = 1; row < size; row += 9)
+			for(int col = 0; col < size; col += 7)
+			{
+				if(!isOpen(col, row, size))
+					continue;
+				setView(col * 128 + 64, row * 128 + 64, frames * 0.7, 640, 400);
+				render(culling);
+				++frames;
+			}
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return ms / frames;
+	};
+
+	double all = timeFrames(false);
+	double culled = timeFrames(true);
+
+	printf("%d linedefs at 640x400: %.2f ms per frame drawing everything, %.2f ms with culling\n",
+		   inst.level.numLinedefs(), all, culled);
+}
+
+//
+// Not a real test: reports how long a wide frame takes on one thread and
+// on all of them
+//
+TEST_F(SoftwareRenderFixture, DISABLED_BenchmarkThreads)
+{
+	static const int size = 40;
+	makeMaze(size);
+
+	auto timeFrames = [this](int threads)
+	{
+		inst.r_view.threads = threads;
+		auto start = std::chrono::steady_clock::now();
+		for(int frame = 0; frame < 10; ++frame)
+		{
+			setView(9 * 128 + 64, 9 * 128 + 64, frame * 0.6, 2560, 1440);
+			render(true);
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 10;
+	};
+
+	double single = timeFrames(1);
+	double all = timeFrames(0);
+
+	printf("2560x1440: %.2f ms per frame on one thread, %.2f ms on %d\n", single, all,
+		   WorkerPool::defaultThreads());
+}
+
+//
+// Not a real test: reports the frames per second from fixed spots on the
+// test maps, with flat colors and with lit textures
+//
+TEST_F(SoftwareRenderFixture, DISABLED_BenchmarkFramesPerSecond)
+{
+	static const int size = 40;
+	makeMaze(size);
+	loadResources();
+
+	auto framesPerSecond = [this](bool texturing, bool lighting)
+	{
+		int frames = 0;
+		auto start = std::chrono::steady_clock::now();
+		for(int row = 1; row < size; row += 5)
+			for(int col = 0; col < size; col += 3)
+			{
+				if(!isOpen(col, row, size))
+					continue;
+				setView(col * 128 + 64, row * 128 + 64, frames * 0.7, 640, 400);
+				inst.r_view.texturing = texturing;
+				inst.r_view.lighting = lighting;
+				render(true);
+				++frames;
+			}
+		return frames / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	double flat = framesPerSecond(false, false);
+	double lit = framesPerSecond(true, true);
+
+	printf("640x400: %.0f frames per second untextured, %.0f textured and lit\n", flat, lit);
+}
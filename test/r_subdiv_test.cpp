@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Document.h"
+#include "e_basis.h"
+#include "Instance.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Vertex.h"
+#include "testUtils/RoomGrid.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+class SubdivFixture : public ::testing::Test
+{
+protected:
+	SubdivFixture()
+	{
+		// keep the object panel (which needs a window) out of the edits
+		inst.edit.mode = ObjType::things;
+	}
+
+	~SubdivFixture()
+	{
+		inst.level.clear();
+	}
+
+	void makeRooms(int columns, int rows);
+	std::vector<double> snapshot();
+	void checkAgainstRebuild();
+
+	int vertexAt(int col, int row) const
+	{
+		return row * (columns + 1) + col;
+	}
+
+	Instance inst;
+	int columns = 0;
+};
+
+//
+// Builds a grid of 64x64 rooms sharing their walls, each room with its
+// own floor height
+//
+void SubdivFixture::makeRooms(int columns, int rows)
+{
+	Document &doc = inst.level;
+	this->columns = columns;
+
+	RoomGrid(columns, rows).build(doc);
+
+	for(int n = 0; n < doc.numSectors(); ++n)
+	{
+		doc.sectors[n]->floorh = n % 5 * 8;
+		doc.sectors[n]->ceilh = 128;
+	}
+}
+
+//
+// Everything the cache knows about every sector, as one list
+//
+std::vector<double> SubdivFixture::snapshot()
+{
+	std::vector<double> result;
+
+	for(int sec = 0; sec < inst.level.numSectors(); ++sec)
+	{
+		const sector_subdivision_c *sub = inst.Subdiv_PolygonsForSector(sec);
+		const sector_3dfloors_c *floors = inst.Subdiv_3DFloorsForSector(sec);
+		const sector_extra_info_t &info = inst.sector_info_cache.infos[sec];
+
+		result.push_back(info.first_line);
+		result.push_back(info.last_line);
+		if(info.first_line >= 0)
+		{
+			result.push_back(info.bound_x1);
+			result.push_back(info.bound_y1);
+			result.push_back(info.bound_x2);
+			result.push_back(info.bound_y2);
+		}
+
+		for(const sector_polygon_t &poly : sub->polygons)
+			for(int k = 0; k < poly.count; ++k)
+			{
+				result.push_back(poly.mx[k]);
+				result.push_back(poly.my[k]);
+			}
+		result.push_back(-1);
+
+		result.push_back(floors->heightsec);
+		result.push_back((double)floors->floors.size());
+		for(const slope_plane_c *plane : { &floors->f_plane, &floors->c_plane })
+		{
+			result.push_back(plane->sloped);
+			result.push_back(plane->xm);
+			result.push_back(plane->ym);
+			result.push_back(plane->zadd);
+		}
+	}
+	return result;
+}
+
+//
+// Compare what the cache has kept up to date with building it all afresh
+//
+void SubdivFixture::checkAgainstRebuild()
+{
+	std::vector<double> kept = snapshot();
+
+	inst.Subdiv_InvalidateAll();
+
+	ASSERT_EQ(kept, snapshot());
+}
+
+TEST_F(SubdivFixture, EditsMatchAFullRebuild)
+{
+	makeRooms(5, 4);
+
+	Document &doc = inst.level;
+
+	checkAgainstRebuild();
+
+	// drag a vertex, one step at a time
+	for(int step = 1; step <= 4; ++step)
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(vertexAt(2, 2), Vertex::F_X, FFixedPoint(128 + step * 7));
+		op.changeVertex(vertexAt(2, 2), Vertex::F_Y, FFixedPoint(128 - step * 5));
+	}
+	checkAgainstRebuild();
+
+	// give a room's wall to its neighbour, and change some heights
+	{
+		EditOperation op(doc.basis);
+		op.changeSidedef(doc.linedefs[7]->right, SideDef::F_SECTOR, 12);
+		op.changeSector(3, Sector::F_FLOORH, 40);
+		op.changeSector(4, Sector::F_CEILH, 96);
+	}
+	checkAgainstRebuild();
+
+	// flip a line over, swapping its sides
+	{
+		EditOperation op(doc.basis);
+		const LineDef L = *doc.linedefs[8];
+		op.changeLinedef(8, LineDef::F_START, L.end);
+		op.changeLinedef(8, LineDef::F_END, L.start);
+		op.changeLinedef(8, LineDef::F_RIGHT, L.left);
+		op.changeLinedef(8, LineDef::F_LEFT, L.right);
+	}
+	checkAgainstRebuild();
+
+	// append a line, with its fields set after insertion
+	{
+		EditOperation op(doc.basis);
+
+		int v = op.addNew(ObjType::vertices);
+		doc.vertices[v]->SetRawXY(MapFormat::doom, { 96, 32 });
+
+		int sd = op.addNew(ObjType::sidedefs);
+		doc.sidedefs[sd]->sector = 1;
+
+		int ld = op.addNew(ObjType::linedefs);
+		doc.linedefs[ld]->start = vertexAt(1, 0);
+		doc.linedefs[ld]->end = v;
+		doc.linedefs[ld]->right = sd;
+	}
+	checkAgainstRebuild();
+
+	// reconnect a line to a vertex across the map
+	{
+		EditOperation op(doc.basis);
+		op.changeLinedef(0, LineDef::F_END, vertexAt(4, 3));
+	}
+	checkAgainstRebuild();
+
+	// delete from the middle, which renumbers the references
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::linedefs, 3);
+	}
+	checkAgainstRebuild();
+
+	while(doc.basis.undo())
+		checkAgainstRebuild();
+
+	while(doc.basis.redo())
+		checkAgainstRebuild();
+}
+
+TEST_F(SubdivFixture, SlopesFollowEdits)
+{
+	// EDGE style slopes
+	inst.loaded.levelFormat = MapFormat::doom;
+	inst.conf.features.slopes = 1;
+	inst.conf.features.gen_types = true;
+
+	makeRooms(4, 3);
+
+	Document &doc = inst.level;
+
+	// the wall between the first two rooms slopes the floor of the first
+	// (on its left side) up to the height of the second
+	int wall = doc.numLinedefs() - 3 * 5 + 1;
+	ASSERT_EQ(doc.linedefs[wall]->start, vertexAt(1, 0));
+	ASSERT_EQ(doc.linedefs[wall]->end, vertexAt(1, 1));
+
+	{
+		EditOperation op(doc.basis);
+		op.changeLinedef(wall, LineDef::F_TYPE, 567);
+	}
+	ASSERT_TRUE(inst.Subdiv_3DFloorsForSector(0)->f_plane.sloped);
+	checkAgainstRebuild();
+
+	// so the height of the second room changes the slope
+	{
+		EditOperation op(doc.basis);
+		op.changeSector(1, Sector::F_FLOORH, 64);
+	}
+	checkAgainstRebuild();
+
+	// and so does moving the far side of the first
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(vertexAt(0, 0), Vertex::F_X, FFixedPoint(-50));
+	}
+	checkAgainstRebuild();
+
+	// a Boom deep water line
+	{
+		EditOperation op(doc.basis);
+		op.changeLinedef(0, LineDef::F_TYPE, 242);
+		op.changeLinedef(0, LineDef::F_TAG, 5);
+		op.changeSector(6, Sector::F_TAG, 5);
+	}
+	ASSERT_EQ(inst.Subdiv_3DFloorsForSector(6)->heightsec, doc.getRight(*doc.linedefs[0])->sector);
+	checkAgainstRebuild();
+
+	// turning it off takes it away again
+	{
+		EditOperation op(doc.basis);
+		op.changeLinedef(wall, LineDef::F_TYPE, 0);
+		op.changeLinedef(0, LineDef::F_TYPE, 0);
+	}
+	ASSERT_FALSE(inst.Subdiv_3DFloorsForSector(0)->f_plane.sloped);
+	ASSERT_EQ(inst.Subdiv_3DFloorsForSector(6)->heightsec, -1);
+	checkAgainstRebuild();
+
+	while(doc.basis.undo())
+		checkAgainstRebuild();
+}
+
+//
+// Not a real test: reports how long each step of dragging a vertex takes
+// on a big map, when every edit rebuilds the whole cache and when only the
+// touched sectors get rebuilt
+//
+TEST_F(SubdivFixture, DISABLED_BenchmarkDrag)
+{
+	static const int size = 100;
+	makeRooms(size, size);
+
+	Document &doc = inst.level;
+	int vertex = vertexAt(size / 2, size / 2);
+
+	// the sectors around the vertex are the ones a view of it would draw
+	auto timeDrag = [&](bool everything)
+	{
+		snapshot();
+
+		auto start = std::chrono::steady_clock::now();
+		for(int step = 0; step < 50; ++step)
+		{
+			{
+				EditOperation op(doc.basis);
+				op.changeVertex(vertex, Vertex::F_X, FFixedPoint(size / 2 * 64 + step % 10));
+			}
+			if(everything)
+				inst.Subdiv_InvalidateAll();
+
+			for(int row = size / 2 - 1; row <= size / 2; ++row)
+				for(int col = size / 2 - 1; col <= size / 2; ++col)
+					inst.Subdiv_PolygonsForSector(row * size + col);
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 50;
+	};
+
+	double all = timeDrag(true);
+	double touched = timeDrag(false);
+
+	printf("%d sectors, %d linedefs: %.3f ms per drag step rebuilding everything, %.3f ms rebuilding the touched sectors\n",
+		   doc.numSectors(), doc.numLinedefs(), all, touched);
+}
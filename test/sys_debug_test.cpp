@@ -23,6 +23,9 @@
 #include "testUtils/TempDirContext.hpp"
 #include "gtest/gtest.h"
 
+#include <sstream>
+#include <thread>
+
 //
 // Temporary directory
 //
@@ -201,3 +204,31 @@ TEST_F(SysDebugTempDir, LifeCycle)
     ASSERT_EQ(localWindowMessages[0], "Extra stuff one\n");
     ASSERT_EQ(localWindowMessages[1], "Extra stuff two\n");
 }
+
+TEST(LogCapture, MessagesComeOutWhenReplayed)
+{
+    LogBuffer first, second;
+
+    std::thread thread([&second]()
+    {
+        LogCapture capture(second);
+        gLog.printf("Second part\n");
+    });
+    {
+        LogCapture capture(first);
+        gLog.printf("First part\n");
+    }
+    thread.join();
+
+    gLog.printf("Before\n");
+    first.replay();
+    second.replay();
+    second.replay();    // nothing is left
+
+    std::ostringstream os;
+    gLog.saveTo(os);
+    std::string text = os.str();
+    std::string tail = "Before\nFirst part\nSecond part\n";
+    ASSERT_GE(text.size(), tail.size());
+    ASSERT_EQ(text.substr(text.size() - tail.size()), tail);
+}
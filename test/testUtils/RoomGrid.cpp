@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "RoomGrid.hpp"
+#include "Document.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+
+RoomGrid::RoomGrid(int columns, int rows, double size) :
+	columns(columns), rows(rows), size(size), cellSector(columns * rows)
+{
+	for(int n = 0; n < columns * rows; ++n)
+		cellSector[n] = n;
+}
+
+RoomGrid::RoomGrid(const std::vector<std::string> &picture, double size) :
+	columns((int)picture[0].size()), rows((int)picture.size()), size(size),
+	cellSector(columns * rows, -1)
+{
+	int sector = 0;
+	for(int row = 0; row < rows; ++row)
+		for(int col = 0; col < columns; ++col)
+			if(picture[rows - 1 - row][col] == '#')
+				cellSector[row * columns + col] = sector++;
+}
+
+int RoomGrid::sectorAt(int col, int row) const
+{
+	if(col < 0 || col >= columns || row < 0 || row >= rows)
+		return -1;
+	return cellSector[row * columns + col];
+}
+
+void RoomGrid::build(Document &doc) const
+{
+	for(int row = 0; row <= rows; ++row)
+		for(int col = 0; col <= columns; ++col)
+		{
+			Vertex vertex;
+			vertex.SetRawXY(MapFormat::doom, { col * size, row * size });
+			doc.vertices.push_back(std::move(vertex));
+		}
+
+	for(int sector : cellSector)
+		if(sector >= 0)
+			doc.sectors.push_back(Sector());
+
+	auto addSide = [&doc](int sector)
+	{
+		if(sector < 0)
+			return -1;
+		SideDef side;
+		side.sector = sector;
+		doc.sidedefs.push_back(std::move(side));
+		return doc.numSidedefs() - 1;
+	};
+	// the line goes from v1 to v2 with 'right_sec' on its right side,
+	// unless only the left side has a room
+	auto addLine = [&doc, &addSide](int v1, int v2, int right_sec, int left_sec)
+	{
+		if(right_sec < 0 && left_sec < 0)
+			return;
+		if(right_sec < 0)
+		{
+			std::swap(v1, v2);
+			std::swap(right_sec, left_sec);
+		}
+		LineDef line;
+		line.start = v1;
+		line.end = v2;
+		line.right = addSide(right_sec);
+		line.left = addSide(left_sec);
+		line.flags = left_sec >= 0 ? MLF_TwoSided : MLF_Blocking;
+		doc.linedefs.push_back(std::move(line));
+	};
+
+	// horizontal walls, with the room above on the right side
+	for(int row = 0; row <= rows; ++row)
+		for(int col = 0; col < columns; ++col)
+			addLine(vertexAt(col + 1, row), vertexAt(col, row), sectorAt(col, row), sectorAt(col, row - 1));
+
+	// vertical walls, with the room to the east on the right side
+	for(int row = 0; row < rows; ++row)
+		for(int col = 0; col <= columns; ++col)
+			addLine(vertexAt(col, row), vertexAt(col, row + 1), sectorAt(col, row), sectorAt(col - 1, row));
+}
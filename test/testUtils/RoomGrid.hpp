@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef ROOMGRID_HPP_
+#define ROOMGRID_HPP_
+
+#include <string>
+#include <vector>
+
+class Document;
+
+//
+// Test maps made of square rooms on a grid, each room its own sector.
+// Neighbouring rooms share a two-sided linedef, and the other walls are
+// one-sided with the room on their right.
+//
+// build() makes the objects in a fixed order, which the tests rely on:
+// the vertices row by row (from the bottom) over the whole lattice, the
+// sectors in the same order as their rooms, then the horizontal walls
+// and after them the vertical ones, each line with its right sidedef
+// first.
+//
+class RoomGrid
+{
+public:
+	// every cell is a room
+	RoomGrid(int columns, int rows, double size = 64);
+	// a room for each '#' in the picture, whose first string is the top row
+	explicit RoomGrid(const std::vector<std::string> &picture, double size = 64);
+
+	// adds the rooms to an empty document
+	void build(Document &doc) const;
+
+	int vertexAt(int col, int row) const
+	{
+		return row * (columns + 1) + col;
+	}
+
+	// the sector of the room in the cell, -1 when there is none
+	int sectorAt(int col, int row) const;
+
+	const int columns;
+	const int rows;
+	const double size;
+
+private:
+	std::vector<int> cellSector;
+};
+
+#endif
@@ -16,6 +16,7 @@
 //
 //------------------------------------------------------------------------
 
+#include "e_basis.h"
 #include "WadData.h"
 #include "m_game.h"
 #include "m_loadsave.h"
@@ -77,3 +78,178 @@ TEST(Texture, WadDataGetNullSprite)
     image = wadData.getSprite(config, 1234, loading);
     ASSERT_FALSE(image);
 }
+
+//
+// Makes a DOOM format patch all of one colour
+//
+static std::vector<uint8_t> makePatch(int width, int height, uint8_t color)
+{
+    std::vector<uint8_t> data;
+    auto add16 = [&data](int value)
+    {
+        data.push_back(static_cast<uint8_t>(value));
+        data.push_back(static_cast<uint8_t>(value >> 8));
+    };
+    add16(width);
+    add16(height);
+    add16(0);
+    add16(0);
+    for(int x = 0; x < width; ++x)
+    {
+        add16(8 + 4 * width + x * (height + 5));
+        add16(0);
+    }
+    for(int x = 0; x < width; ++x)
+    {
+        data.push_back(0);
+        data.push_back(static_cast<uint8_t>(height));
+        data.push_back(0);
+        data.insert(data.end(), height, color);
+        data.push_back(0);
+        data.push_back(255);
+    }
+    return data;
+}
+
+TEST(Texture, TexturesAndFlatsAreDrawnWhenFirstUsed)
+{
+    ConfigData config;
+
+    auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+    ASSERT_TRUE(wad);
+
+    std::vector<uint8_t> data(768);
+    for(int i = 0; i < 768; ++i)
+        data[i] = static_cast<uint8_t>(i / 3);
+    wad->AddLump("PLAYPAL").Write(data.data(), (int)data.size());
+    data.assign(8192, 0);
+    wad->AddLump("COLORMAP").Write(data.data(), (int)data.size());
+
+    static const uint8_t pnames[] = { 2, 0, 0, 0, 'P', 'A', 'T', 'C', 'H', 'A', 0, 0, 'P', 'A', 'T', 'C', 'H', 'B', 0, 0 };
+    wad->AddLump("PNAMES").Write(pnames, sizeof(pnames));
+
+    // the first texture is never used
+    static const uint8_t texture1[] = {
+        2, 0, 0, 0, 12, 0, 0, 0, 44, 0, 0, 0,
+        'A', 'A', 'S', 'H', 'I', 'T', 'T', 'Y', 0, 0, 0, 0, 8, 0, 8, 0, 0, 0, 0, 0, 1, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        'T', 'W', 'O', 'P', 'A', 'T', 'C', 'H', 0, 0, 0, 0, 16, 0, 8, 0, 0, 0, 0, 0, 2, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        8, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+    };
+    wad->AddLump("TEXTURE1").Write(texture1, sizeof(texture1));
+
+    data = makePatch(8, 8, 10);
+    wad->AddLump("PATCHA").Write(data.data(), (int)data.size());
+    data = makePatch(8, 8, 20);
+    wad->AddLump("PATCHB").Write(data.data(), (int)data.size());
+
+    wad->AddLump("F_START");
+    data.assign(4096, 33);
+    wad->AddLump("FLAT1").Write(data.data(), (int)data.size());
+    wad->AddLump("F_END");
+
+    WadData wadData;
+    wadData.reloadResources(wad, config, {});
+    ImageSet &images = wadData.images;
+
+    // nothing gets drawn just to know about the textures
+    ASSERT_TRUE(images.W_TextureIsKnown(config, "TWOPATCH"));
+    ASSERT_FALSE(images.W_TextureIsKnown(config, "AASHITTY"));
+    ASSERT_EQ(images.W_GetTextureHeight(config, "TWOPATCH"), 8);
+    ASSERT_TRUE(images.W_FlatIsKnown(config, "FLAT1"));
+    ASSERT_EQ(images.getImage(images.getTextures().at("TWOPATCH")).width(), 16);
+    ASSERT_EQ(images.drawnImageBytes(), 0);
+
+    const Img_c *flat = images.W_GetFlat(config, "FLAT1");
+    ASSERT_TRUE(flat);
+    ASSERT_EQ(flat->buf()[4095], 33);
+    ASSERT_EQ(images.drawnImageBytes(), 64 * 64 * sizeof(img_pixel_t));
+
+    const Img_c *texture = images.getTexture(config, "TWOPATCH");
+    ASSERT_TRUE(texture);
+    ASSERT_EQ(texture->width(), 16);
+    ASSERT_EQ(texture->buf()[0], 10);
+    ASSERT_EQ(texture->buf()[8], 20);
+    ASSERT_EQ(texture->buf()[16 * 7 + 15], 20);
+    ASSERT_EQ(images.drawnImageBytes(), (16 * 8 + 64 * 64) * sizeof(img_pixel_t));
+
+    // the flat was used longest ago, so it goes first
+    images.setImageBudget(4096);
+    images.W_TrimImages();
+    ASSERT_EQ(images.drawnImageBytes(), 16 * 8 * sizeof(img_pixel_t));
+
+    flat = images.W_GetFlat(config, "FLAT1");
+    ASSERT_TRUE(flat);
+    ASSERT_EQ(flat->buf()[0], 33);
+    ASSERT_EQ(images.drawnImageBytes(), (16 * 8 + 64 * 64) * sizeof(img_pixel_t));
+
+    // they can still be drawn after the lumps are gone from the wad
+    wad->RemoveLumps(wad->FindLumpNum("PATCHA"));
+    wad->RemoveLumps(wad->FindLumpNum("FLAT1"));
+    ASSERT_EQ(wad->FindLumpNum("PATCHA"), -1);
+    images.setImageBudget(0);
+    images.W_TrimImages();
+    ASSERT_EQ(images.drawnImageBytes(), 0);
+
+    flat = images.W_GetFlat(config, "FLAT1");
+    ASSERT_TRUE(flat);
+    ASSERT_EQ(flat->buf()[0], 33);
+    texture = images.getTexture(config, "TWOPATCH");
+    ASSERT_TRUE(texture);
+    ASSERT_EQ(texture->buf()[0], 10);
+    ASSERT_EQ(texture->buf()[8], 20);
+}
+
+TEST(Texture, StringIDsResolveToImageHandles)
+{
+    ConfigData config;
+    config.miscInfo.sky_flat = "F_SKY1";
+
+    ImageSet images;
+    images.W_AddTexture("STARTAN", Img_c(8, 4), false);
+    images.W_AddFlat("FLOOR1", nullptr);
+    images.W_AddTexture("BIGDOOR", Img_c(16, 4), true);
+
+    StringID startan = BA_InternaliseString("STARTAN");
+    StringID bigdoor = BA_InternaliseString("BIGDOOR");
+    StringID floor1 = BA_InternaliseString("FLOOR1");
+
+    int handle = images.textureHandle(config, startan);
+    ASSERT_GE(handle, 0);
+    ASSERT_EQ(images.getImage(handle).width(), 8);
+    ASSERT_EQ(images.drawImage(config, handle), images.getTexture(config, "STARTAN"));
+    ASSERT_EQ(images.getImage(images.textureHandle(config, bigdoor)).width(), 16);
+
+    ASSERT_EQ(images.textureHandle(config, BA_InternaliseString("-")), ImageSet::IMAGE_NULL_TEX);
+    ASSERT_EQ(images.textureHandle(config, BA_InternaliseString("#12345")), ImageSet::IMAGE_SPECIAL_TEX);
+    ASSERT_EQ(images.textureHandle(config, BA_InternaliseString("NOSUCH")), ImageSet::IMAGE_UNKNOWN);
+    ASSERT_EQ(images.textureHandle(config, floor1), ImageSet::IMAGE_UNKNOWN);
+    ASSERT_EQ(images.flatHandle(config, BA_InternaliseString("F_SKY1")), ImageSet::IMAGE_SKY_FLAT);
+    ASSERT_EQ(images.flatHandle(config, BA_InternaliseString("f_sky1")), ImageSet::IMAGE_SKY_FLAT);
+    ASSERT_GE(images.flatHandle(config, floor1), 0);
+
+    // a texture added later is found by a name looked up before
+    StringID later = BA_InternaliseString("LATER");
+    ASSERT_EQ(images.textureHandle(config, later), ImageSet::IMAGE_UNKNOWN);
+    images.W_AddTexture("LATER", Img_c(2, 2), false);
+    ASSERT_GE(images.textureHandle(config, later), 0);
+
+    // the other config may mix textures and flats
+    ConfigData mixed;
+    mixed.features.mix_textures_flats = true;
+    ASSERT_GE(images.textureHandle(mixed, floor1), 0);
+
+    // clearing the flats packs the registry, keeping the textures
+    images.W_ClearFlats();
+    ASSERT_EQ(images.flatHandle(config, floor1), ImageSet::IMAGE_UNKNOWN);
+    ASSERT_EQ(images.getImage(images.textureHandle(config, startan)).width(), 8);
+    ASSERT_EQ(images.getImage(images.textureHandle(config, bigdoor)).width(), 16);
+    ASSERT_TRUE(images.W_TextureCausesMedusa("BIGDOOR"));
+    ASSERT_FALSE(images.W_TextureCausesMedusa("STARTAN"));
+    ASSERT_EQ(images.getImage(images.getTextures().at("LATER")).width(), 2);
+
+    images.W_ClearTextures();
+    ASSERT_EQ(images.textureHandle(config, startan), ImageSet::IMAGE_UNKNOWN);
+    ASSERT_TRUE(images.getTextures().empty());
+}
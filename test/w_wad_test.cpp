@@ -17,6 +17,8 @@
 //------------------------------------------------------------------------
 
 #include "w_wad.h"
+#include "m_game.h"
+#include "w_rawdef.h"
 #include "WadData.h"
 #include "testUtils/TempDirContext.hpp"
 #ifdef None	// fix pollution
@@ -24,6 +26,8 @@
 #endif
 #include "gtest/gtest.h"
 
+#include <chrono>
+
 class WadFileTest : public TempDirContext
 {
 };
@@ -317,6 +321,53 @@ TEST_F(WadFileTest, FindLumpInNamespace)
 			  wad->GetLump(19));
 }
 
+TEST_F(WadFileTest, FindLumpAfterChanges)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	ASSERT_TRUE(wad);
+
+	wad->AddLump("LUMP1");	// 0
+	wad->AddLump("LUMP2");
+	wad->AddLump("LUMP1");	// 2
+
+	// the last one wins, in any case
+	ASSERT_EQ(wad->FindLumpNum("LUMP1"), 2);
+	ASSERT_EQ(wad->FindLump("lump1"), wad->GetLump(2));
+	ASSERT_EQ(wad->FindLumpNum("LUMP3"), -1);
+	ASSERT_EQ(wad->FindLumpNum("LUMP1LUMP1"), -1);
+	ASSERT_EQ(wad->FindLumpNum(""), -1);
+
+	wad->InsertPoint(1);
+	wad->AddLump("LUMP3");
+	ASSERT_EQ(wad->FindLumpNum("LUMP3"), 1);
+	ASSERT_EQ(wad->FindLumpNum("LUMP2"), 2);
+	ASSERT_EQ(wad->FindLumpNum("LUMP1"), 3);
+
+	wad->RemoveLumps(3);
+	ASSERT_EQ(wad->FindLumpNum("LUMP1"), 0);
+
+	wad->RenameLump(0, "renamed");
+	ASSERT_EQ(wad->FindLumpNum("LUMP1"), -1);
+	ASSERT_EQ(wad->FindLumpNum("RENAMED"), 0);
+
+	// sprites are looked up by their first letters
+	wad->AddLump("S_START");
+	wad->AddLump("POSSA1").Printf("a");
+	wad->AddLump("S_END");
+	ASSERT_EQ(wad->findFirstSpriteLump("POSS"), wad->GetLump(4));
+	ASSERT_EQ(wad->findFirstSpriteLump("PO"), wad->GetLump(4));
+	wad->RenameLump(4, "TROOA1");
+	ASSERT_EQ(wad->findFirstSpriteLump("POSS"), nullptr);
+	ASSERT_EQ(wad->findFirstSpriteLump("TROOA"), wad->GetLump(4));
+
+	// many additions in a row, only looked up at the end
+	for(int i = 0; i < 1000; ++i)
+		wad->AddLump(SString::printf("BULK%d", i));
+	ASSERT_EQ(wad->FindLumpNum("BULK0"), 6);
+	ASSERT_EQ(wad->FindLumpNum("BULK999"), 1005);
+	ASSERT_EQ(wad->FindLumpNum("LUMP3"), 1);
+}
+
 //
 // Query levels
 //
@@ -545,3 +596,389 @@ TEST_F(WadFileTest, FindFirstSpriteLump)
 	ASSERT_EQ(wad->findFirstSpriteLump("TROO"), &troob1);
 	ASSERT_EQ(wad->findFirstSpriteLump("POSSD4"), nullptr);
 }
+
+TEST_F(WadFileTest, OpenMappedMapsLumps)
+{
+	fs::path path = getChildPath("wad.wad");
+	auto wad = Wad_file::Open(path, WadOpenMode::write);
+	ASSERT_TRUE(wad);
+	wad->AddLump("LUMP1").Printf("Hello, world!");
+	wad->AddLump("EMPTY");
+	wad->AddLump("LUMP2").Printf("Goodbye!");
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	std::vector<uint8_t> original;
+	readFromPath(path, original);
+
+	auto read = Wad_file::openMapped(path);
+	ASSERT_TRUE(read);
+	ASSERT_TRUE(read->IsReadOnly());
+	ASSERT_EQ(read->NumLumps(), 3);
+
+	// plain read mode reads everything in
+	auto plain = Wad_file::Open(path, WadOpenMode::read);
+	ASSERT_TRUE(plain);
+	ASSERT_FALSE(plain->GetLump(0)->isMapped());
+
+	// same contents as when reading the whole file in
+	auto append = Wad_file::Open(path, WadOpenMode::append);
+	ASSERT_TRUE(append);
+	for(int i = 0; i < 3; ++i)
+	{
+		ASSERT_FALSE(append->GetLump(i)->isMapped());
+		ASSERT_EQ(read->GetLump(i)->Name(), append->GetLump(i)->Name());
+		ASSERT_EQ(read->GetLump(i)->getData(), append->GetLump(i)->getData());
+	}
+	ASSERT_TRUE(read->GetLump(0)->isMapped());
+	ASSERT_FALSE(read->GetLump(1)->isMapped());
+	ASSERT_EQ(read->GetLump(1)->Length(), 0);
+
+	// changing a lump copies it out of the file first
+	Lump_c *lump = read->GetLump(2);
+	lump->Printf("!!");
+	ASSERT_FALSE(lump->isMapped());
+	assertVecString(lump->getData(), "Goodbye!!!");
+	ASSERT_TRUE(read->GetLump(0)->isMapped());
+
+	std::vector<uint8_t> after;
+	readFromPath(path, after);
+	ASSERT_EQ(after, original);
+}
+
+//
+// The peak resident memory of the process in kilobytes since the last
+// resetPeakResident(), or -1 where that cannot be told
+//
+static long peakResidentKB()
+{
+#ifdef __linux__
+	FILE *f = fopen("/proc/self/status", "r");
+	if(!f)
+		return -1;
+	long result = -1;
+	char line[256];
+	while(fgets(line, sizeof(line), f))
+		if(sscanf(line, "VmHWM: %ld kB", &result) == 1)
+			break;
+	fclose(f);
+	return result;
+#else
+	return -1;
+#endif
+}
+
+static void resetPeakResident()
+{
+#ifdef __linux__
+	FILE *f = fopen("/proc/self/clear_refs", "w");
+	if(f)
+	{
+		fputs("5", f);
+		fclose(f);
+	}
+#endif
+}
+
+//
+// Not a real test: reports how long it takes from opening a big IWAD until
+// the first frame can be drawn, and the peak memory used meanwhile, when
+// the lumps are mapped and when they are read in. Goes through the same
+// steps as loadResources() in main.cc, which needs the whole program to
+// run: open the wad, load the palette, colormap and flats, then get the
+// flats like the first frame does.
+//
+TEST_F(WadFileTest, DISABLED_BenchmarkOpenResource)
+{
+	static const int numFlats = 500;
+	static const int numOther = 2000;
+	static const int otherSize = 16384;
+
+	// written directly, so the heap does not hold on to the lumps
+	fs::path path = getChildPath("big.wad");
+	{
+		struct Entry
+		{
+			SString name;
+			int size;
+		};
+		std::vector<Entry> entries;
+		entries.push_back({ "PLAYPAL", 768 });
+		entries.push_back({ "COLORMAP", 34 * 256 });
+		entries.push_back({ "F_START", 0 });
+		for(int i = 0; i < numFlats; ++i)
+			entries.push_back({ SString::printf("FLAT%d", i), 64 * 64 });
+		entries.push_back({ "F_END", 0 });
+		// like the sounds, music and sprites, which aren't needed at first
+		for(int i = 0; i < numOther; ++i)
+			entries.push_back({ SString::printf("LUMP%d", i), otherSize });
+
+		FILE *f = fopen(path.u8string().c_str(), "wb");
+		ASSERT_TRUE(f);
+		int dataSize = 0;
+		for(const Entry &entry : entries)
+			dataSize += entry.size;
+		raw_wad_header_t header = {};
+		memcpy(header.ident, "IWAD", 4);
+		header.num_entries = LE_U32((int)entries.size());
+		header.dir_start = LE_U32(12 + dataSize);
+		ASSERT_EQ(fwrite(&header, sizeof(header), 1, f), 1);
+		std::vector<byte> data;
+		for(size_t i = 0; i < entries.size(); ++i)
+		{
+			data.resize(entries[i].size);
+			for(size_t k = 0; k < data.size(); ++k)
+				data[k] = (byte)(i + k);
+			if(!data.empty())
+			{
+				ASSERT_EQ(fwrite(data.data(), data.size(), 1, f), 1);
+			}
+		}
+		int pos = 12;
+		for(const Entry &entry : entries)
+		{
+			raw_wad_entry_t raw = {};
+			raw.pos = LE_U32(pos);
+			raw.size = LE_U32(entry.size);
+			memcpy(raw.name, entry.name.c_str(), entry.name.length());
+			ASSERT_EQ(fwrite(&raw, sizeof(raw), 1, f), 1);
+			pos += entry.size;
+		}
+		ASSERT_EQ(fclose(f), 0);
+	}
+	mDeleteList.push(path);
+
+	for(bool mapped : { true, false })
+	{
+		resetPeakResident();
+		long before = peakResidentKB();
+
+		auto start = std::chrono::steady_clock::now();
+		std::shared_ptr<Wad_file> wad = mapped ? Wad_file::openMapped(path) :
+				Wad_file::Open(path, WadOpenMode::read);
+		ASSERT_TRUE(wad);
+		auto opened = std::chrono::steady_clock::now();
+
+		ConfigData config;
+		WadData wadData;
+		wadData.reloadResources(wad, config, {});
+		auto loaded = std::chrono::steady_clock::now();
+
+		for(int i = 0; i < numFlats; ++i)
+			ASSERT_TRUE(wadData.images.W_GetFlat(config, SString::printf("FLAT%d", i)));
+		auto drawn = std::chrono::steady_clock::now();
+
+		long after = peakResidentKB();
+
+		auto us = [](std::chrono::steady_clock::duration d)
+		{
+			return (int)std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+		};
+		printf("%s: open %d us, resources %d us, flats %d us, first frame after %d us, peak %ld KB more resident\n",
+			   mapped ? "mapped" : "read in", us(opened - start), us(loaded - opened),
+			   us(drawn - loaded), us(drawn - start),
+			   before < 0 || after < 0 ? -1 : after - before);
+	}
+}
+
+//
+// Makes a wad big enough to be saved by only writing the changes
+//
+static std::shared_ptr<Wad_file> makeBigWad(const fs::path &path)
+{
+	auto wad = Wad_file::Open(path, WadOpenMode::write);
+	std::vector<byte> data(2 << 20);
+	for(size_t i = 0; i < data.size(); ++i)
+		data[i] = (byte)(i * 7);
+	wad->AddLump("BIG").setData(std::move(data));
+	wad->AddLump("SMALL").Printf("Hello, world!");
+	wad->AddLump("OTHER").Printf("Goodbye!");
+	return wad;
+}
+
+TEST_F(WadFileTest, IncrementalSave)
+{
+	fs::path path = getChildPath("wad.wad");
+	auto wad = makeBigWad(path);
+	ASSERT_TRUE(wad);
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	std::vector<uint8_t> original;
+	readFromPath(path, original);
+	ASSERT_EQ((int)original.size(), wad->TotalSize());
+
+	// change one lump, add and rename others
+	wad->GetLump(1)->setData({ 'H', 'i' });
+	wad->AddLump("NEW").Printf("New!");
+	wad->RenameLump(2, "RENAMED");
+	wad->writeToDisk();
+
+	// the old data stays where it was, the changes and a new directory
+	// follow it, and only the header got rewritten
+	std::vector<uint8_t> data;
+	readFromPath(path, data);
+	ASSERT_EQ(data.size(), original.size() + 2 + 4 + 4 * 16);
+	ASSERT_TRUE(std::equal(original.begin() + 12, original.end(), data.begin() + 12));
+
+	auto read = Wad_file::Open(path, WadOpenMode::read);
+	ASSERT_TRUE(read);
+	ASSERT_EQ(read->NumLumps(), 4);
+	ASSERT_EQ(read->GetLump(0)->getData(), wad->GetLump(0)->getData());
+	ASSERT_EQ(read->GetLump(1)->Name(), "SMALL");
+	assertVecString(read->GetLump(1)->getData(), "Hi");
+	ASSERT_EQ(read->GetLump(2)->Name(), "RENAMED");
+	assertVecString(read->GetLump(2)->getData(), "Goodbye!");
+	ASSERT_EQ(read->GetLump(3)->Name(), "NEW");
+	assertVecString(read->GetLump(3)->getData(), "New!");
+	read.reset();
+
+	// saving again without changes only writes the directory
+	wad->writeToDisk();
+	readFromPath(path, data);
+	ASSERT_EQ(data.size(), original.size() + 2 + 4 + 8 * 16);
+
+	// also after reopening it
+	wad = Wad_file::Open(path, WadOpenMode::append);
+	ASSERT_TRUE(wad);
+	wad->writeToDisk();
+	readFromPath(path, data);
+	ASSERT_EQ(data.size(), original.size() + 2 + 4 + 12 * 16);
+}
+
+TEST_F(WadFileTest, IncrementalSaveCompacts)
+{
+	fs::path path = getChildPath("wad.wad");
+	auto wad = makeBigWad(path);
+	ASSERT_TRUE(wad);
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	std::vector<uint8_t> data;
+
+	// replacing the big lump leaves its old copy unused in the file,
+	// until there is too much of that
+	wad->GetLump(0)->setData(std::vector<byte>(2 << 20, 1));
+	wad->writeToDisk();
+	readFromPath(path, data);
+	ASSERT_GT((int)data.size(), wad->TotalSize() + (2 << 20) - 100);
+
+	wad->GetLump(0)->setData(std::vector<byte>(2 << 20, 2));
+	wad->writeToDisk();
+	readFromPath(path, data);
+	ASSERT_EQ((int)data.size(), wad->TotalSize());
+
+	auto read = Wad_file::Open(path, WadOpenMode::read);
+	ASSERT_TRUE(read);
+	ASSERT_EQ(read->GetLump(0)->getData(), std::vector<byte>(2 << 20, 2));
+	assertVecString(read->GetLump(1)->getData(), "Hello, world!");
+}
+
+TEST_F(WadFileTest, IncrementalSaveAfterOutsideChange)
+{
+	fs::path path = getChildPath("wad.wad");
+	auto wad = makeBigWad(path);
+	ASSERT_TRUE(wad);
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	// someone else replaced the file: write all of it again
+	auto other = makeBigWad(path);
+	other->AddLump("EXTRA").Printf("extra");
+	other->writeToDisk();
+
+	wad->GetLump(1)->setData({ 'H', 'i' });
+	wad->writeToDisk();
+
+	std::vector<uint8_t> data;
+	readFromPath(path, data);
+	ASSERT_EQ((int)data.size(), wad->TotalSize());
+
+	auto read = Wad_file::Open(path, WadOpenMode::read);
+	ASSERT_TRUE(read);
+	ASSERT_EQ(read->NumLumps(), 3);
+	assertVecString(read->GetLump(1)->getData(), "Hi");
+}
+
+TEST_F(WadFileTest, IncrementalSaveAfterSameSizeChange)
+{
+	fs::path path = getChildPath("wad.wad");
+	auto wad = makeBigWad(path);
+	ASSERT_TRUE(wad);
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	// someone else rewrote the file without changing its size
+	auto other = makeBigWad(path);
+	other->GetLump(2)->setData({ 'S', 'e', 'e', ' ', 'y', 'o', 'u', '!' });
+	other->writeToDisk();
+	fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(2));
+
+	wad->GetLump(1)->setData({ 'H', 'i' });
+	wad->writeToDisk();
+
+	std::vector<uint8_t> data;
+	readFromPath(path, data);
+	ASSERT_EQ((int)data.size(), wad->TotalSize());
+
+	auto read = Wad_file::Open(path, WadOpenMode::read);
+	ASSERT_TRUE(read);
+	assertVecString(read->GetLump(1)->getData(), "Hi");
+	assertVecString(read->GetLump(2)->getData(), "Goodbye!");
+}
+
+//
+// Not a real test: reports how long saving a big wad takes after changing
+// one of its levels, compared with writing it whole
+//
+TEST_F(WadFileTest, DISABLED_BenchmarkIncrementalSave)
+{
+	static const int numLevels = 32;
+	static const int lumpSize = 65536;
+	static const char *const lumpNames[] = { "THINGS", "LINEDEFS", "SIDEDEFS", "VERTEXES", "SECTORS" };
+
+	fs::path path = getChildPath("big.wad");
+	fs::path path2 = getChildPath("big2.wad");
+	auto wad = Wad_file::Open(path, WadOpenMode::write);
+	auto wad2 = Wad_file::Open(path2, WadOpenMode::write);
+	ASSERT_TRUE(wad);
+	ASSERT_TRUE(wad2);
+	for(int lev = 0; lev < numLevels; ++lev)
+	{
+		for(Wad_file *w : { wad.get(), wad2.get() })
+		{
+			w->AddLevel(SString::printf("MAP%02d", lev + 1));
+			for(const char *name : lumpNames)
+				w->AddLump(name).setData(std::vector<byte>(lumpSize, (byte)lev));
+		}
+	}
+	wad->writeToDisk();
+	mDeleteList.push(path);
+
+	// change one level
+	int start = wad->LevelHeader(numLevels / 2);
+	for(int i = 1; i <= 5; ++i)
+		wad->GetLump(start + i)->setData(std::vector<byte>(lumpSize, 0xff));
+
+	std::vector<uint8_t> data;
+	readFromPath(path, data);
+	size_t oldSize = data.size();
+
+	auto before = std::chrono::steady_clock::now();
+	wad->writeToDisk();
+	auto incremental = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - before);
+
+	readFromPath(path, data);
+
+	// a wad which was never saved gets written whole
+	before = std::chrono::steady_clock::now();
+	wad2->writeToDisk();
+	auto full = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - before);
+	mDeleteList.push(path2);
+
+	printf("saving a %d KB wad: %d us for %d KB of changes, %d us whole\n",
+		   wad->TotalSize() / 1024, (int)incremental.count(),
+		   (int)(data.size() - oldSize) / 1024, (int)full.count());
+}